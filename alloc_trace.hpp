@@ -0,0 +1,181 @@
+#pragma once
+// Opt-in allocation tracing for StackAllocator and StackAllocatorVector.
+//
+// Build with -DEXT_STL_ALLOC_TRACE (the same way in every translation unit)
+// and each allocator type records how its allocations were served into a
+// process-wide registry, keyed by element type, Capacity and call site:
+//
+//   inline hits      allocations served by the inline buffer
+//   heap fallbacks   allocations served by a heap slab or by malloc
+//   bytes spilled    bytes taken from the heap
+//   free list reuse  nodes handed out again after being freed
+//   peak live        most nodes one container held at once, or the largest
+//                    single allocation for vectors and strings
+//
+// AllocTraceSite attributes the allocations made on the current thread to
+// a named call site, AllocTraceRegistry::Instance().Dump() prints them all.
+// Without the macro none of this is compiled and the allocators are
+// unchanged.
+
+#if defined(EXT_STL_ALLOC_TRACE)
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <ostream>
+#include <typeinfo>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+struct AllocTraceCounters {
+  AllocTraceCounters(const char* type, size_t cap, const char* where)
+      : type_name(type), capacity(cap), site(where) {}
+
+  void RecordPeak(uint64_t live) {
+    uint64_t peak = peak_live.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !peak_live.compare_exchange_weak(peak, live,
+                                            std::memory_order_relaxed)) {
+    }
+  }
+
+  const char* type_name;
+  size_t capacity;
+  const char* site;
+  std::atomic<uint64_t> inline_hits{0};
+  std::atomic<uint64_t> heap_fallbacks{0};
+  std::atomic<uint64_t> bytes_spilled{0};
+  std::atomic<uint64_t> free_list_reuse{0};
+  std::atomic<uint64_t> peak_live{0};
+};
+
+// names the call site for allocations made on this thread in its scope
+class AllocTraceSite {
+ public:
+  explicit AllocTraceSite(const char* site) : prev_(Current()) {
+    Current() = site;
+  }
+  ~AllocTraceSite() { Current() = prev_; }
+
+  AllocTraceSite(const AllocTraceSite&) = delete;
+  AllocTraceSite& operator=(const AllocTraceSite&) = delete;
+
+  static const char*& Current() {
+    static thread_local const char* site = nullptr;
+    return site;
+  }
+
+ private:
+  const char* prev_;
+};
+
+class AllocTraceRegistry {
+ public:
+  static AllocTraceRegistry& Instance() {
+    static AllocTraceRegistry registry;
+    return registry;
+  }
+
+  // the counters of one allocator type at one site, created on first use
+  // and never freed, so callers may cache the pointer
+  AllocTraceCounters* Find(const char* type_name, size_t capacity,
+                           const char* site) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& counters : counters_) {
+      if (counters->capacity == capacity &&
+          std::strcmp(counters->type_name, type_name) == 0 &&
+          SameSite(counters->site, site)) {
+        return counters.get();
+      }
+    }
+    counters_.emplace_back(
+        new AllocTraceCounters(type_name, capacity, site));
+    return counters_.back().get();
+  }
+
+  template <typename Func>
+  void ForEach(Func func) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& counters : counters_) func(*counters);
+  }
+
+  void Reset() {
+    ForEach([](AllocTraceCounters& c) {
+      c.inline_hits = 0;
+      c.heap_fallbacks = 0;
+      c.bytes_spilled = 0;
+      c.free_list_reuse = 0;
+      c.peak_live = 0;
+    });
+  }
+
+  void Dump(std::ostream& os) const {
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-16s %8s %12s %12s %14s %12s %10s  %s",
+                  "site", "capacity", "inline hits", "heap", "bytes spilled",
+                  "reused", "peak live", "type");
+    os << line << '\n';
+    ForEach([&](const AllocTraceCounters& c) {
+      std::snprintf(line, sizeof(line),
+                    "%-16s %8zu %12llu %12llu %14llu %12llu %10llu  ",
+                    c.site != nullptr ? c.site : "-", c.capacity,
+                    Count(c.inline_hits), Count(c.heap_fallbacks),
+                    Count(c.bytes_spilled), Count(c.free_list_reuse),
+                    Count(c.peak_live));
+      os << line << Demangle(c.type_name) << '\n';
+    });
+    os.flush();
+  }
+
+ private:
+  AllocTraceRegistry() = default;
+
+  static bool SameSite(const char* lhs, const char* rhs) {
+    if (lhs == nullptr || rhs == nullptr) {
+      return lhs == rhs;
+    }
+    return std::strcmp(lhs, rhs) == 0;
+  }
+
+  static unsigned long long Count(const std::atomic<uint64_t>& counter) {
+    return counter.load(std::memory_order_relaxed);
+  }
+
+  static std::string Demangle(const char* name) {
+#if defined(__GNUG__)
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0 && demangled != nullptr) {
+      std::string result(demangled);
+      std::free(demangled);
+      return result;
+    }
+#endif
+    return name;
+  }
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<AllocTraceCounters>> counters_;
+};
+
+// counters for allocations of T from an allocator with Capacity, at the
+// current call site
+template <typename T, size_t Capacity>
+AllocTraceCounters* AllocTraceFor() {
+  const char* site = AllocTraceSite::Current();
+  if (site == nullptr) {
+    static AllocTraceCounters* counters =
+        AllocTraceRegistry::Instance().Find(typeid(T).name(), Capacity,
+                                            nullptr);
+    return counters;
+  }
+  return AllocTraceRegistry::Instance().Find(typeid(T).name(), Capacity,
+                                             site);
+}
+#endif
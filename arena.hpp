@@ -0,0 +1,202 @@
+#pragma once
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <algorithm>
+
+// Blocks handed back early, kept by exact size and alignment so the next
+// request of the same shape gets one back; users have few distinct sizes,
+// blocks of a size the bins have no room for are dropped.
+class RecycleBins {
+ public:
+  // bins are taken in order, so the first unused one ends the search
+  void* Pop(size_t bytes, size_t align) {
+    for (Bin& bin : bins_) {
+      if (bin.bytes == 0) {
+        break;
+      }
+      if (bin.bytes == bytes && bin.align == align && bin.head != nullptr) {
+        Recycled* block = bin.head;
+        bin.head = block->next;
+        return block;
+      }
+    }
+    return nullptr;
+  }
+
+  void Push(void* p, size_t bytes, size_t align) {
+    if (bytes < sizeof(Recycled) || align < alignof(Recycled)) {
+      return;
+    }
+    Recycled* block = static_cast<Recycled*>(p);
+    for (Bin& bin : bins_) {
+      if (bin.bytes == 0) {
+        bin.bytes = bytes;
+        bin.align = align;
+      }
+      if (bin.bytes == bytes && bin.align == align) {
+        block->next = bin.head;
+        bin.head = block;
+        return;
+      }
+    }
+  }
+
+  void Clear() {
+    for (Bin& bin : bins_) bin = Bin();
+  }
+
+ private:
+  struct Recycled {
+    Recycled* next;
+  };
+
+  struct Bin {
+    size_t bytes = 0;
+    size_t align = 0;
+    Recycled* head = nullptr;
+  };
+  static constexpr size_t kBins = 16;
+
+  Bin bins_[kBins];
+};
+
+// A monotonic arena: memory is carved out of large blocks by bumping a
+// pointer and is only given back all at once by Reset() or the destructor.
+// Recycle() hands a block back early so that a later request of the same
+// size and alignment gets it, which keeps the memory of short lived users
+// warm. An arena is not thread safe, use one per thread
+// (Arena::ThisThread()) or one per request served by a single thread at a
+// time. Everything drawn from it must be dead, or at least never touched
+// again, before Reset().
+class Arena {
+ public:
+  static constexpr size_t kDefaultBlockBytes = 64 * 1024;
+
+  explicit Arena(size_t block_bytes = kDefaultBlockBytes)
+      : block_bytes_(block_bytes) {}
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  ~Arena() { Release(nullptr); }
+
+  void* Allocate(size_t bytes, size_t align) {
+    if (void* recycled = recycled_.Pop(bytes, align)) {
+      return recycled;
+    }
+    uintptr_t cur = (reinterpret_cast<uintptr_t>(cur_) + align - 1) &
+                    ~uintptr_t(align - 1);
+    if (cur_ == nullptr || cur + bytes > reinterpret_cast<uintptr_t>(end_)) {
+      cur = reinterpret_cast<uintptr_t>(AddBlock(bytes + align));
+      cur = (cur + align - 1) & ~uintptr_t(align - 1);
+    }
+    cur_ = reinterpret_cast<char*>(cur + bytes);
+    used_ += bytes;
+    return reinterpret_cast<void*>(cur);
+  }
+
+  // p came from Allocate(bytes, align); a block the bins have no room for
+  // stays unused until Reset()
+  void Recycle(void* p, size_t bytes, size_t align) {
+    recycled_.Push(p, bytes, align);
+  }
+
+  // drops everything allocated so far, the first block is kept for reuse
+  void Reset() {
+    recycled_.Clear();
+    Block* first = blocks_;
+    while (first != nullptr && first->prev != nullptr) first = first->prev;
+    Release(first);
+    blocks_ = first;
+    cur_ = first != nullptr ? first->Data() : nullptr;
+    end_ = first != nullptr ? first->Data() + first->bytes : nullptr;
+    used_ = 0;
+  }
+
+  // bytes handed out since the last Reset()
+  size_t used() const { return used_; }
+
+  // the arena of the calling thread, released when the thread exits
+  static Arena& ThisThread() {
+    static thread_local Arena arena;
+    return arena;
+  }
+
+  // the arena of the innermost ArenaScope on this thread, or ThisThread()
+  static Arena& Current() {
+    Arena* scoped = ScopedArena();
+    return scoped != nullptr ? *scoped : ThisThread();
+  }
+
+ private:
+  friend class ArenaScope;
+
+  struct Block {
+    Block* prev;
+    size_t bytes;
+    char* Data() { return reinterpret_cast<char*>(this + 1); }
+  };
+
+  static Arena*& ScopedArena() {
+    static thread_local Arena* arena = nullptr;
+    return arena;
+  }
+
+  char* AddBlock(size_t min_bytes) {
+    size_t bytes = std::max(block_bytes_, min_bytes);
+    Block* block =
+        static_cast<Block*>(::operator new(sizeof(Block) + bytes));
+    block->prev = blocks_;
+    block->bytes = bytes;
+    blocks_ = block;
+    end_ = block->Data() + bytes;
+    return block->Data();
+  }
+
+  // frees every block newer than keep
+  void Release(Block* keep) {
+    while (blocks_ != keep) {
+      Block* block = blocks_;
+      blocks_ = block->prev;
+      ::operator delete(block);
+    }
+  }
+
+  size_t block_bytes_;
+  Block* blocks_ = nullptr;
+  char* cur_ = nullptr;
+  char* end_ = nullptr;
+  size_t used_ = 0;
+  RecycleBins recycled_;
+};
+
+// makes arena the one containers on this thread draw from while in scope,
+// e.g. a per-request arena that is reset once the request is done
+class ArenaScope {
+ public:
+  explicit ArenaScope(Arena& arena) : prev_(Arena::ScopedArena()) {
+    Arena::ScopedArena() = &arena;
+  }
+  ~ArenaScope() { Arena::ScopedArena() = prev_; }
+
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+
+ private:
+  Arena* prev_;
+};
+
+// Where the node pool of a fixed container takes its overflow slabs from
+// once the inline buffer is full, picked by the container's Slabs template
+// parameter. ArenaSlabs binds the pool to Arena::Current() when the
+// container is constructed, so the arena must outlive the container and
+// anything its nodes are moved or swapped into.
+struct HeapSlabs {
+  static Arena* SlabArena() { return nullptr; }
+};
+
+struct ArenaSlabs {
+  static Arena* SlabArena() { return &Arena::Current(); }
+};
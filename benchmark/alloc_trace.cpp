@@ -0,0 +1,79 @@
+#include "fixed_map.hpp"
+#include "fixed_vector.hpp"
+
+#include <iostream>
+#include "stop_watch.hpp"
+
+// Built twice: alloc_trace_bench as every user gets it, and
+// alloc_trace_on_bench with EXT_STL_ALLOC_TRACE. Without the macro the
+// allocators must carry no extra state and run at the same speed as
+// before, compare the two outputs to see what tracing costs.
+
+constexpr int kRunLoops = 100000;
+constexpr size_t kCapacity = 32;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+using Map = FixedMap<int, int, kCapacity>;
+using Vector = FixedVector<int, kCapacity>;
+
+#if !defined(EXT_STL_ALLOC_TRACE)
+using NodeMemory = Map::ReservsedMemoryType;
+static_assert(sizeof(NodeMemory) ==
+                  sizeof(NodeMemory::buffer_) +
+                      sizeof(NodeMemory::free_bits_) + 5 * sizeof(void*) +
+                      3 * sizeof(size_t),
+              "untraced node memory must not grow");
+static_assert(sizeof(Map::Allocator) == sizeof(void*),
+              "untraced allocator must stay one pointer");
+#endif
+
+void map_churn(size_t count) {
+  for (int i = 0; i < kRunLoops; ++i) {
+    Map con;
+    for (size_t j = 0; j < count; ++j) con[j] = j;
+    for (size_t j = 0; j < count; j += 2) con.erase(j);
+    for (size_t j = 0; j < count; j += 2) con[j] = j;
+    do_not_optmise(con.size());
+  }
+}
+
+void vector_push(size_t count) {
+  for (int i = 0; i < kRunLoops; ++i) {
+    Vector con;
+    for (size_t j = 0; j < count; ++j) con.push_back(j);
+    do_not_optmise(con.front());
+  }
+}
+
+void run(const char* title, void (*func)(size_t), size_t count) {
+  PrintLine pline;
+  std::cout << title << ", " << count << " elements" << std::endl;
+#if defined(EXT_STL_ALLOC_TRACE)
+  std::cout << "traced cost:" << std::endl;
+#else
+  std::cout << "untraced cost:" << std::endl;
+#endif
+  StopWatch sw;
+  func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+int main() {
+  std::cout << "total loops:" << kRunLoops << ", capacity " << kCapacity
+            << std::endl << std::endl;
+  run("map insert, erase and reinsert", map_churn, kCapacity);
+  run("map insert, erase and reinsert", map_churn, kCapacity * 4);
+  run("vector push", vector_push, kCapacity);
+  run("vector push", vector_push, kCapacity * 4);
+#if defined(EXT_STL_ALLOC_TRACE)
+  AllocTraceRegistry::Instance().Dump(std::cout);
+#endif
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include "arena.hpp"
+#include "fixed_map.hpp"
+#include "fixed_list.hpp"
+
+#include <map>
+#include <list>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include "stop_watch.hpp"
+
+constexpr int kRequests = 2000;
+constexpr int kContainersPerRequest = 50;
+constexpr size_t kCapacity = 8;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+// a request builds many short lived containers that spill past kCapacity
+template <typename Map, typename List>
+void ServeRequest(size_t entries) {
+  for (int i = 0; i < kContainersPerRequest; ++i) {
+    Map fmap;
+    List flist;
+    for (size_t j = 0; j < entries; ++j) {
+      fmap[j] = j;
+      flist.push_back(j);
+    }
+    do_not_optmise(fmap.size() + flist.size());
+  }
+}
+
+template <typename Map, typename List>
+void serve_plain(size_t entries) {
+  for (int i = 0; i < kRequests; ++i) ServeRequest<Map, List>(entries);
+}
+
+// every request draws from its own arena, dropped in one go at the end
+void serve_arena(size_t entries) {
+  using Map = FixedMap<size_t, size_t, kCapacity, std::less<size_t>,
+                       ArenaSlabs>;
+  using List = FixedList<size_t, kCapacity, ArenaSlabs>;
+  Arena arena;
+  for (int i = 0; i < kRequests; ++i) {
+    ArenaScope scope(arena);
+    ServeRequest<Map, List>(entries);
+    arena.Reset();
+  }
+}
+
+using BenchFunc = void (*)(size_t);
+
+void RunThreads(int threads, size_t entries, BenchFunc func) {
+  std::vector<std::thread> workers;
+  StopWatch sw;
+  for (int i = 0; i < threads; ++i) workers.emplace_back(func, entries);
+  for (auto& worker : workers) worker.join();
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+void compare(int threads, size_t entries) {
+  PrintLine pline;
+  std::cout << threads << " threads, " << entries
+            << " entries per container" << std::endl;
+
+  std::cout << "std::map and std::list cost:" << std::endl;
+  RunThreads(threads, entries,
+             serve_plain<std::map<size_t, size_t>, std::list<size_t>>);
+
+  std::cout << "inline with heap slabs cost:" << std::endl;
+  RunThreads(threads, entries,
+             serve_plain<FixedMap<size_t, size_t, kCapacity>,
+                         FixedList<size_t, kCapacity>>);
+
+  std::cout << "inline with arena slabs cost:" << std::endl;
+  RunThreads(threads, entries, serve_arena);
+}
+
+int main() {
+  std::cout << "requests per thread:" << kRequests << ", containers per "
+            << "request:" << kContainersPerRequest << ", inline capacity "
+            << kCapacity << std::endl << std::endl;
+  for (int threads : {1, 4, 8}) {
+    for (size_t entries : {size_t(8), size_t(64)}) {
+      compare(threads, entries);
+    }
+  }
+  return 0;
+}
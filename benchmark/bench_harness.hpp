@@ -0,0 +1,181 @@
+#pragma once
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include "stop_watch.hpp"
+
+// A small benchmark harness on top of StopWatch. Every case is run for a
+// number of repetitions, each one timing ops operations, and is reported
+// as mean ns/op, ops/sec and the p50/p99 of the per repetition ns/op.
+//
+//   --repetitions=N   repetitions per case, 20 by default
+//   --filter=TEXT     only run cases whose "name/container" contains TEXT
+//   --json[=FILE]     also write the results as JSON, to stdout without FILE
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct BenchResult {
+  std::string name;
+  std::string container;
+  size_t elements;
+  size_t ops;
+  int repetitions;
+  double mean_ns;
+  double min_ns;
+  double p50_ns;
+  double p99_ns;
+  double max_ns;
+  double ops_per_sec;
+};
+
+class BenchHarness {
+ public:
+  BenchHarness(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+      const char* arg = argv[i];
+      if (std::strncmp(arg, "--repetitions=", 14) == 0) {
+        repetitions_ = std::max(1, std::atoi(arg + 14));
+      } else if (std::strncmp(arg, "--filter=", 9) == 0) {
+        filter_ = arg + 9;
+      } else if (std::strcmp(arg, "--json") == 0) {
+        json_ = true;
+      } else if (std::strncmp(arg, "--json=", 7) == 0) {
+        json_ = true;
+        json_path_ = arg + 7;
+      } else {
+        std::cerr << "unknown argument: " << arg << std::endl;
+      }
+    }
+    // the table goes to stderr when the JSON takes stdout
+    table_ = json_ && json_path_.empty() ? &std::cerr : &std::cout;
+    PrintHeader();
+  }
+
+  // time func, which performs ops operations on containers of elements
+  template <typename Func>
+  void Run(const std::string& name, const std::string& container,
+           size_t elements, size_t ops, Func func) {
+    if (!filter_.empty() &&
+        (name + "/" + container).find(filter_) == std::string::npos) {
+      return;
+    }
+    func();  // warm up caches and the allocator
+    std::vector<double> samples;
+    samples.reserve(repetitions_);
+    for (int i = 0; i < repetitions_; ++i) {
+      StopWatch sw;
+      func();
+      sw.Stop();
+      double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      sw.GetElapse()).count();
+      samples.push_back(ns / ops);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    BenchResult result;
+    result.name = name;
+    result.container = container;
+    result.elements = elements;
+    result.ops = ops;
+    result.repetitions = repetitions_;
+    double sum = 0;
+    for (double sample : samples) sum += sample;
+    result.mean_ns = sum / samples.size();
+    result.min_ns = samples.front();
+    result.p50_ns = Percentile(samples, 50);
+    result.p99_ns = Percentile(samples, 99);
+    result.max_ns = samples.back();
+    result.ops_per_sec = result.mean_ns > 0 ? 1e9 / result.mean_ns : 0;
+    PrintRow(result);
+    results_.push_back(result);
+  }
+
+  const std::vector<BenchResult>& results() const { return results_; }
+
+  // write the JSON report if one was asked for
+  int Finish() {
+    if (!json_) {
+      return 0;
+    }
+    if (json_path_.empty()) {
+      PrintJson(std::cout);
+      return 0;
+    }
+    std::ofstream out(json_path_.c_str());
+    if (!out) {
+      std::cerr << "cannot open " << json_path_ << std::endl;
+      return 1;
+    }
+    PrintJson(out);
+    return 0;
+  }
+
+ private:
+  // nearest rank percentile of sorted samples
+  static double Percentile(const std::vector<double>& sorted, int percent) {
+    size_t rank = (sorted.size() * percent + 99) / 100;
+    return sorted[rank == 0 ? 0 : rank - 1];
+  }
+
+  void PrintHeader() {
+    char line[160];
+    std::snprintf(line, sizeof(line), "%-24s %-24s %8s %10s %14s %10s %10s",
+                  "benchmark", "container", "elements", "ns/op", "ops/sec",
+                  "p50", "p99");
+    *table_ << line << std::endl;
+  }
+
+  void PrintRow(const BenchResult& r) {
+    char line[160];
+    std::snprintf(line, sizeof(line),
+                  "%-24s %-24s %8zu %10.2f %14.0f %10.2f %10.2f",
+                  r.name.c_str(), r.container.c_str(), r.elements, r.mean_ns,
+                  r.ops_per_sec, r.p50_ns, r.p99_ns);
+    *table_ << line << std::endl;
+  }
+
+  static std::string Quote(const std::string& text) {
+    std::string quoted = "\"";
+    for (char ch : text) {
+      if (ch == '"' || ch == '\\') quoted += '\\';
+      quoted += ch;
+    }
+    return quoted + "\"";
+  }
+
+  void PrintJson(std::ostream& os) const {
+    os << "{\n  \"repetitions\": " << repetitions_ << ",\n"
+       << "  \"benchmarks\": [";
+    for (size_t i = 0; i < results_.size(); ++i) {
+      const BenchResult& r = results_[i];
+      os << (i == 0 ? "\n" : ",\n") << "    {"
+         << "\"name\": " << Quote(r.name)
+         << ", \"container\": " << Quote(r.container)
+         << ", \"elements\": " << r.elements
+         << ", \"ops\": " << r.ops
+         << ", \"ns_per_op\": " << r.mean_ns
+         << ", \"ops_per_sec\": " << r.ops_per_sec
+         << ", \"min_ns\": " << r.min_ns
+         << ", \"p50_ns\": " << r.p50_ns
+         << ", \"p99_ns\": " << r.p99_ns
+         << ", \"max_ns\": " << r.max_ns << "}";
+    }
+    os << "\n  ]\n}" << std::endl;
+  }
+
+  int repetitions_ = 20;
+  bool json_ = false;
+  std::string json_path_;
+  std::string filter_;
+  std::ostream* table_;
+  std::vector<BenchResult> results_;
+};
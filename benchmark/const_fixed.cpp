@@ -0,0 +1,167 @@
+#include "const_fixed.hpp"
+#include "fixed_flat_map.hpp"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include "stop_watch.hpp"
+
+constexpr size_t kEntries = 10000;
+constexpr size_t kProbes = 1000000;
+constexpr int kBuilds = 20;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+// entry i of the table, every third key so that lookups can miss
+struct TableEntry {
+  constexpr std::pair<uint32_t, uint32_t> operator()(size_t i) const {
+    return std::pair<uint32_t, uint32_t>(uint32_t(i * 3 + 1),
+                                         uint32_t(i * 2654435761u));
+  }
+};
+
+using ConstTable = ConstFixedFlatMap<uint32_t, uint32_t, kEntries>;
+using RuntimeTable = FixedFlatMap<uint32_t, uint32_t, kEntries>;
+
+// laid out by the compiler, nothing runs for it at startup
+constexpr ConstTable kConstTable =
+    ConstTable::Generate<kEntries>(sorted_unique, TableEntry());
+
+// how a static table is filled in today, one insert per entry in the
+// order the entries are listed
+void BuildRuntimeTable(RuntimeTable& table) {
+  TableEntry entry;
+  for (size_t i = 0; i < kEntries; ++i) {
+    size_t at = (i * 7919) % kEntries;
+    table.emplace(entry(at).first, entry(at).second);
+  }
+}
+
+// the same from entries that are already sorted
+void BuildSortedRuntimeTable(RuntimeTable& table) {
+  std::vector<std::pair<uint32_t, uint32_t>> entries;
+  entries.reserve(kEntries);
+  TableEntry entry;
+  for (size_t i = 0; i < kEntries; ++i) entries.push_back(entry(i));
+  table.insert(sorted_unique, entries.begin(), entries.end());
+}
+
+// the permissions of the mapping that holds address, from /proc/self/maps
+std::string MappingOf(const void* address) {
+  FILE* maps = fopen("/proc/self/maps", "r");
+  if (maps == nullptr) {
+    return "unknown";
+  }
+  uintptr_t at = reinterpret_cast<uintptr_t>(address);
+  char line[512];
+  std::string perms = "unknown";
+  while (fgets(line, sizeof(line), maps) != nullptr) {
+    unsigned long first, last;
+    char mode[5];
+    if (sscanf(line, "%lx-%lx %4s", &first, &last, mode) == 3 &&
+        first <= at && at < last) {
+      perms = mode;
+      break;
+    }
+  }
+  fclose(maps);
+  return perms;
+}
+
+template <typename Table>
+uint64_t lookups(const Table& table, const std::vector<uint32_t>& probes) {
+  uint64_t sum = 0;
+  for (uint32_t key : probes) {
+    auto it = table.find(key);
+    sum += it != table.end() ? it->second : 1;
+  }
+  return sum;
+}
+
+int main() {
+  std::cout << kEntries << " entries" << std::endl << std::endl;
+  {
+    PrintLine pline;
+    std::cout << "startup, building the table " << kBuilds << " times"
+              << std::endl;
+    std::cout << "fixed flat map, inserts cost:" << std::endl;
+    StopWatch sw;
+    for (int i = 0; i < kBuilds; ++i) {
+      std::unique_ptr<RuntimeTable> table(new RuntimeTable);
+      BuildRuntimeTable(*table);
+      size_t size = table->size();
+      do_not_optmise(size);
+    }
+    sw.Stop();
+    std::cout << sw << std::endl;
+
+    std::cout << "fixed flat map, sorted insert cost:" << std::endl;
+    sw.Restart();
+    for (int i = 0; i < kBuilds; ++i) {
+      std::unique_ptr<RuntimeTable> table(new RuntimeTable);
+      BuildSortedRuntimeTable(*table);
+      size_t size = table->size();
+      do_not_optmise(size);
+    }
+    sw.Stop();
+    std::cout << sw << std::endl;
+
+    // all there is to do is to fault the pages in on first use
+    std::cout << "const fixed flat map cost:" << std::endl;
+    sw.Restart();
+    uint64_t sum = 0;
+    for (size_t i = 0; i < kEntries; i += 512) {
+      sum += kConstTable.begin()[i].second;
+    }
+    do_not_optmise(sum);
+    sw.Stop();
+    std::cout << sw << std::endl;
+  }
+
+  std::unique_ptr<RuntimeTable> runtime_table(new RuntimeTable);
+  BuildRuntimeTable(*runtime_table);
+  {
+    PrintLine pline;
+    std::cout << "where the tables live" << std::endl;
+    std::cout << "fixed flat map: " << sizeof(RuntimeTable)
+              << " bytes, built into memory mapped "
+              << MappingOf(runtime_table.get()) << std::endl;
+    std::cout << "const fixed flat map: " << sizeof(ConstTable)
+              << " bytes, in the binary mapped " << MappingOf(&kConstTable)
+              << std::endl;
+  }
+
+  srand(42);
+  std::vector<uint32_t> probes(kProbes);
+  // about two thirds of the probes miss
+  for (uint32_t& probe : probes) probe = rand() % (kEntries * 3 + 3);
+  {
+    PrintLine pline;
+    std::cout << kProbes << " random lookups" << std::endl;
+    std::cout << "fixed flat map cost:" << std::endl;
+    StopWatch sw;
+    uint64_t runtime_sum = lookups(*runtime_table, probes);
+    sw.Stop();
+    std::cout << sw << std::endl;
+
+    std::cout << "const fixed flat map cost:" << std::endl;
+    sw.Restart();
+    uint64_t const_sum = lookups(kConstTable, probes);
+    sw.Stop();
+    std::cout << sw << std::endl;
+    if (runtime_sum != const_sum) {
+      std::cout << "the tables disagree" << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,162 @@
+#include "fixed_vector.hpp"
+#include "fixed_string.hpp"
+#include "fixed_list.hpp"
+#include "fixed_forward_list.hpp"
+#include "fixed_set.hpp"
+#include "fixed_map.hpp"
+
+#include <set>
+#include <map>
+#include <list>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <forward_list>
+#include "bench_harness.hpp"
+
+// Every fixed container next to its std counterpart, sweeping the element
+// count from inside the inline capacity to well beyond it.
+
+constexpr size_t kCapacity = 64;
+constexpr size_t kOpsPerRep = 1 << 15;
+const size_t kCounts[] = {16, kCapacity, kCapacity * 4, kCapacity * 16};
+
+// enough loops for every repetition to do about kOpsPerRep operations
+size_t Loops(size_t count) { return std::max<size_t>(1, kOpsPerRep / count); }
+
+template <typename V>
+struct MakeValue {
+  static V Make(size_t key) { return static_cast<V>(key); }
+};
+
+template <typename K, typename V>
+struct MakeValue<std::pair<const K, V>> {
+  static std::pair<const K, V> Make(size_t key) {
+    return std::pair<const K, V>(key, key);
+  }
+};
+
+inline size_t Weight(size_t value) { return value; }
+inline size_t Weight(int value) { return value; }
+inline size_t Weight(char value) { return value; }
+template <typename K, typename V>
+size_t Weight(const std::pair<K, V>& value) { return value.second; }
+
+// forward lists only grow at the front
+template <typename Container, typename V>
+auto Push(Container& con, const V& value, int)
+    -> decltype(con.push_back(value), void()) {
+  con.push_back(value);
+}
+
+template <typename Container, typename V>
+void Push(Container& con, const V& value, long) {
+  con.push_front(value);
+}
+
+template <typename Container>
+void Fill(Container& con, size_t count) {
+  using V = typename Container::value_type;
+  for (size_t j = 0; j < count; ++j) {
+    Push(con, MakeValue<V>::Make(j), 0);
+  }
+}
+
+template <typename Container>
+size_t Sum(const Container& con) {
+  size_t sum = 0;
+  for (const auto& value : con) sum += Weight(value);
+  return sum;
+}
+
+// random keys, half of which are inserted and probed for
+std::vector<size_t> MakeKeys(size_t count) {
+  std::vector<size_t> keys(count);
+  for (auto& key : keys) key = rand() % (count * 2);
+  return keys;
+}
+
+template <typename Container>
+void Sequence(BenchHarness& harness, const char* label, size_t count) {
+  size_t loops = Loops(count);
+  harness.Run("push", label, count, loops * count, [=] {
+    for (size_t i = 0; i < loops; ++i) {
+      Container con;
+      Fill(con, count);
+      do_not_optmise(*con.begin());
+    }
+  });
+
+  Container filled;
+  Fill(filled, count);
+  harness.Run("iterate", label, count, loops * count, [&] {
+    for (size_t i = 0; i < loops; ++i) {
+      do_not_optmise(*filled.begin());
+      size_t sum = Sum(filled);
+      do_not_optmise(sum);
+    }
+  });
+}
+
+template <typename Container>
+void Associative(BenchHarness& harness, const char* label, size_t count) {
+  using V = typename Container::value_type;
+  size_t loops = Loops(count);
+  std::vector<size_t> keys = MakeKeys(count);
+  harness.Run("insert", label, count, loops * count, [&] {
+    for (size_t i = 0; i < loops; ++i) {
+      Container con;
+      for (size_t key : keys) con.insert(MakeValue<V>::Make(key));
+      do_not_optmise(con.size());
+    }
+  });
+
+  Container filled;
+  for (size_t key : keys) filled.insert(MakeValue<V>::Make(key));
+  std::vector<size_t> probes = MakeKeys(count);
+  harness.Run("find", label, count, loops * count, [&] {
+    for (size_t i = 0; i < loops; ++i) {
+      size_t found = 0;
+      for (size_t key : probes) found += filled.find(key) != filled.end();
+      do_not_optmise(found);
+    }
+  });
+
+  harness.Run("iterate", label, count, loops * filled.size(), [&] {
+    for (size_t i = 0; i < loops; ++i) {
+      do_not_optmise(filled.size());
+      size_t sum = Sum(filled);
+      do_not_optmise(sum);
+    }
+  });
+}
+
+int main(int argc, char** argv) {
+  BenchHarness harness(argc, argv);
+  for (size_t count : kCounts) {
+    Sequence<std::vector<int>>(harness, "std::vector", count);
+    Sequence<FixedVector<int, kCapacity>>(harness, "FixedVector", count);
+    Sequence<std::string>(harness, "std::string", count);
+    Sequence<FixedString<kCapacity>>(harness, "FixedString", count);
+    Sequence<std::list<int>>(harness, "std::list", count);
+    Sequence<FixedList<int, kCapacity>>(harness, "FixedList", count);
+    Sequence<std::forward_list<int>>(harness, "std::forward_list", count);
+    Sequence<FixedForwardList<int, kCapacity>>(harness, "FixedForwardList",
+                                               count);
+  }
+  for (size_t count : kCounts) {
+    Associative<std::set<size_t>>(harness, "std::set", count);
+    Associative<FixedSet<size_t, kCapacity>>(harness, "FixedSet", count);
+    Associative<std::multiset<size_t>>(harness, "std::multiset", count);
+    Associative<FixedMultiSet<size_t, kCapacity>>(harness, "FixedMultiSet",
+                                                  count);
+    Associative<std::map<size_t, size_t>>(harness, "std::map", count);
+    Associative<FixedMap<size_t, size_t, kCapacity>>(harness, "FixedMap",
+                                                     count);
+    Associative<std::multimap<size_t, size_t>>(harness, "std::multimap",
+                                               count);
+    Associative<FixedMultiMap<size_t, size_t, kCapacity>>(
+        harness, "FixedMultiMap", count);
+  }
+  return harness.Finish();
+}
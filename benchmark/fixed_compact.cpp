@@ -0,0 +1,120 @@
+#include "fixed_map.hpp"
+#include "fixed_list.hpp"
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 100;
+constexpr size_t kCapacity = 1 << 17;
+constexpr size_t kEntries = 100000;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+using Map = FixedMap<size_t, size_t, kCapacity>;
+using List = FixedList<size_t, kCapacity>;
+
+// insert in random order, then replace random entries for several rounds
+template <typename Container>
+void ChurnMap(Container& con) {
+  std::vector<size_t> keys(kEntries);
+  for (size_t i = 0; i < kEntries; ++i) keys[i] = i;
+  std::random_shuffle(keys.begin(), keys.end());
+  for (size_t key : keys) con[key] = key;
+  size_t next_key = kEntries;
+  for (int round = 0; round < 4; ++round) {
+    std::random_shuffle(keys.begin(), keys.end());
+    for (size_t i = 0; i < kEntries / 2; ++i) {
+      con.erase(keys[i]);
+      keys[i] = next_key++;
+      con[keys[i]] = keys[i];
+    }
+  }
+}
+
+template <typename Container>
+void ChurnList(Container& con) {
+  for (size_t i = 0; i < kEntries; ++i) con.push_back(i);
+  for (int round = 0; round < 4; ++round) {
+    for (auto it = con.begin(); it != con.end();) {
+      if (rand() % 2 == 0) {
+        size_t value = *it;
+        it = con.erase(it);
+        con.insert(std::next(con.begin(), rand() % 64), value);
+      } else {
+        ++it;
+      }
+    }
+  }
+}
+
+template <typename Container>
+void walk(const Container& con) {
+  for (int i = 0; i < kRunLoops; ++i) {
+    size_t sum = 0;
+    for (const auto& v : con) sum += reinterpret_cast<uintptr_t>(&v);
+    do_not_optmise(sum);
+  }
+}
+
+template <typename Container>
+void compare(const char* title, Container& con, void (*compact)(Container&)) {
+  PrintLine pline;
+  std::cout << title << ", " << con.size() << " entries after churn"
+            << std::endl;
+
+  std::cout << "iterate scattered nodes cost:" << std::endl;
+  StopWatch sw;
+  walk(con);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "compact cost:" << std::endl;
+  sw.Restart();
+  compact(con);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "iterate compacted nodes cost:" << std::endl;
+  sw.Restart();
+  walk(con);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+template <typename Container>
+void Compact(Container& con) {
+  con.compact();
+}
+
+int main() {
+  std::cout << "total loops:" << kRunLoops << ", inline capacity "
+            << kCapacity << std::endl << std::endl;
+  std::unique_ptr<Map> fmap(new Map);
+  ChurnMap(*fmap);
+  compare("fixed map", *fmap, Compact<Map>);
+
+  std::unique_ptr<List> flist(new List);
+  ChurnList(*flist);
+  compare("fixed list", *flist, Compact<List>);
+
+  std::map<size_t, size_t> smap;
+  ChurnMap(smap);
+  PrintLine pline;
+  std::cout << "std::map, " << smap.size() << " entries after churn"
+            << std::endl << "iterate cost:" << std::endl;
+  StopWatch sw;
+  walk(smap);
+  sw.Stop();
+  std::cout << sw << std::endl;
+  return 0;
+}
@@ -0,0 +1,85 @@
+#include "fixed_map.hpp"
+
+#include <map>
+#include <iostream>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 10000;
+constexpr size_t kCapacity = 32;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+using Map = FixedMap<size_t, size_t, kCapacity>;
+
+template <typename Container>
+void Fill(Container& con, size_t count, size_t base) {
+  for (size_t i = 0; i < count; ++i) con[base + i] = i;
+}
+
+// a correct version of what assignment used to do: drop every node, then
+// insert the template's elements into fresh ones
+void refresh_rebuild(size_t count) {
+  Map tmpl;
+  Map conn;
+  Fill(tmpl, count, 0);
+  Fill(conn, count, count);
+  for (int i = 0; i < kRunLoops; ++i) {
+    conn.clear();
+    conn.insert(tmpl.begin(), tmpl.end());
+    do_not_optmise(conn.size());
+  }
+}
+
+template <typename Container>
+void refresh_assign(size_t count) {
+  Container tmpl;
+  Container conn;
+  Fill(tmpl, count, 0);
+  Fill(conn, count, count);
+  for (int i = 0; i < kRunLoops; ++i) {
+    conn = tmpl;
+    do_not_optmise(conn.size());
+  }
+}
+
+using BenchFunc = void (*)(size_t);
+
+void compare(size_t count, BenchFunc rebuild_func, BenchFunc assign_func,
+             BenchFunc std_func) {
+  PrintLine pline;
+  std::cout << "refresh a map from a template, " << count << " entries"
+            << std::endl;
+
+  std::cout << "clear and insert cost:" << std::endl;
+  StopWatch sw;
+  rebuild_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "node reusing assignment cost:" << std::endl;
+  sw.Restart();
+  assign_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "std::map assignment cost:" << std::endl;
+  sw.Restart();
+  std_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+int main() {
+  std::cout << "total loops:" << kRunLoops << ", inline capacity "
+            << kCapacity << std::endl << std::endl;
+  for (size_t count : {size_t(16), size_t(100), size_t(1000)}) {
+    compare(count, refresh_rebuild, refresh_assign<Map>,
+            refresh_assign<std::map<size_t, size_t>>);
+  }
+  return 0;
+}
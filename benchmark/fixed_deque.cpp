@@ -0,0 +1,117 @@
+#include "fixed_deque.hpp"
+#include "fixed_list.hpp"
+
+#include <deque>
+#include <vector>
+#include <iostream>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 20000;
+constexpr size_t kCapacity = 256;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+// a work item: a handle and a few words of arguments
+struct Job {
+  size_t id;
+  size_t args[3];
+};
+
+// a queue that keeps about depth jobs in flight: each round queues a few
+// and runs a few, the way a worker loop drains its inbox
+template <typename Queue>
+void fifo(size_t depth) {
+  Queue queue;
+  size_t next = 0;
+  for (size_t i = 0; i < depth; ++i) queue.push_back(Job{next++, {}});
+  for (int i = 0; i < kRunLoops; ++i) {
+    for (int j = 0; j < 8; ++j) queue.push_back(Job{next++, {}});
+    for (int j = 0; j < 8; ++j) {
+      do_not_optmise(queue.front().id);
+      queue.pop_front();
+    }
+  }
+}
+
+// the same with batches handed over as arrays
+template <typename Queue>
+void batch_single(size_t depth) {
+  Queue queue;
+  std::vector<Job> in(depth, Job{1, {}});
+  std::vector<Job> out(depth);
+  for (int i = 0; i < kRunLoops / 8; ++i) {
+    for (const Job& job : in) queue.push_back(job);
+    for (Job& job : out) {
+      job = queue.front();
+      queue.pop_front();
+    }
+    do_not_optmise(out.back().id);
+  }
+}
+
+void batch_bulk(size_t depth) {
+  FixedDeque<Job, kCapacity> queue;
+  std::vector<Job> in(depth, Job{1, {}});
+  std::vector<Job> out(depth);
+  for (int i = 0; i < kRunLoops / 8; ++i) {
+    queue.push_back(in.data(), in.data() + in.size());
+    queue.pop_front(out.size(), out.data());
+    do_not_optmise(out.back().id);
+  }
+}
+
+using BenchFunc = void (*)(size_t);
+
+void compare(const char* title, size_t depth, BenchFunc std_func,
+             BenchFunc list_func, BenchFunc deque_func,
+             BenchFunc bulk_func = nullptr) {
+  PrintLine pline;
+  std::cout << title << ", " << depth << " jobs" << std::endl;
+
+  std::cout << "std::deque cost:" << std::endl;
+  StopWatch sw;
+  std_func(depth);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed list cost:" << std::endl;
+  sw.Restart();
+  list_func(depth);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed deque cost:" << std::endl;
+  sw.Restart();
+  deque_func(depth);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  if (bulk_func != nullptr) {
+    std::cout << "fixed deque bulk cost:" << std::endl;
+    sw.Restart();
+    bulk_func(depth);
+    sw.Stop();
+    std::cout << sw << std::endl;
+  }
+}
+
+int main() {
+  using StdQueue = std::deque<Job>;
+  using ListQueue = FixedList<Job, kCapacity>;
+  using DequeQueue = FixedDeque<Job, kCapacity>;
+  std::cout << "total loops:" << kRunLoops << ", inline capacity "
+            << kCapacity << std::endl << std::endl;
+  // the last depth outgrows the inline ring
+  for (size_t depth : {size_t(16), size_t(200), size_t(1000)}) {
+    compare("queue 8, run 8", depth, fifo<StdQueue>, fifo<ListQueue>,
+            fifo<DequeQueue>);
+    compare("queue and run a batch", depth, batch_single<StdQueue>,
+            batch_single<ListQueue>, batch_single<DequeQueue>, batch_bulk);
+  }
+  return 0;
+}
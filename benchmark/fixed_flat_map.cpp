@@ -0,0 +1,156 @@
+#include "fixed_flat_map.hpp"
+#include "fixed_flat_set.hpp"
+#include "fixed_map.hpp"
+#include "fixed_set.hpp"
+
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 100000;
+constexpr size_t kCapacity = 64;
+constexpr size_t kEntries = 48;
+constexpr size_t kProbes = 96;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+using BenchFunc = void (*)();
+
+void compare(const char* title, const char* tree_name, BenchFunc tree_func,
+             const char* flat_name, BenchFunc flat_func) {
+  PrintLine pline;
+  std::cout << title << std::endl;
+
+  std::cout << tree_name << " cost:" << std::endl;
+  StopWatch sw;
+  tree_func();
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << flat_name << " cost:" << std::endl;
+  sw.Restart();
+  flat_func();
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+// keys are inserted out of order, as they would arrive from requests
+size_t KeyAt(size_t i) { return (i * 7) % kEntries; }
+
+// random lookups so the branch predictor can not learn the probe sequence,
+// about half of them miss
+std::vector<size_t> MakeProbes() {
+  srand(42);
+  std::vector<size_t> probes(kProbes * 64);
+  for (auto& probe : probes) probe = rand() % (kEntries * 2);
+  return probes;
+}
+
+static const std::vector<size_t> probes = MakeProbes();
+
+template <typename Map>
+void map_insert() {
+  for (int i = 0; i < kRunLoops; ++i) {
+    Map con;
+    for (size_t j = 0; j < kEntries; ++j) {
+      con[KeyAt(j)] = j;
+    }
+    do_not_optmise(con.size());
+  }
+}
+
+template <typename Map>
+void map_lookup() {
+  Map con;
+  for (size_t j = 0; j < kEntries; ++j) con[KeyAt(j)] = j;
+  for (int i = 0; i < kRunLoops; ++i) {
+    size_t sum = 0;
+    const size_t* probe = &probes[(i % 64) * kProbes];
+    for (size_t j = 0; j < kProbes; ++j) {
+      auto it = con.find(probe[j]);
+      if (it != con.end()) sum += it->second;
+    }
+    do_not_optmise(sum);
+  }
+}
+
+template <typename Map>
+void map_iterate() {
+  Map con;
+  for (size_t j = 0; j < kEntries; ++j) con[KeyAt(j)] = j;
+  for (int i = 0; i < kRunLoops; ++i) {
+    do_not_optmise(con.size());
+    size_t sum = 0;
+    for (auto kv : con) sum += kv.second;
+    do_not_optmise(sum);
+  }
+}
+
+template <typename Set>
+void set_insert() {
+  for (int i = 0; i < kRunLoops; ++i) {
+    Set con;
+    for (size_t j = 0; j < kEntries; ++j) {
+      con.insert(KeyAt(j));
+    }
+    do_not_optmise(con.size());
+  }
+}
+
+template <typename Set>
+void set_lookup() {
+  Set con;
+  for (size_t j = 0; j < kEntries; ++j) con.insert(KeyAt(j));
+  for (int i = 0; i < kRunLoops; ++i) {
+    size_t hits = 0;
+    const size_t* probe = &probes[(i % 64) * kProbes];
+    for (size_t j = 0; j < kProbes; ++j) {
+      hits += con.count(probe[j]);
+    }
+    do_not_optmise(hits);
+  }
+}
+
+template <typename Set>
+void set_iterate() {
+  Set con;
+  for (size_t j = 0; j < kEntries; ++j) con.insert(KeyAt(j));
+  for (int i = 0; i < kRunLoops; ++i) {
+    do_not_optmise(con.size());
+    size_t sum = 0;
+    for (size_t key : con) sum += key;
+    do_not_optmise(sum);
+  }
+}
+
+using TreeMap = FixedMap<size_t, size_t, kCapacity>;
+using FlatMap = FixedFlatMap<size_t, size_t, kCapacity>;
+using TreeSet = FixedSet<size_t, kCapacity>;
+using FlatSet = FixedFlatSet<size_t, kCapacity>;
+
+int main() {
+  std::cout << "total loops:" << kRunLoops << ", entries:" << kEntries
+            << std::endl
+            << std::endl;
+
+  compare("map insert", "fixed map", map_insert<TreeMap>, "fixed flat map",
+          map_insert<FlatMap>);
+  compare("map lookup, half hits", "fixed map", map_lookup<TreeMap>,
+          "fixed flat map", map_lookup<FlatMap>);
+  compare("map iteration", "fixed map", map_iterate<TreeMap>,
+          "fixed flat map", map_iterate<FlatMap>);
+  compare("set insert", "fixed set", set_insert<TreeSet>, "fixed flat set",
+          set_insert<FlatSet>);
+  compare("set lookup, half hits", "fixed set", set_lookup<TreeSet>,
+          "fixed flat set", set_lookup<FlatSet>);
+  compare("set iteration", "fixed set", set_iterate<TreeSet>,
+          "fixed flat set", set_iterate<FlatSet>);
+
+  return 0;
+}
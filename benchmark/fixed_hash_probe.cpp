@@ -0,0 +1,89 @@
+#include "fixed_hash_table.hpp"
+#include "fixed_unordered_set.hpp"
+
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <algorithm>
+#include "stop_watch.hpp"
+
+// Hit and miss lookup latency of the same table built over each control
+// byte group, at several load factors. The AVX2 group is only measured
+// when this file is built with -mavx2.
+
+constexpr int kRunLoops = 2000;
+constexpr size_t kCapacity = 448;  // 512 slots for every group width
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+template <typename Group>
+using Table = FixedHashTable<size_t, size_t, __set_key_of_value<size_t>,
+                             kCapacity, std::hash<size_t>,
+                             std::equal_to<size_t>, Group>;
+
+// present keys have the top bit clear and missing keys have it set, both
+// probed in a shuffled order
+std::vector<size_t> MakeKeys(size_t count, bool present) {
+  std::vector<size_t> keys(count);
+  for (auto& key : keys) {
+    key = static_cast<size_t>(rand()) << 16 ^ rand();
+    if (!present) key |= size_t(1) << 63;
+  }
+  return keys;
+}
+
+template <typename Group>
+void lookup(const std::vector<size_t>& stored,
+            const std::vector<size_t>& probes) {
+  Table<Group> table;
+  for (size_t key : stored) table.insert(key);
+  for (int i = 0; i < kRunLoops; ++i) {
+    size_t found = 0;
+    for (size_t key : probes) found += table.count(key);
+    do_not_optmise(found);
+  }
+}
+
+template <typename Group>
+void measure(const char* name, const std::vector<size_t>& stored,
+             const std::vector<size_t>& probes) {
+  std::cout << name << " cost:" << std::endl;
+  StopWatch sw;
+  lookup<Group>(stored, probes);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+void compare(const char* title, const std::vector<size_t>& stored,
+             const std::vector<size_t>& probes) {
+  PrintLine pline;
+  std::cout << title << std::endl;
+  measure<HashGroupScalar>("scalar group", stored, probes);
+#if defined(__SSE2__)
+  measure<HashGroupSse2>("sse2 group", stored, probes);
+#endif
+#if defined(__AVX2__)
+  measure<HashGroupAvx2>("avx2 group", stored, probes);
+#endif
+}
+
+int main() {
+  const size_t slots = Table<HashGroup>().bucket_count();
+  for (size_t eighths : {2, 4, 6, 7}) {
+    size_t count = slots * eighths / 8;
+    std::vector<size_t> stored = MakeKeys(count, true);
+    std::vector<size_t> hits = stored;
+    std::random_shuffle(hits.begin(), hits.end());
+    std::vector<size_t> misses = MakeKeys(count, false);
+
+    std::cout << "load factor " << eighths << "/8, " << count << " elements"
+              << std::endl;
+    compare("lookup hit", stored, hits);
+    compare("lookup miss", stored, misses);
+  }
+}
@@ -0,0 +1,78 @@
+#include "fixed_map.hpp"
+
+#include <map>
+#include <iostream>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 10000;
+constexpr size_t kCapacity = 32;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+// a FixedMap as it was before slab overflow: one malloc per extra node
+template <typename KeyType, typename ValueType, size_t Capacity>
+struct NodeMallocMap {
+  using Allocator =
+      StackAllocator<__std_tree_node_t<std::pair<const KeyType, ValueType>>,
+                     Capacity, false>;
+  using MapType = std::map<KeyType, ValueType, std::less<KeyType>, Allocator>;
+
+  NodeMallocMap() : map_(std::less<KeyType>(), Allocator(&stack_data_)) {}
+  ~NodeMallocMap() { map_.clear(); }
+
+  ValueType& operator[](const KeyType& key) { return map_[key]; }
+  size_t size() const { return map_.size(); }
+
+  typename Allocator::ReservedMemory stack_data_;
+  MapType map_;
+};
+
+template <typename Container>
+void insert_elements(size_t count) {
+  for (int i = 0; i < kRunLoops; ++i) {
+    Container con;
+    for (size_t j = 0; j < count; ++j) {
+      con[j] = j;
+    }
+    do_not_optmise(con.size());
+  }
+}
+
+void bench_insert(size_t times) {
+  PrintLine pline;
+  size_t count = kCapacity * times;
+  std::cout << "insert " << count << " elements, " << times
+            << "x of capacity " << kCapacity << std::endl;
+
+  std::cout << "std::map cost:" << std::endl;
+  StopWatch sw;
+  insert_elements<std::map<size_t, size_t>>(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed map with per node malloc cost:" << std::endl;
+  sw.Restart();
+  insert_elements<NodeMallocMap<size_t, size_t, kCapacity>>(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed map with slab overflow cost:" << std::endl;
+  sw.Restart();
+  insert_elements<FixedMap<size_t, size_t, kCapacity>>(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+int main() {
+  std::cout << "total loops:" << kRunLoops << std::endl;
+  bench_insert(2);
+  bench_insert(10);
+  bench_insert(100);
+
+  return 0;
+}
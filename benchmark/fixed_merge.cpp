@@ -0,0 +1,114 @@
+#include "fixed_forward_list.hpp"
+
+#include <vector>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <forward_list>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 200;
+constexpr size_t kStreams = 8;
+constexpr size_t kCapacity = 64;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+struct Event {
+  size_t time;
+  size_t payload[3];
+  bool operator<(const Event& other) const { return time < other.time; }
+};
+
+using Stream = FixedForwardList<Event, kCapacity>;
+
+// kStreams sorted streams with interleaved times
+template <typename List>
+std::vector<List> MakeStreams(size_t count) {
+  std::vector<List> streams(kStreams);
+  for (size_t s = 0; s < kStreams; ++s) {
+    auto pos = streams[s].before_begin();
+    for (size_t i = 0; i < count; ++i) {
+      pos = streams[s].insert_after(pos, Event{i * kStreams + s, {}});
+    }
+  }
+  return streams;
+}
+
+// what merging two fixed lists took before: copy both into a new one
+void CopyMerge(Stream& lhs, Stream& rhs) {
+  Stream merged;
+  auto pos = merged.before_begin();
+  auto lit = lhs.begin();
+  auto rit = rhs.begin();
+  while (lit != lhs.end() && rit != rhs.end()) {
+    pos = merged.insert_after(pos, *rit < *lit ? *rit++ : *lit++);
+  }
+  for (; lit != lhs.end(); ++lit) pos = merged.insert_after(pos, *lit);
+  for (; rit != rhs.end(); ++rit) pos = merged.insert_after(pos, *rit);
+  rhs.clear();
+  lhs.swap(merged);
+}
+
+template <typename List>
+void MemberMerge(List& lhs, List& rhs) {
+  lhs.merge(rhs);
+}
+
+// k-way merge as a tournament of pairwise merges into the first stream
+template <typename List, void (*Merge)(List&, List&)>
+void merge_streams(size_t count) {
+  for (int i = 0; i < kRunLoops; ++i) {
+    std::vector<List> streams = MakeStreams<List>(count);
+    for (size_t step = 1; step < kStreams; step *= 2) {
+      for (size_t s = 0; s + step < kStreams; s += 2 * step) {
+        Merge(streams[s], streams[s + step]);
+      }
+    }
+    do_not_optmise(streams[0].front().time);
+  }
+}
+
+using BenchFunc = void (*)(size_t);
+
+void compare(size_t count, BenchFunc std_func, BenchFunc copy_func,
+             BenchFunc merge_func) {
+  PrintLine pline;
+  std::cout << "merge " << kStreams << " sorted streams of " << count
+            << " events" << std::endl;
+
+  std::cout << "std::forward_list merge cost:" << std::endl;
+  StopWatch sw;
+  std_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed list copy merge cost:" << std::endl;
+  sw.Restart();
+  copy_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed list merge cost:" << std::endl;
+  sw.Restart();
+  merge_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+int main() {
+  using StdStream = std::forward_list<Event>;
+  std::cout << "total loops:" << kRunLoops << ", inline capacity "
+            << kCapacity << ", building the streams included" << std::endl
+            << std::endl;
+  for (size_t count : {size_t(8), size_t(64), size_t(4096)}) {
+    compare(count, merge_streams<StdStream, MemberMerge<StdStream>>,
+            merge_streams<Stream, CopyMerge>,
+            merge_streams<Stream, MemberMerge<Stream>>);
+  }
+  return 0;
+}
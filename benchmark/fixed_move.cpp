@@ -0,0 +1,110 @@
+#include "fixed_map.hpp"
+#include "fixed_set.hpp"
+
+#include <iostream>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 1000;
+constexpr size_t kCapacity = 32;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+// what a move used to do: reinsert every element, then clear the source
+template <typename Container>
+void ReinsertMove(Container& dst, Container& src) {
+  dst.clear();
+  dst.insert(src.begin(), src.end());
+  src.clear();
+}
+
+using Map = FixedMap<size_t, size_t, kCapacity>;
+using Set = FixedSet<size_t, kCapacity>;
+
+void Fill(Map& con, size_t count) {
+  for (size_t i = 0; i < count; ++i) con[i] = i;
+}
+
+void Fill(Set& con, size_t count) {
+  for (size_t i = 0; i < count; ++i) con.insert(i);
+}
+
+// the contents bounce between two containers, two moves per loop
+template <typename Container>
+void move_reinsert(size_t count) {
+  Container lhs;
+  Container rhs;
+  Fill(lhs, count);
+  for (int i = 0; i < kRunLoops; ++i) {
+    ReinsertMove(rhs, lhs);
+    do_not_optmise(rhs.size());
+    ReinsertMove(lhs, rhs);
+    do_not_optmise(lhs.size());
+  }
+}
+
+template <typename Container>
+void move_steal(size_t count) {
+  Container lhs;
+  Container rhs;
+  Fill(lhs, count);
+  for (int i = 0; i < kRunLoops; ++i) {
+    rhs = std::move(lhs);
+    do_not_optmise(rhs.size());
+    lhs = std::move(rhs);
+    do_not_optmise(lhs.size());
+  }
+}
+
+template <typename Container>
+void move_construct(size_t count) {
+  Container src;
+  Fill(src, count);
+  for (int i = 0; i < kRunLoops; ++i) {
+    Container dst(std::move(src));
+    do_not_optmise(dst.size());
+    src = std::move(dst);
+  }
+}
+
+using BenchFunc = void (*)(size_t);
+
+void compare(const char* title, size_t count, BenchFunc reinsert_func,
+             BenchFunc steal_func, BenchFunc construct_func) {
+  PrintLine pline;
+  std::cout << title << ", " << count << " entries" << std::endl;
+
+  std::cout << "reinsert and clear cost:" << std::endl;
+  StopWatch sw;
+  reinsert_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "move assignment cost:" << std::endl;
+  sw.Restart();
+  steal_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "move construction and back cost:" << std::endl;
+  sw.Restart();
+  construct_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+int main() {
+  std::cout << "total loops:" << kRunLoops << ", inline capacity "
+            << kCapacity << std::endl << std::endl;
+  for (size_t count : {size_t(10), size_t(100), size_t(10000)}) {
+    compare("move fixed map", count, move_reinsert<Map>, move_steal<Map>,
+            move_construct<Map>);
+    compare("move fixed set", count, move_reinsert<Set>, move_steal<Set>,
+            move_construct<Set>);
+  }
+  return 0;
+}
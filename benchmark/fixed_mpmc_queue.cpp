@@ -0,0 +1,237 @@
+#include "fixed_mpmc_queue.hpp"
+#include "fixed_work_stealing_deque.hpp"
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+#include "stop_watch.hpp"
+
+constexpr size_t kItems = 400000;
+constexpr size_t kTasks = 200000;
+constexpr size_t kCapacity = 1024;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+// a failed try gives the other threads the core, the machine may have
+// fewer cores than threads
+inline void Backoff() { std::this_thread::yield(); }
+
+inline uint64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// the thread pool's queues before: a std::deque under a lock, bounded
+// like the lock free ones so that producers cannot run ahead
+template <typename T>
+class MutexDeque {
+ public:
+  bool try_push(const T& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (deque_.size() == kCapacity) {
+      return false;
+    }
+    deque_.push_back(value);
+    return true;
+  }
+
+  bool try_pop(T& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (deque_.empty()) {
+      return false;
+    }
+    value = deque_.front();
+    deque_.pop_front();
+    return true;
+  }
+
+  // work stealing on the same deque: the owner at the back, thieves at
+  // the front
+  bool push(const T& value) { return try_push(value); }
+
+  bool pop(T& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (deque_.empty()) {
+      return false;
+    }
+    value = deque_.back();
+    deque_.pop_back();
+    return true;
+  }
+
+  bool steal(T& value) { return try_pop(value); }
+
+ private:
+  std::mutex mutex_;
+  std::deque<T> deque_;
+};
+
+struct Item {
+  uint64_t pushed_ns;
+  uint64_t payload;
+};
+
+struct Result {
+  double seconds;
+  std::vector<uint64_t> latencies;
+};
+
+// producers and consumers threads each, kItems in all; every item
+// records how long it sat in the queue
+template <typename Queue>
+Result producers_consumers(size_t threads) {
+  Queue queue;
+  std::atomic<size_t> popped{0};
+  std::vector<std::vector<uint64_t>> latencies(threads);
+  std::vector<std::thread> workers;
+  StopWatch sw;
+  for (size_t p = 0; p < threads; ++p) {
+    workers.emplace_back([&queue, threads, p] {
+      size_t count = kItems / threads + (p < kItems % threads);
+      for (size_t i = 0; i < count;) {
+        if (queue.try_push(Item{NowNs(), i})) {
+          ++i;
+        } else {
+          Backoff();
+        }
+      }
+    });
+  }
+  for (size_t c = 0; c < threads; ++c) {
+    workers.emplace_back([&queue, &popped, &latencies, c] {
+      std::vector<uint64_t>& mine = latencies[c];
+      mine.reserve(kItems);
+      Item item;
+      while (popped.load(std::memory_order_relaxed) < kItems) {
+        if (queue.try_pop(item)) {
+          mine.push_back(NowNs() - item.pushed_ns);
+          popped.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          Backoff();
+        }
+      }
+    });
+  }
+  for (std::thread& worker : workers) worker.join();
+  sw.Stop();
+
+  Result result;
+  result.seconds = std::chrono::duration<double>(sw.GetElapse()).count();
+  for (std::vector<uint64_t>& mine : latencies) {
+    result.latencies.insert(result.latencies.end(), mine.begin(), mine.end());
+  }
+  return result;
+}
+
+uint64_t Percentile(std::vector<uint64_t>& values, double fraction) {
+  auto nth = values.begin() + size_t(fraction * (values.size() - 1));
+  std::nth_element(values.begin(), nth, values.end());
+  return *nth;
+}
+
+void PrintResult(Result result) {
+  std::cout << size_t(kItems / result.seconds / 1000) << "k items/s, p50 "
+            << Percentile(result.latencies, 0.5) << "ns, p99 "
+            << Percentile(result.latencies, 0.99) << "ns, p99.9 "
+            << Percentile(result.latencies, 0.999) << "ns" << std::endl;
+}
+
+// a task is a few rounds of mixing, the pool spends its time between
+// tasks in the deques
+inline uint64_t RunTask(size_t task) {
+  uint64_t h = task;
+  for (int i = 0; i < 16; ++i) h = (h ^ (h >> 29)) * 0xbf58476d1ce4e5b9ull;
+  return h;
+}
+
+// worker 0 spawns every task and runs its own newest ones when its deque
+// is full, the others only have what they steal from it
+template <typename Deque>
+double work_stealing(size_t threads) {
+  Deque deque;
+  std::atomic<size_t> done{0};
+  std::vector<std::thread> thieves;
+  StopWatch sw;
+  for (size_t t = 1; t < threads; ++t) {
+    thieves.emplace_back([&deque, &done] {
+      size_t task;
+      uint64_t sum = 0;
+      while (done.load(std::memory_order_relaxed) < kTasks) {
+        if (deque.steal(task)) {
+          sum += RunTask(task);
+          done.fetch_add(1, std::memory_order_relaxed);
+        } else {
+          Backoff();
+        }
+      }
+      do_not_optmise(sum);
+    });
+  }
+  size_t task;
+  uint64_t sum = 0;
+  for (size_t i = 0; i < kTasks; ++i) {
+    while (!deque.push(i)) {
+      if (deque.pop(task)) {
+        sum += RunTask(task);
+        done.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+  while (deque.pop(task)) {
+    sum += RunTask(task);
+    done.fetch_add(1, std::memory_order_relaxed);
+  }
+  while (done.load() < kTasks) Backoff();
+  for (std::thread& thief : thieves) thief.join();
+  sw.Stop();
+  do_not_optmise(sum);
+  return std::chrono::duration<double>(sw.GetElapse()).count();
+}
+
+// 1, 2, 4, ... threads up to the core count, and the core count itself
+std::vector<size_t> ThreadCounts() {
+  size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<size_t> counts;
+  for (size_t n = 1; n < cores; n *= 2) counts.push_back(n);
+  counts.push_back(cores);
+  return counts;
+}
+
+int main() {
+  std::cout << "queues of " << kCapacity << ", "
+            << std::thread::hardware_concurrency() << " hardware threads"
+            << std::endl << std::endl;
+  for (size_t threads : ThreadCounts()) {
+    PrintLine pline;
+    std::cout << threads << " producers and " << threads << " consumers, "
+              << kItems << " items" << std::endl;
+    std::cout << "mutex and std::deque cost:" << std::endl;
+    PrintResult(producers_consumers<MutexDeque<Item>>(threads));
+    std::cout << "mpmc queue cost:" << std::endl;
+    PrintResult(producers_consumers<FixedMpmcQueue<Item, kCapacity>>(threads));
+  }
+  for (size_t threads : ThreadCounts()) {
+    PrintLine pline;
+    std::cout << "work stealing, " << threads << " workers, " << kTasks
+              << " tasks" << std::endl;
+    std::cout << "mutex and std::deque cost:" << std::endl;
+    double seconds = work_stealing<MutexDeque<size_t>>(threads);
+    std::cout << size_t(kTasks / seconds / 1000) << "k tasks/s" << std::endl;
+    std::cout << "work stealing deque cost:" << std::endl;
+    seconds = work_stealing<FixedWorkStealingDeque<size_t, kCapacity>>(threads);
+    std::cout << size_t(kTasks / seconds / 1000) << "k tasks/s" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,131 @@
+#include "fixed_pmr.hpp"
+#include "fixed_map.hpp"
+
+#include <map>
+#include <vector>
+#include <iostream>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 20000;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+#if defined(EXT_STL_HAS_PMR)
+template <size_t Count>
+using NodeBytes = std::integral_constant<
+    size_t, Count * sizeof(std::_Rb_tree_node<std::pair<const size_t,
+                                                        size_t>>)>;
+
+// a short lived map per loop: fill it, look everything up, drop it
+template <size_t Count>
+void scratch_monotonic() {
+  for (int i = 0; i < kRunLoops; ++i) {
+    alignas(std::max_align_t) unsigned char buffer[NodeBytes<Count>::value];
+    std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer));
+    std::pmr::map<size_t, size_t> map(&resource);
+    for (size_t j = 0; j < Count; ++j) map[j] = j;
+    for (size_t j = 0; j < Count; ++j) do_not_optmise(map[j]);
+  }
+}
+
+template <typename Map, size_t Count>
+void scratch() {
+  for (int i = 0; i < kRunLoops; ++i) {
+    Map map;
+    for (size_t j = 0; j < Count; ++j) map[j] = j;
+    for (size_t j = 0; j < Count; ++j) do_not_optmise(map[j]);
+  }
+}
+
+// a long lived map of Count entries that keeps replacing them; monotonic
+// memory is never reused, so it has to keep drawing from upstream
+template <size_t Count>
+void churn_monotonic() {
+  alignas(std::max_align_t) unsigned char buffer[NodeBytes<Count>::value];
+  std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer));
+  std::pmr::map<size_t, size_t> map(&resource);
+  for (size_t j = 0; j < Count; ++j) map[j] = j;
+  for (int i = 0; i < kRunLoops; ++i) {
+    for (size_t j = 0; j < Count; ++j) {
+      map.erase(j);
+      map[j] = i;
+    }
+    do_not_optmise(map.size());
+  }
+}
+
+template <typename Map, size_t Count>
+void churn() {
+  Map map;
+  for (size_t j = 0; j < Count; ++j) map[j] = j;
+  for (int i = 0; i < kRunLoops; ++i) {
+    for (size_t j = 0; j < Count; ++j) {
+      map.erase(j);
+      map[j] = i;
+    }
+    do_not_optmise(map.size());
+  }
+}
+
+using BenchFunc = void (*)();
+
+void compare(const char* title, size_t count, BenchFunc std_func,
+             BenchFunc monotonic_func, BenchFunc fixed_pmr_func,
+             BenchFunc fixed_func) {
+  PrintLine pline;
+  std::cout << title << ", " << count << " entries" << std::endl;
+
+  std::cout << "std::map cost:" << std::endl;
+  StopWatch sw;
+  std_func();
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "pmr::map on monotonic_buffer_resource cost:" << std::endl;
+  sw.Restart();
+  monotonic_func();
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "pmr::FixedMap cost:" << std::endl;
+  sw.Restart();
+  fixed_pmr_func();
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "FixedMap cost:" << std::endl;
+  sw.Restart();
+  fixed_func();
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+template <size_t Count>
+void compare_all() {
+  using StdMap = std::map<size_t, size_t>;
+  using PmrMap = pmr::FixedMap<size_t, size_t, Count>;
+  using Map = FixedMap<size_t, size_t, Count>;
+  compare("scratch map per loop", Count, scratch<StdMap, Count>,
+          scratch_monotonic<Count>, scratch<PmrMap, Count>,
+          scratch<Map, Count>);
+  compare("replace every entry of a map", Count, churn<StdMap, Count>,
+          churn_monotonic<Count>, churn<PmrMap, Count>, churn<Map, Count>);
+}
+#endif
+
+int main() {
+#if defined(EXT_STL_HAS_PMR)
+  std::cout << "total loops:" << kRunLoops << ", inline capacity is the "
+            << "entry count" << std::endl << std::endl;
+  compare_all<16>();
+  compare_all<256>();
+#else
+  std::cout << "std::pmr is not available" << std::endl;
+#endif
+  return 0;
+}
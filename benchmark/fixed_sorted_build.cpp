@@ -0,0 +1,69 @@
+#include "fixed_map.hpp"
+
+#include <map>
+#include <vector>
+#include <iostream>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 100;
+constexpr size_t kCapacity = 1024;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+using Map = FixedMap<size_t, size_t, kCapacity>;
+using Snapshot = std::vector<std::pair<size_t, size_t>>;
+
+Snapshot MakeSnapshot(size_t count) {
+  Snapshot snapshot;
+  for (size_t i = 0; i < count; ++i) snapshot.emplace_back(i * 2, i);
+  return snapshot;
+}
+
+void build_insert(const Snapshot& snapshot) {
+  for (int i = 0; i < kRunLoops; ++i) {
+    Map fmap(snapshot.begin(), snapshot.end());
+    do_not_optmise(fmap.size());
+  }
+}
+
+void build_sorted(const Snapshot& snapshot) {
+  for (int i = 0; i < kRunLoops; ++i) {
+    Map fmap(sorted_unique, snapshot.begin(), snapshot.end());
+    do_not_optmise(fmap.size());
+  }
+}
+
+using BenchFunc = void (*)(const Snapshot&);
+
+void compare(const char* title, const Snapshot& snapshot,
+             BenchFunc insert_func, BenchFunc sorted_func) {
+  PrintLine pline;
+  std::cout << title << ", " << snapshot.size() << " entries" << std::endl;
+
+  std::cout << "range insert cost:" << std::endl;
+  StopWatch sw;
+  insert_func(snapshot);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "sorted_unique cost:" << std::endl;
+  sw.Restart();
+  sorted_func(snapshot);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+int main() {
+  std::cout << "total loops:" << kRunLoops << ", inline capacity "
+            << kCapacity << std::endl << std::endl;
+  for (size_t count : {size_t(100), size_t(1000), size_t(100000)}) {
+    Snapshot snapshot = MakeSnapshot(count);
+    compare("build fixed map", snapshot, build_insert, build_sorted);
+  }
+  return 0;
+}
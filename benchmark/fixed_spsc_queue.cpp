@@ -0,0 +1,182 @@
+#include "fixed_spsc_queue.hpp"
+#include "fixed_list.hpp"
+
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <iostream>
+#include "stop_watch.hpp"
+
+constexpr size_t kItems = 2000000;
+constexpr size_t kRoundTrips = 100000;
+constexpr size_t kCapacity = 1024;
+constexpr size_t kBatch = 32;
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+// a failed try gives the other thread the core, this may run on one cpu
+inline void Backoff() { std::this_thread::yield(); }
+
+// what the I/O thread and the worker used before: a FixedList under a lock
+template <typename T, size_t Capacity>
+class MutexQueue {
+ public:
+  bool try_push(const T& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (list_.size() == Capacity) {
+      return false;
+    }
+    list_.push_back(value);
+    return true;
+  }
+
+  bool try_pop(T& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (list_.empty()) {
+      return false;
+    }
+    value = list_.front();
+    list_.pop_front();
+    return true;
+  }
+
+  size_t try_push_n(const T* first, size_t n) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    n = std::min(n, Capacity - list_.size());
+    for (size_t i = 0; i < n; ++i) list_.push_back(first[i]);
+    return n;
+  }
+
+  size_t try_pop_n(T* out, size_t n) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    n = std::min(n, list_.size());
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = list_.front();
+      list_.pop_front();
+    }
+    return n;
+  }
+
+ private:
+  std::mutex mutex_;
+  FixedList<T, Capacity> list_;
+};
+
+using SpscQueue = FixedSpscQueue<size_t, kCapacity>;
+using LockedQueue = MutexQueue<size_t, kCapacity>;
+
+// one item at a time from the producer thread to this one
+template <typename Queue>
+void throughput() {
+  Queue queue;
+  std::thread producer([&queue] {
+    for (size_t i = 0; i < kItems;) {
+      if (queue.try_push(i)) {
+        ++i;
+      } else {
+        Backoff();
+      }
+    }
+  });
+  size_t sum = 0;
+  size_t value;
+  for (size_t i = 0; i < kItems;) {
+    if (queue.try_pop(value)) {
+      sum += value;
+      ++i;
+    } else {
+      Backoff();
+    }
+  }
+  producer.join();
+  if (sum != kItems * (kItems - 1) / 2) std::cout << "lost items" << std::endl;
+}
+
+template <typename Queue>
+void batch_throughput() {
+  Queue queue;
+  std::thread producer([&queue] {
+    size_t batch[kBatch];
+    for (size_t i = 0; i < kItems;) {
+      size_t n = std::min(kBatch, kItems - i);
+      for (size_t j = 0; j < n; ++j) batch[j] = i + j;
+      size_t pushed = 0;
+      while (pushed < n) {
+        size_t count = queue.try_push_n(batch + pushed, n - pushed);
+        if (count == 0) Backoff();
+        pushed += count;
+      }
+      i += n;
+    }
+  });
+  size_t sum = 0;
+  size_t out[kBatch];
+  for (size_t i = 0; i < kItems;) {
+    size_t n = queue.try_pop_n(out, kBatch);
+    if (n == 0) Backoff();
+    for (size_t j = 0; j < n; ++j) sum += out[j];
+    i += n;
+  }
+  producer.join();
+  if (sum != kItems * (kItems - 1) / 2) std::cout << "lost items" << std::endl;
+}
+
+// a request and its reply through a pair of queues, one in flight at a
+// time, so each trip is two hand-overs
+template <typename Queue>
+void round_trips() {
+  Queue requests;
+  Queue replies;
+  std::thread echo([&requests, &replies] {
+    size_t value;
+    for (size_t i = 0; i < kRoundTrips; ++i) {
+      while (!requests.try_pop(value)) Backoff();
+      while (!replies.try_push(value)) Backoff();
+    }
+  });
+  size_t value;
+  for (size_t i = 0; i < kRoundTrips; ++i) {
+    while (!requests.try_push(i)) Backoff();
+    while (!replies.try_pop(value)) Backoff();
+  }
+  echo.join();
+}
+
+using BenchFunc = void (*)();
+
+void compare(const char* title, size_t count, BenchFunc mutex_func,
+             BenchFunc spsc_func) {
+  PrintLine pline;
+  std::cout << title << std::endl;
+
+  std::cout << "mutex and fixed list cost:" << std::endl;
+  StopWatch sw;
+  mutex_func();
+  sw.Stop();
+  std::cout << sw << ", "
+            << std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   sw.GetElapse()).count() / count
+            << "ns each" << std::endl;
+
+  std::cout << "spsc queue cost:" << std::endl;
+  sw.Restart();
+  spsc_func();
+  sw.Stop();
+  std::cout << sw << ", "
+            << std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   sw.GetElapse()).count() / count
+            << "ns each" << std::endl;
+}
+
+int main() {
+  std::cout << "ring of " << kCapacity << " size_t, "
+            << std::thread::hardware_concurrency() << " hardware threads"
+            << std::endl << std::endl;
+  compare("throughput, 2M items one at a time", kItems,
+          throughput<LockedQueue>, throughput<SpscQueue>);
+  compare("throughput, 2M items in batches of 32", kItems,
+          batch_throughput<LockedQueue>, batch_throughput<SpscQueue>);
+  compare("latency, 100k round trips", kRoundTrips,
+          round_trips<LockedQueue>, round_trips<SpscQueue>);
+  return 0;
+}
@@ -0,0 +1,151 @@
+#include "fixed_string.hpp"
+#include "stack_allocator_vec.hpp"
+
+#include <string>
+#include <iostream>
+#include <functional>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 1000000;
+constexpr size_t kCapacity = 32;
+constexpr size_t kShortSize = 15;
+constexpr size_t kLongSize = 100;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+// the previous FixedString: std::basic_string over StackAllocatorVector,
+// with the buffer reserved up front
+class LegacyString
+    : public std::basic_string<char, std::char_traits<char>,
+                               StackAllocatorVector<char, kCapacity>> {
+ public:
+  using Allocator = StackAllocatorVector<char, kCapacity>;
+  using BaseType =
+      std::basic_string<char, std::char_traits<char>, Allocator>;
+
+  LegacyString() : BaseType(Allocator(&stack_data_)) { reserve(kCapacity); }
+  LegacyString(const char* s) : LegacyString() { assign(s); }
+  LegacyString(const LegacyString& other) : LegacyString() {
+    assign(other.begin(), other.end());
+  }
+  LegacyString& operator=(const LegacyString& other) {
+    assign(other.begin(), other.end());
+    return *this;
+  }
+
+ private:
+  Allocator::ReservedMemory stack_data_;
+};
+
+using FixedStr = FixedString<kCapacity>;
+
+size_t Hash(const std::string& s) { return std::hash<std::string>()(s); }
+size_t Hash(const FixedStr& s) { return std::hash<FixedStr>()(s); }
+// what std::hash<std::string> does underneath, there is no hash for strings
+// with another allocator
+size_t Hash(const LegacyString& s) {
+  return std::_Hash_impl::hash(s.data(), s.size());
+}
+
+template <typename String>
+void append_chars(size_t count) {
+  for (int i = 0; i < kRunLoops; ++i) {
+    String str;
+    for (size_t j = 0; j < count; ++j) {
+      str += static_cast<char>('a' + j % 26);
+    }
+    do_not_optmise(str[0]);
+  }
+}
+
+template <typename String>
+String MakeString(size_t count, char last) {
+  String str;
+  for (size_t j = 0; j + 1 < count; ++j) str += 'x';
+  str += last;
+  return str;
+}
+
+template <typename String>
+void compare_strings(size_t count) {
+  String lhs = MakeString<String>(count, 'a');
+  String rhs = MakeString<String>(count, 'b');
+  int result = 0;
+  for (int i = 0; i < kRunLoops; ++i) {
+    do_not_optmise(lhs[0]);
+    result += lhs.compare(rhs) < 0;
+  }
+  do_not_optmise(result);
+}
+
+template <typename String>
+void copy_strings(size_t count) {
+  String src = MakeString<String>(count, 'a');
+  for (int i = 0; i < kRunLoops; ++i) {
+    String dst(src);
+    do_not_optmise(dst[0]);
+  }
+}
+
+template <typename String>
+void hash_strings(size_t count) {
+  String str = MakeString<String>(count, 'a');
+  size_t sum = 0;
+  for (int i = 0; i < kRunLoops; ++i) {
+    do_not_optmise(str[0]);
+    sum += Hash(str);
+  }
+  do_not_optmise(sum);
+}
+
+using BenchFunc = void (*)(size_t);
+
+void compare(const char* title, size_t count, BenchFunc std_func,
+             BenchFunc legacy_func, BenchFunc fixed_func) {
+  PrintLine pline;
+  std::cout << title << ", " << count << " chars" << std::endl;
+
+  std::cout << "std::string cost:" << std::endl;
+  StopWatch sw;
+  std_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "basic_string over stack allocator cost:" << std::endl;
+  sw.Restart();
+  legacy_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed string cost:" << std::endl;
+  sw.Restart();
+  fixed_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+int main() {
+  std::cout << "total loops:" << kRunLoops << ", inline capacity "
+            << kCapacity << std::endl;
+  std::cout << "sizeof std::string: " << sizeof(std::string)
+            << ", sizeof legacy: " << sizeof(LegacyString)
+            << ", sizeof fixed string: " << sizeof(FixedStr) << std::endl
+            << std::endl;
+
+  for (size_t count : {kShortSize, kLongSize}) {
+    compare("append", count, append_chars<std::string>,
+            append_chars<LegacyString>, append_chars<FixedStr>);
+    compare("compare", count, compare_strings<std::string>,
+            compare_strings<LegacyString>, compare_strings<FixedStr>);
+    compare("copy", count, copy_strings<std::string>,
+            copy_strings<LegacyString>, copy_strings<FixedStr>);
+    compare("hash", count, hash_strings<std::string>,
+            hash_strings<LegacyString>, hash_strings<FixedStr>);
+  }
+  return 0;
+}
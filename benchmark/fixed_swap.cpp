@@ -0,0 +1,97 @@
+#include "fixed_map.hpp"
+#include "fixed_list.hpp"
+#include "fixed_vector.hpp"
+
+#include <iterator>
+#include <iostream>
+#include <algorithm>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 2000;
+constexpr size_t kCapacity = 32;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+// what swap used to do: three full copies through a temporary
+template <typename Container>
+void CopySwap(Container& lhs, Container& rhs) {
+  Container tmp(lhs);
+  lhs.clear();
+  std::copy(rhs.begin(), rhs.end(), std::inserter(lhs, lhs.end()));
+  rhs.clear();
+  std::copy(tmp.begin(), tmp.end(), std::inserter(rhs, rhs.end()));
+}
+
+using Map = FixedMap<size_t, size_t, kCapacity>;
+using List = FixedList<size_t, kCapacity>;
+using Vector = FixedVector<size_t, kCapacity>;
+
+void Fill(Map& con, size_t count, size_t base) {
+  for (size_t i = 0; i < count; ++i) con[base + i] = i;
+}
+
+template <typename Container>
+void Fill(Container& con, size_t count, size_t base) {
+  for (size_t i = 0; i < count; ++i) con.push_back(base + i);
+}
+
+template <typename Container>
+void swap_copy(size_t count) {
+  Container lhs;
+  Container rhs;
+  Fill(lhs, count, 0);
+  Fill(rhs, count / 2, count);
+  for (int i = 0; i < kRunLoops; ++i) {
+    CopySwap(lhs, rhs);
+    do_not_optmise(lhs.size());
+  }
+}
+
+template <typename Container>
+void swap_member(size_t count) {
+  Container lhs;
+  Container rhs;
+  Fill(lhs, count, 0);
+  Fill(rhs, count / 2, count);
+  for (int i = 0; i < kRunLoops; ++i) {
+    lhs.swap(rhs);
+    do_not_optmise(lhs.size());
+  }
+}
+
+using BenchFunc = void (*)(size_t);
+
+void compare(const char* title, size_t count, BenchFunc copy_func,
+             BenchFunc swap_func) {
+  PrintLine pline;
+  std::cout << title << ", " << count << " elements" << std::endl;
+
+  std::cout << "three copies cost:" << std::endl;
+  StopWatch sw;
+  copy_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "container swap cost:" << std::endl;
+  sw.Restart();
+  swap_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+int main() {
+  std::cout << "total loops:" << kRunLoops << ", inline capacity "
+            << kCapacity << std::endl << std::endl;
+  for (size_t count : {size_t(16), size_t(1000)}) {
+    compare("swap fixed map", count, swap_copy<Map>, swap_member<Map>);
+    compare("swap fixed list", count, swap_copy<List>, swap_member<List>);
+    compare("swap fixed vector", count, swap_copy<Vector>,
+            swap_member<Vector>);
+  }
+  return 0;
+}
@@ -0,0 +1,110 @@
+#include "fixed_unordered_map.hpp"
+#include "fixed_map.hpp"
+
+#include <vector>
+#include <cstdlib>
+#include <iostream>
+#include <unordered_map>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 100000;
+constexpr size_t kCapacity = 32;
+constexpr size_t kProbes = 64;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+// random keys, lookups hit about half of the time
+std::vector<size_t> MakeKeys(size_t count) {
+  std::vector<size_t> keys(count);
+  for (auto& key : keys) key = rand();
+  return keys;
+}
+
+static const std::vector<size_t> keys = MakeKeys(kCapacity * 8);
+
+template <typename Map>
+void insert_elements(size_t count) {
+  for (int i = 0; i < kRunLoops; ++i) {
+    Map con;
+    for (size_t j = 0; j < count; ++j) {
+      con[keys[j]] = j;
+    }
+    do_not_optmise(con.size());
+  }
+}
+
+template <typename Map>
+void lookup_elements(size_t count) {
+  Map con;
+  for (size_t j = 0; j < count; ++j) con[keys[j]] = j;
+  for (int i = 0; i < kRunLoops; ++i) {
+    size_t sum = 0;
+    for (size_t j = 0; j < kProbes; ++j) {
+      auto it = con.find(keys[(i + j * 7) % (count * 2)]);
+      if (it != con.end()) sum += it->second;
+    }
+    do_not_optmise(sum);
+  }
+}
+
+template <typename Func>
+void compare(const char* title, Func std_func, Func tree_func,
+             Func hash_func) {
+  PrintLine pline;
+  std::cout << title << std::endl;
+
+  std::cout << "std::unordered_map cost:" << std::endl;
+  StopWatch sw;
+  std_func();
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed map cost:" << std::endl;
+  sw.Restart();
+  tree_func();
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed unordered map cost:" << std::endl;
+  sw.Restart();
+  hash_func();
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+using StdMap = std::unordered_map<size_t, size_t>;
+using TreeMap = FixedMap<size_t, size_t, kCapacity>;
+using HashMap = FixedUnorderedMap<size_t, size_t, kCapacity>;
+using BenchFunc = void (*)();
+
+int main() {
+  std::cout << "total loops:" << kRunLoops << ", capacity:" << kCapacity
+            << std::endl
+            << std::endl;
+
+  compare<BenchFunc>(
+      "insert 32 elements", [] { insert_elements<StdMap>(kCapacity); },
+      [] { insert_elements<TreeMap>(kCapacity); },
+      [] { insert_elements<HashMap>(kCapacity); });
+  compare<BenchFunc>(
+      "insert 128 elements, spilling to heap",
+      [] { insert_elements<StdMap>(kCapacity * 4); },
+      [] { insert_elements<TreeMap>(kCapacity * 4); },
+      [] { insert_elements<HashMap>(kCapacity * 4); });
+  compare<BenchFunc>(
+      "64 lookups in 32 elements", [] { lookup_elements<StdMap>(kCapacity); },
+      [] { lookup_elements<TreeMap>(kCapacity); },
+      [] { lookup_elements<HashMap>(kCapacity); });
+  compare<BenchFunc>(
+      "64 lookups in 128 elements",
+      [] { lookup_elements<StdMap>(kCapacity * 4); },
+      [] { lookup_elements<TreeMap>(kCapacity * 4); },
+      [] { lookup_elements<HashMap>(kCapacity * 4); });
+
+  return 0;
+}
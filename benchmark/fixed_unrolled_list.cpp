@@ -0,0 +1,115 @@
+#include "fixed_unrolled_list.hpp"
+#include "fixed_list.hpp"
+
+#include <list>
+#include <iostream>
+#include <iterator>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 200;
+constexpr size_t kCapacity = 4096;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+// a list that was built by inserts all over the place, so that the nodes
+// of the node based lists are not in address order
+template <typename List>
+void Scatter(List& list, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    auto pos = list.begin();
+    std::advance(pos, (i * 7919) % (list.size() + 1));
+    list.insert(pos, int(i));
+  }
+}
+
+template <typename List>
+void iterate(size_t count) {
+  List list;
+  Scatter(list, count);
+  for (int i = 0; i < kRunLoops * 10; ++i) {
+    long sum = 0;
+    for (int value : list) sum += value;
+    do_not_optmise(sum);
+  }
+}
+
+// walk to the middle and insert there, what an ordered list does
+template <typename List>
+void insert_middle(size_t count) {
+  for (int i = 0; i < kRunLoops; ++i) {
+    List list;
+    for (size_t j = 0; j < count; ++j) {
+      auto pos = list.begin();
+      std::advance(pos, list.size() / 2);
+      list.insert(pos, int(j));
+    }
+    do_not_optmise(list.front());
+  }
+}
+
+// drop every third element in one pass, then the rest from the middle
+template <typename List>
+void erase(size_t count) {
+  for (int i = 0; i < kRunLoops; ++i) {
+    List list;
+    for (size_t j = 0; j < count; ++j) list.push_back(int(j));
+    for (auto it = list.begin(); it != list.end();) {
+      it = *it % 3 == 0 ? list.erase(it) : std::next(it);
+    }
+    while (!list.empty()) {
+      auto pos = list.begin();
+      std::advance(pos, list.size() / 2);
+      list.erase(pos);
+    }
+    do_not_optmise(list.size());
+  }
+}
+
+using BenchFunc = void (*)(size_t);
+
+void compare(const char* title, size_t count, BenchFunc std_func,
+             BenchFunc fixed_func, BenchFunc unrolled_func) {
+  PrintLine pline;
+  std::cout << title << ", " << count << " ints" << std::endl;
+
+  std::cout << "std::list cost:" << std::endl;
+  StopWatch sw;
+  std_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed list cost:" << std::endl;
+  sw.Restart();
+  fixed_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed unrolled list cost:" << std::endl;
+  sw.Restart();
+  unrolled_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+int main() {
+  using StdList = std::list<int>;
+  using Fixed = FixedList<int, kCapacity>;
+  using Unrolled = FixedUnrolledList<int, kCapacity>;
+  std::cout << "total loops:" << kRunLoops << ", " << sizeof(Unrolled::Node)
+            << " byte nodes of " << UnrolledElemsPerNode<int>() << " ints"
+            << std::endl << std::endl;
+  for (size_t count : {size_t(64), size_t(1000)}) {
+    compare("sum a scattered list", count, iterate<StdList>, iterate<Fixed>,
+            iterate<Unrolled>);
+    compare("insert in the middle", count, insert_middle<StdList>,
+            insert_middle<Fixed>, insert_middle<Unrolled>);
+    compare("erase every third, then from the middle", count, erase<StdList>,
+            erase<Fixed>, erase<Unrolled>);
+  }
+  return 0;
+}
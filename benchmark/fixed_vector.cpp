@@ -7,6 +7,7 @@
 
 constexpr int kRunLoops = 1000000;
 constexpr int kVecSize = 100;
+constexpr int kSpilledSize = 4096;
 
 template <typename T>
 void do_not_optmise(T&& val) {
@@ -123,7 +124,39 @@ void bench_push() {
   std::cout << sw << std::endl;
 }
 
+template <typename Container>
+void move_elements(int size) {
+  Container lhs(size);
+  Container rhs;
+  for (int i = 0; i < kRunLoops; ++i) {
+    rhs = std::move(lhs);
+    lhs = std::move(rhs);
+    do_not_optmise(lhs.size());
+  }
+}
+
+void bench_move() {
+  PrintLine pline;
+  std::cout << "move assign back and forth" << std::endl;
+  std::cout << "std::vector cost for 4096 elements:" << std::endl;
+
+  StopWatch sw;
+  move_elements<std::vector<int>>(kSpilledSize);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed vector cost for 4096 elements (on heap):" << std::endl;
+  sw.Restart();
+  move_elements<FixedVector<int, kVecSize>>(kSpilledSize);
+  sw.Stop();
+  std::cout << sw << std::endl;
 
+  std::cout << "fixed vector cost for 100 elements (inline):" << std::endl;
+  sw.Restart();
+  move_elements<FixedVector<int, kVecSize>>(kVecSize);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
 
 int main() {
   std::cout << "total loops:" << kRunLoops << std::endl;
@@ -131,6 +164,7 @@ int main() {
   bench_iota();
   bench_sum();
   bench_push();
+  bench_move();
 
   return 0;
 }
@@ -0,0 +1,172 @@
+#include "intrusive_list.hpp"
+#include "intrusive_forward_list.hpp"
+#include "fixed_list.hpp"
+#include "fixed_forward_list.hpp"
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 2000;
+constexpr size_t kCapacity = 1024;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+// what a scheduler queue holds: a few cache lines of state per task
+struct Task {
+  size_t id = 0;
+  IntrusiveListHook hook;
+  IntrusiveForwardListHook queue_hook;
+  size_t state[6] = {};
+};
+
+using TaskList = IntrusiveList<Task, &Task::hook>;
+using TaskQueue = IntrusiveForwardList<Task, &Task::queue_hook>;
+
+std::vector<Task>& Tasks(size_t count) {
+  static std::vector<Task> tasks(kCapacity);
+  for (size_t i = 0; i < count; ++i) tasks[i].id = i;
+  return tasks;
+}
+
+// queue every task, then run them in order
+template <typename List>
+void fifo_fixed(size_t count) {
+  std::vector<Task>& tasks = Tasks(count);
+  List queue;
+  for (int i = 0; i < kRunLoops; ++i) {
+    for (size_t j = 0; j < count; ++j) queue.push_back(tasks[j]);
+    while (!queue.empty()) {
+      do_not_optmise(queue.front().id);
+      queue.pop_front();
+    }
+  }
+}
+
+void fifo_forward_fixed(size_t count) {
+  std::vector<Task>& tasks = Tasks(count);
+  FixedForwardList<Task, kCapacity> queue;
+  for (int i = 0; i < kRunLoops; ++i) {
+    auto tail = queue.before_begin();
+    for (size_t j = 0; j < count; ++j) {
+      tail = queue.insert_after(tail, tasks[j]);
+    }
+    while (!queue.empty()) {
+      do_not_optmise(queue.front().id);
+      queue.pop_front();
+    }
+  }
+}
+
+template <typename List>
+void fifo_intrusive(size_t count) {
+  std::vector<Task>& tasks = Tasks(count);
+  List queue;
+  for (int i = 0; i < kRunLoops; ++i) {
+    for (size_t j = 0; j < count; ++j) queue.push_back(tasks[j]);
+    while (!queue.empty()) {
+      do_not_optmise(queue.front().id);
+      queue.pop_front();
+    }
+  }
+}
+
+// every task hops from the ready list to the waiting one and back; a
+// FixedList cannot splice between two pools, so it moves the values
+void move_across_fixed(size_t count) {
+  std::vector<Task>& tasks = Tasks(count);
+  FixedList<Task, kCapacity> ready(tasks.begin(), tasks.begin() + count);
+  FixedList<Task, kCapacity> waiting;
+  for (int i = 0; i < kRunLoops; ++i) {
+    while (!ready.empty()) {
+      waiting.push_back(ready.front());
+      ready.pop_front();
+    }
+    ready.swap(waiting);
+    do_not_optmise(ready.size());
+  }
+}
+
+void move_across_intrusive(size_t count) {
+  std::vector<Task>& tasks = Tasks(count);
+  TaskList ready(tasks.begin(), tasks.begin() + count);
+  TaskList waiting;
+  for (int i = 0; i < kRunLoops; ++i) {
+    while (!ready.empty()) {
+      waiting.splice(waiting.end(), ready, ready.begin());
+    }
+    ready.swap(waiting);
+    do_not_optmise(ready.size());
+  }
+  ready.clear();
+}
+
+// cancel every other task given only the task, then queue it again
+void cancel_fixed(size_t count) {
+  std::vector<Task>& tasks = Tasks(count);
+  FixedList<Task, kCapacity> list(tasks.begin(), tasks.begin() + count);
+  for (int i = 0; i < kRunLoops; ++i) {
+    for (size_t j = 0; j < count; j += 2) {
+      size_t id = tasks[j].id;
+      auto match = [id](const Task& task) { return task.id == id; };
+      list.erase(std::find_if(list.begin(), list.end(), match));
+      list.push_back(tasks[j]);
+    }
+    do_not_optmise(list.size());
+  }
+}
+
+void cancel_intrusive(size_t count) {
+  std::vector<Task>& tasks = Tasks(count);
+  TaskList list(tasks.begin(), tasks.begin() + count);
+  for (int i = 0; i < kRunLoops; ++i) {
+    for (size_t j = 0; j < count; j += 2) {
+      list.erase(list.iterator_to(tasks[j]));
+      list.push_back(tasks[j]);
+    }
+    do_not_optmise(list.size());
+  }
+  list.clear();
+}
+
+using BenchFunc = void (*)(size_t);
+
+void compare(const char* title, size_t count, BenchFunc fixed_func,
+             BenchFunc intrusive_func) {
+  PrintLine pline;
+  std::cout << title << ", " << count << " tasks" << std::endl;
+
+  std::cout << "fixed list cost:" << std::endl;
+  StopWatch sw;
+  fixed_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "intrusive list cost:" << std::endl;
+  sw.Restart();
+  intrusive_func(count);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+int main() {
+  std::cout << "total loops:" << kRunLoops << ", task size " << sizeof(Task)
+            << " bytes" << std::endl << std::endl;
+  for (size_t count : {size_t(16), size_t(1000)}) {
+    compare("push_back and pop_front, list", count,
+            fifo_fixed<FixedList<Task, kCapacity>>, fifo_intrusive<TaskList>);
+    compare("push_back and pop_front, forward list", count,
+            fifo_forward_fixed, fifo_intrusive<TaskQueue>);
+    compare("move every task to another list", count, move_across_fixed,
+            move_across_intrusive);
+    compare("unlink and requeue half the tasks", count, cancel_fixed,
+            cancel_intrusive);
+  }
+  return 0;
+}
@@ -0,0 +1,139 @@
+#include "sharded_fixed_map.hpp"
+#include "fixed_map.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+#include "stop_watch.hpp"
+
+constexpr size_t kKeys = 4096;
+constexpr size_t kOpsPerThread = 200000;
+constexpr size_t kBatch = 16;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+struct Route {
+  uint64_t next_hop;
+  uint64_t weight;
+};
+
+// the routing table before: one FixedMap behind one mutex
+class LockedMap {
+ public:
+  bool get(uint64_t key, Route& route) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = map_.find(key);
+    if (it == map_.end()) {
+      return false;
+    }
+    route = it->second;
+    return true;
+  }
+
+  size_t multi_get(const uint64_t* keys, size_t n, Route* routes) {
+    size_t hits = 0;
+    for (size_t i = 0; i < n; ++i) hits += get(keys[i], routes[i]);
+    return hits;
+  }
+
+  void insert_or_assign(uint64_t key, const Route& route) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    map_[key] = route;
+  }
+
+ private:
+  std::mutex mutex_;
+  FixedMap<uint64_t, Route, kKeys> map_;
+};
+
+using ShardedMap = ShardedFixedMap<uint64_t, Route, kKeys / 16, 16>;
+
+// a per thread xorshift, <random> is not used in this tree
+inline uint64_t NextRandom(uint64_t& state) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+// every thread does kOpsPerThread operations, writes_per_mille of them
+// updates and the rest lookups, one key at a time or kBatch at once
+template <typename Map>
+void mixed(size_t threads, size_t writes_per_mille, bool batched) {
+  Map map;
+  for (uint64_t key = 0; key < kKeys; ++key) {
+    map.insert_or_assign(key, Route{key, 1});
+  }
+  std::vector<std::thread> workers;
+  for (size_t t = 0; t < threads; ++t) {
+    workers.emplace_back([&map, t, writes_per_mille, batched] {
+      uint64_t state = 0x9E3779B97F4A7C15ull * (t + 1);
+      uint64_t keys[kBatch];
+      Route routes[kBatch];
+      uint64_t sum = 0;
+      for (size_t op = 0; op < kOpsPerThread;) {
+        uint64_t r = NextRandom(state);
+        if (r % 1000 < writes_per_mille) {
+          map.insert_or_assign(r % kKeys, Route{r, 2});
+          ++op;
+        } else if (batched) {
+          for (size_t i = 0; i < kBatch; ++i) {
+            keys[i] = NextRandom(state) % kKeys;
+          }
+          sum += map.multi_get(keys, kBatch, routes);
+          op += kBatch;
+        } else {
+          Route route;
+          sum += map.get(r % kKeys, route);
+          ++op;
+        }
+      }
+      do_not_optmise(sum);
+    });
+  }
+  for (std::thread& worker : workers) worker.join();
+}
+
+void compare(size_t threads, size_t writes_per_mille, bool batched) {
+  PrintLine pline;
+  std::cout << threads << " threads, " << writes_per_mille / 10.0
+            << "% writes, " << (batched ? "batches of 16" : "single gets")
+            << std::endl;
+
+  std::cout << "mutex fixed map cost:" << std::endl;
+  StopWatch sw;
+  mixed<LockedMap>(threads, writes_per_mille, batched);
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "sharded fixed map cost:" << std::endl;
+  sw.Restart();
+  mixed<ShardedMap>(threads, writes_per_mille, batched);
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+int main() {
+  size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  std::cout << kKeys << " keys, " << kOpsPerThread << " operations a thread, "
+            << cores << " hardware threads" << std::endl << std::endl;
+  std::vector<size_t> thread_counts;
+  for (size_t n = 1; n < cores; n *= 2) thread_counts.push_back(n);
+  thread_counts.push_back(cores);
+  for (size_t threads : thread_counts) {
+    for (size_t writes : {size_t(0), size_t(10), size_t(100), size_t(500)}) {
+      compare(threads, writes, false);
+    }
+    compare(threads, 10, true);
+  }
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include "small_vector.hpp"
+#include "fixed_vector.hpp"
+
+#include <vector>
+#include <numeric>
+#include <iostream>
+#include <algorithm>
+#include "stop_watch.hpp"
+
+constexpr int kRunLoops = 1000000;
+constexpr int kVecSize = 100;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+template <typename Container>
+void ctor_dtor() {
+  for (int i = 0; i < kRunLoops; ++i) {
+    Container con(kVecSize);
+    do_not_optmise(con.begin());
+  }
+}
+
+template <typename Container>
+void push_elements(int count) {
+  for (int i = 0; i < kRunLoops; ++i) {
+    Container con;
+    for (int j = 0; j < count; ++j) {
+      con.push_back(j);
+    }
+    do_not_optmise(con.front());
+  }
+}
+
+template <typename Container>
+void sum_up() {
+  Container con(kVecSize);
+  std::iota(std::begin(con), std::end(con), 0);
+  for (int i = 0; i < kRunLoops; ++i) {
+    do_not_optmise(con.front());
+    auto sum = std::accumulate(std::begin(con), std::end(con), 0);
+    do_not_optmise(sum);
+  }
+}
+
+template <typename Container>
+void move_elements(int count) {
+  Container lhs(count);
+  Container rhs;
+  for (int i = 0; i < kRunLoops; ++i) {
+    rhs = std::move(lhs);
+    lhs = std::move(rhs);
+    do_not_optmise(lhs.size());
+  }
+}
+
+using BenchFunc = void (*)();
+
+void compare(const char* title, BenchFunc std_func, BenchFunc fixed_func,
+             BenchFunc small_func) {
+  PrintLine pline;
+  std::cout << title << std::endl;
+
+  std::cout << "std::vector cost:" << std::endl;
+  StopWatch sw;
+  std_func();
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "fixed vector cost:" << std::endl;
+  sw.Restart();
+  fixed_func();
+  sw.Stop();
+  std::cout << sw << std::endl;
+
+  std::cout << "small vector cost:" << std::endl;
+  sw.Restart();
+  small_func();
+  sw.Stop();
+  std::cout << sw << std::endl;
+}
+
+using StdVector = std::vector<int>;
+using FixedVec = FixedVector<int, kVecSize>;
+using SmallVec = SmallVector<int, kVecSize>;
+
+int main() {
+  std::cout << "total loops:" << kRunLoops << std::endl;
+  std::cout << "sizeof fixed vector: " << sizeof(FixedVec)
+            << ", sizeof small vector: " << sizeof(SmallVec) << std::endl
+            << std::endl;
+
+  compare("constructing and destructing", ctor_dtor<StdVector>,
+          ctor_dtor<FixedVec>, ctor_dtor<SmallVec>);
+  compare("sum up for 100 elements", sum_up<StdVector>, sum_up<FixedVec>,
+          sum_up<SmallVec>);
+  compare("push for 100 elements once each",
+          [] { push_elements<StdVector>(kVecSize); },
+          [] { push_elements<FixedVec>(kVecSize); },
+          [] { push_elements<SmallVec>(kVecSize); });
+  compare("push for 400 elements once each, spilling to heap",
+          [] { push_elements<StdVector>(kVecSize * 4); },
+          [] { push_elements<FixedVec>(kVecSize * 4); },
+          [] { push_elements<SmallVec>(kVecSize * 4); });
+  compare("move assign back and forth for 100 elements",
+          [] { move_elements<StdVector>(kVecSize); },
+          [] { move_elements<FixedVec>(kVecSize); },
+          [] { move_elements<SmallVec>(kVecSize); });
+  return 0;
+}
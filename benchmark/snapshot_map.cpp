@@ -0,0 +1,170 @@
+#include "snapshot_map.hpp"
+#include "sharded_fixed_map.hpp"
+#include "fixed_map.hpp"
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <algorithm>
+#include "stop_watch.hpp"
+
+constexpr size_t kKeys = 1024;
+constexpr size_t kReadsPerThread = 400000;
+
+template <typename T>
+void do_not_optmise(T&& val) {
+  asm volatile ("" : "+r" (val));
+}
+
+struct PrintLine { ~PrintLine() { std::cout << std::endl; } };
+
+using Map = FixedMap<uint64_t, uint64_t, kKeys>;
+
+// the lookup table before: one FixedMap behind one mutex
+class MutexMap {
+ public:
+  class Reader {
+   public:
+    explicit Reader(MutexMap& owner) : owner_(owner) {}
+
+    bool get(uint64_t key, uint64_t& value) {
+      std::lock_guard<std::mutex> lock(owner_.mutex_);
+      return Find(owner_.map_, key, value);
+    }
+
+   private:
+    MutexMap& owner_;
+  };
+
+  template <typename Func>
+  void update(Func func) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    func(map_);
+  }
+
+  static bool Find(const Map& map, uint64_t key, uint64_t& value) {
+    auto it = map.find(key);
+    if (it == map.end()) {
+      return false;
+    }
+    value = it->second;
+    return true;
+  }
+
+ private:
+  std::mutex mutex_;
+  Map map_;
+};
+
+// the same behind a reader-writer lock
+class RwLockMap {
+ public:
+  class Reader {
+   public:
+    explicit Reader(RwLockMap& owner) : owner_(owner) {}
+
+    bool get(uint64_t key, uint64_t& value) {
+      ReadLock lock(owner_.lock_);
+      return MutexMap::Find(owner_.map_, key, value);
+    }
+
+   private:
+    RwLockMap& owner_;
+  };
+
+  template <typename Func>
+  void update(Func func) {
+    std::lock_guard<RwLock> lock(lock_);
+    func(map_);
+  }
+
+ private:
+  RwLock lock_;
+  Map map_;
+};
+
+using RcuMap = SnapshotMap<Map>;
+
+// a per thread xorshift, <random> is not used in this tree
+inline uint64_t NextRandom(uint64_t& state) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+// readers threads do kReadsPerThread lookups each; with a writer, one
+// more thread changes a value every writer_pause until they are done
+template <typename Table>
+void reads(size_t readers, bool writer,
+           std::chrono::microseconds writer_pause) {
+  Table table;
+  table.update([](Map& map) {
+    for (uint64_t key = 0; key < kKeys; ++key) map.emplace(key, key);
+  });
+  std::atomic<size_t> running{readers};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < readers; ++t) {
+    threads.emplace_back([&table, &running, t] {
+      typename Table::Reader reader(table);
+      uint64_t state = 0x9E3779B97F4A7C15ull * (t + 1);
+      uint64_t sum = 0;
+      uint64_t value;
+      for (size_t i = 0; i < kReadsPerThread; ++i) {
+        sum += reader.get(NextRandom(state) % kKeys, value) ? value : 0;
+      }
+      do_not_optmise(sum);
+      running.fetch_sub(1);
+    });
+  }
+  if (writer) {
+    threads.emplace_back([&table, &running, writer_pause] {
+      uint64_t state = 42;
+      while (running.load() > 0) {
+        uint64_t key = NextRandom(state) % kKeys;
+        table.update([key](Map& map) { ++map.find(key)->second; });
+        std::this_thread::sleep_for(writer_pause);
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+}
+
+template <typename Table>
+void run(const char* name, size_t readers, bool writer) {
+  std::cout << name << " cost:" << std::endl;
+  StopWatch sw;
+  reads<Table>(readers, writer, std::chrono::microseconds(100));
+  sw.Stop();
+  double seconds = std::chrono::duration<double>(sw.GetElapse()).count();
+  std::cout << sw << ", "
+            << size_t(readers * kReadsPerThread / seconds / 1000)
+            << "k reads/s" << std::endl;
+}
+
+void compare(size_t readers, bool writer) {
+  PrintLine pline;
+  std::cout << readers << " readers, "
+            << (writer ? "a writer every 100us" : "no writer") << std::endl;
+  run<MutexMap>("mutex fixed map", readers, writer);
+  run<RwLockMap>("rwlock fixed map", readers, writer);
+  run<RcuMap>("snapshot map", readers, writer);
+}
+
+int main() {
+  size_t cores = std::max(1u, std::thread::hardware_concurrency());
+  std::cout << kKeys << " keys, " << kReadsPerThread << " reads a thread, "
+            << cores << " hardware threads" << std::endl << std::endl;
+  std::vector<size_t> reader_counts;
+  for (size_t n = 1; n < cores; n *= 2) reader_counts.push_back(n);
+  reader_counts.push_back(cores);
+  for (size_t readers : reader_counts) {
+    compare(readers, false);
+    compare(readers, true);
+  }
+  return 0;
+}
@@ -0,0 +1,379 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "fixed_flat_map.hpp"
+#include "utils.hpp"
+
+// constexpr lookups take the plain loop of BranchlessLowerBound at run
+// time when the compiler can tell the two apart, the recursive form gets
+// inlined into branches once the size is a constant
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define EXT_STL_HAS_IS_CONSTANT_EVALUATED 1
+#endif
+#endif
+
+// Containers for lookup tables that are built by the compiler. They are
+// literal types, a constexpr variable of one is laid out at compile time
+// and placed in .rodata: no constructor runs at startup and there is no
+// initialization order to get wrong. The contents cannot change after
+// construction, every member is const.
+//
+// The tree is C++11, where a constexpr function is one return statement,
+// so the elements are copied in by expanding an index sequence and every
+// recursion below halves its range to stay within the compiler's depth
+// limit on tables of thousands of entries. Elements past size() are value
+// initialized, T must be a literal type with a constexpr default
+// constructor.
+
+template <size_t... I>
+struct IndexSequence {};
+
+// IndexSequence<0, ..., N - 1>, built by doubling so that the template
+// depth is log N
+template <size_t N, typename = void>
+struct MakeIndexSequenceImpl;
+
+template <typename First, typename Second>
+struct ConcatIndexSequence;
+
+template <size_t... I, size_t... J>
+struct ConcatIndexSequence<IndexSequence<I...>, IndexSequence<J...>> {
+  using type = IndexSequence<I..., (sizeof...(I) + J)...>;
+};
+
+template <size_t N, typename>
+struct MakeIndexSequenceImpl {
+  using type = typename ConcatIndexSequence<
+      typename MakeIndexSequenceImpl<N / 2>::type,
+      typename MakeIndexSequenceImpl<N - N / 2>::type>::type;
+};
+
+template <size_t N>
+struct MakeIndexSequenceImpl<N, typename std::enable_if<(N < 2)>::type> {
+  using type = typename std::conditional<N == 0, IndexSequence<>,
+                                         IndexSequence<0>>::type;
+};
+
+template <size_t N>
+using MakeIndexSequence = typename MakeIndexSequenceImpl<N>::type;
+
+// std::less is constexpr from C++14 on
+template <typename T>
+struct ConstLess {
+  constexpr bool operator()(const T& lhs, const T& rhs) const {
+    return lhs < rhs;
+  }
+};
+
+// reads element i of an array for the generating constructors
+template <typename T>
+struct ConstArrayReader {
+  constexpr const T& operator()(size_t i) const { return data[i]; }
+  const T* data;
+};
+
+// The elements of a fixed size array: built from an array, or from
+// gen(0), ..., gen(N - 1) where gen is a literal function object.
+template <typename T, size_t Capacity>
+class ConstFixedVector {
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using const_reference = const T&;
+  using const_pointer = const T*;
+  using const_iterator = const T*;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  constexpr ConstFixedVector() : data_{}, size_(0) {}
+
+  template <size_t N>
+  constexpr ConstFixedVector(const T (&values)[N])
+      : ConstFixedVector(ConstArrayReader<T>{values}, MakeIndexSequence<N>()) {
+  }
+
+  template <size_t N, typename Gen>
+  static constexpr ConstFixedVector Generate(Gen gen) {
+    return ConstFixedVector(gen, MakeIndexSequence<N>());
+  }
+
+  constexpr size_type size() const { return size_; }
+  constexpr bool empty() const { return size_ == 0; }
+  static constexpr size_type capacity() { return Capacity; }
+
+  constexpr const_pointer data() const { return data_; }
+  constexpr const_iterator begin() const { return data_; }
+  constexpr const_iterator end() const { return data_ + size_; }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  constexpr const_reference operator[](size_type i) const { return data_[i]; }
+
+  constexpr const_reference at(size_type i) const {
+    return i < size_ ? data_[i]
+                     : throw std::out_of_range("ConstFixedVector::at");
+  }
+
+  constexpr const_reference front() const { return data_[0]; }
+  constexpr const_reference back() const { return data_[size_ - 1]; }
+
+ private:
+  template <typename Gen, size_t... I>
+  constexpr ConstFixedVector(Gen gen, IndexSequence<I...>)
+      : data_{gen(I)...}, size_(sizeof...(I)) {
+    static_assert(sizeof...(I) <= Capacity,
+                  "more values than the ConstFixedVector holds");
+  }
+
+  T data_[Capacity];
+  size_type size_;
+};
+
+// A string of up to Capacity characters, built from a literal.
+template <size_t Capacity>
+class ConstFixedString {
+ public:
+  using value_type = char;
+  using size_type = size_t;
+  using const_reference = const char&;
+  using const_pointer = const char*;
+  using const_iterator = const char*;
+
+  constexpr ConstFixedString() : data_{}, size_(0) {}
+
+  template <size_t N>
+  constexpr ConstFixedString(const char (&literal)[N])
+      : ConstFixedString(literal, MakeIndexSequence<N - 1>()) {}
+
+  constexpr size_type size() const { return size_; }
+  constexpr size_type length() const { return size_; }
+  constexpr bool empty() const { return size_ == 0; }
+  static constexpr size_type capacity() { return Capacity; }
+
+  constexpr const_pointer data() const { return data_; }
+  constexpr const_pointer c_str() const { return data_; }
+  constexpr const_iterator begin() const { return data_; }
+  constexpr const_iterator end() const { return data_ + size_; }
+  constexpr const_reference operator[](size_type i) const { return data_[i]; }
+
+  // <0, 0 or >0 like std::string::compare
+  template <size_t OtherCapacity>
+  constexpr int compare(const ConstFixedString<OtherCapacity>& other) const {
+    return CompareAt(other, Mismatch(other.data(), 0, MinSize(other)),
+                     MinSize(other));
+  }
+
+ private:
+  template <size_t... I>
+  constexpr ConstFixedString(const char* literal, IndexSequence<I...>)
+      : data_{literal[I]...}, size_(sizeof...(I)) {
+    static_assert(sizeof...(I) <= Capacity,
+                  "the literal is longer than the ConstFixedString holds");
+  }
+
+  template <size_t OtherCapacity>
+  constexpr size_type MinSize(const ConstFixedString<OtherCapacity>& other)
+      const {
+    return size_ < other.size() ? size_ : other.size();
+  }
+
+  // the first index in [first, last) where the two differ, or last
+  constexpr size_type Mismatch(const char* other, size_type first,
+                               size_type last) const {
+    return last - first < 2
+               ? (first == last || data_[first] != other[first] ? first
+                                                                : last)
+               : MismatchRight(
+                     other,
+                     Mismatch(other, first, first + (last - first) / 2),
+                     first + (last - first) / 2, last);
+  }
+
+  // the right half only matters when the left one matched throughout
+  constexpr size_type MismatchRight(const char* other, size_type left,
+                                    size_type middle, size_type last) const {
+    return left != middle ? left : Mismatch(other, middle, last);
+  }
+
+  template <size_t OtherCapacity>
+  constexpr int CompareAt(const ConstFixedString<OtherCapacity>& other,
+                          size_type i, size_type common) const {
+    return i < common
+               ? (static_cast<unsigned char>(data_[i]) <
+                          static_cast<unsigned char>(other[i])
+                      ? -1
+                      : 1)
+               : (size_ < other.size() ? -1 : size_ > other.size() ? 1 : 0);
+  }
+
+  // one more for the terminating zero
+  char data_[Capacity + 1];
+  size_type size_;
+};
+
+template <size_t N, size_t M>
+constexpr bool operator==(const ConstFixedString<N>& lhs,
+                          const ConstFixedString<M>& rhs) {
+  return lhs.compare(rhs) == 0;
+}
+
+template <size_t N, size_t M>
+constexpr bool operator!=(const ConstFixedString<N>& lhs,
+                          const ConstFixedString<M>& rhs) {
+  return lhs.compare(rhs) != 0;
+}
+
+template <size_t N, size_t M>
+constexpr bool operator<(const ConstFixedString<N>& lhs,
+                         const ConstFixedString<M>& rhs) {
+  return lhs.compare(rhs) < 0;
+}
+
+// A sorted table of key and value pairs, the constant counterpart of
+// FixedFlatMap with the same layout: keys and values in two arrays, so a
+// lookup only touches the keys, and iterators that yield a pair of
+// references. The entries are given in order, as with the sorted_unique
+// constructors of the other containers; entries out of order or with
+// equivalent keys fail the build when the map is constexpr and throw
+// std::invalid_argument otherwise. Compare has to be constexpr, which
+// std::less is not before C++14. Lookups are the branchless lower bound of
+// utils.hpp, with a recursive form of it for constant evaluation.
+template <typename Key, typename Value, size_t Capacity,
+          typename Compare = ConstLess<Key>>
+class ConstFixedFlatMap {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using value_type = std::pair<Key, Value>;
+  using key_compare = Compare;
+  using size_type = size_t;
+  using const_iterator = FlatMapIterator<Key, const Value>;
+  using KeyContainer = ConstFixedVector<Key, Capacity>;
+  using ValueContainer = ConstFixedVector<Value, Capacity>;
+
+  constexpr ConstFixedFlatMap() : keys_(), values_() {}
+
+  template <size_t N>
+  constexpr ConstFixedFlatMap(sorted_unique_t,
+                              const value_type (&entries)[N])
+      : ConstFixedFlatMap(ConstArrayReader<value_type>{entries},
+                          MakeIndexSequence<N>()) {}
+
+  // the map of gen(0), ..., gen(N - 1), which must come in key order
+  template <size_t N, typename Gen>
+  static constexpr ConstFixedFlatMap Generate(sorted_unique_t, Gen gen) {
+    return ConstFixedFlatMap(gen, MakeIndexSequence<N>());
+  }
+
+  constexpr size_type size() const { return keys_.size(); }
+  constexpr bool empty() const { return keys_.empty(); }
+  static constexpr size_type capacity() { return Capacity; }
+
+  constexpr const KeyContainer& keys() const { return keys_; }
+  constexpr const ValueContainer& values() const { return values_; }
+
+  constexpr const_iterator begin() const { return IteratorAt(0); }
+  constexpr const_iterator end() const { return IteratorAt(size()); }
+
+  constexpr const_iterator lower_bound(const Key& key) const {
+    return IteratorAt(LowerBound(key));
+  }
+
+  constexpr const_iterator find(const Key& key) const {
+    return IteratorAt(Found(LowerBound(key), key));
+  }
+
+  constexpr bool contains(const Key& key) const {
+    return Found(LowerBound(key), key) != size();
+  }
+
+  constexpr size_type count(const Key& key) const { return contains(key); }
+
+  constexpr const Value& at(const Key& key) const {
+    return ValueAt(Found(LowerBound(key), key));
+  }
+
+ private:
+  // the keys and the values of gen's entries, checked to be in order
+  template <typename Gen>
+  struct KeyReader {
+    constexpr Key operator()(size_t i) const { return gen(i).first; }
+    Gen gen;
+  };
+
+  template <typename Gen>
+  struct ValueReader {
+    constexpr Value operator()(size_t i) const { return gen(i).second; }
+    Gen gen;
+  };
+
+  template <typename Gen, size_t... I>
+  constexpr ConstFixedFlatMap(Gen gen, IndexSequence<I...>)
+      : keys_(CheckedKeys(KeyContainer::template Generate<sizeof...(I)>(
+            KeyReader<Gen>{gen}))),
+        values_(ValueContainer::template Generate<sizeof...(I)>(
+            ValueReader<Gen>{gen})) {}
+
+  // every key before the next one, halving to keep the depth log n
+  static constexpr bool Ordered(const KeyContainer& keys, size_type first,
+                                size_type last) {
+    return last - first < 2 ||
+           (Compare()(keys[first + (last - first) / 2 - 1],
+                      keys[first + (last - first) / 2]) &&
+            Ordered(keys, first, first + (last - first) / 2) &&
+            Ordered(keys, first + (last - first) / 2, last));
+  }
+
+  static constexpr const KeyContainer& CheckedKeys(const KeyContainer& keys) {
+    return Ordered(keys, 0, keys.size())
+               ? keys
+               : throw std::invalid_argument(
+                     "ConstFixedFlatMap entries are not sorted and unique");
+  }
+
+  constexpr const_iterator IteratorAt(size_type i) const {
+    return const_iterator(keys_.data() + i, values_.data() + i);
+  }
+
+  constexpr size_type LowerBound(const Key& key) const {
+#if defined(EXT_STL_HAS_IS_CONSTANT_EVALUATED)
+    return __builtin_is_constant_evaluated()
+               ? ConstLowerBound(keys_.data(), keys_.size(), key) -
+                     keys_.data()
+               : BranchlessLowerBound(keys_.data(), keys_.size(), key,
+                                      Compare());
+#else
+    return ConstLowerBound(keys_.data(), keys_.size(), key) - keys_.data();
+#endif
+  }
+
+  // BranchlessLowerBound as a tail call for constant evaluation
+  static constexpr const Key* ConstLowerBound(const Key* base, size_type n,
+                                              const Key& key) {
+    return n > 1 ? ConstLowerBound(Compare()(base[n / 2], key)
+                                       ? base + n / 2
+                                       : base,
+                                   n - n / 2, key)
+                 : base + (n == 1 && Compare()(*base, key));
+  }
+
+  // i when it holds key, otherwise size()
+  constexpr size_type Found(size_type i, const Key& key) const {
+    return i != size() && !Compare()(key, keys_[i]) ? i : size();
+  }
+
+  constexpr const Value& ValueAt(size_type i) const {
+    return i != size() ? values_[i]
+                       : throw std::out_of_range("ConstFixedFlatMap::at");
+  }
+
+  KeyContainer keys_;
+  ValueContainer values_;
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "arena.hpp"
+
+// std::pmr needs C++17 and <memory_resource>, the rest of the library
+// stays C++11, so everything here compiles away without them
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<memory_resource>)
+#define EXT_STL_HAS_PMR 1
+#endif
+#endif
+
+#if defined(EXT_STL_HAS_PMR)
+#include <memory_resource>
+
+// The inline buffer then upstream strategy of StackAllocator as a
+// std::pmr::memory_resource, for std::pmr containers and anything else
+// that takes a polymorphic_allocator. Requests are carved out of Bytes of
+// inline storage by bumping a pointer and go to upstream once it is used
+// up. Unlike std::pmr::monotonic_buffer_resource, freed memory is reused:
+// the block on top of the bump pointer is taken back, others are recycled
+// for the next request of the same size, and upstream blocks are returned
+// to upstream right away. Not thread safe, and only equal to itself.
+template <size_t Bytes>
+class FixedBufferResource : public std::pmr::memory_resource {
+ public:
+  explicit FixedBufferResource(
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+      : upstream_(upstream) {}
+
+  FixedBufferResource(const FixedBufferResource&) = delete;
+  FixedBufferResource& operator=(const FixedBufferResource&) = delete;
+
+  std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+
+  bool owns(const void* p) const {
+    const unsigned char* byte = static_cast<const unsigned char*>(p);
+    return byte >= buffer_ && byte < buffer_ + Bytes;
+  }
+
+  // bytes of the inline buffer below the bump pointer
+  size_t buffer_used() const { return cur_ - buffer_; }
+
+ protected:
+  void* do_allocate(size_t bytes, size_t align) override {
+    if (void* recycled = recycled_.Pop(bytes, align)) {
+      return recycled;
+    }
+    uintptr_t cur = (reinterpret_cast<uintptr_t>(cur_) + align - 1) &
+                    ~uintptr_t(align - 1);
+    if (cur + bytes <= reinterpret_cast<uintptr_t>(buffer_ + Bytes)) {
+      cur_ = reinterpret_cast<unsigned char*>(cur + bytes);
+      return reinterpret_cast<void*>(cur);
+    }
+    return upstream_->allocate(bytes, align);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t align) override {
+    if (!owns(p)) {
+      upstream_->deallocate(p, bytes, align);
+    } else if (static_cast<unsigned char*>(p) + bytes == cur_) {
+      cur_ = static_cast<unsigned char*>(p);
+    } else {
+      recycled_.Push(p, bytes, align);
+    }
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+ private:
+  std::pmr::memory_resource* upstream_;
+  unsigned char* cur_ = buffer_;
+  RecycleBins recycled_;
+  alignas(std::max_align_t) unsigned char buffer_[Bytes];
+};
+#endif
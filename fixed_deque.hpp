@@ -0,0 +1,733 @@
+#pragma once
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+#include <cstring>
+#include <cassert>
+#include "utils.hpp"
+
+// A position in a ring of power of two slots. It counts from the ring's
+// start without wrapping, so positions compare and subtract directly and
+// the mask is only applied to reach the slot.
+template <typename T, typename Value>
+class RingIterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = Value*;
+  using reference = Value&;
+
+  RingIterator() = default;
+  RingIterator(T* data, size_t mask, size_t pos)
+      : data_(data), mask_(mask), pos_(pos) {}
+
+  // iterator to const_iterator
+  operator RingIterator<T, const T>() const {
+    return RingIterator<T, const T>(data_, mask_, pos_);
+  }
+
+  reference operator*() const { return data_[pos_ & mask_]; }
+  pointer operator->() const { return &data_[pos_ & mask_]; }
+  reference operator[](difference_type n) const {
+    return data_[(pos_ + n) & mask_];
+  }
+
+  RingIterator& operator++() {
+    ++pos_;
+    return *this;
+  }
+  RingIterator operator++(int) {
+    RingIterator tmp(*this);
+    ++pos_;
+    return tmp;
+  }
+  RingIterator& operator--() {
+    --pos_;
+    return *this;
+  }
+  RingIterator operator--(int) {
+    RingIterator tmp(*this);
+    --pos_;
+    return tmp;
+  }
+  RingIterator& operator+=(difference_type n) {
+    pos_ += n;
+    return *this;
+  }
+  RingIterator& operator-=(difference_type n) {
+    pos_ -= n;
+    return *this;
+  }
+  RingIterator operator+(difference_type n) const {
+    return RingIterator(data_, mask_, pos_ + n);
+  }
+  RingIterator operator-(difference_type n) const {
+    return RingIterator(data_, mask_, pos_ - n);
+  }
+  friend RingIterator operator+(difference_type n, const RingIterator& it) {
+    return it + n;
+  }
+  difference_type operator-(const RingIterator& other) const {
+    return static_cast<difference_type>(pos_ - other.pos_);
+  }
+
+  bool operator==(const RingIterator& other) const {
+    return pos_ == other.pos_;
+  }
+  bool operator!=(const RingIterator& other) const {
+    return pos_ != other.pos_;
+  }
+  bool operator<(const RingIterator& other) const {
+    return pos_ < other.pos_;
+  }
+  bool operator>(const RingIterator& other) const {
+    return pos_ > other.pos_;
+  }
+  bool operator<=(const RingIterator& other) const {
+    return pos_ <= other.pos_;
+  }
+  bool operator>=(const RingIterator& other) const {
+    return pos_ >= other.pos_;
+  }
+
+ private:
+  T* data_ = nullptr;
+  size_t mask_ = 0;
+  size_t pos_ = 0;
+};
+
+// A double ended queue in a ring buffer, with the ring for the first
+// Capacity elements (rounded up to a power of two) stored inline, see
+// SmallVector. Pushing or popping at either end is an index update and a
+// masked store, no allocation happens until the ring is full; then the
+// elements move to a heap ring twice the size, and shrink_to_fit() can
+// bring them back. References stay valid across pushes and pops at the
+// ends until the ring grows, iterators only until the next insertion.
+// The bulk push_back(first, last) and pop_front(n, out) copy at most two
+// contiguous runs with memcpy when T is trivially copyable.
+template <typename T, size_t Capacity>
+class FixedDeque {
+  static_assert(Capacity > 0, "FixedDeque needs a non-empty inline buffer");
+
+ public:
+  static constexpr size_t kInlineCapacity = RingSlots(Capacity);
+
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = RingIterator<T, T>;
+  using const_iterator = RingIterator<T, const T>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using allocator_type = std::allocator<T>;
+
+  FixedDeque()
+      : data_(InlineData()), head_(0), size_(0),
+        capacity_(kInlineCapacity) {}
+
+  explicit FixedDeque(size_type n) : FixedDeque() { resize(n); }
+
+  FixedDeque(size_type n, const T& value) : FixedDeque() {
+    assign(n, value);
+  }
+
+  template <typename InputIterator,
+            typename = typename std::enable_if<!std::is_integral<
+                InputIterator>::value>::type>
+  FixedDeque(InputIterator first, InputIterator last) : FixedDeque() {
+    assign(first, last);
+  }
+
+  FixedDeque(std::initializer_list<T> ilist) : FixedDeque() {
+    assign(ilist);
+  }
+
+  FixedDeque(const FixedDeque& other) : FixedDeque() {
+    assign(other.begin(), other.end());
+  }
+
+  FixedDeque(FixedDeque&& other) : FixedDeque() { TakeFrom(other); }
+
+  ~FixedDeque() {
+    clear();
+    FreeHeap();
+  }
+
+  FixedDeque& operator=(const FixedDeque& other) {
+    if (this != &other) {
+      assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  FixedDeque& operator=(FixedDeque&& other) {
+    if (this != &other) {
+      clear();
+      FreeHeap();
+      TakeFrom(other);
+    }
+    return *this;
+  }
+
+  FixedDeque& operator=(std::initializer_list<T> ilist) {
+    assign(ilist);
+    return *this;
+  }
+
+  void assign(size_type n, const T& value) {
+    clear();
+    insert(end(), n, value);
+  }
+
+  template <typename InputIterator,
+            typename = typename std::enable_if<!std::is_integral<
+                InputIterator>::value>::type>
+  void assign(InputIterator first, InputIterator last) {
+    clear();
+    push_back(first, last);
+  }
+
+  void assign(std::initializer_list<T> ilist) {
+    assign(ilist.begin(), ilist.end());
+  }
+
+  allocator_type get_allocator() const { return allocator_type(); }
+
+  // element access
+  reference at(size_type pos) {
+    if (pos >= size_) throw std::out_of_range("FixedDeque::at");
+    return *Slot(pos);
+  }
+  const_reference at(size_type pos) const {
+    if (pos >= size_) throw std::out_of_range("FixedDeque::at");
+    return *Slot(pos);
+  }
+  reference operator[](size_type pos) { return *Slot(pos); }
+  const_reference operator[](size_type pos) const { return *Slot(pos); }
+  reference front() { return data_[head_]; }
+  const_reference front() const { return data_[head_]; }
+  reference back() { return *Slot(size_ - 1); }
+  const_reference back() const { return *Slot(size_ - 1); }
+
+  // iterators
+  iterator begin() { return iterator(data_, capacity_ - 1, head_); }
+  const_iterator begin() const {
+    return const_iterator(data_, capacity_ - 1, head_);
+  }
+  const_iterator cbegin() const { return begin(); }
+  iterator end() { return begin() + size_; }
+  const_iterator end() const { return begin() + size_; }
+  const_iterator cend() const { return end(); }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator crbegin() const {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+  const_reverse_iterator crend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  // capacity
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+  size_type max_size() const { return allocator_type().max_size(); }
+  size_type capacity() const { return capacity_; }
+  bool use_stack_memory() const { return data_ == InlineData(); }
+
+  void reserve(size_type n) {
+    if (n > capacity_) {
+      Reallocate(RingSlots(n));
+    }
+  }
+
+  // go back to the inline buffer whenever the elements fit in it
+  void shrink_to_fit() {
+    if (use_stack_memory()) {
+      return;
+    }
+    size_type new_capacity = std::max(kInlineCapacity, RingSlots(size_));
+    if (new_capacity < capacity_) {
+      Reallocate(new_capacity);
+    }
+  }
+
+  // modifiers
+  void clear() {
+    Destroy(0, size_);
+    head_ = 0;
+    size_ = 0;
+  }
+
+  iterator insert(const_iterator pos, const T& value) {
+    return emplace(pos, value);
+  }
+
+  iterator insert(const_iterator pos, T&& value) {
+    return emplace(pos, std::move(value));
+  }
+
+  iterator insert(const_iterator pos, size_type n, const T& value) {
+    size_type index = pos - cbegin();
+    if (n == 0) {
+      return begin() + index;
+    }
+    T copy(value);  // value may live inside this deque
+    MakeRoom(index, n);
+    FillRoom(index, n, [&copy](T* slot) { new (slot) T(copy); });
+    size_ += n;
+    return begin() + index;
+  }
+
+  template <typename InputIterator,
+            typename = typename std::enable_if<!std::is_integral<
+                InputIterator>::value>::type>
+  iterator insert(const_iterator pos, InputIterator first,
+                  InputIterator last) {
+    return InsertRange(
+        pos, first, last,
+        typename std::iterator_traits<InputIterator>::iterator_category());
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+    return insert(pos, ilist.begin(), ilist.end());
+  }
+
+  // the elements on the shorter side of pos move
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    size_type index = pos - cbegin();
+    if (index == size_) {
+      emplace_back(std::forward<Args>(args)...);
+      return end() - 1;
+    }
+    if (index == 0) {
+      emplace_front(std::forward<Args>(args)...);
+      return begin();
+    }
+    T value(std::forward<Args>(args)...);
+    MakeRoom(index, 1);
+    FillRoom(index, 1, [&value](T* slot) { new (slot) T(std::move(value)); });
+    ++size_;
+    return begin() + index;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    size_type index = first - cbegin();
+    size_type n = last - first;
+    if (n == 0) {
+      return begin() + index;
+    }
+    if (index < size_ - index - n) {
+      std::move_backward(begin(), begin() + index, begin() + index + n);
+      Destroy(0, n);
+      head_ = (head_ + n) & (capacity_ - 1);
+    } else {
+      std::move(begin() + index + n, end(), begin() + index);
+      Destroy(size_ - n, size_);
+    }
+    size_ -= n;
+    return begin() + index;
+  }
+
+  // the hot paths are a single compare against capacity
+  void push_back(const T& value) { emplace_back(value); }
+  void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    if (size_ < capacity_) {
+      new (Slot(size_)) T(std::forward<Args>(args)...);
+      ++size_;
+    } else {
+      GrowAndEmplace(false, std::forward<Args>(args)...);
+    }
+  }
+
+  void push_front(const T& value) { emplace_front(value); }
+  void push_front(T&& value) { emplace_front(std::move(value)); }
+
+  template <typename... Args>
+  void emplace_front(Args&&... args) {
+    if (size_ < capacity_) {
+      size_type head = (head_ - 1) & (capacity_ - 1);
+      new (data_ + head) T(std::forward<Args>(args)...);
+      head_ = head;
+      ++size_;
+    } else {
+      GrowAndEmplace(true, std::forward<Args>(args)...);
+    }
+  }
+
+  void pop_back() {
+    --size_;
+    Slot(size_)->~T();
+  }
+
+  void pop_front() {
+    data_[head_].~T();
+    head_ = (head_ + 1) & (capacity_ - 1);
+    --size_;
+  }
+
+  // append a whole range, growing at most once when its size is known
+  template <typename InputIterator,
+            typename = typename std::enable_if<!std::is_integral<
+                InputIterator>::value>::type>
+  void push_back(InputIterator first, InputIterator last) {
+    AppendRange(
+        first, last,
+        typename std::iterator_traits<InputIterator>::iterator_category());
+  }
+
+  void pop_front(size_type n) {
+    assert(n <= size_);
+    Destroy(0, n);
+    head_ = (head_ + n) & (capacity_ - 1);
+    size_ -= n;
+  }
+
+  // move the first n elements to out, then drop them
+  template <typename OutputIterator>
+  OutputIterator pop_front(size_type n, OutputIterator out) {
+    assert(n <= size_);
+    out = MoveOut(n, out, std::integral_constant<
+                              bool, TriviallyRelocatable::value &&
+                                        std::is_same<OutputIterator,
+                                                     T*>::value>());
+    pop_front(n);
+    return out;
+  }
+
+  void resize(size_type n) {
+    if (n < size_) {
+      Destroy(n, size_);
+      size_ = n;
+    } else if (n > size_) {
+      reserve(n);
+      while (size_ < n) emplace_back();
+    }
+  }
+
+  void resize(size_type n, const T& value) {
+    if (n < size_) {
+      Destroy(n, size_);
+      size_ = n;
+    } else if (n > size_) {
+      insert(end(), n - size_, value);
+    }
+  }
+
+  // heap rings are exchanged by pointer, inline elements are moved
+  void swap(FixedDeque& other) {
+    if (this == &other) {
+      return;
+    }
+    if (!use_stack_memory() && !other.use_stack_memory()) {
+      std::swap(data_, other.data_);
+      std::swap(head_, other.head_);
+      std::swap(size_, other.size_);
+      std::swap(capacity_, other.capacity_);
+      return;
+    }
+    FixedDeque tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+ private:
+  using AlignedStorage =
+      typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+  using TriviallyRelocatable =
+      std::integral_constant<bool, std::is_trivially_copyable<T>::value>;
+
+  T* InlineData() { return reinterpret_cast<T*>(buffer_); }
+  const T* InlineData() const { return reinterpret_cast<const T*>(buffer_); }
+
+  T* Slot(size_type index) const {
+    return data_ + ((head_ + index) & (capacity_ - 1));
+  }
+
+  // the elements at [first, last) counted from the front
+  void Destroy(size_type first, size_type last) {
+    for (; first != last; ++first) Slot(first)->~T();
+  }
+
+  // move the element at src to the uninitialized dest and end its lifetime
+  static void Relocate(T* src, T* dest, std::true_type) {
+    std::memcpy(static_cast<void*>(dest), src, sizeof(T));
+  }
+
+  static void Relocate(T* src, T* dest, std::false_type) {
+    new (dest) T(std::move(*src));
+    src->~T();
+  }
+
+  static void Relocate(T* src, T* dest) {
+    Relocate(src, dest, TriviallyRelocatable());
+  }
+
+  // the ring in order to the start of dest, as at most two runs
+  void RelocateOut(T* dest, std::true_type) {
+    size_type first = std::min(size_, capacity_ - head_);
+    std::memcpy(static_cast<void*>(dest), data_ + head_, first * sizeof(T));
+    std::memcpy(static_cast<void*>(dest + first), data_,
+                (size_ - first) * sizeof(T));
+  }
+
+  void RelocateOut(T* dest, std::false_type) {
+    for (size_type i = 0; i < size_; ++i) Relocate(Slot(i), dest + i);
+  }
+
+  void FreeHeap() {
+    if (!use_stack_memory()) {
+      allocator_type().deallocate(data_, capacity_);
+      data_ = InlineData();
+      capacity_ = kInlineCapacity;
+      head_ = 0;
+    }
+  }
+
+  void ReplaceBuffer(T* new_data, size_type new_capacity) {
+    if (!use_stack_memory()) {
+      allocator_type().deallocate(data_, capacity_);
+    }
+    data_ = new_data;
+    capacity_ = new_capacity;
+  }
+
+  // move the elements to the start of a ring of new_capacity, which is
+  // the inline buffer when new_capacity is kInlineCapacity
+  void Reallocate(size_type new_capacity) {
+    assert(new_capacity >= size_);
+    T* new_data = new_capacity == kInlineCapacity
+                      ? InlineData()
+                      : allocator_type().allocate(new_capacity);
+    if (new_data == data_) {
+      return;
+    }
+    RelocateOut(new_data, TriviallyRelocatable());
+    ReplaceBuffer(new_data, new_capacity);
+    head_ = 0;
+  }
+
+  // build the new element before relocating, args may point into us; a
+  // new front goes to the last slot of the bigger ring
+  template <typename... Args>
+  void GrowAndEmplace(bool at_front, Args&&... args) {
+    size_type new_capacity = capacity_ * 2;
+    T* new_data = allocator_type().allocate(new_capacity);
+    size_type slot = at_front ? new_capacity - 1 : size_;
+    try {
+      new (new_data + slot) T(std::forward<Args>(args)...);
+    } catch (...) {
+      allocator_type().deallocate(new_data, new_capacity);
+      throw;
+    }
+    RelocateOut(new_data, TriviallyRelocatable());
+    ReplaceBuffer(new_data, new_capacity);
+    head_ = at_front ? slot : 0;
+    ++size_;
+  }
+
+  // open a gap of n uninitialized slots at index by moving the elements on
+  // the shorter side of it, size_ is left untouched
+  void MakeRoom(size_type index, size_type n) {
+    reserve(size_ + n);
+    if (index < size_ - index) {
+      head_ = (head_ - n) & (capacity_ - 1);
+      for (size_type i = 0; i < index; ++i) Relocate(Slot(i + n), Slot(i));
+    } else {
+      for (size_type i = size_; i-- > index;) Relocate(Slot(i), Slot(i + n));
+    }
+  }
+
+  // the reverse of MakeRoom(index, n)
+  void CloseRoom(size_type index, size_type n) {
+    if (index < size_ - index) {
+      for (size_type i = index; i-- > 0;) Relocate(Slot(i), Slot(i + n));
+      head_ = (head_ + n) & (capacity_ - 1);
+    } else {
+      for (size_type i = index; i < size_; ++i) Relocate(Slot(i + n), Slot(i));
+    }
+  }
+
+  // build(slot) constructs each element of the gap MakeRoom(index, n)
+  // opened in turn; if one throws, those built are destroyed and the gap
+  // closes again, which leaves the deque as it was
+  template <typename Build>
+  void FillRoom(size_type index, size_type n, Build build) {
+    size_type built = 0;
+    try {
+      for (; built < n; ++built) build(Slot(index + built));
+    } catch (...) {
+      Destroy(index, index + built);
+      CloseRoom(index, n);
+      throw;
+    }
+  }
+
+  template <typename InputIterator>
+  iterator InsertRange(const_iterator pos, InputIterator first,
+                       InputIterator last, std::input_iterator_tag) {
+    size_type index = pos - cbegin();
+    for (size_type i = index; first != last; ++first, ++i) {
+      emplace(begin() + i, *first);
+    }
+    return begin() + index;
+  }
+
+  template <typename ForwardIterator>
+  iterator InsertRange(const_iterator pos, ForwardIterator first,
+                       ForwardIterator last, std::forward_iterator_tag) {
+    size_type index = pos - cbegin();
+    size_type n = std::distance(first, last);
+    if (n == 0) {
+      return begin() + index;
+    }
+    MakeRoom(index, n);
+    FillRoom(index, n, [&first](T* slot) {
+      new (slot) T(*first);
+      ++first;
+    });
+    size_ += n;
+    return begin() + index;
+  }
+
+  template <typename InputIterator>
+  void AppendRange(InputIterator first, InputIterator last,
+                   std::input_iterator_tag) {
+    for (; first != last; ++first) emplace_back(*first);
+  }
+
+  template <typename ForwardIterator>
+  void AppendRange(ForwardIterator first, ForwardIterator last,
+                   std::forward_iterator_tag) {
+    size_type n = std::distance(first, last);
+    reserve(size_ + n);
+    CopyIn(first, n,
+           std::integral_constant<
+               bool, TriviallyRelocatable::value &&
+                         std::is_pointer<ForwardIterator>::value &&
+                         std::is_same<typename std::remove_cv<
+                                          typename std::remove_pointer<
+                                              ForwardIterator>::type>::type,
+                                      T>::value>());
+    size_ += n;
+  }
+
+  // T is trivially copyable and first points at T, the free slots after
+  // the back are at most two runs
+  template <typename Pointer>
+  void CopyIn(Pointer first, size_type n, std::true_type) {
+    size_type tail = (head_ + size_) & (capacity_ - 1);
+    size_type run = std::min(n, capacity_ - tail);
+    std::memcpy(static_cast<void*>(data_ + tail), first, run * sizeof(T));
+    std::memcpy(static_cast<void*>(data_), first + run,
+                (n - run) * sizeof(T));
+  }
+
+  template <typename ForwardIterator>
+  void CopyIn(ForwardIterator first, size_type n, std::false_type) {
+    std::uninitialized_copy_n(first, n, end());
+  }
+
+  T* MoveOut(size_type n, T* out, std::true_type) {
+    size_type run = std::min(n, capacity_ - head_);
+    std::memcpy(static_cast<void*>(out), data_ + head_, run * sizeof(T));
+    std::memcpy(static_cast<void*>(out + run), data_, (n - run) * sizeof(T));
+    return out + n;
+  }
+
+  template <typename OutputIterator>
+  OutputIterator MoveOut(size_type n, OutputIterator out, std::false_type) {
+    return std::move(begin(), begin() + n, out);
+  }
+
+  // steal other's heap ring, or relocate its inline elements into ours
+  void TakeFrom(FixedDeque& other) {
+    if (other.use_stack_memory()) {
+      other.RelocateOut(data_, TriviallyRelocatable());
+    } else {
+      data_ = other.data_;
+      head_ = other.head_;
+      capacity_ = other.capacity_;
+      other.data_ = other.InlineData();
+      other.capacity_ = kInlineCapacity;
+    }
+    other.head_ = 0;
+    size_ = other.size_;
+    other.size_ = 0;
+  }
+
+  T* data_;
+  size_type head_;
+  size_type size_;
+  size_type capacity_;
+  AlignedStorage buffer_[kInlineCapacity];
+};
+
+template <typename T, size_t Capacity>
+constexpr size_t FixedDeque<T, Capacity>::kInlineCapacity;
+
+// the same container under the name FIFO code looks for
+template <typename T, size_t Capacity>
+using FixedRingBuffer = FixedDeque<T, Capacity>;
+
+template <typename T, size_t Capacity>
+void swap(FixedDeque<T, Capacity>& lhs, FixedDeque<T, Capacity>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2>
+inline bool operator==(const FixedDeque<T, Capacity1>& lhs,
+                       const FixedDeque<T, Capacity2>& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs));
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2>
+inline bool operator!=(const FixedDeque<T, Capacity1>& lhs,
+                       const FixedDeque<T, Capacity2>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2>
+inline bool operator<(const FixedDeque<T, Capacity1>& lhs,
+                      const FixedDeque<T, Capacity2>& rhs) {
+  return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
+                                      std::begin(rhs), std::end(rhs));
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2>
+inline bool operator<=(const FixedDeque<T, Capacity1>& lhs,
+                       const FixedDeque<T, Capacity2>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2>
+inline bool operator>(const FixedDeque<T, Capacity1>& lhs,
+                      const FixedDeque<T, Capacity2>& rhs) {
+  return rhs < lhs;
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2>
+inline bool operator>=(const FixedDeque<T, Capacity1>& lhs,
+                       const FixedDeque<T, Capacity2>& rhs) {
+  return !(lhs < rhs);
+}
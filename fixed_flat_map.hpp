@@ -0,0 +1,474 @@
+#pragma once
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+#include "small_vector.hpp"
+#include "utils.hpp"
+
+// Random access iterator over the parallel key and value arrays of a
+// FixedFlatMap. Dereferencing yields a pair of references, so the key and
+// value arrays never have to be interleaved.
+template <typename KeyType, typename ValueType>
+class FlatMapIterator {
+ public:
+  template <typename K, typename V>
+  friend class FlatMapIterator;
+
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type =
+      std::pair<KeyType, typename std::remove_const<ValueType>::type>;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::pair<const KeyType&, ValueType&>;
+
+  struct pointer {
+    reference ref_;
+    constexpr const reference* operator->() const { return &ref_; }
+  };
+
+  constexpr FlatMapIterator() : key_(nullptr), value_(nullptr) {}
+
+  constexpr FlatMapIterator(const KeyType* key, ValueType* value)
+      : key_(key), value_(value) {}
+
+  // iterator to const_iterator
+  template <typename V, typename = typename std::enable_if<
+                            std::is_same<const V, ValueType>::value>::type>
+  constexpr FlatMapIterator(const FlatMapIterator<KeyType, V>& other)
+      : key_(other.key_), value_(other.value_) {}
+
+  constexpr reference operator*() const { return reference(*key_, *value_); }
+  constexpr pointer operator->() const { return pointer{**this}; }
+  constexpr reference operator[](difference_type n) const {
+    return reference(key_[n], value_[n]);
+  }
+
+  FlatMapIterator& operator++() {
+    ++key_;
+    ++value_;
+    return *this;
+  }
+  FlatMapIterator operator++(int) {
+    FlatMapIterator tmp(*this);
+    ++*this;
+    return tmp;
+  }
+  FlatMapIterator& operator--() {
+    --key_;
+    --value_;
+    return *this;
+  }
+  FlatMapIterator operator--(int) {
+    FlatMapIterator tmp(*this);
+    --*this;
+    return tmp;
+  }
+  FlatMapIterator& operator+=(difference_type n) {
+    key_ += n;
+    value_ += n;
+    return *this;
+  }
+  FlatMapIterator& operator-=(difference_type n) { return *this += -n; }
+  FlatMapIterator operator+(difference_type n) const {
+    return FlatMapIterator(key_ + n, value_ + n);
+  }
+  FlatMapIterator operator-(difference_type n) const {
+    return FlatMapIterator(key_ - n, value_ - n);
+  }
+  friend FlatMapIterator operator+(difference_type n,
+                                   const FlatMapIterator& it) {
+    return it + n;
+  }
+
+  template <typename V>
+  difference_type operator-(const FlatMapIterator<KeyType, V>& other) const {
+    return key_ - other.key_;
+  }
+  template <typename V>
+  constexpr bool operator==(const FlatMapIterator<KeyType, V>& other) const {
+    return key_ == other.key_;
+  }
+  template <typename V>
+  constexpr bool operator!=(const FlatMapIterator<KeyType, V>& other) const {
+    return key_ != other.key_;
+  }
+  template <typename V>
+  bool operator<(const FlatMapIterator<KeyType, V>& other) const {
+    return key_ < other.key_;
+  }
+  template <typename V>
+  bool operator>(const FlatMapIterator<KeyType, V>& other) const {
+    return key_ > other.key_;
+  }
+  template <typename V>
+  bool operator<=(const FlatMapIterator<KeyType, V>& other) const {
+    return key_ <= other.key_;
+  }
+  template <typename V>
+  bool operator>=(const FlatMapIterator<KeyType, V>& other) const {
+    return key_ >= other.key_;
+  }
+
+  constexpr const KeyType* key_ptr() const { return key_; }
+  constexpr ValueType* value_ptr() const { return value_; }
+
+ private:
+  const KeyType* key_;
+  ValueType* value_;
+};
+
+// A sorted associative array with unique keys. Keys and values are kept in
+// two SmallVector, so up to Capacity entries live inline, and lookups only
+// touch the contiguous key array.
+template <typename KeyType, typename ValueType, size_t Capacity,
+          typename Compare = std::less<KeyType>>
+class FixedFlatMap {
+ public:
+  using KeyContainer = SmallVector<KeyType, Capacity>;
+  using ValueContainer = SmallVector<ValueType, Capacity>;
+
+  using key_type = KeyType;
+  using mapped_type = ValueType;
+  using value_type = std::pair<KeyType, ValueType>;
+  using key_compare = Compare;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::pair<const KeyType&, ValueType&>;
+  using const_reference = std::pair<const KeyType&, const ValueType&>;
+  using iterator = FlatMapIterator<KeyType, ValueType>;
+  using const_iterator = FlatMapIterator<KeyType, const ValueType>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  struct value_compare {
+    bool operator()(const_reference lhs, const_reference rhs) const {
+      return comp_(lhs.first, rhs.first);
+    }
+    Compare comp_;
+  };
+
+  FixedFlatMap() : FixedFlatMap(Compare()) {}
+
+  explicit FixedFlatMap(const Compare& comp) : comp_(comp) {}
+
+  template <typename InputIterator>
+  FixedFlatMap(InputIterator first, InputIterator last,
+               const Compare& comp = Compare())
+      : FixedFlatMap(comp) {
+    insert(first, last);
+  }
+
+  template <typename InputIterator>
+  FixedFlatMap(sorted_unique_t, InputIterator first, InputIterator last,
+               const Compare& comp = Compare())
+      : FixedFlatMap(comp) {
+    insert(sorted_unique, first, last);
+  }
+
+  FixedFlatMap(std::initializer_list<value_type> init) : FixedFlatMap() {
+    insert(init);
+  }
+
+  FixedFlatMap(const FixedFlatMap& other) = default;
+  FixedFlatMap(FixedFlatMap&& other) = default;
+  ~FixedFlatMap() = default;
+
+  FixedFlatMap& operator=(const FixedFlatMap& other) = default;
+  FixedFlatMap& operator=(FixedFlatMap&& other) = default;
+
+  FixedFlatMap& operator=(std::initializer_list<value_type> init) {
+    clear();
+    insert(init);
+    return *this;
+  }
+
+  // iterators
+  iterator begin() { return iterator(keys_.data(), values_.data()); }
+  const_iterator begin() const {
+    return const_iterator(keys_.data(), values_.data());
+  }
+  const_iterator cbegin() const { return begin(); }
+  iterator end() { return begin() + size(); }
+  const_iterator end() const { return begin() + size(); }
+  const_iterator cend() const { return end(); }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  // capacity
+  bool empty() const { return keys_.empty(); }
+  size_type size() const { return keys_.size(); }
+  size_type max_size() const { return keys_.max_size(); }
+  size_type capacity() const { return keys_.capacity(); }
+  void reserve(size_type n) {
+    keys_.reserve(n);
+    values_.reserve(n);
+  }
+  void shrink_to_fit() {
+    keys_.shrink_to_fit();
+    values_.shrink_to_fit();
+  }
+
+  const KeyContainer& keys() const { return keys_; }
+  const ValueContainer& values() const { return values_; }
+
+  // element access
+  ValueType& at(const KeyType& key) {
+    iterator it = find(key);
+    if (it == end()) throw std::out_of_range("FixedFlatMap::at");
+    return it->second;
+  }
+  const ValueType& at(const KeyType& key) const {
+    const_iterator it = find(key);
+    if (it == end()) throw std::out_of_range("FixedFlatMap::at");
+    return it->second;
+  }
+  ValueType& operator[](const KeyType& key) {
+    return try_emplace(key).first->second;
+  }
+
+  // modifiers
+  void clear() {
+    keys_.clear();
+    values_.clear();
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return try_emplace(value.first, value.second);
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return try_emplace(std::move(value.first), std::move(value.second));
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    return insert(value_type(std::forward<Args>(args)...));
+  }
+
+  template <typename K, typename... Args>
+  std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    size_type index = LowerBoundIndex(key);
+    if (index != size() && !comp_(key, keys_[index])) {
+      return std::make_pair(begin() + index, false);
+    }
+    values_.emplace(values_.begin() + index, std::forward<Args>(args)...);
+    keys_.emplace(keys_.begin() + index, std::forward<K>(key));
+    return std::make_pair(begin() + index, true);
+  }
+
+  // unsorted input is sorted on the side, then merged in one pass
+  template <typename InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    SmallVector<value_type, Capacity> entries(first, last);
+    std::stable_sort(entries.begin(), entries.end(),
+                     [this](const value_type& lhs, const value_type& rhs) {
+                       return comp_(lhs.first, rhs.first);
+                     });
+    KeyContainer new_keys;
+    ValueContainer new_values;
+    for (auto& entry : entries) {
+      // the first of equivalent keys wins, as with repeated insert()
+      if (new_keys.empty() || comp_(new_keys.back(), entry.first)) {
+        new_keys.push_back(std::move(entry.first));
+        new_values.push_back(std::move(entry.second));
+      }
+    }
+    MergeSorted(new_keys, new_values);
+  }
+
+  // O(size() + distance(first, last)) merge of an already sorted range
+  template <typename InputIterator>
+  void insert(sorted_unique_t, InputIterator first, InputIterator last) {
+    KeyContainer new_keys;
+    ValueContainer new_values;
+    for (; first != last; ++first) {
+      new_keys.push_back(first->first);
+      new_values.push_back(first->second);
+    }
+    MergeSorted(new_keys, new_values);
+  }
+
+  void insert(std::initializer_list<value_type> init) {
+    insert(init.begin(), init.end());
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    size_type index = first - cbegin();
+    size_type count = last - first;
+    keys_.erase(keys_.begin() + index, keys_.begin() + index + count);
+    values_.erase(values_.begin() + index, values_.begin() + index + count);
+    return begin() + index;
+  }
+
+  size_type erase(const KeyType& key) {
+    const_iterator it = find(key);
+    if (it == cend()) {
+      return 0;
+    }
+    erase(it);
+    return 1;
+  }
+
+  void swap(FixedFlatMap& other) {
+    keys_.swap(other.keys_);
+    values_.swap(other.values_);
+    std::swap(comp_, other.comp_);
+  }
+
+  // lookup
+  size_type count(const KeyType& key) const { return find(key) != end(); }
+
+  iterator find(const KeyType& key) {
+    size_type index = FindIndex(key);
+    return begin() + index;
+  }
+  const_iterator find(const KeyType& key) const {
+    size_type index = FindIndex(key);
+    return begin() + index;
+  }
+
+  iterator lower_bound(const KeyType& key) {
+    return begin() + LowerBoundIndex(key);
+  }
+  const_iterator lower_bound(const KeyType& key) const {
+    return begin() + LowerBoundIndex(key);
+  }
+  iterator upper_bound(const KeyType& key) {
+    return begin() + UpperBoundIndex(key);
+  }
+  const_iterator upper_bound(const KeyType& key) const {
+    return begin() + UpperBoundIndex(key);
+  }
+  std::pair<iterator, iterator> equal_range(const KeyType& key) {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+  std::pair<const_iterator, const_iterator> equal_range(
+      const KeyType& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  key_compare key_comp() const { return comp_; }
+  value_compare value_comp() const { return value_compare{comp_}; }
+
+ private:
+  size_type LowerBoundIndex(const KeyType& key) const {
+    return BranchlessLowerBound(keys_.data(), keys_.size(), key, comp_);
+  }
+
+  size_type UpperBoundIndex(const KeyType& key) const {
+    return std::upper_bound(keys_.begin(), keys_.end(), key, comp_) -
+           keys_.begin();
+  }
+
+  // index of key, or size() when it is absent
+  size_type FindIndex(const KeyType& key) const {
+    size_type index = LowerBoundIndex(key);
+    if (index != size() && comp_(key, keys_[index])) {
+      return size();
+    }
+    return index;
+  }
+
+  // merge sorted unique new entries from the back, so every element moves
+  // at most once; keys already present keep their old value
+  void MergeSorted(KeyContainer& new_keys, ValueContainer& new_values) {
+    size_type old_size = size();
+    size_type dest = old_size + new_keys.size();
+    size_type i = old_size;
+    size_type j = new_keys.size();
+    if (j == 0) {
+      return;
+    }
+    keys_.resize(dest);
+    values_.resize(dest);
+    while (j > 0) {
+      if (i > 0 && comp_(new_keys[j - 1], keys_[i - 1])) {
+        --i;
+        --dest;
+        keys_[dest] = std::move(keys_[i]);
+        values_[dest] = std::move(values_[i]);
+      } else if (i > 0 && !comp_(keys_[i - 1], new_keys[j - 1])) {
+        --j;
+      } else {
+        --j;
+        --dest;
+        keys_[dest] = std::move(new_keys[j]);
+        values_[dest] = std::move(new_values[j]);
+      }
+    }
+    // close the gap left by the duplicates that were dropped
+    keys_.erase(keys_.begin() + i, keys_.begin() + dest);
+    values_.erase(values_.begin() + i, values_.begin() + dest);
+  }
+
+  KeyContainer keys_;
+  ValueContainer values_;
+  Compare comp_;
+};
+
+template <typename KeyType, typename ValueType, size_t Capacity,
+          typename Compare>
+void swap(FixedFlatMap<KeyType, ValueType, Capacity, Compare>& lhs,
+          FixedFlatMap<KeyType, ValueType, Capacity, Compare>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename KeyType, typename ValueType, size_t Capacity1,
+          size_t Capacity2, typename Compare>
+inline bool operator==(
+    const FixedFlatMap<KeyType, ValueType, Capacity1, Compare>& lhs,
+    const FixedFlatMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+  return lhs.keys() == rhs.keys() && lhs.values() == rhs.values();
+}
+
+template <typename KeyType, typename ValueType, size_t Capacity1,
+          size_t Capacity2, typename Compare>
+inline bool operator!=(
+    const FixedFlatMap<KeyType, ValueType, Capacity1, Compare>& lhs,
+    const FixedFlatMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename KeyType, typename ValueType, size_t Capacity1,
+          size_t Capacity2, typename Compare>
+inline bool operator<(
+    const FixedFlatMap<KeyType, ValueType, Capacity1, Compare>& lhs,
+    const FixedFlatMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+  return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
+                                      std::begin(rhs), std::end(rhs));
+}
+
+template <typename KeyType, typename ValueType, size_t Capacity1,
+          size_t Capacity2, typename Compare>
+inline bool operator<=(
+    const FixedFlatMap<KeyType, ValueType, Capacity1, Compare>& lhs,
+    const FixedFlatMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename KeyType, typename ValueType, size_t Capacity1,
+          size_t Capacity2, typename Compare>
+inline bool operator>(
+    const FixedFlatMap<KeyType, ValueType, Capacity1, Compare>& lhs,
+    const FixedFlatMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+  return rhs < lhs;
+}
+
+template <typename KeyType, typename ValueType, size_t Capacity1,
+          size_t Capacity2, typename Compare>
+inline bool operator>=(
+    const FixedFlatMap<KeyType, ValueType, Capacity1, Compare>& lhs,
+    const FixedFlatMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+  return !(lhs < rhs);
+}
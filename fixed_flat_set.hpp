@@ -0,0 +1,256 @@
+#pragma once
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include "small_vector.hpp"
+#include "utils.hpp"
+
+// A sorted set with unique keys stored in one SmallVector, so up to
+// Capacity keys live inline and lookups are binary searches over
+// contiguous memory.
+template <typename T, size_t Capacity, typename Compare = std::less<T>>
+class FixedFlatSet {
+ public:
+  using KeyContainer = SmallVector<T, Capacity>;
+
+  using key_type = T;
+  using value_type = T;
+  using key_compare = Compare;
+  using value_compare = Compare;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = const T&;
+  using const_reference = const T&;
+  using pointer = const T*;
+  using const_pointer = const T*;
+  using iterator = const T*;
+  using const_iterator = const T*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  FixedFlatSet() : FixedFlatSet(Compare()) {}
+
+  explicit FixedFlatSet(const Compare& comp) : comp_(comp) {}
+
+  template <typename InputIterator>
+  FixedFlatSet(InputIterator first, InputIterator last,
+               const Compare& comp = Compare())
+      : FixedFlatSet(comp) {
+    insert(first, last);
+  }
+
+  template <typename InputIterator>
+  FixedFlatSet(sorted_unique_t, InputIterator first, InputIterator last,
+               const Compare& comp = Compare())
+      : FixedFlatSet(comp) {
+    insert(sorted_unique, first, last);
+  }
+
+  FixedFlatSet(std::initializer_list<T> init) : FixedFlatSet() {
+    insert(init);
+  }
+
+  FixedFlatSet(const FixedFlatSet& other) = default;
+  FixedFlatSet(FixedFlatSet&& other) = default;
+  ~FixedFlatSet() = default;
+
+  FixedFlatSet& operator=(const FixedFlatSet& other) = default;
+  FixedFlatSet& operator=(FixedFlatSet&& other) = default;
+
+  FixedFlatSet& operator=(std::initializer_list<T> init) {
+    clear();
+    insert(init);
+    return *this;
+  }
+
+  // iterators
+  iterator begin() const { return keys_.begin(); }
+  const_iterator cbegin() const { return keys_.begin(); }
+  iterator end() const { return keys_.end(); }
+  const_iterator cend() const { return keys_.end(); }
+  reverse_iterator rbegin() const { return reverse_iterator(end()); }
+  const_reverse_iterator crbegin() const { return rbegin(); }
+  reverse_iterator rend() const { return reverse_iterator(begin()); }
+  const_reverse_iterator crend() const { return rend(); }
+
+  // capacity
+  bool empty() const { return keys_.empty(); }
+  size_type size() const { return keys_.size(); }
+  size_type max_size() const { return keys_.max_size(); }
+  size_type capacity() const { return keys_.capacity(); }
+  void reserve(size_type n) { keys_.reserve(n); }
+  void shrink_to_fit() { keys_.shrink_to_fit(); }
+
+  const KeyContainer& keys() const { return keys_; }
+
+  // modifiers
+  void clear() { keys_.clear(); }
+
+  std::pair<iterator, bool> insert(const T& value) {
+    return emplace(value);
+  }
+
+  std::pair<iterator, bool> insert(T&& value) {
+    return emplace(std::move(value));
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    T value(std::forward<Args>(args)...);
+    size_type index = LowerBoundIndex(value);
+    if (index != size() && !comp_(value, keys_[index])) {
+      return std::make_pair(begin() + index, false);
+    }
+    keys_.insert(keys_.begin() + index, std::move(value));
+    return std::make_pair(begin() + index, true);
+  }
+
+  // unsorted input is sorted on the side, then merged in one pass
+  template <typename InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    KeyContainer new_keys(first, last);
+    std::stable_sort(new_keys.begin(), new_keys.end(), comp_);
+    new_keys.erase(std::unique(new_keys.begin(), new_keys.end(),
+                               [this](const T& lhs, const T& rhs) {
+                                 return !comp_(lhs, rhs);
+                               }),
+                   new_keys.end());
+    MergeSorted(new_keys);
+  }
+
+  // O(size() + distance(first, last)) merge of an already sorted range
+  template <typename InputIterator>
+  void insert(sorted_unique_t, InputIterator first, InputIterator last) {
+    KeyContainer new_keys(first, last);
+    MergeSorted(new_keys);
+  }
+
+  void insert(std::initializer_list<T> init) {
+    insert(init.begin(), init.end());
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    return keys_.erase(first, last);
+  }
+
+  size_type erase(const T& key) {
+    const_iterator it = find(key);
+    if (it == cend()) {
+      return 0;
+    }
+    erase(it);
+    return 1;
+  }
+
+  void swap(FixedFlatSet& other) {
+    keys_.swap(other.keys_);
+    std::swap(comp_, other.comp_);
+  }
+
+  // lookup
+  size_type count(const T& key) const { return find(key) != end(); }
+
+  const_iterator find(const T& key) const {
+    const_iterator it = lower_bound(key);
+    if (it != end() && comp_(key, *it)) {
+      return end();
+    }
+    return it;
+  }
+
+  const_iterator lower_bound(const T& key) const {
+    return begin() + BranchlessLowerBound(keys_.data(), size(), key, comp_);
+  }
+  const_iterator upper_bound(const T& key) const {
+    return std::upper_bound(begin(), end(), key, comp_);
+  }
+  std::pair<const_iterator, const_iterator> equal_range(const T& key) const {
+    return std::make_pair(lower_bound(key), upper_bound(key));
+  }
+
+  key_compare key_comp() const { return comp_; }
+  value_compare value_comp() const { return comp_; }
+
+ private:
+  size_type LowerBoundIndex(const T& key) const {
+    return lower_bound(key) - begin();
+  }
+
+  // merge sorted unique new keys from the back, so every key moves at most
+  // once; keys already present are kept
+  void MergeSorted(KeyContainer& new_keys) {
+    size_type old_size = size();
+    size_type dest = old_size + new_keys.size();
+    size_type i = old_size;
+    size_type j = new_keys.size();
+    if (j == 0) {
+      return;
+    }
+    keys_.resize(dest);
+    while (j > 0) {
+      if (i > 0 && comp_(new_keys[j - 1], keys_[i - 1])) {
+        --i;
+        --dest;
+        keys_[dest] = std::move(keys_[i]);
+      } else if (i > 0 && !comp_(keys_[i - 1], new_keys[j - 1])) {
+        --j;
+      } else {
+        --j;
+        --dest;
+        keys_[dest] = std::move(new_keys[j]);
+      }
+    }
+    // close the gap left by the duplicates that were dropped
+    keys_.erase(keys_.begin() + i, keys_.begin() + dest);
+  }
+
+  KeyContainer keys_;
+  Compare comp_;
+};
+
+template <typename T, size_t Capacity, typename Compare>
+void swap(FixedFlatSet<T, Capacity, Compare>& lhs,
+          FixedFlatSet<T, Capacity, Compare>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
+inline bool operator==(const FixedFlatSet<T, Capacity1, Compare>& lhs,
+                       const FixedFlatSet<T, Capacity2, Compare>& rhs) {
+  return lhs.keys() == rhs.keys();
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
+inline bool operator!=(const FixedFlatSet<T, Capacity1, Compare>& lhs,
+                       const FixedFlatSet<T, Capacity2, Compare>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
+inline bool operator<(const FixedFlatSet<T, Capacity1, Compare>& lhs,
+                      const FixedFlatSet<T, Capacity2, Compare>& rhs) {
+  return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
+                                      std::begin(rhs), std::end(rhs));
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
+inline bool operator<=(const FixedFlatSet<T, Capacity1, Compare>& lhs,
+                       const FixedFlatSet<T, Capacity2, Compare>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
+inline bool operator>(const FixedFlatSet<T, Capacity1, Compare>& lhs,
+                      const FixedFlatSet<T, Capacity2, Compare>& rhs) {
+  return rhs < lhs;
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
+inline bool operator>=(const FixedFlatSet<T, Capacity1, Compare>& lhs,
+                       const FixedFlatSet<T, Capacity2, Compare>& rhs) {
+  return !(lhs < rhs);
+}
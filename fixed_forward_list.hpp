@@ -1,13 +1,16 @@
 #pragma once
 #include <forward_list>
+#include <vector>
+#include <iterator>
 #include <algorithm>
+#include <functional>
 #include "stack_allocator.hpp"
 
 // XXX
 template <typename T>
 using __std_forward_list_node_t = std::_Fwd_list_node<T>;
 
-template <typename T, size_t Capacity>
+template <typename T, size_t Capacity, typename Slabs = HeapSlabs>
 class FixedForwardList
     : public std::forward_list<
           T, StackAllocator<__std_forward_list_node_t<T>, Capacity>> {
@@ -76,19 +79,25 @@ class FixedForwardList
   FixedForwardList& operator=(FixedForwardList&& other) {
     assign(other.begin(), other.end());
     other.clear();
+    return *this;
   }
 
-  FixedForwardList& operator=(std::initializer_list<T> ilist) { assign(ilist); }
+  FixedForwardList& operator=(std::initializer_list<T> ilist) {
+    assign(ilist);
+    return *this;
+  }
 
   template <size_t Cap>
   FixedForwardList& operator=(const FixedForwardList<T, Cap>& other) {
     assign(other.begin(), other.end());
+    return *this;
   }
 
   template <size_t Cap>
   FixedForwardList& operator=(FixedForwardList<T, Cap>&& other) {
     assign(other.begin(), other.end());
     other.clear();
+    return *this;
   }
 
   FixedForwardList(const std::forward_list<T>& flist) : FixedForwardList() {
@@ -102,62 +111,260 @@ class FixedForwardList
 
   FixedForwardList& operator=(const std::forward_list<T>& flist) {
     assign(flist.begin(), flist.end());
+    return *this;
   }
 
   FixedForwardList& operator=(std::forward_list<T>&& flist) {
     assign(flist.begin(), flist.end());
     flist.clear();
+    return *this;
   }
 
+  ~FixedForwardList() { BaseType::clear(); }
+
+  // trade the lists and then the node pools, no element is copied; a node
+  // does not know who links to it, so the links are fixed by one walk of
+  // each list instead of per moved node. When moving a value may throw
+  // the lists are copied instead.
   void swap(FixedForwardList& other) {
-    if (this != &other)
-      FixedSwap(*this, other);
+    if (this == &other) {
+      return;
+    }
+    SwapFixed(*this, other, [this, &other] {
+      BaseType::swap(other);
+      stack_data_.SwapWith(other.stack_data_,
+                           [](std::_Fwd_list_node_base*,
+                              std::_Fwd_list_node_base*, const Relocation&) {});
+      RelocateLinks(Relocation(other.stack_data_, stack_data_));
+      other.RelocateLinks(Relocation(stack_data_, other.stack_data_));
+    }, NodesRelocatable<typename Allocator::value_type>());
   }
 
-  // TODO add this series of operations
-  /*
-  void merge(FixedForwardList& other);
+  // lay the nodes out in list order at the front of the inline buffer, so
+  // iterating reads memory sequentially; invalidates iterators, does
+  // nothing when moving a value may throw
+  void compact() {
+    if (!NodesRelocatable<typename Allocator::value_type>::value) {
+      return;
+    }
+    using NodePtr = typename Allocator::pointer;
+    std::vector<NodePtr> nodes;
+    for (auto it = begin(); it != end(); ++it) {
+      nodes.push_back(static_cast<NodePtr>(it._M_node));
+    }
+    stack_data_.Compact(nodes.data(), nodes.size());
+    std::_Fwd_list_node_base* prev = BaseType::before_begin()._M_node;
+    for (NodePtr node : nodes) {
+      prev->_M_next = node;
+      prev = node;
+    }
+    prev->_M_next = nullptr;
+  }
 
-  void merge(FixedForwardList&& other);
+  // Nodes in other's slabs are relinked as they are, the slabs become
+  // ours; values in other's inline buffer are moved (or copied, when the
+  // move may throw) into nodes of ours, which are the only allocation.
+  // Merging two sorted lists is O(n).
+  void merge(FixedForwardList& other) { merge(other, std::less<T>()); }
+
+  void merge(FixedForwardList&& other) { merge(other, std::less<T>()); }
 
   template <typename Compare>
-  void merge(FixedForwardList& other, Compare comp);
+  void merge(FixedForwardList& other, Compare comp) {
+    if (this == &other) {
+      return;
+    }
+    TakeNodes(other);
+    try {
+      BaseType::merge(other, comp);
+    } catch (...) {
+      // the nodes left in other are ours by now, they must stay with us
+      BaseType::splice_after(Last(), other);
+      throw;
+    }
+  }
 
   template <typename Compare>
-  void merge(FixedForwardList&& other, Compare comp);
+  void merge(FixedForwardList&& other, Compare comp) {
+    merge(other, comp);
+  }
+
+  void splice_after(const_iterator pos, FixedForwardList& other) {
+    if (this == &other || other.empty()) {
+      return;
+    }
+    TakeNodes(other);
+    BaseType::splice_after(pos, other);
+  }
 
-  void splice_after(const_iterator pos,
-                    FixedForwardList& other);
-  
-  void splice_after(const_iterator pos,
-                    FixedForwardList&& other);
+  void splice_after(const_iterator pos, FixedForwardList&& other) {
+    splice_after(pos, other);
+  }
 
+  // a single node cannot leave the pool that owns its slab, so the value
+  // after it is moved into a node of ours
   void splice_after(const_iterator pos, FixedForwardList& other,
-                    const_iterator it);
+                    const_iterator it) {
+    if (this == &other) {
+      BaseType::splice_after(pos, other, it);
+      return;
+    }
+    MoveAfter(pos, other, it);
+  }
 
   void splice_after(const_iterator pos, FixedForwardList&& other,
-                    const_iterator it);
+                    const_iterator it) {
+    splice_after(pos, other, it);
+  }
 
+  // the values in (first, last), one move each; if one throws, the ones
+  // moved so far are here and the rest still in other
   void splice_after(const_iterator pos, FixedForwardList& other,
-                    const_iterator first, const_iterator last);
+                    const_iterator first, const_iterator last) {
+    if (this == &other) {
+      BaseType::splice_after(pos, other, first, last);
+      return;
+    }
+    while (std::next(first) != last) {
+      pos = MoveAfter(pos, other, first);
+    }
+  }
 
   void splice_after(const_iterator pos, FixedForwardList&& other,
-                    const_iterator first, const_iterator last);
-  */
+                    const_iterator first, const_iterator last) {
+    splice_after(pos, other, first, last);
+  }
 
  private:
-  ReservsedMemoryType stack_data_;
+  using Relocation = typename ReservsedMemoryType::Relocation;
+
+  using Node = __std_forward_list_node_t<T>;
+  using NodeBase = std::_Fwd_list_node_base;
+
+  const_iterator Last() const {
+    const_iterator last = BaseType::before_begin();
+    for (const_iterator it = begin(); it != end(); ++it) last = it;
+    return last;
+  }
+
+  // move the value after it in other into a new node after pos
+  iterator MoveAfter(const_iterator pos, FixedForwardList& other,
+                     const_iterator it) {
+    iterator value(const_cast<NodeBase*>(std::next(it)._M_node));
+    iterator moved = BaseType::insert_after(pos, std::move(*value));
+    other.erase_after(it);
+    return moved;
+  }
+
+  // Make every node of other one of ours, so that its whole chain can be
+  // relinked into this list: the slabs of other are adopted, and the
+  // values in its inline buffer are moved into nodes of ours, or copied
+  // when their move may throw. The nodes are taken and the values built
+  // before anything is relinked, so that a throw leaves both lists
+  // untouched. If the pools draw slabs from different arenas every value
+  // is moved.
+  void TakeNodes(FixedForwardList& other) {
+    bool adopt = stack_data_.CanAdopt(other.stack_data_);
+    Allocator alloc(&stack_data_);
+    NodeBase* spare = nullptr;
+    size_t slab_nodes = 0;
+    try {
+      for (NodeBase* node = other.before_begin()._M_node->_M_next;
+           node != nullptr; node = node->_M_next) {
+        if (adopt && !other.stack_data_.InRange(static_cast<Node*>(node))) {
+          ++slab_nodes;
+          continue;
+        }
+        NodeBase* fresh = ::new (static_cast<void*>(alloc.allocate(1))) Node;
+        fresh->_M_next = spare;
+        spare = fresh;
+      }
+      BuildSpares(other, spare, adopt);
+    } catch (...) {
+      while (spare != nullptr) {
+        NodeBase* next = spare->_M_next;
+        alloc.deallocate(static_cast<Node*>(spare), 1);
+        spare = next;
+      }
+      throw;
+    }
+    ReplaceNodes(other, spare, adopt, slab_nodes);
+  }
+
+  // the value of each node of other to be replaced into the next spare;
+  // if one throws the values built are destroyed, what was moved out of
+  // other is given back
+  void BuildSpares(FixedForwardList& other, NodeBase* spare, bool adopt) {
+    NodeBase* fresh = spare;
+    NodeBase* node = other.before_begin()._M_node->_M_next;
+    try {
+      for (; node != nullptr; node = node->_M_next) {
+        if (adopt && !other.stack_data_.InRange(static_cast<Node*>(node))) {
+          continue;
+        }
+        TransferValue(static_cast<Node*>(fresh)->_M_valptr(),
+                      *static_cast<Node*>(node)->_M_valptr());
+        fresh = fresh->_M_next;
+      }
+    } catch (...) {
+      NodeBase* failed = node;
+      fresh = spare;
+      for (node = other.before_begin()._M_node->_M_next; node != failed;
+           node = node->_M_next) {
+        if (adopt && !other.stack_data_.InRange(static_cast<Node*>(node))) {
+          continue;
+        }
+        T* value = static_cast<Node*>(fresh)->_M_valptr();
+        UndoTransfer(*value, *static_cast<Node*>(node)->_M_valptr());
+        value->~T();
+        fresh = fresh->_M_next;
+      }
+      throw;
+    }
+  }
+
+  // relink the built spares in place of the nodes of other they replace
+  void ReplaceNodes(FixedForwardList& other, NodeBase* spare, bool adopt,
+                    size_t slab_nodes) noexcept {
+    Allocator other_alloc(&other.stack_data_);
+    for (NodeBase* prev = other.before_begin()._M_node;
+         prev->_M_next != nullptr; prev = prev->_M_next) {
+      Node* node = static_cast<Node*>(prev->_M_next);
+      if (adopt && !other.stack_data_.InRange(node)) {
+        continue;
+      }
+      NodeBase* fresh = spare;
+      spare = spare->_M_next;
+      node->_M_valptr()->~T();
+      fresh->_M_next = node->_M_next;
+      prev->_M_next = fresh;
+      other_alloc.deallocate(node, 1);
+    }
+    if (adopt) {
+      stack_data_.AdoptSlabs(other.stack_data_, slab_nodes);
+    }
+  }
+
+  void RelocateLinks(const Relocation& relocate) {
+    for (std::_Fwd_list_node_base* node = BaseType::before_begin()._M_node;
+         node != nullptr; node = node->_M_next) {
+      node->_M_next = relocate(node->_M_next);
+    }
+  }
+
+  ReservsedMemoryType stack_data_{Slabs::SlabArena()};
 };
 
-template <typename T, size_t Capacity>
-void swap(FixedForwardList<T, Capacity>& lhs,
-          FixedForwardList<T, Capacity>& rhs) {
-  FixedSwap(lhs, rhs);
+template <typename T, size_t Capacity, typename Slabs>
+void swap(FixedForwardList<T, Capacity, Slabs>& lhs,
+          FixedForwardList<T, Capacity, Slabs>& rhs) {
+  lhs.swap(rhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator==(const FixedForwardList<T, Capacity1>& lhs,
-                       const FixedForwardList<T, Capacity2>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Slabs1,
+          typename Slabs2>
+inline bool operator==(const FixedForwardList<T, Capacity1, Slabs1>& lhs,
+                       const FixedForwardList<T, Capacity2, Slabs2>& rhs) {
   auto litr = lhs.cbegin();
   auto ritr = rhs.cbegin();
   while (litr != lhs.cend() && ritr != rhs.cend()) {
@@ -169,33 +376,38 @@ inline bool operator==(const FixedForwardList<T, Capacity1>& lhs,
   return litr == lhs.cend() && ritr == rhs.cend();
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator!=(const FixedForwardList<T, Capacity1>& lhs,
-                       const FixedForwardList<T, Capacity2>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Slabs1,
+          typename Slabs2>
+inline bool operator!=(const FixedForwardList<T, Capacity1, Slabs1>& lhs,
+                       const FixedForwardList<T, Capacity2, Slabs2>& rhs) {
   return !(lhs == rhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator<(const FixedForwardList<T, Capacity1>& lhs,
-                      const FixedForwardList<T, Capacity2>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Slabs1,
+          typename Slabs2>
+inline bool operator<(const FixedForwardList<T, Capacity1, Slabs1>& lhs,
+                      const FixedForwardList<T, Capacity2, Slabs2>& rhs) {
   return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
                                       std::begin(rhs), std::end(rhs));
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator<=(const FixedForwardList<T, Capacity1>& lhs,
-                       const FixedForwardList<T, Capacity2>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Slabs1,
+          typename Slabs2>
+inline bool operator<=(const FixedForwardList<T, Capacity1, Slabs1>& lhs,
+                       const FixedForwardList<T, Capacity2, Slabs2>& rhs) {
   return !(rhs < lhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator>(const FixedForwardList<T, Capacity1>& lhs,
-                      const FixedForwardList<T, Capacity2>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Slabs1,
+          typename Slabs2>
+inline bool operator>(const FixedForwardList<T, Capacity1, Slabs1>& lhs,
+                      const FixedForwardList<T, Capacity2, Slabs2>& rhs) {
   return rhs < lhs;
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator>=(const FixedForwardList<T, Capacity1>& lhs,
-                       const FixedForwardList<T, Capacity2>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Slabs1,
+          typename Slabs2>
+inline bool operator>=(const FixedForwardList<T, Capacity1, Slabs1>& lhs,
+                       const FixedForwardList<T, Capacity2, Slabs2>& rhs) {
   return !(lhs < rhs);
 }
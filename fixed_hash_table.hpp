@@ -0,0 +1,668 @@
+#pragma once
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+#include "utils.hpp"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Open addressing hash table shared by FixedUnorderedMap and
+// FixedUnorderedSet, laid out like SwissTable: every slot has a control
+// byte that is either empty, deleted, or the low 7 bits of the hash (H2)
+// of the element in it. Lookups probe whole groups of control bytes at a
+// time and only compare keys whose H2 matches.
+
+using HashCtrl = int8_t;
+constexpr HashCtrl kHashCtrlEmpty = -128;
+constexpr HashCtrl kHashCtrlDeleted = -2;
+
+inline bool IsHashCtrlFull(HashCtrl ctrl) { return ctrl >= 0; }
+
+// one match per slot of a group; slot i owns bit i << Shift, the other
+// bits of its lane are clear
+template <int Shift>
+class HashBitMask {
+ public:
+  explicit HashBitMask(uint64_t mask) : mask_(mask) {}
+  explicit operator bool() const { return mask_ != 0; }
+  size_t LowestBit() const { return __builtin_ctzll(mask_) >> Shift; }
+  void ClearLowestBit() { mask_ &= mask_ - 1; }
+
+ private:
+  uint64_t mask_;
+};
+
+// portable group, eight control bytes are matched at once inside a
+// uint64_t (SWAR), each slot reports through the high bit of its byte.
+// Match() may report a false positive right after a real match, which only
+// costs an extra key compare. Assumes a little endian target.
+struct HashGroupScalar {
+  static constexpr size_t kWidth = 8;
+  static constexpr uint64_t kLsbs = 0x0101010101010101ull;
+  static constexpr uint64_t kMsbs = 0x8080808080808080ull;
+  using BitMask = HashBitMask<3>;
+
+  explicit HashGroupScalar(const HashCtrl* pos) {
+    std::memcpy(&ctrl_, pos, kWidth);
+  }
+
+  BitMask Match(HashCtrl h2) const {
+    uint64_t x = ctrl_ ^ (kLsbs * static_cast<uint8_t>(h2));
+    return BitMask((x - kLsbs) & ~x & kMsbs);
+  }
+
+  // empty is the only value with the high bit set and bit 1 clear
+  BitMask MatchEmpty() const { return BitMask(ctrl_ & ~(ctrl_ << 6) & kMsbs); }
+
+  // empty and deleted are the only values with high bit set, bit 0 clear
+  BitMask MatchEmptyOrDeleted() const {
+    return BitMask(ctrl_ & ~(ctrl_ << 7) & kMsbs);
+  }
+
+  uint64_t ctrl_;
+};
+
+#if defined(__SSE2__)
+// sixteen control bytes compared by one SSE2 instruction
+struct HashGroupSse2 {
+  static constexpr size_t kWidth = 16;
+  using BitMask = HashBitMask<0>;
+
+  explicit HashGroupSse2(const HashCtrl* pos)
+      : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+  BitMask Match(HashCtrl h2) const {
+    return BitMask(static_cast<uint16_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_))));
+  }
+
+  BitMask MatchEmpty() const { return Match(kHashCtrlEmpty); }
+
+  BitMask MatchEmptyOrDeleted() const {
+    return BitMask(static_cast<uint16_t>(
+        _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrl_))));
+  }
+
+  __m128i ctrl_;
+};
+#endif
+
+#if defined(__AVX2__)
+// thirty-two control bytes compared by one AVX2 instruction
+struct HashGroupAvx2 {
+  static constexpr size_t kWidth = 32;
+  using BitMask = HashBitMask<0>;
+
+  explicit HashGroupAvx2(const HashCtrl* pos)
+      : ctrl_(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos))) {}
+
+  BitMask Match(HashCtrl h2) const {
+    return BitMask(static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), ctrl_))));
+  }
+
+  BitMask MatchEmpty() const { return Match(kHashCtrlEmpty); }
+
+  BitMask MatchEmptyOrDeleted() const {
+    return BitMask(static_cast<uint32_t>(_mm256_movemask_epi8(
+        _mm256_cmpgt_epi8(_mm256_set1_epi8(-1), ctrl_))));
+  }
+
+  __m256i ctrl_;
+};
+#endif
+
+// SSE2 groups whenever the target has them, which every x86-64 does.
+// Define EXT_STL_HASH_AVX2 (and build with -mavx2) for 32-byte groups, or
+// EXT_STL_HASH_SCALAR to force the portable one. The choice changes the
+// table layout, so every translation unit must be built with the same one.
+#if defined(EXT_STL_HASH_SCALAR)
+using HashGroup = HashGroupScalar;
+#elif defined(EXT_STL_HASH_AVX2)
+#if !defined(__AVX2__)
+#error "EXT_STL_HASH_AVX2 needs a target with AVX2, build with -mavx2"
+#endif
+using HashGroup = HashGroupAvx2;
+#elif defined(__SSE2__)
+using HashGroup = HashGroupSse2;
+#else
+using HashGroup = HashGroupScalar;
+#endif
+
+// smallest power of two number of slots, at least one group of width,
+// that holds n elements under the 7/8 maximum load factor
+constexpr size_t HashTableSlots(size_t n, size_t width) {
+  return width - width / 8 >= n ? width : HashTableSlots(n, width * 2);
+}
+
+template <typename Value, typename Key, typename KeyOfValue, size_t Capacity,
+          typename Hash, typename KeyEqual, typename Group = HashGroup>
+class FixedHashTable {
+  using Storage = typename std::aligned_storage<sizeof(Value),
+                                                alignof(Value)>::type;
+
+ public:
+  static constexpr size_t kInlineSlots =
+      HashTableSlots(Capacity, Group::kWidth);
+
+  using key_type = Key;
+  using value_type = Value;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+  using reference = Value&;
+  using const_reference = const Value&;
+  using pointer = Value*;
+  using const_pointer = const Value*;
+
+  template <typename V>
+  class Iterator {
+   public:
+    friend class FixedHashTable;
+    template <typename U>
+    friend class Iterator;
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using reference = V&;
+    using pointer = V*;
+
+    Iterator() : ctrl_(nullptr), slot_(nullptr), end_(nullptr) {}
+
+    // iterator to const_iterator
+    template <typename U, typename = typename std::enable_if<
+                              std::is_same<const U, V>::value>::type>
+    Iterator(const Iterator<U>& other)
+        : ctrl_(other.ctrl_), slot_(other.slot_), end_(other.end_) {}
+
+    reference operator*() const { return *slot_; }
+    pointer operator->() const { return slot_; }
+
+    Iterator& operator++() {
+      ++ctrl_;
+      ++slot_;
+      SkipEmpty();
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator tmp(*this);
+      ++*this;
+      return tmp;
+    }
+
+    template <typename U>
+    bool operator==(const Iterator<U>& other) const {
+      return ctrl_ == other.ctrl_;
+    }
+    template <typename U>
+    bool operator!=(const Iterator<U>& other) const {
+      return ctrl_ != other.ctrl_;
+    }
+
+   private:
+    Iterator(const HashCtrl* ctrl, V* slot, const HashCtrl* end)
+        : ctrl_(ctrl), slot_(slot), end_(end) {}
+
+    void SkipEmpty() {
+      while (ctrl_ != end_ && !IsHashCtrlFull(*ctrl_)) {
+        ++ctrl_;
+        ++slot_;
+      }
+    }
+
+    const HashCtrl* ctrl_;
+    V* slot_;
+    const HashCtrl* end_;
+  };
+
+  using iterator = Iterator<Value>;
+  using const_iterator = Iterator<const Value>;
+
+  explicit FixedHashTable(const Hash& hash = Hash(),
+                          const KeyEqual& equal = KeyEqual())
+      : hash_(hash), equal_(equal) {
+    UseInline();
+  }
+
+  FixedHashTable(const FixedHashTable& other)
+      : FixedHashTable(other.hash_, other.equal_) {
+    CopyFrom(other);
+  }
+
+  FixedHashTable(FixedHashTable&& other)
+      : FixedHashTable(other.hash_, other.equal_) {
+    MoveFrom(other);
+  }
+
+  ~FixedHashTable() {
+    DestroyAll();
+    FreeHeap();
+  }
+
+  FixedHashTable& operator=(const FixedHashTable& other) {
+    if (this != &other) {
+      DestroyAll();
+      FreeHeap();
+      UseInline();
+      hash_ = other.hash_;
+      equal_ = other.equal_;
+      CopyFrom(other);
+    }
+    return *this;
+  }
+
+  FixedHashTable& operator=(FixedHashTable&& other) {
+    if (this != &other) {
+      DestroyAll();
+      FreeHeap();
+      UseInline();
+      hash_ = other.hash_;
+      equal_ = other.equal_;
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  // iterators
+  iterator begin() {
+    iterator it(ctrl_, Slot(0), ctrl_ + capacity_);
+    it.SkipEmpty();
+    return it;
+  }
+  const_iterator begin() const {
+    const_iterator it(ctrl_, Slot(0), ctrl_ + capacity_);
+    it.SkipEmpty();
+    return it;
+  }
+  const_iterator cbegin() const { return begin(); }
+  iterator end() {
+    return iterator(ctrl_ + capacity_, Slot(capacity_), ctrl_ + capacity_);
+  }
+  const_iterator end() const {
+    return const_iterator(ctrl_ + capacity_, Slot(capacity_),
+                          ctrl_ + capacity_);
+  }
+  const_iterator cend() const { return end(); }
+
+  // capacity
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+  size_type max_size() const { return std::allocator<Value>().max_size(); }
+  bool use_stack_memory() const { return ctrl_ == ctrl_inline_; }
+
+  // buckets and hash policy, a bucket is a slot here
+  size_type bucket_count() const { return capacity_; }
+  float load_factor() const {
+    return static_cast<float>(size_) / static_cast<float>(capacity_);
+  }
+  float max_load_factor() const { return 7.0f / 8.0f; }
+
+  // make room for n elements without further rehashing
+  void reserve(size_type n) {
+    if (n > Growth(capacity_)) {
+      Resize(HashTableSlots(n, Group::kWidth));
+    }
+  }
+
+  // resize to at least n slots and drop the tombstones, a table that fits
+  // in the inline buffer moves back to it
+  void rehash(size_type n) {
+    size_type slots =
+        std::max(HashTableSlots(size_, Group::kWidth), kInlineSlots);
+    while (slots < n) slots *= 2;
+    Resize(slots);
+  }
+
+  hasher hash_function() const { return hash_; }
+  key_equal key_eq() const { return equal_; }
+
+  // modifiers
+  void clear() {
+    DestroyAll();
+    ResetCtrl();
+  }
+
+  // construct a Value from args in the slot for key unless key is present
+  template <typename... Args>
+  std::pair<iterator, bool> EmplaceKey(const Key& key, Args&&... args) {
+    std::pair<size_type, bool> res = FindOrPrepareInsert(key);
+    if (res.second) {
+      ConstructAt(res.first, std::forward<Args>(args)...);
+    }
+    return std::make_pair(IteratorAt(res.first), res.second);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    Value value(std::forward<Args>(args)...);
+    return EmplaceKey(KeyOfValue()(value), std::move(value));
+  }
+
+  std::pair<iterator, bool> insert(const Value& value) {
+    return EmplaceKey(KeyOfValue()(value), value);
+  }
+
+  std::pair<iterator, bool> insert(Value&& value) {
+    return EmplaceKey(KeyOfValue()(value), std::move(value));
+  }
+
+  template <typename InputIterator>
+  void insert(InputIterator first, InputIterator last) {
+    for (; first != last; ++first) {
+      emplace(*first);
+    }
+  }
+
+  void insert(std::initializer_list<Value> ilist) {
+    insert(ilist.begin(), ilist.end());
+  }
+
+  iterator erase(const_iterator pos) {
+    size_type index = pos.ctrl_ - ctrl_;
+    EraseAt(index);
+    iterator next(ctrl_ + index, Slot(index), ctrl_ + capacity_);
+    next.SkipEmpty();
+    return next;
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    while (first != last) {
+      first = erase(first);
+    }
+    size_type index = last.ctrl_ - ctrl_;
+    return iterator(ctrl_ + index, Slot(index), ctrl_ + capacity_);
+  }
+
+  size_type erase(const Key& key) {
+    size_type index = FindIndex(key);
+    if (index == capacity_) {
+      return 0;
+    }
+    EraseAt(index);
+    return 1;
+  }
+
+  // heap tables are exchanged by pointer, inline elements are moved
+  void swap(FixedHashTable& other) {
+    if (this == &other) {
+      return;
+    }
+    if (!use_stack_memory() && !other.use_stack_memory()) {
+      std::swap(ctrl_, other.ctrl_);
+      std::swap(slots_, other.slots_);
+      std::swap(capacity_, other.capacity_);
+      std::swap(size_, other.size_);
+      std::swap(growth_left_, other.growth_left_);
+      std::swap(hash_, other.hash_);
+      std::swap(equal_, other.equal_);
+      return;
+    }
+    FixedHashTable tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+  // lookup
+  size_type count(const Key& key) const { return FindIndex(key) != capacity_; }
+
+  iterator find(const Key& key) { return IteratorAt(FindIndex(key)); }
+
+  const_iterator find(const Key& key) const {
+    size_type index = FindIndex(key);
+    return const_iterator(ctrl_ + index, Slot(index), ctrl_ + capacity_);
+  }
+
+  std::pair<iterator, iterator> equal_range(const Key& key) {
+    iterator it = find(key);
+    iterator next = it;
+    return std::make_pair(it, it == end() ? it : ++next);
+  }
+
+  std::pair<const_iterator, const_iterator> equal_range(
+      const Key& key) const {
+    const_iterator it = find(key);
+    const_iterator next = it;
+    return std::make_pair(it, it == end() ? it : ++next);
+  }
+
+ private:
+  static size_type Growth(size_type slots) { return slots - slots / 8; }
+  static size_type H1(size_type hash) { return hash >> 7; }
+  static HashCtrl H2(size_type hash) { return hash & 0x7f; }
+
+  Value* Slot(size_type index) {
+    return reinterpret_cast<Value*>(slots_ + index);
+  }
+  const Value* Slot(size_type index) const {
+    return reinterpret_cast<const Value*>(slots_ + index);
+  }
+
+  iterator IteratorAt(size_type index) {
+    return iterator(ctrl_ + index, Slot(index), ctrl_ + capacity_);
+  }
+
+  // groups are aligned to kWidth slots and visited in triangular order,
+  // which touches every group of a power of two table exactly once
+  template <typename Visitor>
+  size_type Probe(size_type hash, Visitor visit) const {
+    size_type group_mask = capacity_ / Group::kWidth - 1;
+    size_type group = H1(hash) & group_mask;
+    for (size_type step = 1;; ++step) {
+      size_type base = group * Group::kWidth;
+      size_type index = visit(Group(ctrl_ + base), base);
+      if (index != capacity_ + 1) {
+        return index;
+      }
+      group = (group + step) & group_mask;
+    }
+  }
+
+  // slot index of key, or capacity_ when it is absent
+  size_type FindIndex(const Key& key) const {
+    size_type hash = MixHash(hash_(key));
+    HashCtrl h2 = H2(hash);
+    return Probe(hash, [&](const Group& group,
+                             size_type base) -> size_type {
+      typename Group::BitMask match = group.Match(h2);
+      while (match) {
+        size_type index = base + match.LowestBit();
+        if (equal_(key, KeyOfValue()(*Slot(index)))) {
+          return index;
+        }
+        match.ClearLowestBit();
+      }
+      return group.MatchEmpty() ? capacity_ : capacity_ + 1;
+    });
+  }
+
+  size_type FindFirstNonFull(size_type hash) const {
+    return Probe(hash, [&](const Group& group,
+                             size_type base) -> size_type {
+      typename Group::BitMask mask = group.MatchEmptyOrDeleted();
+      return mask ? base + mask.LowestBit() : capacity_ + 1;
+    });
+  }
+
+  // slot index for key and whether that slot still has to be constructed
+  std::pair<size_type, bool> FindOrPrepareInsert(const Key& key) {
+    size_type index = FindIndex(key);
+    if (index != capacity_) {
+      return std::make_pair(index, false);
+    }
+    size_type hash = MixHash(hash_(key));
+    index = FindFirstNonFull(hash);
+    if (growth_left_ == 0 && ctrl_[index] == kHashCtrlEmpty) {
+      // mostly tombstones: clean them up in place, otherwise double
+      Resize(size_ < Growth(capacity_) / 2 ? capacity_ : capacity_ * 2);
+      index = FindFirstNonFull(hash);
+    }
+    if (ctrl_[index] == kHashCtrlEmpty) {
+      --growth_left_;
+    }
+    ctrl_[index] = H2(hash);
+    ++size_;
+    return std::make_pair(index, true);
+  }
+
+  template <typename... Args>
+  void ConstructAt(size_type index, Args&&... args) {
+    try {
+      new (Slot(index)) Value(std::forward<Args>(args)...);
+    } catch (...) {
+      ctrl_[index] = kHashCtrlDeleted;
+      --size_;
+      throw;
+    }
+  }
+
+  void EraseAt(size_type index) {
+    Slot(index)->~Value();
+    ctrl_[index] = kHashCtrlDeleted;
+    --size_;
+  }
+
+  void DestroyAll() {
+    for (size_type i = 0; i < capacity_ && size_ > 0; ++i) {
+      if (IsHashCtrlFull(ctrl_[i])) {
+        Slot(i)->~Value();
+        --size_;
+      }
+    }
+  }
+
+  void ResetCtrl() {
+    std::memset(ctrl_, kHashCtrlEmpty, capacity_);
+    size_ = 0;
+    growth_left_ = Growth(capacity_);
+  }
+
+  void UseInline() {
+    ctrl_ = ctrl_inline_;
+    slots_ = slots_inline_;
+    capacity_ = kInlineSlots;
+    ResetCtrl();
+  }
+
+  // one block per heap table: the slots, then the control bytes
+  void UseHeap(size_type slots) {
+    slots_ = static_cast<Storage*>(
+        ::operator new(slots * (sizeof(Storage) + sizeof(HashCtrl))));
+    ctrl_ = reinterpret_cast<HashCtrl*>(slots_ + slots);
+    capacity_ = slots;
+    ResetCtrl();
+  }
+
+  void FreeHeap() {
+    if (!use_stack_memory()) {
+      ::operator delete(slots_);
+    }
+  }
+
+  // move every element of the old table into the current one
+  void MoveAll(HashCtrl* old_ctrl, Storage* old_slots, size_type old_cap) {
+    for (size_type i = 0; i < old_cap; ++i) {
+      if (!IsHashCtrlFull(old_ctrl[i])) {
+        continue;
+      }
+      Value* value = reinterpret_cast<Value*>(old_slots + i);
+      size_type hash = MixHash(hash_(KeyOfValue()(*value)));
+      size_type index = FindFirstNonFull(hash);
+      ctrl_[index] = H2(hash);
+      new (Slot(index)) Value(std::move(*value));
+      value->~Value();
+    }
+  }
+
+  void Resize(size_type slots) {
+    size_type old_size = size_;
+    HashCtrl* old_ctrl = ctrl_;
+    Storage* old_slots = slots_;
+    size_type old_cap = capacity_;
+    bool old_heap = !use_stack_memory();
+    if (!old_heap && slots <= kInlineSlots) {
+      // inline to inline: park the elements in a heap table first
+      UseHeap(old_cap);
+      MoveAll(old_ctrl, old_slots, old_cap);
+      old_ctrl = ctrl_;
+      old_slots = slots_;
+      old_heap = true;
+    }
+    if (slots <= kInlineSlots) {
+      UseInline();
+    } else {
+      UseHeap(slots);
+    }
+    MoveAll(old_ctrl, old_slots, old_cap);
+    size_ = old_size;
+    growth_left_ = Growth(capacity_) - size_;
+    if (old_heap) {
+      ::operator delete(old_slots);
+    }
+  }
+
+  // same capacity and control bytes, so every element keeps its slot
+  void CopyFrom(const FixedHashTable& other) {
+    if (!other.use_stack_memory()) {
+      FreeHeap();
+      UseHeap(other.capacity_);
+    }
+    for (size_type i = 0; i < capacity_; ++i) {
+      if (IsHashCtrlFull(other.ctrl_[i])) {
+        new (Slot(i)) Value(*other.Slot(i));
+        ctrl_[i] = other.ctrl_[i];
+        ++size_;
+      }
+    }
+    growth_left_ = Growth(capacity_) - size_;
+  }
+
+  // steal other's heap table, or move its inline elements slot by slot
+  void MoveFrom(FixedHashTable& other) {
+    if (!other.use_stack_memory()) {
+      ctrl_ = other.ctrl_;
+      slots_ = other.slots_;
+      capacity_ = other.capacity_;
+      size_ = other.size_;
+      growth_left_ = other.growth_left_;
+      other.UseInline();
+      return;
+    }
+    for (size_type i = 0; i < capacity_; ++i) {
+      if (IsHashCtrlFull(other.ctrl_[i])) {
+        new (Slot(i)) Value(std::move(*other.Slot(i)));
+        ctrl_[i] = other.ctrl_[i];
+        ++size_;
+      }
+    }
+    growth_left_ = Growth(capacity_) - size_;
+    other.clear();
+  }
+
+  HashCtrl* ctrl_;
+  Storage* slots_;
+  size_type capacity_;
+  size_type size_;
+  size_type growth_left_;
+  Hash hash_;
+  KeyEqual equal_;
+
+  HashCtrl ctrl_inline_[kInlineSlots];
+  Storage slots_inline_[kInlineSlots];
+};
+
+template <typename Value, typename Key, typename KeyOfValue, size_t Capacity,
+          typename Hash, typename KeyEqual, typename Group>
+constexpr size_t FixedHashTable<Value, Key, KeyOfValue, Capacity, Hash,
+                                KeyEqual, Group>::kInlineSlots;
@@ -1,5 +1,6 @@
 #pragma once
 #include <list>
+#include <vector>
 #include <algorithm>
 #include "stack_allocator.hpp"
 
@@ -8,7 +9,25 @@
 template <typename T>
 using __std_list_node_t = std::_List_node<T>;
 
-template <typename T, size_t Capacity>
+// repoint a list node that moved from old, and the neighbours outside the
+// relocated buffer that linked to it
+struct ListRelink {
+  template <typename Relocation>
+  void operator()(std::__detail::_List_node_base* node,
+                  std::__detail::_List_node_base* old,
+                  const Relocation& relocate) const {
+    node->_M_next = relocate(node->_M_next);
+    node->_M_prev = relocate(node->_M_prev);
+    for (std::__detail::_List_node_base* neighbour :
+         {node->_M_next, node->_M_prev}) {
+      if (relocate.InTarget(neighbour)) continue;
+      if (neighbour->_M_next == old) neighbour->_M_next = node;
+      if (neighbour->_M_prev == old) neighbour->_M_prev = node;
+    }
+  }
+};
+
+template <typename T, size_t Capacity, typename Slabs = HeapSlabs>
 class FixedList
     : public std::list<T, StackAllocator<__std_list_node_t<T>, Capacity>> {
  public:
@@ -66,6 +85,7 @@ class FixedList
 
   FixedList& operator=(const FixedList& other) {
     assign(other.begin(), other.end());
+    return *this;
   }
 
   FixedList& operator=(FixedList&& other) {
@@ -84,51 +104,94 @@ class FixedList
     other.clear();
   }
 
-  ~FixedList() = default;
+  ~FixedList() { BaseType::clear(); }
+
+  // trade the lists and then the node pools, no element is copied; when
+  // moving a value may throw the lists are copied instead
+  void swap(FixedList& other) {
+    if (this == &other) {
+      return;
+    }
+    SwapFixed(*this, other, [this, &other] {
+      BaseType::swap(other);
+      stack_data_.SwapWith(other.stack_data_, ListRelink());
+    }, NodesRelocatable<typename Allocator::value_type>());
+  }
+
+  // lay the nodes out in list order at the front of the inline buffer, so
+  // iterating reads memory sequentially; invalidates iterators, does
+  // nothing when moving a value may throw
+  void compact() {
+    if (!NodesRelocatable<typename Allocator::value_type>::value) {
+      return;
+    }
+    using NodePtr = typename Allocator::pointer;
+    std::vector<NodePtr> nodes;
+    nodes.reserve(size());
+    for (auto it = begin(); it != end(); ++it) {
+      nodes.push_back(static_cast<NodePtr>(it._M_node));
+    }
+    stack_data_.Compact(nodes.data(), nodes.size());
+    std::__detail::_List_node_base* prev = end()._M_node;
+    for (NodePtr node : nodes) {
+      prev->_M_next = node;
+      node->_M_prev = prev;
+      prev = node;
+    }
+    prev->_M_next = end()._M_node;
+    end()._M_node->_M_prev = prev;
+  }
 
  private:
-  ReservsedMemoryType stack_data_;
+  ReservsedMemoryType stack_data_{Slabs::SlabArena()};
 };
 
-template <typename T, size_t Capacity>
-void swap(FixedList<T, Capacity>& lhs, FixedList<T, Capacity>& rhs) {
-  FixedSwap(lhs, rhs);
+template <typename T, size_t Capacity, typename Slabs>
+void swap(FixedList<T, Capacity, Slabs>& lhs,
+          FixedList<T, Capacity, Slabs>& rhs) {
+  lhs.swap(rhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator==(const FixedList<T, Capacity1>& lhs,
-                       const FixedList<T, Capacity2>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Slabs1,
+          typename Slabs2>
+inline bool operator==(const FixedList<T, Capacity1, Slabs1>& lhs,
+                       const FixedList<T, Capacity2, Slabs2>& rhs) {
   return lhs.size() == rhs.size() &&
          std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs));
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator!=(const FixedList<T, Capacity1>& lhs,
-                       const FixedList<T, Capacity2>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Slabs1,
+          typename Slabs2>
+inline bool operator!=(const FixedList<T, Capacity1, Slabs1>& lhs,
+                       const FixedList<T, Capacity2, Slabs2>& rhs) {
   return !(lhs == rhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator<(const FixedList<T, Capacity1>& lhs,
-                      const FixedList<T, Capacity2>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Slabs1,
+          typename Slabs2>
+inline bool operator<(const FixedList<T, Capacity1, Slabs1>& lhs,
+                      const FixedList<T, Capacity2, Slabs2>& rhs) {
   return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
                                       std::begin(rhs), std::end(rhs));
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator<=(const FixedList<T, Capacity1>& lhs,
-                       const FixedList<T, Capacity2>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Slabs1,
+          typename Slabs2>
+inline bool operator<=(const FixedList<T, Capacity1, Slabs1>& lhs,
+                       const FixedList<T, Capacity2, Slabs2>& rhs) {
   return !(rhs < lhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator>(const FixedList<T, Capacity1>& lhs,
-                      const FixedList<T, Capacity2>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Slabs1,
+          typename Slabs2>
+inline bool operator>(const FixedList<T, Capacity1, Slabs1>& lhs,
+                      const FixedList<T, Capacity2, Slabs2>& rhs) {
   return rhs < lhs;
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator>=(const FixedList<T, Capacity1>& lhs,
-                       const FixedList<T, Capacity2>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Slabs1,
+          typename Slabs2>
+inline bool operator>=(const FixedList<T, Capacity1, Slabs1>& lhs,
+                       const FixedList<T, Capacity2, Slabs2>& rhs) {
   return !(lhs < rhs);
 }
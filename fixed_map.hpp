@@ -8,7 +8,8 @@ template <typename T>
 using __std_tree_node_t = std::_Rb_tree_node<T>;
 
 template <typename KeyType, typename ValueType, size_t Capacity,
-          typename Compare = std::less<KeyType>>
+          typename Compare = std::less<KeyType>,
+          typename Slabs = HeapSlabs>
 class FixedMap
     : public std::map<
           KeyType, ValueType, Compare,
@@ -55,34 +56,46 @@ class FixedMap
     insert(first, last);
   }
 
-  FixedMap(const FixedMap& other) : FixedMap() {
-    insert(std::begin(other), std::end(other));
+  // the range is sorted by comp, the tree is linked up in linear time
+  template <typename InputIterator>
+  FixedMap(sorted_unique_t, InputIterator first, InputIterator last,
+           const Compare& comp = Compare())
+      : FixedMap(comp) {
+    BuildSortedTree(static_cast<BaseType&>(*this), first, last);
   }
 
-  FixedMap(FixedMap&& other) : FixedMap() {
-    insert(std::begin(other), std::end(other));
-    other.clear();
+  FixedMap(const FixedMap& other) : FixedMap(other.key_comp()) {
+    BaseType::operator=(other);
   }
 
+  // steal the tree: slab nodes keep their address and the inline ones are
+  // relinked in place, or rebuilt in our buffer when moving them may
+  // throw; other is left empty
+  FixedMap(FixedMap&& other) : FixedMap() { MoveFrom(other); }
+
   FixedMap(std::initializer_list<value_type> init) : FixedMap() {
     insert(init);
   }
 
-  ~FixedMap() = default;
+  ~FixedMap() { BaseType::clear(); }
 
+  // the nodes already held are reused for the new values and the tree
+  // shape is copied as is, O(n) and no allocation when sizes match
   FixedMap& operator=(const FixedMap& other) {
-    insert(std::begin(other), std::end(other));
+    BaseType::operator=(other);
     return *this;
   }
 
   FixedMap& operator=(FixedMap&& other) {
-    insert(std::begin(other), std::end(other));
-    other.clear();
+    if (this != &other) {
+      BaseType::clear();
+      MoveFrom(other);
+    }
     return *this;
   }
 
   FixedMap& operator=(std::initializer_list<value_type> init) {
-    insert(init);
+    BaseType::operator=(init);
     return *this;
   }
 
@@ -101,82 +114,120 @@ class FixedMap
 
   template <typename Comp, typename Alloc>
   FixedMap& operator=(const std::map<KeyType, ValueType, Comp, Alloc>& other) {
+    BaseType::clear();
     insert(std::begin(other), std::end(other));
     return *this;
   }
 
   template <typename Comp, typename Alloc>
   FixedMap& operator=(std::map<KeyType, ValueType, Comp, Alloc>&& other) {
+    BaseType::clear();
     insert(std::begin(other), std::end(other));
     other.clear();
     return *this;
   }
 
+  // trade the trees and then the node pools, no element is copied; when
+  // moving a value may throw, as for a std::string key, which is const
+  // and so copied, the maps are copied instead
+  void swap(FixedMap& other) {
+    if (this == &other) {
+      return;
+    }
+    SwapFixed(*this, other, [this, &other] {
+      SwapFixedTree(static_cast<BaseType&>(*this), stack_data_,
+                    static_cast<BaseType&>(other), other.stack_data_);
+    }, NodesRelocatable<typename Allocator::value_type>());
+  }
+
+  // lay the nodes out in key order at the front of the inline buffer, so
+  // iterating reads memory sequentially; invalidates iterators, does
+  // nothing when moving a value may throw
+  void compact() {
+    if (NodesRelocatable<typename Allocator::value_type>::value) {
+      CompactFixedTree(static_cast<BaseType&>(*this), stack_data_);
+    }
+  }
+
  private:
-  ReservsedMemoryType stack_data_;
+  // the tree of other into this empty map
+  void MoveFrom(FixedMap& other) {
+    MoveFixedTree(static_cast<BaseType&>(*this), stack_data_,
+                  static_cast<BaseType&>(other), other.stack_data_,
+                  NodesRelocatable<typename Allocator::value_type>());
+  }
+
+  ReservsedMemoryType stack_data_{Slabs::SlabArena()};
 };
 
 template <typename KeyType, typename ValueType, size_t Capacity,
-          typename Compare>
-void swap(FixedMap<KeyType, ValueType, Capacity, Compare>& lhs,
-          FixedMap<KeyType, ValueType, Capacity, Compare>& rhs) {
-  FixedSwap(lhs, rhs);
+          typename Compare, typename Slabs>
+void swap(FixedMap<KeyType, ValueType, Capacity, Compare, Slabs>& lhs,
+          FixedMap<KeyType, ValueType, Capacity, Compare, Slabs>& rhs) {
+  lhs.swap(rhs);
 }
 
 template <typename KeyType, typename ValueType, size_t Capacity1,
-          size_t Capacity2, typename Compare>
+          size_t Capacity2, typename Compare, typename Slabs1,
+          typename Slabs2>
 inline bool operator==(
-    const FixedMap<KeyType, ValueType, Capacity1, Compare>& lhs,
-    const FixedMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+    const FixedMap<KeyType, ValueType, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMap<KeyType, ValueType, Capacity2, Compare, Slabs2>& rhs) {
   return lhs.size() == rhs.size() &&
          std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs));
 }
 
 template <typename KeyType, typename ValueType, size_t Capacity1,
-          size_t Capacity2, typename Compare>
+          size_t Capacity2, typename Compare, typename Slabs1,
+          typename Slabs2>
 inline bool operator!=(
-    const FixedMap<KeyType, ValueType, Capacity1, Compare>& lhs,
-    const FixedMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+    const FixedMap<KeyType, ValueType, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMap<KeyType, ValueType, Capacity2, Compare, Slabs2>& rhs) {
   return !(lhs == rhs);
 }
 
 template <typename KeyType, typename ValueType, size_t Capacity1,
-          size_t Capacity2, typename Compare>
+          size_t Capacity2, typename Compare, typename Slabs1,
+          typename Slabs2>
 inline bool operator<(
-    const FixedMap<KeyType, ValueType, Capacity1, Compare>& lhs,
-    const FixedMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+    const FixedMap<KeyType, ValueType, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMap<KeyType, ValueType, Capacity2, Compare, Slabs2>& rhs) {
   return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
                                       std::begin(rhs), std::end(rhs));
 }
 
 template <typename KeyType, typename ValueType, size_t Capacity1,
-          size_t Capacity2, typename Compare>
+          size_t Capacity2, typename Compare, typename Slabs1,
+          typename Slabs2>
 inline bool operator<=(
-    const FixedMap<KeyType, ValueType, Capacity1, Compare>& lhs,
-    const FixedMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+    const FixedMap<KeyType, ValueType, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMap<KeyType, ValueType, Capacity2, Compare, Slabs2>& rhs) {
   return !(rhs < lhs);
 }
 
 template <typename KeyType, typename ValueType, size_t Capacity1,
-          size_t Capacity2, typename Compare>
+          size_t Capacity2, typename Compare, typename Slabs1,
+          typename Slabs2>
 inline bool operator>(
-    const FixedMap<KeyType, ValueType, Capacity1, Compare>& lhs,
-    const FixedMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+    const FixedMap<KeyType, ValueType, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMap<KeyType, ValueType, Capacity2, Compare, Slabs2>& rhs) {
   return rhs < lhs;
 }
 
 template <typename KeyType, typename ValueType, size_t Capacity1,
-          size_t Capacity2, typename Compare>
+          size_t Capacity2, typename Compare, typename Slabs1,
+          typename Slabs2>
 inline bool operator>=(
-    const FixedMap<KeyType, ValueType, Capacity1, Compare>& lhs,
-    const FixedMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+    const FixedMap<KeyType, ValueType, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMap<KeyType, ValueType, Capacity2, Compare, Slabs2>& rhs) {
   return !(lhs < rhs);
 }
 
 // definition for FixedMultiMap
 
 template <typename KeyType, typename ValueType, size_t Capacity,
-          typename Compare = std::less<KeyType>>
+          typename Compare = std::less<KeyType>,
+          typename Slabs = HeapSlabs>
 class FixedMultiMap
     : public std::multimap<
           KeyType, ValueType, Compare,
@@ -223,34 +274,46 @@ class FixedMultiMap
     insert(first, last);
   }
 
-  FixedMultiMap(const FixedMultiMap& other) : FixedMultiMap() {
-    insert(std::begin(other), std::end(other));
+  // the range is sorted by comp, the tree is linked up in linear time
+  template <typename InputIterator>
+  FixedMultiMap(sorted_equivalent_t, InputIterator first, InputIterator last,
+                const Compare& comp = Compare())
+      : FixedMultiMap(comp) {
+    BuildSortedTree(static_cast<BaseType&>(*this), first, last);
   }
 
-  FixedMultiMap(FixedMultiMap&& other) : FixedMultiMap() {
-    insert(std::begin(other), std::end(other));
-    other.clear();
+  FixedMultiMap(const FixedMultiMap& other) : FixedMultiMap(other.key_comp()) {
+    BaseType::operator=(other);
   }
 
+  // steal the tree: slab nodes keep their address and the inline ones are
+  // relinked in place, or rebuilt in our buffer when moving them may
+  // throw; other is left empty
+  FixedMultiMap(FixedMultiMap&& other) : FixedMultiMap() { MoveFrom(other); }
+
   FixedMultiMap(std::initializer_list<value_type> init) : FixedMultiMap() {
     insert(init);
   }
 
-  ~FixedMultiMap() = default;
+  ~FixedMultiMap() { BaseType::clear(); }
 
+  // the nodes already held are reused for the new values and the tree
+  // shape is copied as is, O(n) and no allocation when sizes match
   FixedMultiMap& operator=(const FixedMultiMap& other) {
-    insert(std::begin(other), std::end(other));
+    BaseType::operator=(other);
     return *this;
   }
 
   FixedMultiMap& operator=(FixedMultiMap&& other) {
-    insert(std::begin(other), std::end(other));
-    other.clear();
+    if (this != &other) {
+      BaseType::clear();
+      MoveFrom(other);
+    }
     return *this;
   }
 
   FixedMultiMap& operator=(std::initializer_list<value_type> init) {
-    insert(init);
+    BaseType::operator=(init);
     return *this;
   }
 
@@ -270,6 +333,7 @@ class FixedMultiMap
   template <typename Comp, typename Alloc>
   FixedMultiMap& operator=(
       const std::multimap<KeyType, ValueType, Comp, Alloc>& other) {
+    BaseType::clear();
     insert(std::begin(other), std::end(other));
     return *this;
   }
@@ -277,68 +341,104 @@ class FixedMultiMap
   template <typename Comp, typename Alloc>
   FixedMultiMap& operator=(
       std::multimap<KeyType, ValueType, Comp, Alloc>&& other) {
+    BaseType::clear();
     insert(std::begin(other), std::end(other));
     other.clear();
     return *this;
   }
 
+  // trade the trees and then the node pools, no element is copied; when
+  // moving a value may throw, as for a std::string key, which is const
+  // and so copied, the maps are copied instead
+  void swap(FixedMultiMap& other) {
+    if (this == &other) {
+      return;
+    }
+    SwapFixed(*this, other, [this, &other] {
+      SwapFixedTree(static_cast<BaseType&>(*this), stack_data_,
+                    static_cast<BaseType&>(other), other.stack_data_);
+    }, NodesRelocatable<typename Allocator::value_type>());
+  }
+
+  // lay the nodes out in key order at the front of the inline buffer, so
+  // iterating reads memory sequentially; invalidates iterators, does
+  // nothing when moving a value may throw
+  void compact() {
+    if (NodesRelocatable<typename Allocator::value_type>::value) {
+      CompactFixedTree(static_cast<BaseType&>(*this), stack_data_);
+    }
+  }
+
  private:
-  ReservsedMemoryType stack_data_;
+  // the tree of other into this empty map
+  void MoveFrom(FixedMultiMap& other) {
+    MoveFixedTree(static_cast<BaseType&>(*this), stack_data_,
+                  static_cast<BaseType&>(other), other.stack_data_,
+                  NodesRelocatable<typename Allocator::value_type>());
+  }
+
+  ReservsedMemoryType stack_data_{Slabs::SlabArena()};
 };
 
 template <typename KeyType, typename ValueType, size_t Capacity,
-          typename Compare>
-void swap(FixedMultiMap<KeyType, ValueType, Capacity, Compare>& lhs,
-          FixedMultiMap<KeyType, ValueType, Capacity, Compare>& rhs) {
-  FixedMultiSwap(lhs, rhs);
+          typename Compare, typename Slabs>
+void swap(FixedMultiMap<KeyType, ValueType, Capacity, Compare, Slabs>& lhs,
+          FixedMultiMap<KeyType, ValueType, Capacity, Compare, Slabs>& rhs) {
+  lhs.swap(rhs);
 }
 
 template <typename KeyType, typename ValueType, size_t Capacity1,
-          size_t Capacity2, typename Compare>
+          size_t Capacity2, typename Compare, typename Slabs1,
+          typename Slabs2>
 inline bool operator==(
-    const FixedMultiMap<KeyType, ValueType, Capacity1, Compare>& lhs,
-    const FixedMultiMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+    const FixedMultiMap<KeyType, ValueType, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMultiMap<KeyType, ValueType, Capacity2, Compare, Slabs2>& rhs) {
   return lhs.size() == rhs.size() &&
          std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs));
 }
 
 template <typename KeyType, typename ValueType, size_t Capacity1,
-          size_t Capacity2, typename Compare>
+          size_t Capacity2, typename Compare, typename Slabs1,
+          typename Slabs2>
 inline bool operator!=(
-    const FixedMultiMap<KeyType, ValueType, Capacity1, Compare>& lhs,
-    const FixedMultiMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+    const FixedMultiMap<KeyType, ValueType, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMultiMap<KeyType, ValueType, Capacity2, Compare, Slabs2>& rhs) {
   return !(lhs == rhs);
 }
 
 template <typename KeyType, typename ValueType, size_t Capacity1,
-          size_t Capacity2, typename Compare>
+          size_t Capacity2, typename Compare, typename Slabs1,
+          typename Slabs2>
 inline bool operator<(
-    const FixedMultiMap<KeyType, ValueType, Capacity1, Compare>& lhs,
-    const FixedMultiMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+    const FixedMultiMap<KeyType, ValueType, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMultiMap<KeyType, ValueType, Capacity2, Compare, Slabs2>& rhs) {
   return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
                                       std::begin(rhs), std::end(rhs));
 }
 
 template <typename KeyType, typename ValueType, size_t Capacity1,
-          size_t Capacity2, typename Compare>
+          size_t Capacity2, typename Compare, typename Slabs1,
+          typename Slabs2>
 inline bool operator<=(
-    const FixedMultiMap<KeyType, ValueType, Capacity1, Compare>& lhs,
-    const FixedMultiMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+    const FixedMultiMap<KeyType, ValueType, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMultiMap<KeyType, ValueType, Capacity2, Compare, Slabs2>& rhs) {
   return !(rhs < lhs);
 }
 
 template <typename KeyType, typename ValueType, size_t Capacity1,
-          size_t Capacity2, typename Compare>
+          size_t Capacity2, typename Compare, typename Slabs1,
+          typename Slabs2>
 inline bool operator>(
-    const FixedMultiMap<KeyType, ValueType, Capacity1, Compare>& lhs,
-    const FixedMultiMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+    const FixedMultiMap<KeyType, ValueType, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMultiMap<KeyType, ValueType, Capacity2, Compare, Slabs2>& rhs) {
   return rhs < lhs;
 }
 
 template <typename KeyType, typename ValueType, size_t Capacity1,
-          size_t Capacity2, typename Compare>
+          size_t Capacity2, typename Compare, typename Slabs1,
+          typename Slabs2>
 inline bool operator>=(
-    const FixedMultiMap<KeyType, ValueType, Capacity1, Compare>& lhs,
-    const FixedMultiMap<KeyType, ValueType, Capacity2, Compare>& rhs) {
+    const FixedMultiMap<KeyType, ValueType, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMultiMap<KeyType, ValueType, Capacity2, Compare, Slabs2>& rhs) {
   return !(lhs < rhs);
 }
@@ -0,0 +1,130 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#include "utils.hpp"
+
+// A bounded queue any number of threads may push to and pop from, lock
+// free and without allocation, after Dmitry Vyukov's design: each of the
+// Capacity cells, rounded up to a power of two and stored inline, carries
+// a sequence number that says whose turn it is. A producer claims the
+// cell at the enqueue position once its sequence equals that position,
+// a consumer the one at the dequeue position once its sequence is one
+// past it. Threads only contend on the position they move, and the two
+// positions sit on their own cache lines.
+//
+// The value is built before a cell is claimed so that a throwing
+// constructor cannot leave a claimed cell unfilled; it is then moved in,
+// which must not throw.
+template <typename T, size_t Capacity>
+class FixedMpmcQueue {
+  static_assert(Capacity > 1, "FixedMpmcQueue needs at least two cells");
+  static_assert(std::is_nothrow_move_constructible<T>::value,
+                "a claimed cell must be filled without throwing");
+
+ public:
+  static constexpr size_t kCapacity = RingSlots(Capacity);
+
+  using value_type = T;
+  using size_type = size_t;
+
+  FixedMpmcQueue() {
+    for (size_t i = 0; i < kCapacity; ++i) {
+      cells_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  FixedMpmcQueue(const FixedMpmcQueue&) = delete;
+  FixedMpmcQueue& operator=(const FixedMpmcQueue&) = delete;
+
+  // no thread may be using the queue any more
+  ~FixedMpmcQueue() {
+    size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+    for (size_t i = dequeue_pos_.load(std::memory_order_relaxed); i != tail;
+         ++i) {
+      cells_[i & (kCapacity - 1)].Value()->~T();
+    }
+  }
+
+  bool try_push(const T& value) { return try_emplace(value); }
+  bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    T value(std::forward<Args>(args)...);
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+      cell = &cells_[pos & (kCapacity - 1)];
+      size_t sequence = cell->sequence_.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(sequence - pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // the cell still holds a value from a lap ago
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    new (cell->Value()) T(std::move(value));
+    cell->sequence_.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool try_pop(T& value) {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+      cell = &cells_[pos & (kCapacity - 1)];
+      size_t sequence = cell->sequence_.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(sequence - (pos + 1));
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // nothing pushed to the cell yet
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    T* slot = cell->Value();
+    value = std::move(*slot);
+    slot->~T();
+    cell->sequence_.store(pos + kCapacity, std::memory_order_release);
+    return true;
+  }
+
+  // a snapshot that may be stale by the time it is used; pushes that
+  // claimed a cell but have not filled it yet are counted
+  size_type size_approx() const {
+    size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+    size_t head = dequeue_pos_.load(std::memory_order_acquire);
+    return tail - head < kCapacity ? tail - head : kCapacity;
+  }
+  bool empty_approx() const { return size_approx() == 0; }
+  static constexpr size_type capacity() { return kCapacity; }
+
+ private:
+  struct Cell {
+    T* Value() { return reinterpret_cast<T*>(&value_); }
+
+    std::atomic<size_t> sequence_;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type value_;
+  };
+
+  std::atomic<size_t> enqueue_pos_{0};
+  char enqueue_pad_[kCacheLineSize];
+  std::atomic<size_t> dequeue_pos_{0};
+  char dequeue_pad_[kCacheLineSize];
+  Cell cells_[kCapacity];
+};
+
+template <typename T, size_t Capacity>
+constexpr size_t FixedMpmcQueue<T, Capacity>::kCapacity;
@@ -0,0 +1,184 @@
+#pragma once
+#include "fixed_buffer_resource.hpp"
+
+#if defined(EXT_STL_HAS_PMR)
+#include <map>
+#include <set>
+#include <list>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <forward_list>
+#include <unordered_map>
+#include <unordered_set>
+#include <initializer_list>
+
+// std::pmr containers that own a FixedBufferResource sized for Capacity
+// elements: the same inline buffer then heap behaviour as the Fixed*
+// containers, but with the std::pmr allocator model, so they mix with
+// other pmr aware code. Copies and moves go element by element into the
+// destination's own buffer, as the resources of two containers never
+// compare equal.
+namespace pmr {
+
+// a base class, so the resource is built before and destroyed after the
+// container that uses it
+template <size_t Bytes>
+struct FixedResourceHolder {
+  FixedBufferResource<Bytes> resource_;
+};
+
+template <typename Container>
+auto ReserveInline(Container& con, size_t count, int)
+    -> decltype(con.reserve(count), void()) {
+  con.reserve(count);
+}
+
+template <typename Container>
+void ReserveInline(Container&, size_t, long) {}
+
+template <typename Container, size_t Capacity, size_t Bytes>
+class FixedContainer : private FixedResourceHolder<Bytes>, public Container {
+ public:
+  using BaseType = Container;
+  using allocator_type = typename BaseType::allocator_type;
+  using value_type = typename BaseType::value_type;
+
+  // containers that can reserve take their Capacity elements up front,
+  // so growing up to it never leaves dead copies in the buffer
+  FixedContainer() : BaseType(allocator_type(&this->resource_)) {
+    ReserveInline(static_cast<BaseType&>(*this), Capacity, 0);
+  }
+
+  FixedContainer(std::initializer_list<value_type> init) : FixedContainer() {
+    BaseType::operator=(init);
+  }
+
+  FixedContainer(const FixedContainer& other) : FixedContainer() {
+    BaseType::operator=(other);
+  }
+
+  FixedContainer(FixedContainer&& other) : FixedContainer() {
+    BaseType::operator=(std::move(other));
+  }
+
+  explicit FixedContainer(const BaseType& other) : FixedContainer() {
+    BaseType::operator=(other);
+  }
+
+  explicit FixedContainer(BaseType&& other) : FixedContainer() {
+    BaseType::operator=(std::move(other));
+  }
+
+  FixedContainer& operator=(const FixedContainer& other) {
+    BaseType::operator=(other);
+    return *this;
+  }
+
+  FixedContainer& operator=(FixedContainer&& other) {
+    if (this != &other) {
+      BaseType::operator=(std::move(other));
+    }
+    return *this;
+  }
+
+  FixedContainer& operator=(std::initializer_list<value_type> init) {
+    BaseType::operator=(init);
+    return *this;
+  }
+
+  // std swap requires equal allocators, which two containers never have
+  void swap(FixedContainer& other) {
+    if (this == &other) {
+      return;
+    }
+    FixedContainer tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+  FixedBufferResource<Bytes>* resource() { return &this->resource_; }
+};
+
+template <typename Container, size_t Capacity, size_t Bytes>
+void swap(FixedContainer<Container, Capacity, Bytes>& lhs,
+          FixedContainer<Container, Capacity, Bytes>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename T, size_t Capacity>
+using FixedVector =
+    FixedContainer<std::pmr::vector<T>, Capacity, Capacity * sizeof(T)>;
+
+template <typename CharT, size_t Capacity,
+          typename Traits = std::char_traits<CharT>>
+using FixedBasicString =
+    FixedContainer<std::pmr::basic_string<CharT, Traits>, Capacity,
+                   (Capacity + 1) * sizeof(CharT)>;
+
+template <size_t Capacity>
+using FixedString = FixedBasicString<char, Capacity>;
+
+template <typename T, size_t Capacity>
+using FixedList = FixedContainer<std::pmr::list<T>, Capacity,
+                                 Capacity * sizeof(std::_List_node<T>)>;
+
+template <typename T, size_t Capacity>
+using FixedForwardList =
+    FixedContainer<std::pmr::forward_list<T>, Capacity,
+                   Capacity * sizeof(std::_Fwd_list_node<T>)>;
+
+template <typename KeyType, typename ValueType, size_t Capacity,
+          typename Compare = std::less<KeyType>>
+using FixedMap = FixedContainer<
+    std::pmr::map<KeyType, ValueType, Compare>, Capacity,
+    Capacity *
+        sizeof(std::_Rb_tree_node<std::pair<const KeyType, ValueType>>)>;
+
+template <typename KeyType, typename ValueType, size_t Capacity,
+          typename Compare = std::less<KeyType>>
+using FixedMultiMap = FixedContainer<
+    std::pmr::multimap<KeyType, ValueType, Compare>, Capacity,
+    Capacity *
+        sizeof(std::_Rb_tree_node<std::pair<const KeyType, ValueType>>)>;
+
+template <typename KeyType, size_t Capacity,
+          typename Compare = std::less<KeyType>>
+using FixedSet =
+    FixedContainer<std::pmr::set<KeyType, Compare>, Capacity,
+                   Capacity * sizeof(std::_Rb_tree_node<KeyType>)>;
+
+template <typename KeyType, size_t Capacity,
+          typename Compare = std::less<KeyType>>
+using FixedMultiSet =
+    FixedContainer<std::pmr::multiset<KeyType, Compare>, Capacity,
+                   Capacity * sizeof(std::_Rb_tree_node<KeyType>)>;
+
+// nodes plus the bucket array, which reserve() sizes to the next prime
+// past Capacity; twice that is room to spare
+template <typename Value, typename KeyType, typename Hash, size_t Capacity>
+constexpr size_t HashInlineBytes() {
+  return Capacity *
+             sizeof(std::__detail::_Hash_node<
+                    Value, std::__cache_default<KeyType, Hash>::value>) +
+         (2 * Capacity + 2) * sizeof(void*);
+}
+
+template <typename KeyType, typename ValueType, size_t Capacity,
+          typename Hash = std::hash<KeyType>,
+          typename KeyEqual = std::equal_to<KeyType>>
+using FixedUnorderedMap = FixedContainer<
+    std::pmr::unordered_map<KeyType, ValueType, Hash, KeyEqual>, Capacity,
+    HashInlineBytes<std::pair<const KeyType, ValueType>, KeyType, Hash,
+                    Capacity>()>;
+
+template <typename KeyType, size_t Capacity,
+          typename Hash = std::hash<KeyType>,
+          typename KeyEqual = std::equal_to<KeyType>>
+using FixedUnorderedSet = FixedContainer<
+    std::pmr::unordered_set<KeyType, Hash, KeyEqual>, Capacity,
+    HashInlineBytes<KeyType, KeyType, Hash, Capacity>()>;
+
+}  // namespace pmr
+#endif
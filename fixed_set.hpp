@@ -7,7 +7,8 @@
 template <typename T>
 using __std_tree_node_t = std::_Rb_tree_node<T>;
 
-template <typename T, size_t Capacity, typename Compare = std::less<T>>
+template <typename T, size_t Capacity, typename Compare = std::less<T>,
+          typename Slabs = HeapSlabs>
 class FixedSet
     : public std::set<T, Compare,
                       StackAllocator<__std_tree_node_t<T>, Capacity>> {
@@ -49,32 +50,44 @@ class FixedSet
     insert(first, last);
   }
 
-  FixedSet(const FixedSet& other) : FixedSet() {
-    insert(std::begin(other), std::end(other));
+  // the range is sorted by comp, the tree is linked up in linear time
+  template <typename InputIterator>
+  FixedSet(sorted_unique_t, InputIterator first, InputIterator last,
+           const Compare& comp = Compare())
+      : FixedSet(comp) {
+    BuildSortedTree(static_cast<BaseType&>(*this), first, last);
   }
 
-  FixedSet(FixedSet&& other) : FixedSet() {
-    insert(std::begin(other), std::end(other));
-    other.clear();
+  FixedSet(const FixedSet& other) : FixedSet(other.key_comp()) {
+    BaseType::operator=(other);
   }
 
+  // steal the tree: slab nodes keep their address and the inline ones are
+  // relinked in place, or rebuilt in our buffer when moving them may
+  // throw; other is left empty
+  FixedSet(FixedSet&& other) : FixedSet() { MoveFrom(other); }
+
   FixedSet(std::initializer_list<T> init) : FixedSet() { insert(init); }
 
-  ~FixedSet() = default;
+  ~FixedSet() { BaseType::clear(); }
 
+  // the nodes already held are reused for the new values and the tree
+  // shape is copied as is, O(n) and no allocation when sizes match
   FixedSet& operator=(const FixedSet& other) {
-    insert(std::begin(other), std::end(other));
+    BaseType::operator=(other);
     return *this;
   }
 
   FixedSet& operator=(FixedSet&& other) {
-    insert(std::begin(other), std::end(other));
-    other.clear();
+    if (this != &other) {
+      BaseType::clear();
+      MoveFrom(other);
+    }
     return *this;
   }
 
   FixedSet& operator=(std::initializer_list<T> init) {
-    insert(init);
+    BaseType::operator=(init);
     return *this;
   }
 
@@ -93,68 +106,105 @@ class FixedSet
 
   template <typename Comp, typename Alloc>
   FixedSet& operator=(const std::set<T, Comp, Alloc>& other) {
+    BaseType::clear();
     insert(std::begin(other), std::end(other));
     return *this;
   }
 
   template <typename Comp, typename Alloc>
   FixedSet& operator=(std::set<T, Comp, Alloc>&& other) {
+    BaseType::clear();
     insert(std::begin(other), std::end(other));
     other.clear();
     return *this;
   }
 
+  // trade the trees and then the node pools, no element is copied; when
+  // moving a value may throw the sets are copied instead
+  void swap(FixedSet& other) {
+    if (this == &other) {
+      return;
+    }
+    SwapFixed(*this, other, [this, &other] {
+      SwapFixedTree(static_cast<BaseType&>(*this), stack_data_,
+                    static_cast<BaseType&>(other), other.stack_data_);
+    }, NodesRelocatable<typename Allocator::value_type>());
+  }
+
+  // lay the nodes out in key order at the front of the inline buffer, so
+  // iterating reads memory sequentially; invalidates iterators, does
+  // nothing when moving a value may throw
+  void compact() {
+    if (NodesRelocatable<typename Allocator::value_type>::value) {
+      CompactFixedTree(static_cast<BaseType&>(*this), stack_data_);
+    }
+  }
+
  private:
-  ReservsedMemoryType stack_data_;
+  // the tree of other into this empty set
+  void MoveFrom(FixedSet& other) {
+    MoveFixedTree(static_cast<BaseType&>(*this), stack_data_,
+                  static_cast<BaseType&>(other), other.stack_data_,
+                  NodesRelocatable<typename Allocator::value_type>());
+  }
+
+  ReservsedMemoryType stack_data_{Slabs::SlabArena()};
 };
 
-template <typename T, size_t Capacity, typename Compare>
-void swap(FixedSet<T, Capacity, Compare>& lhs,
-          FixedSet<T, Capacity, Compare>& rhs) {
-  FixedSwap(lhs, rhs);
+template <typename T, size_t Capacity, typename Compare, typename Slabs>
+void swap(FixedSet<T, Capacity, Compare, Slabs>& lhs,
+          FixedSet<T, Capacity, Compare, Slabs>& rhs) {
+  lhs.swap(rhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
-inline bool operator==(const FixedSet<T, Capacity1, Compare>& lhs,
-                       const FixedSet<T, Capacity2, Compare>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare,
+          typename Slabs1, typename Slabs2>
+inline bool operator==(const FixedSet<T, Capacity1, Compare, Slabs1>& lhs,
+                       const FixedSet<T, Capacity2, Compare, Slabs2>& rhs) {
   return lhs.size() == rhs.size() &&
          std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs));
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
-inline bool operator!=(const FixedSet<T, Capacity1, Compare>& lhs,
-                       const FixedSet<T, Capacity2, Compare>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare,
+          typename Slabs1, typename Slabs2>
+inline bool operator!=(const FixedSet<T, Capacity1, Compare, Slabs1>& lhs,
+                       const FixedSet<T, Capacity2, Compare, Slabs2>& rhs) {
   return !(lhs == rhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
-inline bool operator<(const FixedSet<T, Capacity1, Compare>& lhs,
-                      const FixedSet<T, Capacity2, Compare>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare,
+          typename Slabs1, typename Slabs2>
+inline bool operator<(const FixedSet<T, Capacity1, Compare, Slabs1>& lhs,
+                      const FixedSet<T, Capacity2, Compare, Slabs2>& rhs) {
   return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
                                       std::begin(rhs), std::end(rhs));
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
-inline bool operator<=(const FixedSet<T, Capacity1, Compare>& lhs,
-                       const FixedSet<T, Capacity2, Compare>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare,
+          typename Slabs1, typename Slabs2>
+inline bool operator<=(const FixedSet<T, Capacity1, Compare, Slabs1>& lhs,
+                       const FixedSet<T, Capacity2, Compare, Slabs2>& rhs) {
   return !(rhs < lhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
-inline bool operator>(const FixedSet<T, Capacity1, Compare>& lhs,
-                      const FixedSet<T, Capacity2, Compare>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare,
+          typename Slabs1, typename Slabs2>
+inline bool operator>(const FixedSet<T, Capacity1, Compare, Slabs1>& lhs,
+                      const FixedSet<T, Capacity2, Compare, Slabs2>& rhs) {
   return rhs < lhs;
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
-inline bool operator>=(const FixedSet<T, Capacity1, Compare>& lhs,
-                       const FixedSet<T, Capacity2, Compare>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare,
+          typename Slabs1, typename Slabs2>
+inline bool operator>=(const FixedSet<T, Capacity1, Compare, Slabs1>& lhs,
+                       const FixedSet<T, Capacity2, Compare, Slabs2>& rhs) {
   return !(lhs < rhs);
 }
 
 // definitoin for FixedMutiSet
 
-template <typename T, size_t Capacity, typename Compare = std::less<T>>
+template <typename T, size_t Capacity, typename Compare = std::less<T>,
+          typename Slabs = HeapSlabs>
 class FixedMultiSet
     : public std::multiset<T, Compare,
                            StackAllocator<__std_tree_node_t<T>, Capacity>> {
@@ -183,9 +233,10 @@ class FixedMultiSet
   using BaseType::size;
   using BaseType::begin;
   using BaseType::end;
-  FixedMultiSet() : BaseType(Compare(), Allocator(&stack_data_)) {}
 
-  explicit FixedMultiSet(const Compare& comp = Compare())
+  FixedMultiSet() : FixedMultiSet(Compare()) {}
+
+  explicit FixedMultiSet(const Compare& comp)
       : BaseType(comp, Allocator(&stack_data_)) {}
 
   template <typename InputIterator>
@@ -195,34 +246,46 @@ class FixedMultiSet
     insert(first, last);
   }
 
-  FixedMultiSet(const FixedMultiSet& other) : FixedMultiSet() {
-    insert(std::begin(other), std::end(other));
+  // the range is sorted by comp, the tree is linked up in linear time
+  template <typename InputIterator>
+  FixedMultiSet(sorted_equivalent_t, InputIterator first, InputIterator last,
+                const Compare& comp = Compare())
+      : FixedMultiSet(comp) {
+    BuildSortedTree(static_cast<BaseType&>(*this), first, last);
   }
 
-  FixedMultiSet(FixedMultiSet&& other) : FixedMultiSet() {
-    insert(std::begin(other), std::end(other));
-    other.clear();
+  FixedMultiSet(const FixedMultiSet& other) : FixedMultiSet(other.key_comp()) {
+    BaseType::operator=(other);
   }
 
+  // steal the tree: slab nodes keep their address and the inline ones are
+  // relinked in place, or rebuilt in our buffer when moving them may
+  // throw; other is left empty
+  FixedMultiSet(FixedMultiSet&& other) : FixedMultiSet() { MoveFrom(other); }
+
   FixedMultiSet(std::initializer_list<T> init) : FixedMultiSet() {
     insert(init);
   }
 
-  ~FixedMultiSet() = default;
+  ~FixedMultiSet() { BaseType::clear(); }
 
+  // the nodes already held are reused for the new values and the tree
+  // shape is copied as is, O(n) and no allocation when sizes match
   FixedMultiSet& operator=(const FixedMultiSet& other) {
-    insert(std::begin(other), std::end(other));
+    BaseType::operator=(other);
     return *this;
   }
 
   FixedMultiSet& operator=(FixedMultiSet&& other) {
-    insert(std::begin(other), std::end(other));
-    other.clear();
+    if (this != &other) {
+      BaseType::clear();
+      MoveFrom(other);
+    }
     return *this;
   }
 
   FixedMultiSet& operator=(std::initializer_list<T> init) {
-    insert(init);
+    BaseType::operator=(init);
     return *this;
   }
 
@@ -241,61 +304,103 @@ class FixedMultiSet
 
   template <typename Comp, typename Alloc>
   FixedMultiSet& operator=(const std::multiset<T, Comp, Alloc>& other) {
+    BaseType::clear();
     insert(std::begin(other), std::end(other));
     return *this;
   }
 
   template <typename Comp, typename Alloc>
   FixedMultiSet& operator=(std::multiset<T, Comp, Alloc>&& other) {
+    BaseType::clear();
     insert(std::begin(other), std::end(other));
     other.clear();
     return *this;
   }
 
+  // trade the trees and then the node pools, no element is copied; when
+  // moving a value may throw the sets are copied instead
+  void swap(FixedMultiSet& other) {
+    if (this == &other) {
+      return;
+    }
+    SwapFixed(*this, other, [this, &other] {
+      SwapFixedTree(static_cast<BaseType&>(*this), stack_data_,
+                    static_cast<BaseType&>(other), other.stack_data_);
+    }, NodesRelocatable<typename Allocator::value_type>());
+  }
+
+  // lay the nodes out in key order at the front of the inline buffer, so
+  // iterating reads memory sequentially; invalidates iterators, does
+  // nothing when moving a value may throw
+  void compact() {
+    if (NodesRelocatable<typename Allocator::value_type>::value) {
+      CompactFixedTree(static_cast<BaseType&>(*this), stack_data_);
+    }
+  }
+
  private:
-  ReservsedMemoryType stack_data_;
+  // the tree of other into this empty set
+  void MoveFrom(FixedMultiSet& other) {
+    MoveFixedTree(static_cast<BaseType&>(*this), stack_data_,
+                  static_cast<BaseType&>(other), other.stack_data_,
+                  NodesRelocatable<typename Allocator::value_type>());
+  }
+
+  ReservsedMemoryType stack_data_{Slabs::SlabArena()};
 };
 
-template <typename T, size_t Capacity, typename Compare>
-void swap(FixedMultiSet<T, Capacity, Compare>& lhs,
-          FixedMultiSet<T, Capacity, Compare>& rhs) {
-  FixedMultiSwap(lhs, rhs);
+template <typename T, size_t Capacity, typename Compare, typename Slabs>
+void swap(FixedMultiSet<T, Capacity, Compare, Slabs>& lhs,
+          FixedMultiSet<T, Capacity, Compare, Slabs>& rhs) {
+  lhs.swap(rhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
-inline bool operator==(const FixedMultiSet<T, Capacity1, Compare>& lhs,
-                       const FixedMultiSet<T, Capacity2, Compare>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare,
+          typename Slabs1, typename Slabs2>
+inline bool operator==(
+    const FixedMultiSet<T, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMultiSet<T, Capacity2, Compare, Slabs2>& rhs) {
   return lhs.size() == rhs.size() &&
          std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs));
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
-inline bool operator!=(const FixedMultiSet<T, Capacity1, Compare>& lhs,
-                       const FixedMultiSet<T, Capacity2, Compare>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare,
+          typename Slabs1, typename Slabs2>
+inline bool operator!=(
+    const FixedMultiSet<T, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMultiSet<T, Capacity2, Compare, Slabs2>& rhs) {
   return !(lhs == rhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
-inline bool operator<(const FixedMultiSet<T, Capacity1, Compare>& lhs,
-                      const FixedMultiSet<T, Capacity2, Compare>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare,
+          typename Slabs1, typename Slabs2>
+inline bool operator<(
+    const FixedMultiSet<T, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMultiSet<T, Capacity2, Compare, Slabs2>& rhs) {
   return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
                                       std::begin(rhs), std::end(rhs));
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
-inline bool operator<=(const FixedMultiSet<T, Capacity1, Compare>& lhs,
-                       const FixedMultiSet<T, Capacity2, Compare>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare,
+          typename Slabs1, typename Slabs2>
+inline bool operator<=(
+    const FixedMultiSet<T, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMultiSet<T, Capacity2, Compare, Slabs2>& rhs) {
   return !(rhs < lhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
-inline bool operator>(const FixedMultiSet<T, Capacity1, Compare>& lhs,
-                      const FixedMultiSet<T, Capacity2, Compare>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare,
+          typename Slabs1, typename Slabs2>
+inline bool operator>(
+    const FixedMultiSet<T, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMultiSet<T, Capacity2, Compare, Slabs2>& rhs) {
   return rhs < lhs;
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2, typename Compare>
-inline bool operator>=(const FixedMultiSet<T, Capacity1, Compare>& lhs,
-                       const FixedMultiSet<T, Capacity2, Compare>& rhs) {
+template <typename T, size_t Capacity1, size_t Capacity2, typename Compare,
+          typename Slabs1, typename Slabs2>
+inline bool operator>=(
+    const FixedMultiSet<T, Capacity1, Compare, Slabs1>& lhs,
+    const FixedMultiSet<T, Capacity2, Compare, Slabs2>& rhs) {
   return !(lhs < rhs);
 }
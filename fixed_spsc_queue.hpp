@@ -0,0 +1,217 @@
+#pragma once
+#include <atomic>
+#include <cstring>
+#include <cstddef>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include "utils.hpp"
+
+// A bounded queue between exactly one producer thread and one consumer
+// thread, lock free and without allocation: the ring of Capacity slots,
+// rounded up to a power of two, is stored inline like the buffer of
+// StackAllocatorVector::ReservedMemory. Only the producer may call the
+// push functions and only the consumer the pop ones and front().
+//
+// The head (next slot to read) and tail (next slot to write) count up
+// without wrapping and sit a cache line apart, each next to the owner's
+// cached copy of the other index, so a thread only touches the other's
+// line when the ring looks full or empty from its copy. The batch calls
+// move up to n elements and publish them with one store.
+template <typename T, size_t Capacity>
+class FixedSpscQueue {
+  static_assert(Capacity > 0, "FixedSpscQueue needs a non-empty ring");
+
+ public:
+  static constexpr size_t kCapacity = RingSlots(Capacity);
+
+  using value_type = T;
+  using size_type = size_t;
+
+  FixedSpscQueue() = default;
+  FixedSpscQueue(const FixedSpscQueue&) = delete;
+  FixedSpscQueue& operator=(const FixedSpscQueue&) = delete;
+
+  // no thread may be using the queue any more
+  ~FixedSpscQueue() {
+    size_t tail = tail_.load(std::memory_order_acquire);
+    for (size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+      Slot(i)->~T();
+    }
+  }
+
+  // producer side
+
+  bool try_push(const T& value) { return try_emplace(value); }
+  bool try_push(T&& value) { return try_emplace(std::move(value)); }
+
+  template <typename... Args>
+  bool try_emplace(Args&&... args) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_cache_ == kCapacity) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail - head_cache_ == kCapacity) {
+        return false;
+      }
+    }
+    new (Slot(tail)) T(std::forward<Args>(args)...);
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  // push the first elements of [first, first + n) that fit, returns how
+  // many that was
+  template <typename InputIterator>
+  size_type try_push_n(InputIterator first, size_type n) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (kCapacity - (tail - head_cache_) < n) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+    }
+    n = std::min(n, kCapacity - (tail - head_cache_));
+    if (n == 0) {
+      return 0;
+    }
+    CopyIn(tail, first, n, std::integral_constant<
+                               bool, std::is_trivially_copyable<T>::value &&
+                                         IsPointerTo<InputIterator>::value>());
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  // consumer side
+
+  bool try_pop(T& value) {
+    T* slot = front();
+    if (slot == nullptr) {
+      return false;
+    }
+    value = std::move(*slot);
+    pop();
+    return true;
+  }
+
+  // the oldest element, nullptr when the queue is empty
+  T* front() {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_cache_) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head == tail_cache_) {
+        return nullptr;
+      }
+    }
+    return Slot(head);
+  }
+
+  // drop the element front() returned
+  void pop() {
+    size_t head = head_.load(std::memory_order_relaxed);
+    Slot(head)->~T();
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  // move up to n elements to out, returns how many that was
+  template <typename OutputIterator>
+  size_type try_pop_n(OutputIterator out, size_type n) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (tail_cache_ - head < n) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+    }
+    n = std::min(n, tail_cache_ - head);
+    if (n == 0) {
+      return 0;
+    }
+    MoveOut(head, out, n, std::integral_constant<
+                              bool, std::is_trivially_copyable<T>::value &&
+                                        std::is_same<OutputIterator,
+                                                     T*>::value>());
+    head_.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  // either side, a snapshot that may be stale by the time it is used
+  size_type size_approx() const {
+    size_t tail = tail_.load(std::memory_order_acquire);
+    size_t head = head_.load(std::memory_order_acquire);
+    return tail - head;
+  }
+  bool empty_approx() const { return size_approx() == 0; }
+  static constexpr size_type capacity() { return kCapacity; }
+
+ private:
+  using AlignedStorage =
+      typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+  template <typename Iterator>
+  using IsPointerTo = std::integral_constant<
+      bool, std::is_pointer<Iterator>::value &&
+                std::is_same<typename std::remove_cv<typename std::
+                                 remove_pointer<Iterator>::type>::type,
+                             T>::value>;
+
+  T* Slot(size_t index) {
+    return reinterpret_cast<T*>(&buffer_[index & (kCapacity - 1)]);
+  }
+
+  // the n slots from index are at most two runs
+  template <typename Pointer>
+  void CopyIn(size_t index, Pointer first, size_type n, std::true_type) {
+    size_t slot = index & (kCapacity - 1);
+    size_type run = std::min(n, kCapacity - slot);
+    std::memcpy(static_cast<void*>(Slot(index)), first, run * sizeof(T));
+    std::memcpy(static_cast<void*>(Slot(0)), first + run,
+                (n - run) * sizeof(T));
+  }
+
+  // a throwing copy leaves the ring as it was
+  template <typename InputIterator>
+  void CopyIn(size_t index, InputIterator first, size_type n,
+              std::false_type) {
+    size_type i = 0;
+    try {
+      for (; i < n; ++i, ++first) new (Slot(index + i)) T(*first);
+    } catch (...) {
+      while (i-- > 0) Slot(index + i)->~T();
+      throw;
+    }
+  }
+
+  void MoveOut(size_t index, T* out, size_type n, std::true_type) {
+    size_t slot = index & (kCapacity - 1);
+    size_type run = std::min(n, kCapacity - slot);
+    std::memcpy(static_cast<void*>(out), Slot(index), run * sizeof(T));
+    std::memcpy(static_cast<void*>(out + run), Slot(0),
+                (n - run) * sizeof(T));
+  }
+
+  // the slots moved out before an assignment throws are destroyed
+  // already, so they are given back to the producer before rethrowing;
+  // the one that threw stays at the front
+  template <typename OutputIterator>
+  void MoveOut(size_t index, OutputIterator out, size_type n,
+               std::false_type) {
+    size_type i = 0;
+    try {
+      for (; i < n; ++i, ++out) {
+        T* slot = Slot(index + i);
+        *out = std::move(*slot);
+        slot->~T();
+      }
+    } catch (...) {
+      head_.store(index + i, std::memory_order_release);
+      throw;
+    }
+  }
+
+  // consumer line
+  std::atomic<size_t> head_{0};
+  size_t tail_cache_ = 0;
+  char head_pad_[kCacheLineSize];
+  // producer line
+  std::atomic<size_t> tail_{0};
+  size_t head_cache_ = 0;
+  char tail_pad_[kCacheLineSize];
+  AlignedStorage buffer_[kCapacity];
+};
+
+template <typename T, size_t Capacity>
+constexpr size_t FixedSpscQueue<T, Capacity>::kCapacity;
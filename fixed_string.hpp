@@ -1,160 +1,844 @@
 #pragma once
 #include <string>
+#include <memory>
+#include <ostream>
+#include <iterator>
 #include <algorithm>
-#include "stack_allocator_vec.hpp"
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+#include <cstring>
+#include <cstdint>
+#include <cassert>
+
+// A string with its first Capacity characters stored inline, not built on
+// std::basic_string, so there is no SSO or COW underneath to fight with.
+// The object is a data pointer, length, capacity and the buffer, strings up
+// to Capacity characters never touch the heap and longer ones spill to it.
+// shrink_to_fit() brings a short enough string back to the inline buffer.
+template <typename CharT, size_t Capacity,
+          typename Traits = std::char_traits<CharT>>
+class FixedBasicString {
+  static_assert(Capacity > 0, "FixedBasicString needs a non-empty buffer");
 
-template <typename CharT, size_t Capacity>
-class FixedBasicString
-    : public std::basic_string<CharT, std::char_traits<char>,
-                               StackAllocatorVector<CharT, Capacity>> {
  public:
-  using BaseType = std::basic_string<CharT, std::char_traits<CharT>,
-                                     StackAllocatorVector<CharT, Capacity>>;
-  using Allocator = StackAllocatorVector<CharT, Capacity>;
-  using ReservsedMemoryType = typename Allocator::ReservedMemory;
-
-  using reference = typename BaseType::reference;
-  using const_reference = typename BaseType::const_reference;
-  using iterator = typename BaseType::iterator;
-  using const_iterator = typename BaseType::const_iterator;
-  using size_type = typename BaseType::size_type;
-  using allocator_type = typename BaseType::allocator_type;
-  using pointer = typename BaseType::pointer;
-  using const_pointer = typename BaseType::const_pointer;
-  using reverse_iterator = typename BaseType::reverse_iterator;
-  using const_reverse_iterator = typename BaseType::const_reverse_iterator;
-
-  using BaseType::assign;
-  using BaseType::size;
-  using BaseType::resize;
-  using BaseType::reserve;
-  using BaseType::begin;
-  using BaseType::end;
-  using BaseType::get_allocator;
-
-  FixedBasicString() : BaseType(Allocator(&stack_data_)) { reserve(Capacity); }
+  using traits_type = Traits;
+  using value_type = CharT;
+  using reference = CharT&;
+  using const_reference = const CharT&;
+  using pointer = CharT*;
+  using const_pointer = const CharT*;
+  using iterator = CharT*;
+  using const_iterator = const CharT*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using allocator_type = std::allocator<CharT>;
+  using StdString = std::basic_string<CharT, Traits>;
+
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+  FixedBasicString() : data_(buffer_), size_(0), capacity_(Capacity) {
+    buffer_[0] = CharT();
+  }
 
   explicit FixedBasicString(size_type n) : FixedBasicString() { resize(n); }
 
-  explicit FixedBasicString(size_type n, const CharT& value)
+  FixedBasicString(size_type n, CharT ch) : FixedBasicString() {
+    assign(n, ch);
+  }
+
+  FixedBasicString(const CharT* s, size_type count) : FixedBasicString() {
+    assign(s, count);
+  }
+
+  FixedBasicString(const CharT* s) : FixedBasicString() { assign(s); }
+
+  template <typename InputIterator,
+            typename = typename std::enable_if<!std::is_integral<
+                InputIterator>::value>::type>
+  FixedBasicString(InputIterator first, InputIterator last)
       : FixedBasicString() {
-    assign(n, value);
+    assign(first, last);
+  }
+
+  FixedBasicString(std::initializer_list<CharT> ilist) : FixedBasicString() {
+    assign(ilist);
   }
 
   FixedBasicString(const FixedBasicString& other) : FixedBasicString() {
-    assign(other.begin(), other.end());
+    assign(other.data(), other.size());
   }
 
   FixedBasicString(FixedBasicString&& other) : FixedBasicString() {
-    assign(other.begin(), other.end());
-    other.clear();
+    TakeFrom(other);
   }
 
-  FixedBasicString(const CharT* s, size_type count) : FixedBasicString() {
-    assign(s, count);
+  FixedBasicString(const StdString& other) : FixedBasicString() {
+    assign(other.data(), other.size());
   }
 
-  FixedBasicString(const CharT* s) : FixedBasicString() { assign(s); }
-
-  ~FixedBasicString() = default;
+  ~FixedBasicString() { FreeHeap(); }
 
-  FixedBasicString(std::initializer_list<CharT> ilist) { assign(ilist); }
+  FixedBasicString& operator=(const FixedBasicString& other) {
+    if (this != &other) {
+      assign(other.data(), other.size());
+    }
+    return *this;
+  }
 
-  FixedBasicString& operator=(const FixedBasicString<CharT, Capacity>& other) {
-    assign(other.begin(), other.end());
+  FixedBasicString& operator=(FixedBasicString&& other) {
+    if (this != &other) {
+      FreeHeap();
+      TakeFrom(other);
+    }
     return *this;
   }
 
+  FixedBasicString& operator=(const CharT* s) { return assign(s); }
+
+  FixedBasicString& operator=(CharT ch) { return assign(1, ch); }
+
   FixedBasicString& operator=(std::initializer_list<CharT> ilist) {
-    assign(ilist);
+    return assign(ilist);
+  }
+
+  FixedBasicString& operator=(const StdString& other) {
+    return assign(other.data(), other.size());
+  }
+
+  FixedBasicString& assign(size_type n, CharT ch) {
+    clear();
+    return append(n, ch);
+  }
+
+  FixedBasicString& assign(const FixedBasicString& other) {
+    return *this = other;
+  }
+
+  FixedBasicString& assign(FixedBasicString&& other) {
+    return *this = std::move(other);
+  }
+
+  FixedBasicString& assign(const CharT* s, size_type count) {
+    if (count > capacity_) {
+      Reallocate(NextCapacity(count));
+    }
+    Traits::move(data_, s, count);
+    SetSize(count);
     return *this;
   }
 
-  template <typename InputIterator>
-  FixedBasicString(InputIterator first, InputIterator last)
-      : FixedBasicString() {
-    assign(first, last);
+  FixedBasicString& assign(const CharT* s) {
+    return assign(s, Traits::length(s));
   }
 
-  FixedBasicString(const std::basic_string<CharT>& other) : FixedBasicString() {
-    assign(other);
+  template <typename InputIterator,
+            typename = typename std::enable_if<!std::is_integral<
+                InputIterator>::value>::type>
+  FixedBasicString& assign(InputIterator first, InputIterator last) {
+    clear();
+    return append(first, last);
   }
 
-  FixedBasicString(std::basic_string<CharT>&& other) : FixedBasicString() {
-    assign(other);
-    other.clear();
+  FixedBasicString& assign(std::initializer_list<CharT> ilist) {
+    return assign(ilist.begin(), ilist.size());
   }
 
-  FixedBasicString& operator=(const std::basic_string<CharT>& other) {
-    assign(other);
+  FixedBasicString& assign(const StdString& other) {
+    return assign(other.data(), other.size());
   }
 
-  FixedBasicString& operator=(std::basic_string<CharT>&& other) {
-    assign(other);
-    other.clear();
+  allocator_type get_allocator() const { return allocator_type(); }
+
+  // element access
+  reference at(size_type pos) {
+    if (pos >= size_) throw std::out_of_range("FixedBasicString::at");
+    return data_[pos];
+  }
+  const_reference at(size_type pos) const {
+    if (pos >= size_) throw std::out_of_range("FixedBasicString::at");
+    return data_[pos];
+  }
+  reference operator[](size_type pos) { return data_[pos]; }
+  const_reference operator[](size_type pos) const { return data_[pos]; }
+  reference front() { return data_[0]; }
+  const_reference front() const { return data_[0]; }
+  reference back() { return data_[size_ - 1]; }
+  const_reference back() const { return data_[size_ - 1]; }
+  CharT* data() { return data_; }
+  const CharT* data() const { return data_; }
+  const CharT* c_str() const { return data_; }
+  StdString str() const { return StdString(data_, size_); }
+
+  // iterators
+  iterator begin() { return data_; }
+  const_iterator begin() const { return data_; }
+  const_iterator cbegin() const { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator end() const { return data_ + size_; }
+  const_iterator cend() const { return data_ + size_; }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator crbegin() const {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+  const_reverse_iterator crend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  // capacity
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+  size_type length() const { return size_; }
+  size_type max_size() const { return allocator_type().max_size() - 1; }
+  size_type capacity() const { return capacity_; }
+  bool use_stack_memory() const { return data_ == buffer_; }
+
+  void reserve(size_type n) {
+    if (n > capacity_) {
+      Reallocate(n);
+    }
   }
 
-  // rewrite this function
+  // go back to the inline buffer whenever the characters fit in it
   void shrink_to_fit() {
-    Allocator alloc = get_allocator();
-    if (alloc.use_stack_memory()) {
+    if (use_stack_memory() || size_ == capacity_) {
       return;
     }
-    // copy back from heap to stack
-    if (size() < Capacity) {
-      FixedBasicString tmp(*this);
-      tmp.swap(*this);
+    Reallocate(size_ <= Capacity ? Capacity : size_);
+  }
+
+  // modifiers
+  void clear() { SetSize(0); }
+
+  FixedBasicString& insert(size_type index, size_type count, CharT ch) {
+    CheckPos(index, "FixedBasicString::insert");
+    Traits::assign(MakeRoom(index, count), count, ch);
+    SetSize(size_ + count);
+    return *this;
+  }
+
+  FixedBasicString& insert(size_type index, const CharT* s, size_type count) {
+    CheckPos(index, "FixedBasicString::insert");
+    return Replace(index, 0, s, count);
+  }
+
+  FixedBasicString& insert(size_type index, const CharT* s) {
+    return insert(index, s, Traits::length(s));
+  }
+
+  FixedBasicString& insert(size_type index, const FixedBasicString& str) {
+    return insert(index, str.data(), str.size());
+  }
+
+  iterator insert(const_iterator pos, CharT ch) {
+    return insert(pos, 1, ch);
+  }
+
+  iterator insert(const_iterator pos, size_type count, CharT ch) {
+    size_type index = pos - cbegin();
+    insert(index, count, ch);
+    return begin() + index;
+  }
+
+  template <typename InputIterator,
+            typename = typename std::enable_if<!std::is_integral<
+                InputIterator>::value>::type>
+  iterator insert(const_iterator pos, InputIterator first,
+                  InputIterator last) {
+    size_type index = pos - cbegin();
+    FixedBasicString tmp(first, last);
+    insert(index, tmp.data(), tmp.size());
+    return begin() + index;
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<CharT> ilist) {
+    size_type index = pos - cbegin();
+    insert(index, ilist.begin(), ilist.size());
+    return begin() + index;
+  }
+
+  FixedBasicString& erase(size_type index = 0, size_type count = npos) {
+    CheckPos(index, "FixedBasicString::erase");
+    count = std::min(count, size_ - index);
+    Traits::move(data_ + index, data_ + index + count, size_ - index - count);
+    SetSize(size_ - count);
+    return *this;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    size_type index = first - cbegin();
+    erase(index, last - first);
+    return begin() + index;
+  }
+
+  // stores through CharT* may alias the members, so work on locals
+  void push_back(CharT ch) {
+    size_type n = size_;
+    if (n == capacity_) {
+      Reallocate(NextCapacity(n + 1));
+    }
+    CharT* p = data_;
+    p[n] = ch;
+    p[n + 1] = CharT();
+    size_ = n + 1;
+  }
+
+  void pop_back() { SetSize(size_ - 1); }
+
+  FixedBasicString& append(size_type count, CharT ch) {
+    if (size_ + count > capacity_) {
+      Reallocate(NextCapacity(size_ + count));
+    }
+    Traits::assign(data_ + size_, count, ch);
+    SetSize(size_ + count);
+    return *this;
+  }
+
+  FixedBasicString& append(const FixedBasicString& str) {
+    return append(str.data(), str.size());
+  }
+
+  FixedBasicString& append(const FixedBasicString& str, size_type pos,
+                           size_type count = npos) {
+    str.CheckPos(pos, "FixedBasicString::append");
+    return append(str.data() + pos, std::min(count, str.size() - pos));
+  }
+
+  // s may point into this string, so it is copied before the old buffer
+  // is released
+  FixedBasicString& append(const CharT* s, size_type count) {
+    if (size_ + count > capacity_) {
+      return Replace(size_, 0, s, count);
+    }
+    Traits::copy(data_ + size_, s, count);
+    SetSize(size_ + count);
+    return *this;
+  }
+
+  FixedBasicString& append(const CharT* s) {
+    return append(s, Traits::length(s));
+  }
+
+  template <typename InputIterator,
+            typename = typename std::enable_if<!std::is_integral<
+                InputIterator>::value>::type>
+  FixedBasicString& append(InputIterator first, InputIterator last) {
+    for (; first != last; ++first) push_back(*first);
+    return *this;
+  }
+
+  FixedBasicString& append(std::initializer_list<CharT> ilist) {
+    return append(ilist.begin(), ilist.size());
+  }
+
+  FixedBasicString& append(const StdString& str) {
+    return append(str.data(), str.size());
+  }
+
+  FixedBasicString& operator+=(const FixedBasicString& str) {
+    return append(str);
+  }
+  FixedBasicString& operator+=(CharT ch) {
+    push_back(ch);
+    return *this;
+  }
+  FixedBasicString& operator+=(const CharT* s) { return append(s); }
+  FixedBasicString& operator+=(std::initializer_list<CharT> ilist) {
+    return append(ilist);
+  }
+  FixedBasicString& operator+=(const StdString& str) { return append(str); }
+
+  FixedBasicString& replace(size_type pos, size_type count,
+                            const CharT* s, size_type count2) {
+    CheckPos(pos, "FixedBasicString::replace");
+    return Replace(pos, std::min(count, size_ - pos), s, count2);
+  }
+
+  FixedBasicString& replace(size_type pos, size_type count, const CharT* s) {
+    return replace(pos, count, s, Traits::length(s));
+  }
+
+  FixedBasicString& replace(size_type pos, size_type count,
+                            const FixedBasicString& str) {
+    return replace(pos, count, str.data(), str.size());
+  }
+
+  FixedBasicString& replace(const_iterator first, const_iterator last,
+                            const FixedBasicString& str) {
+    return replace(first - cbegin(), last - first, str);
+  }
+
+  size_type copy(CharT* dest, size_type count, size_type pos = 0) const {
+    CheckPos(pos, "FixedBasicString::copy");
+    count = std::min(count, size_ - pos);
+    Traits::copy(dest, data_ + pos, count);
+    return count;
+  }
+
+  void resize(size_type n) { resize(n, CharT()); }
+
+  void resize(size_type n, CharT ch) {
+    if (n > size_) {
+      append(n - size_, ch);
     } else {
-      BaseType::shrink_to_fit();
+      SetSize(n);
     }
   }
 
+  // exchange the heap buffers when both strings are spilled, otherwise
+  // copy the shorter characters through the stack
+  void swap(FixedBasicString& other) {
+    if (this == &other) {
+      return;
+    }
+    if (!use_stack_memory() && !other.use_stack_memory()) {
+      std::swap(data_, other.data_);
+      std::swap(size_, other.size_);
+      std::swap(capacity_, other.capacity_);
+      return;
+    }
+    FixedBasicString tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+  // operations
+  int compare(const CharT* s, size_type count) const {
+    int result = Traits::compare(data_, s, std::min(size_, count));
+    if (result != 0) {
+      return result;
+    }
+    return size_ < count ? -1 : size_ > count ? 1 : 0;
+  }
+
+  int compare(const FixedBasicString& str) const {
+    return compare(str.data(), str.size());
+  }
+
+  int compare(const CharT* s) const { return compare(s, Traits::length(s)); }
+
+  int compare(const StdString& str) const {
+    return compare(str.data(), str.size());
+  }
+
+  int compare(size_type pos, size_type count,
+              const FixedBasicString& str) const {
+    return substr(pos, count).compare(str);
+  }
+
+  FixedBasicString substr(size_type pos = 0, size_type count = npos) const {
+    CheckPos(pos, "FixedBasicString::substr");
+    return FixedBasicString(data_ + pos, std::min(count, size_ - pos));
+  }
+
+  // search
+  size_type find(const CharT* s, size_type pos, size_type count) const {
+    if (count == 0) {
+      return pos <= size_ ? pos : npos;
+    }
+    for (; pos + count <= size_; ++pos) {
+      const CharT* hit = Traits::find(data_ + pos, size_ - count - pos + 1,
+                                      s[0]);
+      if (hit == nullptr) {
+        return npos;
+      }
+      pos = hit - data_;
+      if (Traits::compare(hit, s, count) == 0) {
+        return pos;
+      }
+    }
+    return npos;
+  }
+  size_type find(const FixedBasicString& str, size_type pos = 0) const {
+    return find(str.data(), pos, str.size());
+  }
+  size_type find(const CharT* s, size_type pos = 0) const {
+    return find(s, pos, Traits::length(s));
+  }
+  size_type find(CharT ch, size_type pos = 0) const {
+    if (pos >= size_) {
+      return npos;
+    }
+    const CharT* hit = Traits::find(data_ + pos, size_ - pos, ch);
+    return hit == nullptr ? npos : hit - data_;
+  }
+
+  size_type rfind(const CharT* s, size_type pos, size_type count) const {
+    if (count > size_) {
+      return npos;
+    }
+    pos = std::min(pos, size_ - count);
+    do {
+      if (Traits::compare(data_ + pos, s, count) == 0) {
+        return pos;
+      }
+    } while (pos-- > 0);
+    return npos;
+  }
+  size_type rfind(const FixedBasicString& str, size_type pos = npos) const {
+    return rfind(str.data(), pos, str.size());
+  }
+  size_type rfind(const CharT* s, size_type pos = npos) const {
+    return rfind(s, pos, Traits::length(s));
+  }
+  size_type rfind(CharT ch, size_type pos = npos) const {
+    return rfind(&ch, pos, 1);
+  }
+
+  size_type find_first_of(const CharT* s, size_type pos,
+                          size_type count) const {
+    for (; pos < size_; ++pos) {
+      if (Traits::find(s, count, data_[pos]) != nullptr) return pos;
+    }
+    return npos;
+  }
+  size_type find_first_of(const FixedBasicString& str,
+                          size_type pos = 0) const {
+    return find_first_of(str.data(), pos, str.size());
+  }
+  size_type find_first_of(const CharT* s, size_type pos = 0) const {
+    return find_first_of(s, pos, Traits::length(s));
+  }
+  size_type find_first_of(CharT ch, size_type pos = 0) const {
+    return find(ch, pos);
+  }
+
+  size_type find_first_not_of(const CharT* s, size_type pos,
+                              size_type count) const {
+    for (; pos < size_; ++pos) {
+      if (Traits::find(s, count, data_[pos]) == nullptr) return pos;
+    }
+    return npos;
+  }
+  size_type find_first_not_of(const FixedBasicString& str,
+                              size_type pos = 0) const {
+    return find_first_not_of(str.data(), pos, str.size());
+  }
+  size_type find_first_not_of(const CharT* s, size_type pos = 0) const {
+    return find_first_not_of(s, pos, Traits::length(s));
+  }
+  size_type find_first_not_of(CharT ch, size_type pos = 0) const {
+    return find_first_not_of(&ch, pos, 1);
+  }
+
+  size_type find_last_of(const CharT* s, size_type pos,
+                         size_type count) const {
+    if (size_ == 0) {
+      return npos;
+    }
+    pos = std::min(pos, size_ - 1);
+    do {
+      if (Traits::find(s, count, data_[pos]) != nullptr) return pos;
+    } while (pos-- > 0);
+    return npos;
+  }
+  size_type find_last_of(const FixedBasicString& str,
+                         size_type pos = npos) const {
+    return find_last_of(str.data(), pos, str.size());
+  }
+  size_type find_last_of(const CharT* s, size_type pos = npos) const {
+    return find_last_of(s, pos, Traits::length(s));
+  }
+  size_type find_last_of(CharT ch, size_type pos = npos) const {
+    return rfind(ch, pos);
+  }
+
+  size_type find_last_not_of(const CharT* s, size_type pos,
+                             size_type count) const {
+    if (size_ == 0) {
+      return npos;
+    }
+    pos = std::min(pos, size_ - 1);
+    do {
+      if (Traits::find(s, count, data_[pos]) == nullptr) return pos;
+    } while (pos-- > 0);
+    return npos;
+  }
+  size_type find_last_not_of(const FixedBasicString& str,
+                             size_type pos = npos) const {
+    return find_last_not_of(str.data(), pos, str.size());
+  }
+  size_type find_last_not_of(const CharT* s, size_type pos = npos) const {
+    return find_last_not_of(s, pos, Traits::length(s));
+  }
+  size_type find_last_not_of(CharT ch, size_type pos = npos) const {
+    return find_last_not_of(&ch, pos, 1);
+  }
+
  private:
-  ReservsedMemoryType stack_data_;
+  void CheckPos(size_type pos, const char* what) const {
+    if (pos > size_) throw std::out_of_range(what);
+  }
+
+  void SetSize(size_type n) {
+    size_ = n;
+    data_[n] = CharT();
+  }
+
+  void FreeHeap() {
+    if (!use_stack_memory()) {
+      allocator_type().deallocate(data_, capacity_ + 1);
+      data_ = buffer_;
+      capacity_ = Capacity;
+    }
+  }
+
+  size_type NextCapacity(size_type required) const {
+    return std::max(capacity_ * 2, required);
+  }
+
+  // move the characters to a buffer of new_capacity, which is the inline
+  // buffer when new_capacity is Capacity
+  void Reallocate(size_type new_capacity) {
+    assert(new_capacity >= size_);
+    CharT* new_data = new_capacity == Capacity
+                          ? buffer_
+                          : allocator_type().allocate(new_capacity + 1);
+    if (new_data == data_) {
+      return;
+    }
+    Traits::copy(new_data, data_, size_ + 1);
+    FreeHeap();
+    data_ = new_data;
+    capacity_ = new_capacity;
+  }
+
+  // open a gap of n characters at index, size_ is left untouched
+  CharT* MakeRoom(size_type index, size_type n) {
+    if (size_ + n > capacity_) {
+      Reallocate(NextCapacity(size_ + n));
+    }
+    Traits::move(data_ + index + n, data_ + index, size_ - index);
+    return data_ + index;
+  }
+
+  // replace count characters at pos by s, which may point into this string
+  FixedBasicString& Replace(size_type pos, size_type count, const CharT* s,
+                            size_type count2) {
+    size_type new_size = size_ - count + count2;
+    if (new_size > capacity_) {
+      FixedBasicString tmp;
+      tmp.reserve(NextCapacity(new_size));
+      Traits::copy(tmp.data_, data_, pos);
+      Traits::copy(tmp.data_ + pos, s, count2);
+      Traits::copy(tmp.data_ + pos + count2, data_ + pos + count,
+                   size_ - pos - count);
+      tmp.SetSize(new_size);
+      return *this = std::move(tmp);
+    }
+    bool aliased = s >= data_ && s <= data_ + size_;
+    if (!aliased) {
+      Traits::move(data_ + pos + count2, data_ + pos + count,
+                   size_ - pos - count);
+      Traits::copy(data_ + pos, s, count2);
+    } else {
+      FixedBasicString tmp(s, count2);
+      Traits::move(data_ + pos + count2, data_ + pos + count,
+                   size_ - pos - count);
+      Traits::copy(data_ + pos, tmp.data(), count2);
+    }
+    SetSize(new_size);
+    return *this;
+  }
+
+  // steal other's heap buffer, or copy its inline characters into ours
+  void TakeFrom(FixedBasicString& other) {
+    if (other.use_stack_memory()) {
+      Traits::copy(data_, other.data_, other.size_);
+      SetSize(other.size_);
+    } else {
+      data_ = other.data_;
+      size_ = other.size_;
+      capacity_ = other.capacity_;
+      other.data_ = other.buffer_;
+      other.capacity_ = Capacity;
+    }
+    other.SetSize(0);
+  }
+
+  CharT* data_;
+  size_type size_;
+  size_type capacity_;
+  CharT buffer_[Capacity + 1];
 };
 
-template <typename T, size_t Capacity>
-void swap(FixedBasicString<T, Capacity>& lhs,
-          FixedBasicString<T, Capacity>& rhs) {
-  FixedSwap(lhs, rhs);
+template <typename CharT, size_t Capacity, typename Traits>
+constexpr typename FixedBasicString<CharT, Capacity, Traits>::size_type
+    FixedBasicString<CharT, Capacity, Traits>::npos;
+
+template <typename CharT, size_t Capacity, typename Traits>
+void swap(FixedBasicString<CharT, Capacity, Traits>& lhs,
+          FixedBasicString<CharT, Capacity, Traits>& rhs) {
+  lhs.swap(rhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator==(const FixedBasicString<T, Capacity1>& lhs,
-                       const FixedBasicString<T, Capacity2>& rhs) {
+template <typename CharT, size_t Capacity1, size_t Capacity2,
+          typename Traits>
+inline bool operator==(const FixedBasicString<CharT, Capacity1, Traits>& lhs,
+                       const FixedBasicString<CharT, Capacity2, Traits>& rhs) {
+  return lhs.size() == rhs.size() &&
+         lhs.compare(rhs.data(), rhs.size()) == 0;
+}
+
+template <typename CharT, size_t Capacity, typename Traits>
+inline bool operator==(const FixedBasicString<CharT, Capacity, Traits>& lhs,
+                       const CharT* rhs) {
   return lhs.compare(rhs) == 0;
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator!=(const FixedBasicString<T, Capacity1>& lhs,
-                       const FixedBasicString<T, Capacity2>& rhs) {
+template <typename CharT, size_t Capacity, typename Traits>
+inline bool operator==(const CharT* lhs,
+                       const FixedBasicString<CharT, Capacity, Traits>& rhs) {
+  return rhs.compare(lhs) == 0;
+}
+
+template <typename CharT, size_t Capacity, typename Traits>
+inline bool operator==(const FixedBasicString<CharT, Capacity, Traits>& lhs,
+                       const std::basic_string<CharT, Traits>& rhs) {
+  return lhs.compare(rhs) == 0;
+}
+
+template <typename CharT, size_t Capacity, typename Traits>
+inline bool operator==(const std::basic_string<CharT, Traits>& lhs,
+                       const FixedBasicString<CharT, Capacity, Traits>& rhs) {
+  return rhs.compare(lhs) == 0;
+}
+
+template <typename CharT, size_t Capacity1, size_t Capacity2,
+          typename Traits>
+inline bool operator!=(const FixedBasicString<CharT, Capacity1, Traits>& lhs,
+                       const FixedBasicString<CharT, Capacity2, Traits>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename CharT, size_t Capacity, typename Traits>
+inline bool operator!=(const FixedBasicString<CharT, Capacity, Traits>& lhs,
+                       const CharT* rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename CharT, size_t Capacity, typename Traits>
+inline bool operator!=(const CharT* lhs,
+                       const FixedBasicString<CharT, Capacity, Traits>& rhs) {
   return !(lhs == rhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator<(const FixedBasicString<T, Capacity1>& lhs,
-                      const FixedBasicString<T, Capacity2>& rhs) {
-  return lhs.compare(rhs) < 0;
+template <typename CharT, size_t Capacity1, size_t Capacity2,
+          typename Traits>
+inline bool operator<(const FixedBasicString<CharT, Capacity1, Traits>& lhs,
+                      const FixedBasicString<CharT, Capacity2, Traits>& rhs) {
+  return lhs.compare(rhs.data(), rhs.size()) < 0;
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator<=(const FixedBasicString<T, Capacity1>& lhs,
-                       const FixedBasicString<T, Capacity2>& rhs) {
+template <typename CharT, size_t Capacity1, size_t Capacity2,
+          typename Traits>
+inline bool operator<=(const FixedBasicString<CharT, Capacity1, Traits>& lhs,
+                       const FixedBasicString<CharT, Capacity2, Traits>& rhs) {
   return !(rhs < lhs);
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator>(const FixedBasicString<T, Capacity1>& lhs,
-                      const FixedBasicString<T, Capacity2>& rhs) {
+template <typename CharT, size_t Capacity1, size_t Capacity2,
+          typename Traits>
+inline bool operator>(const FixedBasicString<CharT, Capacity1, Traits>& lhs,
+                      const FixedBasicString<CharT, Capacity2, Traits>& rhs) {
   return rhs < lhs;
 }
 
-template <typename T, size_t Capacity1, size_t Capacity2>
-inline bool operator>=(const FixedBasicString<T, Capacity1>& lhs,
-                       const FixedBasicString<T, Capacity2>& rhs) {
+template <typename CharT, size_t Capacity1, size_t Capacity2,
+          typename Traits>
+inline bool operator>=(const FixedBasicString<CharT, Capacity1, Traits>& lhs,
+                       const FixedBasicString<CharT, Capacity2, Traits>& rhs) {
   return !(lhs < rhs);
 }
 
+template <typename CharT, size_t Capacity, typename Traits>
+FixedBasicString<CharT, Capacity, Traits> operator+(
+    const FixedBasicString<CharT, Capacity, Traits>& lhs,
+    const FixedBasicString<CharT, Capacity, Traits>& rhs) {
+  FixedBasicString<CharT, Capacity, Traits> result(lhs);
+  result.append(rhs);
+  return result;
+}
+
+template <typename CharT, size_t Capacity, typename Traits>
+FixedBasicString<CharT, Capacity, Traits> operator+(
+    const FixedBasicString<CharT, Capacity, Traits>& lhs, const CharT* rhs) {
+  FixedBasicString<CharT, Capacity, Traits> result(lhs);
+  result.append(rhs);
+  return result;
+}
+
+template <typename CharT, size_t Capacity, typename Traits>
+FixedBasicString<CharT, Capacity, Traits> operator+(
+    const CharT* lhs, const FixedBasicString<CharT, Capacity, Traits>& rhs) {
+  FixedBasicString<CharT, Capacity, Traits> result(lhs);
+  result.append(rhs);
+  return result;
+}
+
+template <typename CharT, size_t Capacity, typename Traits>
+FixedBasicString<CharT, Capacity, Traits> operator+(
+    const FixedBasicString<CharT, Capacity, Traits>& lhs, CharT rhs) {
+  FixedBasicString<CharT, Capacity, Traits> result(lhs);
+  result.push_back(rhs);
+  return result;
+}
+
+template <typename CharT, size_t Capacity, typename Traits>
+std::basic_ostream<CharT, Traits>& operator<<(
+    std::basic_ostream<CharT, Traits>& os,
+    const FixedBasicString<CharT, Capacity, Traits>& str) {
+  return os.write(str.data(), str.size());
+}
+
+// word at a time multiplicative hash of the characters, the same result
+// for every capacity
+inline size_t HashStringBytes(const void* data, size_t len) {
+  constexpr uint64_t kMul = 0x9E3779B97F4A7C15ull;
+  const unsigned char* p = static_cast<const unsigned char*>(data);
+  uint64_t h = len * kMul;
+  for (; len >= 8; p += 8, len -= 8) {
+    uint64_t word;
+    std::memcpy(&word, p, 8);
+    h = (h ^ word) * kMul;
+    h ^= h >> 29;
+  }
+  // the tail is read as two overlapping words instead of byte by byte
+  if (len >= 4) {
+    uint32_t lo, hi;
+    std::memcpy(&lo, p, 4);
+    std::memcpy(&hi, p + len - 4, 4);
+    h = (h ^ (uint64_t(hi) << 32 | lo)) * kMul;
+  } else if (len > 0) {
+    uint64_t word = uint64_t(p[0]) << 16 | uint64_t(p[len >> 1]) << 8 |
+                    p[len - 1];
+    h = (h ^ word) * kMul;
+  }
+  return static_cast<size_t>(h ^ (h >> 32));
+}
+
+namespace std {
+template <typename CharT, size_t Capacity, typename Traits>
+struct hash<FixedBasicString<CharT, Capacity, Traits>> {
+  size_t operator()(
+      const FixedBasicString<CharT, Capacity, Traits>& str) const {
+    return HashStringBytes(str.data(), str.size() * sizeof(CharT));
+  }
+};
+}  // namespace std
+
 template <size_t Capacity>
 using FixedString = FixedBasicString<char, Capacity>;
 
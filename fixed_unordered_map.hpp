@@ -0,0 +1,164 @@
+#pragma once
+#include <tuple>
+#include <utility>
+#include <stdexcept>
+#include <functional>
+#include <unordered_map>
+#include "fixed_hash_table.hpp"
+
+template <typename KeyType, typename ValueType>
+struct __map_key_of_value {
+  const KeyType& operator()(
+      const std::pair<const KeyType, ValueType>& value) const {
+    return value.first;
+  }
+};
+
+// Open addressing hash map whose first Capacity elements live inline,
+// spilling to a heap table only when it grows beyond that.
+template <typename KeyType, typename ValueType, size_t Capacity,
+          typename Hash = std::hash<KeyType>,
+          typename KeyEqual = std::equal_to<KeyType>>
+class FixedUnorderedMap
+    : public FixedHashTable<std::pair<const KeyType, ValueType>, KeyType,
+                            __map_key_of_value<KeyType, ValueType>, Capacity,
+                            Hash, KeyEqual> {
+ public:
+  using BaseType =
+      FixedHashTable<std::pair<const KeyType, ValueType>, KeyType,
+                     __map_key_of_value<KeyType, ValueType>, Capacity, Hash,
+                     KeyEqual>;
+
+  using key_type = typename BaseType::key_type;
+  using mapped_type = ValueType;
+  using value_type = typename BaseType::value_type;
+  using hasher = typename BaseType::hasher;
+  using key_equal = typename BaseType::key_equal;
+
+  using reference = typename BaseType::reference;
+  using const_reference = typename BaseType::const_reference;
+  using iterator = typename BaseType::iterator;
+  using const_iterator = typename BaseType::const_iterator;
+  using size_type = typename BaseType::size_type;
+  using pointer = typename BaseType::pointer;
+  using const_pointer = typename BaseType::const_pointer;
+
+  using BaseType::insert;
+  using BaseType::size;
+  using BaseType::begin;
+  using BaseType::end;
+  using BaseType::find;
+
+  FixedUnorderedMap() : FixedUnorderedMap(Hash()) {}
+
+  explicit FixedUnorderedMap(const Hash& hash,
+                             const KeyEqual& equal = KeyEqual())
+      : BaseType(hash, equal) {}
+
+  template <typename InputIterator>
+  FixedUnorderedMap(InputIterator first, InputIterator last,
+                    const Hash& hash = Hash(),
+                    const KeyEqual& equal = KeyEqual())
+      : FixedUnorderedMap(hash, equal) {
+    insert(first, last);
+  }
+
+  FixedUnorderedMap(std::initializer_list<value_type> init)
+      : FixedUnorderedMap() {
+    insert(init);
+  }
+
+  FixedUnorderedMap(const FixedUnorderedMap& other) = default;
+  FixedUnorderedMap(FixedUnorderedMap&& other) = default;
+  ~FixedUnorderedMap() = default;
+
+  FixedUnorderedMap& operator=(const FixedUnorderedMap& other) = default;
+  FixedUnorderedMap& operator=(FixedUnorderedMap&& other) = default;
+
+  FixedUnorderedMap& operator=(std::initializer_list<value_type> init) {
+    BaseType::clear();
+    insert(init);
+    return *this;
+  }
+
+  template <typename H, typename E, typename Alloc>
+  FixedUnorderedMap(
+      const std::unordered_map<KeyType, ValueType, H, E, Alloc>& other)
+      : FixedUnorderedMap() {
+    BaseType::reserve(other.size());
+    insert(std::begin(other), std::end(other));
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const KeyType& key, Args&&... args) {
+    return BaseType::EmplaceKey(key, std::piecewise_construct,
+                                std::forward_as_tuple(key),
+                                std::forward_as_tuple(
+                                    std::forward<Args>(args)...));
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(KeyType&& key, Args&&... args) {
+    return BaseType::EmplaceKey(key, std::piecewise_construct,
+                                std::forward_as_tuple(std::move(key)),
+                                std::forward_as_tuple(
+                                    std::forward<Args>(args)...));
+  }
+
+  ValueType& operator[](const KeyType& key) {
+    return try_emplace(key).first->second;
+  }
+
+  ValueType& operator[](KeyType&& key) {
+    return try_emplace(std::move(key)).first->second;
+  }
+
+  ValueType& at(const KeyType& key) {
+    iterator it = find(key);
+    if (it == end()) throw std::out_of_range("FixedUnorderedMap::at");
+    return it->second;
+  }
+
+  const ValueType& at(const KeyType& key) const {
+    const_iterator it = find(key);
+    if (it == end()) throw std::out_of_range("FixedUnorderedMap::at");
+    return it->second;
+  }
+};
+
+template <typename KeyType, typename ValueType, size_t Capacity,
+          typename Hash, typename KeyEqual>
+void swap(
+    FixedUnorderedMap<KeyType, ValueType, Capacity, Hash, KeyEqual>& lhs,
+    FixedUnorderedMap<KeyType, ValueType, Capacity, Hash, KeyEqual>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename KeyType, typename ValueType, size_t Capacity1,
+          size_t Capacity2, typename Hash, typename KeyEqual>
+inline bool operator==(
+    const FixedUnorderedMap<KeyType, ValueType, Capacity1, Hash, KeyEqual>&
+        lhs,
+    const FixedUnorderedMap<KeyType, ValueType, Capacity2, Hash, KeyEqual>&
+        rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (const auto& kv : lhs) {
+    auto it = rhs.find(kv.first);
+    if (it == rhs.end() || !(it->second == kv.second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename KeyType, typename ValueType, size_t Capacity1,
+          size_t Capacity2, typename Hash, typename KeyEqual>
+inline bool operator!=(
+    const FixedUnorderedMap<KeyType, ValueType, Capacity1, Hash, KeyEqual>&
+        lhs,
+    const FixedUnorderedMap<KeyType, ValueType, Capacity2, Hash, KeyEqual>&
+        rhs) {
+  return !(lhs == rhs);
+}
@@ -0,0 +1,127 @@
+#pragma once
+#include <utility>
+#include <functional>
+#include <unordered_set>
+#include "fixed_hash_table.hpp"
+
+template <typename T>
+struct __set_key_of_value {
+  const T& operator()(const T& value) const { return value; }
+};
+
+// Open addressing hash set whose first Capacity elements live inline,
+// spilling to a heap table only when it grows beyond that.
+template <typename T, size_t Capacity, typename Hash = std::hash<T>,
+          typename KeyEqual = std::equal_to<T>>
+class FixedUnorderedSet
+    : public FixedHashTable<T, T, __set_key_of_value<T>, Capacity, Hash,
+                            KeyEqual> {
+ public:
+  using BaseType =
+      FixedHashTable<T, T, __set_key_of_value<T>, Capacity, Hash, KeyEqual>;
+
+  using key_type = typename BaseType::key_type;
+  using value_type = typename BaseType::value_type;
+  using hasher = typename BaseType::hasher;
+  using key_equal = typename BaseType::key_equal;
+
+  // elements are keys, so they can not be modified in place
+  using reference = typename BaseType::const_reference;
+  using const_reference = typename BaseType::const_reference;
+  using iterator = typename BaseType::const_iterator;
+  using const_iterator = typename BaseType::const_iterator;
+  using size_type = typename BaseType::size_type;
+  using pointer = typename BaseType::const_pointer;
+  using const_pointer = typename BaseType::const_pointer;
+
+  using BaseType::insert;
+  using BaseType::size;
+
+  FixedUnorderedSet() : FixedUnorderedSet(Hash()) {}
+
+  explicit FixedUnorderedSet(const Hash& hash,
+                             const KeyEqual& equal = KeyEqual())
+      : BaseType(hash, equal) {}
+
+  template <typename InputIterator>
+  FixedUnorderedSet(InputIterator first, InputIterator last,
+                    const Hash& hash = Hash(),
+                    const KeyEqual& equal = KeyEqual())
+      : FixedUnorderedSet(hash, equal) {
+    insert(first, last);
+  }
+
+  FixedUnorderedSet(std::initializer_list<T> init) : FixedUnorderedSet() {
+    insert(init);
+  }
+
+  FixedUnorderedSet(const FixedUnorderedSet& other) = default;
+  FixedUnorderedSet(FixedUnorderedSet&& other) = default;
+  ~FixedUnorderedSet() = default;
+
+  FixedUnorderedSet& operator=(const FixedUnorderedSet& other) = default;
+  FixedUnorderedSet& operator=(FixedUnorderedSet&& other) = default;
+
+  FixedUnorderedSet& operator=(std::initializer_list<T> init) {
+    BaseType::clear();
+    insert(init);
+    return *this;
+  }
+
+  template <typename H, typename E, typename Alloc>
+  FixedUnorderedSet(const std::unordered_set<T, H, E, Alloc>& other)
+      : FixedUnorderedSet() {
+    BaseType::reserve(other.size());
+    insert(std::begin(other), std::end(other));
+  }
+
+  std::pair<iterator, bool> insert(const T& value) {
+    auto res = BaseType::insert(value);
+    return std::make_pair(iterator(res.first), res.second);
+  }
+
+  std::pair<iterator, bool> insert(T&& value) {
+    auto res = BaseType::insert(std::move(value));
+    return std::make_pair(iterator(res.first), res.second);
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args&&... args) {
+    auto res = BaseType::emplace(std::forward<Args>(args)...);
+    return std::make_pair(iterator(res.first), res.second);
+  }
+
+  const_iterator begin() const { return BaseType::begin(); }
+  const_iterator end() const { return BaseType::end(); }
+  const_iterator find(const T& key) const { return BaseType::find(key); }
+};
+
+template <typename T, size_t Capacity, typename Hash, typename KeyEqual>
+void swap(FixedUnorderedSet<T, Capacity, Hash, KeyEqual>& lhs,
+          FixedUnorderedSet<T, Capacity, Hash, KeyEqual>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, typename Hash,
+          typename KeyEqual>
+inline bool operator==(
+    const FixedUnorderedSet<T, Capacity1, Hash, KeyEqual>& lhs,
+    const FixedUnorderedSet<T, Capacity2, Hash, KeyEqual>& rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+  for (const auto& key : lhs) {
+    if (rhs.count(key) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, typename Hash,
+          typename KeyEqual>
+inline bool operator!=(
+    const FixedUnorderedSet<T, Capacity1, Hash, KeyEqual>& lhs,
+    const FixedUnorderedSet<T, Capacity2, Hash, KeyEqual>& rhs) {
+  return !(lhs == rhs);
+}
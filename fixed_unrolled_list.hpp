@@ -0,0 +1,562 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <cassert>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+#include "stack_allocator.hpp"
+
+// as many elements as fit in a 64 byte node next to its links and count,
+// but at least two so that a full node can be split
+template <typename T>
+constexpr size_t UnrolledElemsPerNode() {
+  return (64 - 3 * sizeof(void*)) / sizeof(T) > 2
+             ? (64 - 3 * sizeof(void*)) / sizeof(T)
+             : 2;
+}
+
+struct UnrolledNodeBase {
+  UnrolledNodeBase* prev_;
+  UnrolledNodeBase* next_;
+};
+
+// aligned to a cache line so that a node never straddles two
+template <typename T, size_t ElemsPerNode>
+struct alignas(64) UnrolledNode : UnrolledNodeBase {
+  T* Elems() { return reinterpret_cast<T*>(elems_); }
+
+  size_t count_;
+  typename std::aligned_storage<sizeof(T), alignof(T)>::type
+      elems_[ElemsPerNode];
+};
+
+template <typename T, size_t ElemsPerNode, typename Value>
+class UnrolledListIterator {
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = Value*;
+  using reference = Value&;
+  using Node = UnrolledNode<T, ElemsPerNode>;
+
+  UnrolledListIterator() = default;
+  UnrolledListIterator(UnrolledNodeBase* node, size_t index)
+      : node_(node), index_(index) {}
+
+  // iterator to const_iterator
+  operator UnrolledListIterator<T, ElemsPerNode, const T>() const {
+    return UnrolledListIterator<T, ElemsPerNode, const T>(node_, index_);
+  }
+
+  reference operator*() const {
+    return static_cast<Node*>(node_)->Elems()[index_];
+  }
+  pointer operator->() const { return &**this; }
+
+  UnrolledListIterator& operator++() {
+    if (++index_ == static_cast<Node*>(node_)->count_) {
+      node_ = node_->next_;
+      index_ = 0;
+    }
+    return *this;
+  }
+  UnrolledListIterator operator++(int) {
+    UnrolledListIterator tmp(*this);
+    ++*this;
+    return tmp;
+  }
+  UnrolledListIterator& operator--() {
+    if (index_ == 0) {
+      node_ = node_->prev_;
+      index_ = static_cast<Node*>(node_)->count_;
+    }
+    --index_;
+    return *this;
+  }
+  UnrolledListIterator operator--(int) {
+    UnrolledListIterator tmp(*this);
+    --*this;
+    return tmp;
+  }
+
+  bool operator==(const UnrolledListIterator& other) const {
+    return node_ == other.node_ && index_ == other.index_;
+  }
+  bool operator!=(const UnrolledListIterator& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  template <typename U, size_t Cap, size_t Elems, typename Slabs>
+  friend class FixedUnrolledList;
+
+  UnrolledNodeBase* node_ = nullptr;
+  size_t index_ = 0;
+};
+
+// A list that packs up to ElemsPerNode elements into each node, so a walk
+// reads whole cache lines of elements instead of chasing one pointer per
+// element. Nodes come from the same inline pool as FixedList, with room
+// for Capacity elements in full nodes; nodes are kept at least half full.
+// Inserting or erasing shifts elements within one node, invalidating the
+// iterators into that node and, when it splits or folds, its neighbour;
+// iterators into other nodes stay valid. Splicing or moving a whole list
+// relinks its nodes; only the ones in the source's inline buffer have
+// their elements moved, so it costs O(Capacity) however long the list is.
+// Elements are shifted between nodes in states that cannot be rolled
+// back, so T must be nothrow move constructible.
+template <typename T, size_t Capacity,
+          size_t ElemsPerNode = UnrolledElemsPerNode<T>(),
+          typename Slabs = HeapSlabs>
+class FixedUnrolledList {
+ public:
+  static_assert(ElemsPerNode >= 2, "a node must hold at least 2 elements");
+  static_assert(std::is_nothrow_move_constructible<T>::value,
+                "elements are shifted between nodes without a way back");
+
+  using Node = UnrolledNode<T, ElemsPerNode>;
+  static constexpr size_t kInlineNodes =
+      (Capacity + ElemsPerNode - 1) / ElemsPerNode;
+  using Allocator = StackAllocator<Node, kInlineNodes>;
+  using ReservsedMemoryType = typename Allocator::ReservedMemory;
+
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using iterator = UnrolledListIterator<T, ElemsPerNode, T>;
+  using const_iterator = UnrolledListIterator<T, ElemsPerNode, const T>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  FixedUnrolledList() { head_.prev_ = head_.next_ = &head_; }
+
+  explicit FixedUnrolledList(size_type count, const T& value = T())
+      : FixedUnrolledList() {
+    assign(count, value);
+  }
+
+  template <typename InputIterator>
+  FixedUnrolledList(InputIterator first, InputIterator last)
+      : FixedUnrolledList() {
+    assign(first, last);
+  }
+
+  FixedUnrolledList(std::initializer_list<T> init) : FixedUnrolledList() {
+    assign(init);
+  }
+
+  FixedUnrolledList(const FixedUnrolledList& other) : FixedUnrolledList() {
+    assign(other.begin(), other.end());
+  }
+
+  FixedUnrolledList(FixedUnrolledList&& other) : FixedUnrolledList() {
+    splice(end(), other);
+  }
+
+  FixedUnrolledList& operator=(const FixedUnrolledList& other) {
+    if (this != &other) {
+      assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  FixedUnrolledList& operator=(FixedUnrolledList&& other) {
+    if (this != &other) {
+      clear();
+      splice(end(), other);
+    }
+    return *this;
+  }
+
+  FixedUnrolledList& operator=(std::initializer_list<T> init) {
+    assign(init);
+    return *this;
+  }
+
+  ~FixedUnrolledList() { clear(); }
+
+  template <typename InputIterator>
+  void assign(InputIterator first, InputIterator last) {
+    clear();
+    for (; first != last; ++first) emplace_back(*first);
+  }
+
+  void assign(size_type count, const T& value) {
+    clear();
+    for (size_type i = 0; i < count; ++i) push_back(value);
+  }
+
+  void assign(std::initializer_list<T> init) {
+    assign(init.begin(), init.end());
+  }
+
+  iterator begin() { return iterator(head_.next_, 0); }
+  iterator end() { return iterator(&head_, 0); }
+  const_iterator begin() const { return const_iterator(head_.next_, 0); }
+  const_iterator end() const { return const_iterator(Head(), 0); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+
+  reference front() { return *begin(); }
+  const_reference front() const { return *begin(); }
+  reference back() { return *--end(); }
+  const_reference back() const { return *--end(); }
+
+  void push_back(const T& value) { emplace(end(), value); }
+  void push_back(T&& value) { emplace(end(), std::move(value)); }
+  void push_front(const T& value) { emplace(begin(), value); }
+  void push_front(T&& value) { emplace(begin(), std::move(value)); }
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args) {
+    return *emplace(end(), std::forward<Args>(args)...);
+  }
+
+  template <typename... Args>
+  reference emplace_front(Args&&... args) {
+    return *emplace(begin(), std::forward<Args>(args)...);
+  }
+
+  void pop_back() { erase(--end()); }
+  void pop_front() { erase(begin()); }
+
+  iterator insert(const_iterator pos, const T& value) {
+    return emplace(pos, value);
+  }
+
+  iterator insert(const_iterator pos, T&& value) {
+    return emplace(pos, std::move(value));
+  }
+
+  // The value is built first, and a node a full one spills into is taken
+  // before anything moves, so a throw leaves the list as it was. At the
+  // front or back of a full node the value goes to the neighbour on that
+  // side if it has room, else to a new node; in the middle the upper half
+  // of the elements moves to a new node.
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    T value(std::forward<Args>(args)...);
+    UnrolledNodeBase* base = pos.node_;
+    size_t index = pos.index_;
+    if (base == &head_) {
+      base = head_.prev_ != &head_ ? head_.prev_ : NewNodeAfter(&head_);
+      index = static_cast<Node*>(base)->count_;
+    }
+    Node* node = static_cast<Node*>(base);
+    if (node->count_ == ElemsPerNode) {
+      if (index == 0) {
+        node = HasRoom(node->prev_) ? static_cast<Node*>(node->prev_)
+                                    : NewNodeAfter(node->prev_);
+        index = node->count_;
+      } else if (index == ElemsPerNode) {
+        node = HasRoom(node->next_) ? static_cast<Node*>(node->next_)
+                                    : NewNodeAfter(node);
+        index = 0;
+      } else {
+        Node* upper = NewNodeAfter(node);
+        size_t half = ElemsPerNode / 2;
+        MoveElems(node, half, ElemsPerNode, upper, 0);
+        upper->count_ = ElemsPerNode - half;
+        node->count_ = half;
+        if (index > half) {
+          node = upper;
+          index -= half;
+        }
+      }
+    }
+    PutAt(node, index, value);
+    ++size_;
+    return iterator(node, index);
+  }
+
+  // a node left less than half full takes in the next one when they fit
+  iterator erase(const_iterator pos) {
+    Node* node = static_cast<Node*>(pos.node_);
+    size_t index = pos.index_;
+    EraseAt(node, index);
+    --size_;
+    if (node->count_ == 0) {
+      UnrolledNodeBase* next = node->next_;
+      FreeNode(node);
+      return iterator(next, 0);
+    }
+    if (node->count_ < ElemsPerNode / 2 && node->next_ != &head_) {
+      Node* next = static_cast<Node*>(node->next_);
+      if (node->count_ + next->count_ <= ElemsPerNode) {
+        MoveElems(next, 0, next->count_, node, node->count_);
+        node->count_ += next->count_;
+        next->count_ = 0;
+        FreeNode(next);
+      }
+    }
+    if (index == node->count_) {
+      return iterator(node->next_, 0);
+    }
+    return iterator(node, index);
+  }
+
+  // erasing may fold nodes together and move last, so count instead
+  iterator erase(const_iterator first, const_iterator last) {
+    size_t count = std::distance(first, last);
+    iterator it(first.node_, first.index_);
+    while (count-- > 0) it = erase(it);
+    return it;
+  }
+
+  void clear() {
+    UnrolledNodeBase* base = head_.next_;
+    while (base != &head_) {
+      Node* node = static_cast<Node*>(base);
+      base = base->next_;
+      DestroyElems(node, 0, node->count_);
+      Allocator(&stack_data_).deallocate(node, 1);
+    }
+    head_.prev_ = head_.next_ = &head_;
+    size_ = 0;
+  }
+
+  // pos inside a node splits it, which is the only allocation besides the
+  // nodes for other's inline elements
+  void splice(const_iterator pos, FixedUnrolledList& other) {
+    if (this == &other || other.empty()) {
+      return;
+    }
+    UnrolledNodeBase* before = SplitAt(pos);
+    TakeNodes(other);
+    UnrolledNodeBase* first = other.head_.next_;
+    UnrolledNodeBase* last = other.head_.prev_;
+    first->prev_ = before->prev_;
+    before->prev_->next_ = first;
+    last->next_ = before;
+    before->prev_ = last;
+    size_ += other.size_;
+    other.head_.prev_ = other.head_.next_ = &other.head_;
+    other.size_ = 0;
+  }
+
+  void splice(const_iterator pos, FixedUnrolledList&& other) {
+    splice(pos, other);
+  }
+
+  void swap(FixedUnrolledList& other) {
+    if (this == &other) {
+      return;
+    }
+    FixedUnrolledList tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+ private:
+  UnrolledNodeBase* Head() const {
+    return const_cast<UnrolledNodeBase*>(&head_);
+  }
+
+  bool HasRoom(UnrolledNodeBase* base) const {
+    return base != &head_ && static_cast<Node*>(base)->count_ < ElemsPerNode;
+  }
+
+  Node* NewNodeAfter(UnrolledNodeBase* prev) {
+    Node* node = Allocator(&stack_data_).allocate(1);
+    node->count_ = 0;
+    node->prev_ = prev;
+    node->next_ = prev->next_;
+    prev->next_->prev_ = node;
+    prev->next_ = node;
+    return node;
+  }
+
+  void FreeNode(Node* node) {
+    node->prev_->next_ = node->next_;
+    node->next_->prev_ = node->prev_;
+    Allocator(&stack_data_).deallocate(node, 1);
+  }
+
+  // the node that pos starts, splitting its node if pos is inside one
+  UnrolledNodeBase* SplitAt(const_iterator pos) {
+    if (pos.index_ == 0) {
+      return pos.node_;
+    }
+    Node* node = static_cast<Node*>(pos.node_);
+    Node* upper = NewNodeAfter(node);
+    MoveElems(node, pos.index_, node->count_, upper, 0);
+    upper->count_ = node->count_ - pos.index_;
+    node->count_ = pos.index_;
+    return upper;
+  }
+
+  // elements are moved within and between nodes with the list in a state
+  // that cannot be rolled back, hence the nothrow move of T
+  static void MoveElems(Node* from, size_t first, size_t last, Node* to,
+                        size_t at) noexcept {
+    if (std::is_trivially_copyable<T>::value) {
+      std::memmove(static_cast<void*>(to->Elems() + at), from->Elems() + first,
+                   (last - first) * sizeof(T));
+      return;
+    }
+    T* src = from->Elems();
+    T* dest = to->Elems();
+    if (from == to && at > first) {
+      for (size_t i = last; i-- > first;) {
+        ::new (&dest[at + i - first]) T(std::move(src[i]));
+        src[i].~T();
+      }
+      return;
+    }
+    for (size_t i = first; i < last; ++i) {
+      ::new (&dest[at + i - first]) T(std::move(src[i]));
+      src[i].~T();
+    }
+  }
+
+  static void PutAt(Node* node, size_t index, T& value) noexcept {
+    MoveElems(node, index, node->count_, node, index + 1);
+    ::new (&node->Elems()[index]) T(std::move(value));
+    ++node->count_;
+  }
+
+  static void EraseAt(Node* node, size_t index) noexcept {
+    node->Elems()[index].~T();
+    MoveElems(node, index + 1, node->count_, node, index);
+    --node->count_;
+  }
+
+  static void DestroyElems(Node* node, size_t first, size_t last) {
+    for (size_t i = first; i < last; ++i) node->Elems()[i].~T();
+  }
+
+  // Make every node of other one of ours so its chain can be relinked
+  // here, see FixedForwardList::TakeNodes: the slabs of other are adopted
+  // and the nodes in its inline buffer are swapped for nodes of ours,
+  // all taken before anything moves.
+  void TakeNodes(FixedUnrolledList& other) {
+    bool adopt = stack_data_.CanAdopt(other.stack_data_);
+    Allocator alloc(&stack_data_);
+    UnrolledNodeBase* spare = nullptr;
+    size_t slab_nodes = 0;
+    try {
+      for (UnrolledNodeBase* base = other.head_.next_; base != &other.head_;
+           base = base->next_) {
+        if (adopt && !other.stack_data_.InRange(static_cast<Node*>(base))) {
+          ++slab_nodes;
+          continue;
+        }
+        Node* fresh = alloc.allocate(1);
+        fresh->next_ = spare;
+        spare = fresh;
+      }
+    } catch (...) {
+      while (spare != nullptr) {
+        UnrolledNodeBase* next = spare->next_;
+        alloc.deallocate(static_cast<Node*>(spare), 1);
+        spare = next;
+      }
+      throw;
+    }
+    ReplaceNodes(other, spare, adopt, slab_nodes);
+  }
+
+  void ReplaceNodes(FixedUnrolledList& other, UnrolledNodeBase* spare,
+                    bool adopt, size_t slab_nodes) noexcept {
+    Allocator other_alloc(&other.stack_data_);
+    for (UnrolledNodeBase* base = other.head_.next_; base != &other.head_;
+         base = base->next_) {
+      Node* node = static_cast<Node*>(base);
+      if (adopt && !other.stack_data_.InRange(node)) {
+        continue;
+      }
+      Node* fresh = static_cast<Node*>(spare);
+      spare = spare->next_;
+      MoveElems(node, 0, node->count_, fresh, 0);
+      fresh->count_ = node->count_;
+      fresh->prev_ = node->prev_;
+      fresh->next_ = node->next_;
+      node->prev_->next_ = fresh;
+      node->next_->prev_ = fresh;
+      other_alloc.deallocate(node, 1);
+      base = fresh;
+    }
+    if (adopt) {
+      stack_data_.AdoptSlabs(other.stack_data_, slab_nodes);
+    }
+  }
+
+  UnrolledNodeBase head_;
+  size_t size_ = 0;
+  ReservsedMemoryType stack_data_{Slabs::SlabArena()};
+};
+
+template <typename T, size_t Capacity, size_t ElemsPerNode, typename Slabs>
+void swap(FixedUnrolledList<T, Capacity, ElemsPerNode, Slabs>& lhs,
+          FixedUnrolledList<T, Capacity, ElemsPerNode, Slabs>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, size_t Elems1,
+          size_t Elems2, typename Slabs1, typename Slabs2>
+inline bool operator==(
+    const FixedUnrolledList<T, Capacity1, Elems1, Slabs1>& lhs,
+    const FixedUnrolledList<T, Capacity2, Elems2, Slabs2>& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs));
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, size_t Elems1,
+          size_t Elems2, typename Slabs1, typename Slabs2>
+inline bool operator!=(
+    const FixedUnrolledList<T, Capacity1, Elems1, Slabs1>& lhs,
+    const FixedUnrolledList<T, Capacity2, Elems2, Slabs2>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, size_t Elems1,
+          size_t Elems2, typename Slabs1, typename Slabs2>
+inline bool operator<(
+    const FixedUnrolledList<T, Capacity1, Elems1, Slabs1>& lhs,
+    const FixedUnrolledList<T, Capacity2, Elems2, Slabs2>& rhs) {
+  return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
+                                      std::begin(rhs), std::end(rhs));
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, size_t Elems1,
+          size_t Elems2, typename Slabs1, typename Slabs2>
+inline bool operator<=(
+    const FixedUnrolledList<T, Capacity1, Elems1, Slabs1>& lhs,
+    const FixedUnrolledList<T, Capacity2, Elems2, Slabs2>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, size_t Elems1,
+          size_t Elems2, typename Slabs1, typename Slabs2>
+inline bool operator>(
+    const FixedUnrolledList<T, Capacity1, Elems1, Slabs1>& lhs,
+    const FixedUnrolledList<T, Capacity2, Elems2, Slabs2>& rhs) {
+  return rhs < lhs;
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2, size_t Elems1,
+          size_t Elems2, typename Slabs1, typename Slabs2>
+inline bool operator>=(
+    const FixedUnrolledList<T, Capacity1, Elems1, Slabs1>& lhs,
+    const FixedUnrolledList<T, Capacity2, Elems2, Slabs2>& rhs) {
+  return !(lhs < rhs);
+}
@@ -40,14 +40,24 @@ class FixedVector : public std::vector<T, StackAllocatorVector<T, Capacity>> {
     assign(other.begin(), other.end());
   }
 
-  FixedVector(FixedVector&& other) : FixedVector() {
-    std::move(other.begin(), other.end(), begin());
-    other.clear();
+  // steal the heap buffer when other has spilled, otherwise the elements
+  // live in other's inline buffer and have to be moved one by one
+  FixedVector(FixedVector&& other) : BaseType(Allocator(&stack_data_)) {
+    if (other.get_allocator().use_stack_memory()) {
+      reserve(Capacity);
+      assign(std::make_move_iterator(other.begin()),
+             std::make_move_iterator(other.end()));
+      other.clear();
+    } else {
+      StealHeapMemory(other);
+    }
   }
 
   ~FixedVector() = default;
 
-  FixedVector(std::initializer_list<T> ilist) { assign(ilist); }
+  FixedVector(std::initializer_list<T> ilist) : FixedVector() {
+    assign(ilist);
+  }
 
   FixedVector& operator=(const FixedVector<T, Capacity>& other) {
     assign(other.begin(), other.end());
@@ -55,8 +65,17 @@ class FixedVector : public std::vector<T, StackAllocatorVector<T, Capacity>> {
   }
 
   FixedVector& operator=(FixedVector<T, Capacity>&& other) {
-    std::move(other.begin(), other.end(), begin());
-    other.clear();
+    if (this == &other) {
+      return *this;
+    }
+    if (other.get_allocator().use_stack_memory()) {
+      assign(std::make_move_iterator(other.begin()),
+             std::make_move_iterator(other.end()));
+      other.clear();
+    } else {
+      ReleaseMemory();
+      StealHeapMemory(other);
+    }
     return *this;
   }
 
@@ -89,6 +108,22 @@ class FixedVector : public std::vector<T, StackAllocatorVector<T, Capacity>> {
     assign(first, last);
   }
 
+  // heap buffers trade places by pointer, an inline buffer cannot leave
+  // its object so those elements are moved through a temporary
+  void swap(FixedVector& other) {
+    if (this == &other) {
+      return;
+    }
+    if (!get_allocator().use_stack_memory() &&
+        !other.get_allocator().use_stack_memory()) {
+      this->_M_impl._M_swap_data(other._M_impl);
+      return;
+    }
+    FixedVector tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
   // rewrite this function
   void shrink_to_fit() {
     Allocator alloc = get_allocator();
@@ -105,12 +140,28 @@ class FixedVector : public std::vector<T, StackAllocatorVector<T, Capacity>> {
   }
 
  private:
+  // give back the current buffer, inline or heap, through our own allocator
+  void ReleaseMemory() {
+    BaseType tmp(get_allocator());
+    BaseType::swap(tmp);
+  }
+
+  // take over other's heap buffer, then point other back to its inline one
+  // we must not hold any buffer here, or other would end up owning it.
+  // std::vector::swap is undefined for allocators that compare unequal and
+  // do not propagate, so the buffer pointers are traded directly; a heap
+  // buffer can be freed through any of our allocators
+  void StealHeapMemory(FixedVector& other) {
+    this->_M_impl._M_swap_data(other._M_impl);
+    other.reserve(Capacity);
+  }
+
   ReservsedMemoryType stack_data_;
 };
 
 template <typename T, size_t Capacity>
 void swap(FixedVector<T, Capacity>& lhs, FixedVector<T, Capacity>& rhs) {
-  FixedSwap(lhs, rhs);
+  lhs.swap(rhs);
 }
 
 template <typename T, size_t Capacity1, size_t Capacity2>
@@ -0,0 +1,115 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "utils.hpp"
+
+// A Chase-Lev work stealing deque with its ring of Capacity slots,
+// rounded up to a power of two, stored inline. The thread that owns it
+// pushes and pops tasks at the bottom, last in first out so it keeps
+// working on what is warm in its cache; any other thread may steal the
+// oldest task from the top. The owner only synchronizes with thieves
+// when they race for the last task. The ring does not grow, push()
+// returns false when it is full and the owner runs the task itself.
+//
+// A thief reads the top slot before it knows whether it won the task,
+// possibly while the owner reuses it, so slots are atomics and T must be
+// a trivially copyable handle, a task pointer or an index. The memory
+// orders follow Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+// Work-Stealing for Weak Memory Models", PPoPP 2013.
+template <typename T, size_t Capacity>
+class FixedWorkStealingDeque {
+  static_assert(Capacity > 0, "FixedWorkStealingDeque needs a ring");
+  static_assert(std::is_trivially_copyable<T>::value,
+                "tasks are read racily, use a pointer or an index");
+
+ public:
+  static constexpr size_t kCapacity = RingSlots(Capacity);
+
+  using value_type = T;
+  using size_type = size_t;
+
+  FixedWorkStealingDeque() = default;
+  FixedWorkStealingDeque(const FixedWorkStealingDeque&) = delete;
+  FixedWorkStealingDeque& operator=(const FixedWorkStealingDeque&) = delete;
+
+  // owner only
+  bool push(T value) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed);
+    int64_t top = top_.load(std::memory_order_acquire);
+    if (bottom - top >= static_cast<int64_t>(kCapacity)) {
+      return false;
+    }
+    Slot(bottom).store(value, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // owner only, the newest task
+  bool pop(T& value) {
+    int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+    bottom_.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = top_.load(std::memory_order_relaxed);
+    if (top > bottom) {
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return false;
+    }
+    value = Slot(bottom).load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // the last task, a thief may be after it too
+      bool won = top_.compare_exchange_strong(top, top + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed);
+      bottom_.store(bottom + 1, std::memory_order_relaxed);
+      return won;
+    }
+    return true;
+  }
+
+  // any thread, the oldest task; false when the deque is empty or another
+  // thread took the task first, so a thief that wants work tries again
+  // while !empty_approx()
+  bool steal(T& value) {
+    int64_t top = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return false;
+    }
+    T task = Slot(top).load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(top, top + 1,
+                                      std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return false;
+    }
+    value = task;
+    return true;
+  }
+
+  // a snapshot that may be stale by the time it is used
+  size_type size_approx() const {
+    int64_t bottom = bottom_.load(std::memory_order_acquire);
+    int64_t top = top_.load(std::memory_order_acquire);
+    return bottom > top ? static_cast<size_type>(bottom - top) : 0;
+  }
+  bool empty_approx() const { return size_approx() == 0; }
+  static constexpr size_type capacity() { return kCapacity; }
+
+ private:
+  std::atomic<T>& Slot(int64_t index) {
+    return slots_[static_cast<size_t>(index) & (kCapacity - 1)];
+  }
+
+  // thieves write the top, the owner the bottom
+  std::atomic<int64_t> top_{0};
+  char top_pad_[kCacheLineSize];
+  std::atomic<int64_t> bottom_{0};
+  char bottom_pad_[kCacheLineSize];
+  std::atomic<T> slots_[kCapacity];
+};
+
+template <typename T, size_t Capacity>
+constexpr size_t FixedWorkStealingDeque<T, Capacity>::kCapacity;
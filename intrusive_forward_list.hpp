@@ -0,0 +1,346 @@
+#pragma once
+#include <cstddef>
+#include <cassert>
+#include <iterator>
+#include <algorithm>
+#include "utils.hpp"
+
+// The singly linked counterpart of IntrusiveListHook: one pointer per
+// object, for queues that only ever take from the front.
+class IntrusiveForwardListHook {
+ public:
+  IntrusiveForwardListHook() = default;
+  IntrusiveForwardListHook(const IntrusiveForwardListHook&) {}
+  IntrusiveForwardListHook& operator=(const IntrusiveForwardListHook&) {
+    return *this;
+  }
+
+  // an object must be taken off its list before it goes away
+  ~IntrusiveForwardListHook() { assert(!is_linked()); }
+
+  bool is_linked() const { return next_ != nullptr; }
+
+ private:
+  template <typename T, IntrusiveForwardListHook T::*Hook>
+  friend class IntrusiveForwardList;
+  template <typename T, IntrusiveForwardListHook T::*Hook, typename Value>
+  friend class IntrusiveForwardListIterator;
+
+  IntrusiveForwardListHook* next_ = nullptr;
+};
+
+template <typename T, IntrusiveForwardListHook T::*Hook, typename Value>
+class IntrusiveForwardListIterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = Value*;
+  using reference = Value&;
+
+  IntrusiveForwardListIterator() = default;
+  explicit IntrusiveForwardListIterator(IntrusiveForwardListHook* node)
+      : node_(node) {}
+
+  // iterator to const_iterator
+  operator IntrusiveForwardListIterator<T, Hook, const T>() const {
+    return IntrusiveForwardListIterator<T, Hook, const T>(node_);
+  }
+
+  reference operator*() const {
+    return *MemberOwner<T, IntrusiveForwardListHook, Hook>(node_);
+  }
+  pointer operator->() const { return &**this; }
+
+  IntrusiveForwardListIterator& operator++() {
+    node_ = node_->next_;
+    return *this;
+  }
+  IntrusiveForwardListIterator operator++(int) {
+    IntrusiveForwardListIterator tmp(*this);
+    node_ = node_->next_;
+    return tmp;
+  }
+
+  bool operator==(const IntrusiveForwardListIterator& other) const {
+    return node_ == other.node_;
+  }
+  bool operator!=(const IntrusiveForwardListIterator& other) const {
+    return node_ != other.node_;
+  }
+
+ private:
+  template <typename U, IntrusiveForwardListHook U::*H>
+  friend class IntrusiveForwardList;
+
+  IntrusiveForwardListHook* node_ = nullptr;
+};
+
+// A singly linked list of objects linked in place through their
+// IntrusiveForwardListHook member, see IntrusiveList. It also keeps its
+// tail, so push_back() and pop_front() make a FIFO queue. The chain is a
+// ring through the head, which makes before_begin() and end() the same
+// position: walk from begin() to end(), never from before_begin().
+template <typename T, IntrusiveForwardListHook T::*Hook>
+class IntrusiveForwardList {
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using iterator = IntrusiveForwardListIterator<T, Hook, T>;
+  using const_iterator = IntrusiveForwardListIterator<T, Hook, const T>;
+
+  IntrusiveForwardList() { head_.next_ = tail_ = &head_; }
+
+  template <typename InputIterator>
+  IntrusiveForwardList(InputIterator first, InputIterator last)
+      : IntrusiveForwardList() {
+    for (; first != last; ++first) push_back(*first);
+  }
+
+  IntrusiveForwardList(const IntrusiveForwardList&) = delete;
+  IntrusiveForwardList& operator=(const IntrusiveForwardList&) = delete;
+
+  IntrusiveForwardList(IntrusiveForwardList&& other)
+      : IntrusiveForwardList() {
+    swap(other);
+  }
+
+  IntrusiveForwardList& operator=(IntrusiveForwardList&& other) {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  // unlinks whatever is left, the head is a hook that must not look linked
+  ~IntrusiveForwardList() {
+    clear();
+    head_.next_ = nullptr;
+  }
+
+  iterator before_begin() { return iterator(&head_); }
+  iterator begin() { return iterator(head_.next_); }
+  iterator end() { return iterator(&head_); }
+  const_iterator before_begin() const { return const_iterator(Head()); }
+  const_iterator begin() const { return const_iterator(head_.next_); }
+  const_iterator end() const { return const_iterator(Head()); }
+  const_iterator cbefore_begin() const { return before_begin(); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+
+  reference front() { return *begin(); }
+  const_reference front() const { return *begin(); }
+  reference back() { return *iterator(tail_); }
+  const_reference back() const { return *const_iterator(tail_); }
+
+  iterator iterator_to(T& value) { return iterator(&(value.*Hook)); }
+  const_iterator iterator_to(const T& value) const {
+    return const_iterator(
+        const_cast<IntrusiveForwardListHook*>(&(value.*Hook)));
+  }
+
+  void push_front(T& value) { LinkAfter(&head_, &(value.*Hook)); }
+  void push_back(T& value) { LinkAfter(tail_, &(value.*Hook)); }
+  void pop_front() { UnlinkAfter(&head_); }
+
+  iterator insert_after(const_iterator pos, T& value) {
+    LinkAfter(pos.node_, &(value.*Hook));
+    return iterator(&(value.*Hook));
+  }
+
+  iterator erase_after(const_iterator pos) {
+    UnlinkAfter(pos.node_);
+    return iterator(pos.node_->next_);
+  }
+
+  iterator erase_after(const_iterator first, const_iterator last) {
+    while (first.node_->next_ != last.node_) UnlinkAfter(first.node_);
+    return iterator(last.node_);
+  }
+
+  void clear() {
+    IntrusiveForwardListHook* node = head_.next_;
+    while (node != &head_) {
+      IntrusiveForwardListHook* next = node->next_;
+      node->next_ = nullptr;
+      node = next;
+    }
+    head_.next_ = tail_ = &head_;
+    size_ = 0;
+  }
+
+  // all of other after pos
+  void splice_after(const_iterator pos, IntrusiveForwardList& other) {
+    if (this == &other || other.empty()) {
+      return;
+    }
+    IntrusiveForwardListHook* first = other.head_.next_;
+    IntrusiveForwardListHook* last = other.tail_;
+    size_t count = other.size_;
+    other.head_.next_ = other.tail_ = &other.head_;
+    other.size_ = 0;
+    LinkChainAfter(pos.node_, first, last, count);
+  }
+
+  void splice_after(const_iterator pos, IntrusiveForwardList&& other) {
+    splice_after(pos, other);
+  }
+
+  // the element after it
+  void splice_after(const_iterator pos, IntrusiveForwardList& other,
+                    const_iterator it) {
+    IntrusiveForwardListHook* node = it.node_->next_;
+    if (pos.node_ == it.node_ || pos.node_ == node) {
+      return;
+    }
+    other.UnlinkChainAfter(it.node_, node, 1);
+    LinkChainAfter(pos.node_, node, node, 1);
+  }
+
+  void splice_after(const_iterator pos, IntrusiveForwardList&& other,
+                    const_iterator it) {
+    splice_after(pos, other, it);
+  }
+
+  // the elements in (first, last), O(distance(first, last))
+  void splice_after(const_iterator pos, IntrusiveForwardList& other,
+                    const_iterator first, const_iterator last) {
+    IntrusiveForwardListHook* begin = first.node_->next_;
+    if (begin == last.node_) {
+      return;
+    }
+    size_t count = 1;
+    IntrusiveForwardListHook* end = begin;
+    while (end->next_ != last.node_) {
+      end = end->next_;
+      ++count;
+    }
+    other.UnlinkChainAfter(first.node_, end, count);
+    LinkChainAfter(pos.node_, begin, end, count);
+  }
+
+  void splice_after(const_iterator pos, IntrusiveForwardList&& other,
+                    const_iterator first, const_iterator last) {
+    splice_after(pos, other, first, last);
+  }
+
+  // the heads stay in their lists, only the chains trade places
+  void swap(IntrusiveForwardList& other) {
+    std::swap(head_.next_, other.head_.next_);
+    std::swap(tail_, other.tail_);
+    std::swap(size_, other.size_);
+    FixHead();
+    other.FixHead();
+  }
+
+ private:
+  IntrusiveForwardListHook* Head() const {
+    return const_cast<IntrusiveForwardListHook*>(&head_);
+  }
+
+  void LinkAfter(IntrusiveForwardListHook* pos,
+                 IntrusiveForwardListHook* node) {
+    assert(!node->is_linked());
+    LinkChainAfter(pos, node, node, 1);
+  }
+
+  void UnlinkAfter(IntrusiveForwardListHook* pos) {
+    IntrusiveForwardListHook* node = pos->next_;
+    UnlinkChainAfter(pos, node, 1);
+    node->next_ = nullptr;
+  }
+
+  // link the chain first..last, count nodes, in after pos
+  void LinkChainAfter(IntrusiveForwardListHook* pos,
+                      IntrusiveForwardListHook* first,
+                      IntrusiveForwardListHook* last, size_t count) {
+    last->next_ = pos->next_;
+    pos->next_ = first;
+    if (pos == tail_) {
+      tail_ = last;
+    }
+    size_ += count;
+  }
+
+  // cut out the chain from after pos to last, count nodes; the chain keeps
+  // its inner links
+  void UnlinkChainAfter(IntrusiveForwardListHook* pos,
+                        IntrusiveForwardListHook* last, size_t count) {
+    pos->next_ = last->next_;
+    if (last == tail_) {
+      tail_ = pos;
+    }
+    size_ -= count;
+  }
+
+  void FixHead() {
+    if (size_ == 0) {
+      head_.next_ = tail_ = &head_;
+    } else {
+      tail_->next_ = &head_;
+    }
+  }
+
+  IntrusiveForwardListHook head_;
+  IntrusiveForwardListHook* tail_;
+  size_t size_ = 0;
+};
+
+template <typename T, IntrusiveForwardListHook T::*Hook>
+void swap(IntrusiveForwardList<T, Hook>& lhs,
+          IntrusiveForwardList<T, Hook>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename T, IntrusiveForwardListHook T::*Hook1,
+          IntrusiveForwardListHook T::*Hook2>
+inline bool operator==(const IntrusiveForwardList<T, Hook1>& lhs,
+                       const IntrusiveForwardList<T, Hook2>& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs));
+}
+
+template <typename T, IntrusiveForwardListHook T::*Hook1,
+          IntrusiveForwardListHook T::*Hook2>
+inline bool operator!=(const IntrusiveForwardList<T, Hook1>& lhs,
+                       const IntrusiveForwardList<T, Hook2>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, IntrusiveForwardListHook T::*Hook1,
+          IntrusiveForwardListHook T::*Hook2>
+inline bool operator<(const IntrusiveForwardList<T, Hook1>& lhs,
+                      const IntrusiveForwardList<T, Hook2>& rhs) {
+  return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
+                                      std::begin(rhs), std::end(rhs));
+}
+
+template <typename T, IntrusiveForwardListHook T::*Hook1,
+          IntrusiveForwardListHook T::*Hook2>
+inline bool operator<=(const IntrusiveForwardList<T, Hook1>& lhs,
+                       const IntrusiveForwardList<T, Hook2>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, IntrusiveForwardListHook T::*Hook1,
+          IntrusiveForwardListHook T::*Hook2>
+inline bool operator>(const IntrusiveForwardList<T, Hook1>& lhs,
+                      const IntrusiveForwardList<T, Hook2>& rhs) {
+  return rhs < lhs;
+}
+
+template <typename T, IntrusiveForwardListHook T::*Hook1,
+          IntrusiveForwardListHook T::*Hook2>
+inline bool operator>=(const IntrusiveForwardList<T, Hook1>& lhs,
+                       const IntrusiveForwardList<T, Hook2>& rhs) {
+  return !(lhs < rhs);
+}
@@ -0,0 +1,344 @@
+#pragma once
+#include <cstddef>
+#include <cassert>
+#include <iterator>
+#include <algorithm>
+#include "utils.hpp"
+
+// Embedded in T, one per IntrusiveList an object can be on at a time. Put
+// it next to the fields a walk over the list reads, so following a link
+// and looking at the object touch the same cache line. A copied hook
+// starts out unlinked, the copy is on no list.
+class IntrusiveListHook {
+ public:
+  IntrusiveListHook() = default;
+  IntrusiveListHook(const IntrusiveListHook&) {}
+  IntrusiveListHook& operator=(const IntrusiveListHook&) { return *this; }
+
+  // an object must be taken off its list before it goes away
+  ~IntrusiveListHook() { assert(!is_linked()); }
+
+  bool is_linked() const { return next_ != nullptr; }
+
+ private:
+  template <typename T, IntrusiveListHook T::*Hook>
+  friend class IntrusiveList;
+  template <typename T, IntrusiveListHook T::*Hook, typename Value>
+  friend class IntrusiveListIterator;
+
+  IntrusiveListHook* prev_ = nullptr;
+  IntrusiveListHook* next_ = nullptr;
+};
+
+template <typename T, IntrusiveListHook T::*Hook, typename Value>
+class IntrusiveListIterator {
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = Value*;
+  using reference = Value&;
+
+  IntrusiveListIterator() = default;
+  explicit IntrusiveListIterator(IntrusiveListHook* node) : node_(node) {}
+
+  // iterator to const_iterator
+  operator IntrusiveListIterator<T, Hook, const T>() const {
+    return IntrusiveListIterator<T, Hook, const T>(node_);
+  }
+
+  reference operator*() const {
+    return *MemberOwner<T, IntrusiveListHook, Hook>(node_);
+  }
+  pointer operator->() const { return &**this; }
+
+  IntrusiveListIterator& operator++() {
+    node_ = node_->next_;
+    return *this;
+  }
+  IntrusiveListIterator operator++(int) {
+    IntrusiveListIterator tmp(*this);
+    node_ = node_->next_;
+    return tmp;
+  }
+  IntrusiveListIterator& operator--() {
+    node_ = node_->prev_;
+    return *this;
+  }
+  IntrusiveListIterator operator--(int) {
+    IntrusiveListIterator tmp(*this);
+    node_ = node_->prev_;
+    return tmp;
+  }
+
+  bool operator==(const IntrusiveListIterator& other) const {
+    return node_ == other.node_;
+  }
+  bool operator!=(const IntrusiveListIterator& other) const {
+    return node_ != other.node_;
+  }
+
+ private:
+  template <typename U, IntrusiveListHook U::*H>
+  friend class IntrusiveList;
+
+  IntrusiveListHook* node_ = nullptr;
+};
+
+// A doubly linked list of objects that already exist: they are linked in
+// place through their IntrusiveListHook member, so nothing is allocated or
+// copied. The list does not own its elements, each must outlive its
+// membership. Erasing an element found through iterator_to() and every
+// splice but the range one from another list take O(1).
+template <typename T, IntrusiveListHook T::*Hook>
+class IntrusiveList {
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using iterator = IntrusiveListIterator<T, Hook, T>;
+  using const_iterator = IntrusiveListIterator<T, Hook, const T>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  IntrusiveList() { head_.prev_ = head_.next_ = &head_; }
+
+  template <typename InputIterator>
+  IntrusiveList(InputIterator first, InputIterator last) : IntrusiveList() {
+    for (; first != last; ++first) push_back(*first);
+  }
+
+  IntrusiveList(const IntrusiveList&) = delete;
+  IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+  IntrusiveList(IntrusiveList&& other) : IntrusiveList() { swap(other); }
+
+  IntrusiveList& operator=(IntrusiveList&& other) {
+    if (this != &other) {
+      clear();
+      swap(other);
+    }
+    return *this;
+  }
+
+  // unlinks whatever is left, the head is a hook that must not look linked
+  ~IntrusiveList() {
+    clear();
+    head_.prev_ = head_.next_ = nullptr;
+  }
+
+  iterator begin() { return iterator(head_.next_); }
+  iterator end() { return iterator(&head_); }
+  const_iterator begin() const { return const_iterator(head_.next_); }
+  const_iterator end() const { return const_iterator(Head()); }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+
+  reference front() { return *begin(); }
+  const_reference front() const { return *begin(); }
+  reference back() { return *--end(); }
+  const_reference back() const { return *--end(); }
+
+  // the position of an object known to be on this list
+  iterator iterator_to(T& value) { return iterator(&(value.*Hook)); }
+  const_iterator iterator_to(const T& value) const {
+    return const_iterator(const_cast<IntrusiveListHook*>(&(value.*Hook)));
+  }
+
+  void push_front(T& value) { LinkBefore(head_.next_, &(value.*Hook)); }
+  void push_back(T& value) { LinkBefore(&head_, &(value.*Hook)); }
+  void pop_front() { Unlink(head_.next_); }
+  void pop_back() { Unlink(head_.prev_); }
+
+  iterator insert(const_iterator pos, T& value) {
+    LinkBefore(pos.node_, &(value.*Hook));
+    return iterator(&(value.*Hook));
+  }
+
+  iterator erase(const_iterator pos) {
+    IntrusiveListHook* next = pos.node_->next_;
+    Unlink(pos.node_);
+    return iterator(next);
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    while (first != last) first = erase(first);
+    return iterator(last.node_);
+  }
+
+  void clear() {
+    IntrusiveListHook* node = head_.next_;
+    while (node != &head_) {
+      IntrusiveListHook* next = node->next_;
+      node->prev_ = node->next_ = nullptr;
+      node = next;
+    }
+    head_.prev_ = head_.next_ = &head_;
+    size_ = 0;
+  }
+
+  void splice(const_iterator pos, IntrusiveList& other) {
+    if (this == &other || other.empty()) {
+      return;
+    }
+    Transfer(pos.node_, other.head_.next_, &other.head_);
+    size_ += other.size_;
+    other.size_ = 0;
+  }
+
+  void splice(const_iterator pos, IntrusiveList&& other) {
+    splice(pos, other);
+  }
+
+  void splice(const_iterator pos, IntrusiveList& other, const_iterator it) {
+    IntrusiveListHook* node = it.node_;
+    if (pos.node_ == node || pos.node_ == node->next_) {
+      return;
+    }
+    Transfer(pos.node_, node, node->next_);
+    ++size_;
+    --other.size_;
+  }
+
+  void splice(const_iterator pos, IntrusiveList&& other, const_iterator it) {
+    splice(pos, other, it);
+  }
+
+  // O(distance(first, last)) from another list, to keep size() O(1)
+  void splice(const_iterator pos, IntrusiveList& other, const_iterator first,
+              const_iterator last) {
+    if (first == last) {
+      return;
+    }
+    if (this != &other) {
+      size_t count = std::distance(first, last);
+      size_ += count;
+      other.size_ -= count;
+    }
+    Transfer(pos.node_, first.node_, last.node_);
+  }
+
+  void splice(const_iterator pos, IntrusiveList&& other, const_iterator first,
+              const_iterator last) {
+    splice(pos, other, first, last);
+  }
+
+  // the heads stay in their lists, only the chains trade places
+  void swap(IntrusiveList& other) {
+    std::swap(head_.next_, other.head_.next_);
+    std::swap(head_.prev_, other.head_.prev_);
+    std::swap(size_, other.size_);
+    FixHead();
+    other.FixHead();
+  }
+
+ private:
+  IntrusiveListHook* Head() const {
+    return const_cast<IntrusiveListHook*>(&head_);
+  }
+
+  void LinkBefore(IntrusiveListHook* pos, IntrusiveListHook* node) {
+    assert(!node->is_linked());
+    node->next_ = pos;
+    node->prev_ = pos->prev_;
+    pos->prev_->next_ = node;
+    pos->prev_ = node;
+    ++size_;
+  }
+
+  void Unlink(IntrusiveListHook* node) {
+    node->prev_->next_ = node->next_;
+    node->next_->prev_ = node->prev_;
+    node->prev_ = node->next_ = nullptr;
+    --size_;
+  }
+
+  // move [first, last) in front of pos
+  static void Transfer(IntrusiveListHook* pos, IntrusiveListHook* first,
+                       IntrusiveListHook* last) {
+    IntrusiveListHook* tail = last->prev_;
+    first->prev_->next_ = last;
+    last->prev_ = first->prev_;
+    IntrusiveListHook* before = pos->prev_;
+    before->next_ = first;
+    first->prev_ = before;
+    tail->next_ = pos;
+    pos->prev_ = tail;
+  }
+
+  void FixHead() {
+    if (size_ == 0) {
+      head_.prev_ = head_.next_ = &head_;
+    } else {
+      head_.next_->prev_ = &head_;
+      head_.prev_->next_ = &head_;
+    }
+  }
+
+  IntrusiveListHook head_;
+  size_t size_ = 0;
+};
+
+template <typename T, IntrusiveListHook T::*Hook>
+void swap(IntrusiveList<T, Hook>& lhs, IntrusiveList<T, Hook>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename T, IntrusiveListHook T::*Hook1,
+          IntrusiveListHook T::*Hook2>
+inline bool operator==(const IntrusiveList<T, Hook1>& lhs,
+                       const IntrusiveList<T, Hook2>& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs));
+}
+
+template <typename T, IntrusiveListHook T::*Hook1,
+          IntrusiveListHook T::*Hook2>
+inline bool operator!=(const IntrusiveList<T, Hook1>& lhs,
+                       const IntrusiveList<T, Hook2>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, IntrusiveListHook T::*Hook1,
+          IntrusiveListHook T::*Hook2>
+inline bool operator<(const IntrusiveList<T, Hook1>& lhs,
+                      const IntrusiveList<T, Hook2>& rhs) {
+  return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
+                                      std::begin(rhs), std::end(rhs));
+}
+
+template <typename T, IntrusiveListHook T::*Hook1,
+          IntrusiveListHook T::*Hook2>
+inline bool operator<=(const IntrusiveList<T, Hook1>& lhs,
+                       const IntrusiveList<T, Hook2>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, IntrusiveListHook T::*Hook1,
+          IntrusiveListHook T::*Hook2>
+inline bool operator>(const IntrusiveList<T, Hook1>& lhs,
+                      const IntrusiveList<T, Hook2>& rhs) {
+  return rhs < lhs;
+}
+
+template <typename T, IntrusiveListHook T::*Hook1,
+          IntrusiveListHook T::*Hook2>
+inline bool operator>=(const IntrusiveList<T, Hook1>& lhs,
+                       const IntrusiveList<T, Hook2>& rhs) {
+  return !(lhs < rhs);
+}
@@ -0,0 +1,228 @@
+#pragma once
+#include <pthread.h>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <functional>
+#include "fixed_map.hpp"
+#include "small_vector.hpp"
+#include "utils.hpp"
+
+// A reader-writer lock on pthread_rwlock_t, std::shared_mutex needs C++17.
+// lock() and unlock() make it usable with std::lock_guard for writers.
+class RwLock {
+ public:
+  RwLock() { pthread_rwlock_init(&lock_, nullptr); }
+  ~RwLock() { pthread_rwlock_destroy(&lock_); }
+  RwLock(const RwLock&) = delete;
+  RwLock& operator=(const RwLock&) = delete;
+
+  void lock() { pthread_rwlock_wrlock(&lock_); }
+  void unlock() { pthread_rwlock_unlock(&lock_); }
+  void lock_shared() { pthread_rwlock_rdlock(&lock_); }
+  void unlock_shared() { pthread_rwlock_unlock(&lock_); }
+
+ private:
+  pthread_rwlock_t lock_;
+};
+
+// holds a RwLock shared for a scope, like std::shared_lock
+class ReadLock {
+ public:
+  explicit ReadLock(RwLock& lock) : lock_(lock) { lock_.lock_shared(); }
+  ~ReadLock() { lock_.unlock_shared(); }
+  ReadLock(const ReadLock&) = delete;
+  ReadLock& operator=(const ReadLock&) = delete;
+
+ private:
+  RwLock& lock_;
+};
+
+// A map for lookup tables that many threads read and a few update. The
+// keys are hashed to Shards independent FixedMaps, each with an inline
+// pool of ShardCapacity nodes and its own reader-writer lock, so readers
+// never block each other and a writer only blocks the readers of one
+// shard. Shards sit at least a cache line apart.
+//
+// Values are copied out under the lock rather than handed out by
+// reference; visit() runs a function on the value in place instead.
+// multi_get() sorts a batch of keys by shard and takes each shard's lock
+// once for all of its keys. Overflow nodes always come from the heap: an
+// arena is owned by one thread and the shards are written by many.
+template <typename Key, typename Value, size_t ShardCapacity,
+          size_t Shards = 16, typename Hash = std::hash<Key>,
+          typename Compare = std::less<Key>>
+class ShardedFixedMap {
+  static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0,
+                "the shard count must be a power of two");
+
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  using size_type = size_t;
+  using MapType = FixedMap<Key, Value, ShardCapacity, Compare>;
+
+  ShardedFixedMap() = default;
+  ShardedFixedMap(const ShardedFixedMap&) = delete;
+  ShardedFixedMap& operator=(const ShardedFixedMap&) = delete;
+
+  static size_type shard_of(const Key& key) {
+    return MixHash(Hash()(key)) & (Shards - 1);
+  }
+
+  static constexpr size_type shard_count() { return Shards; }
+
+  // copy the value of key to value, false when there is none
+  bool get(const Key& key, Value& value) const {
+    Shard& shard = ShardFor(key);
+    ReadLock lock(shard.lock_);
+    auto it = shard.map_.find(key);
+    if (it == shard.map_.end()) {
+      return false;
+    }
+    value = it->second;
+    return true;
+  }
+
+  bool contains(const Key& key) const {
+    Shard& shard = ShardFor(key);
+    ReadLock lock(shard.lock_);
+    return shard.map_.find(key) != shard.map_.end();
+  }
+
+  // call func(const Value&) under the shard's read lock, which it must not
+  // try to take again
+  template <typename Func>
+  bool visit(const Key& key, Func func) const {
+    Shard& shard = ShardFor(key);
+    ReadLock lock(shard.lock_);
+    auto it = shard.map_.find(key);
+    if (it == shard.map_.end()) {
+      return false;
+    }
+    func(static_cast<const Value&>(it->second));
+    return true;
+  }
+
+  // Look up keys[0, n): found values go to values[i] and found[i] says
+  // which were there, found may be nullptr. Returns how many were found.
+  size_type multi_get(const Key* keys, size_type n, Value* values,
+                      bool* found = nullptr) const {
+    // counting sort of the key indices by shard
+    size_type starts[Shards + 1] = {};
+    SmallVector<uint32_t, 64> shard_ids(n);
+    for (size_type i = 0; i < n; ++i) {
+      shard_ids[i] = static_cast<uint32_t>(shard_of(keys[i]));
+      ++starts[shard_ids[i] + 1];
+    }
+    for (size_type s = 0; s < Shards; ++s) starts[s + 1] += starts[s];
+    SmallVector<uint32_t, 64> order(n);
+    size_type next[Shards];
+    std::copy(starts, starts + Shards, next);
+    for (size_type i = 0; i < n; ++i) {
+      order[next[shard_ids[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    size_type hits = 0;
+    for (size_type s = 0; s < Shards; ++s) {
+      if (starts[s] == starts[s + 1]) {
+        continue;
+      }
+      Shard& shard = shards_[s];
+      ReadLock lock(shard.lock_);
+      for (size_type j = starts[s]; j < starts[s + 1]; ++j) {
+        size_type i = order[j];
+        auto it = shard.map_.find(keys[i]);
+        bool hit = it != shard.map_.end();
+        if (hit) {
+          values[i] = it->second;
+          ++hits;
+        }
+        if (found != nullptr) {
+          found[i] = hit;
+        }
+      }
+    }
+    return hits;
+  }
+
+  // false and no change when key is there already
+  bool insert(const Key& key, const Value& value) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<RwLock> lock(shard.lock_);
+    return shard.map_.emplace(key, value).second;
+  }
+
+  // true when key was not there before
+  bool insert_or_assign(const Key& key, const Value& value) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<RwLock> lock(shard.lock_);
+    auto result = shard.map_.emplace(key, value);
+    if (!result.second) {
+      result.first->second = value;
+    }
+    return result.second;
+  }
+
+  // call func(Value&) under the shard's write lock, false when key is not
+  // there
+  template <typename Func>
+  bool update(const Key& key, Func func) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<RwLock> lock(shard.lock_);
+    auto it = shard.map_.find(key);
+    if (it == shard.map_.end()) {
+      return false;
+    }
+    func(it->second);
+    return true;
+  }
+
+  size_type erase(const Key& key) {
+    Shard& shard = ShardFor(key);
+    std::lock_guard<RwLock> lock(shard.lock_);
+    return shard.map_.erase(key);
+  }
+
+  void clear() {
+    for (Shard& shard : shards_) {
+      std::lock_guard<RwLock> lock(shard.lock_);
+      shard.map_.clear();
+    }
+  }
+
+  // the shards are counted one after another, not at a single instant
+  size_type size() const {
+    size_type total = 0;
+    for (Shard& shard : shards_) {
+      ReadLock lock(shard.lock_);
+      total += shard.map_.size();
+    }
+    return total;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  // call func(const Key&, const Value&) on every entry, a shard at a time
+  // under its read lock; keys are in order within a shard only
+  template <typename Func>
+  void for_each(Func func) const {
+    for (Shard& shard : shards_) {
+      ReadLock lock(shard.lock_);
+      for (const auto& entry : shard.map_) func(entry.first, entry.second);
+    }
+  }
+
+ private:
+  struct Shard {
+    RwLock lock_;
+    MapType map_;
+    char pad_[kCacheLineSize];
+  };
+
+  Shard& ShardFor(const Key& key) const { return shards_[shard_of(key)]; }
+
+  // the locks are taken by const readers too
+  mutable Shard shards_[Shards];
+};
@@ -0,0 +1,535 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <initializer_list>
+#include <cstring>
+#include <cassert>
+
+// A vector with its first Capacity elements stored inline, not built on
+// std::vector. The object is a data pointer, size, capacity and the buffer,
+// growth beyond Capacity goes to the heap and shrink_to_fit() can bring the
+// elements back to the inline buffer.
+template <typename T, size_t Capacity>
+class SmallVector {
+  static_assert(Capacity > 0, "SmallVector needs a non-empty inline buffer");
+
+ public:
+  using value_type = T;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using iterator = T*;
+  using const_iterator = const T*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using allocator_type = std::allocator<T>;
+
+  SmallVector() : data_(InlineData()), size_(0), capacity_(Capacity) {}
+
+  explicit SmallVector(size_type n) : SmallVector() { resize(n); }
+
+  SmallVector(size_type n, const T& value) : SmallVector() {
+    assign(n, value);
+  }
+
+  template <typename InputIterator,
+            typename = typename std::enable_if<!std::is_integral<
+                InputIterator>::value>::type>
+  SmallVector(InputIterator first, InputIterator last)
+      : SmallVector() {
+    assign(first, last);
+  }
+
+  SmallVector(std::initializer_list<T> ilist) : SmallVector() {
+    assign(ilist);
+  }
+
+  SmallVector(const SmallVector& other) : SmallVector() {
+    assign(other.begin(), other.end());
+  }
+
+  // noexcept when T's move is, so that std::vector moves SmallVectors
+  // rather than copies them when it grows
+  SmallVector(SmallVector&& other) noexcept(
+      std::is_nothrow_move_constructible<T>::value)
+      : SmallVector() {
+    TakeFrom(other);
+  }
+
+  SmallVector(const std::vector<T>& other) : SmallVector() {
+    assign(other.begin(), other.end());
+  }
+
+  SmallVector(std::vector<T>&& other) : SmallVector() {
+    assign(std::make_move_iterator(other.begin()),
+           std::make_move_iterator(other.end()));
+    other.clear();
+  }
+
+  ~SmallVector() {
+    Destroy(begin(), end());
+    FreeHeap();
+  }
+
+  SmallVector& operator=(const SmallVector& other) {
+    if (this != &other) {
+      assign(other.begin(), other.end());
+    }
+    return *this;
+  }
+
+  SmallVector& operator=(SmallVector&& other) noexcept(
+      std::is_nothrow_move_constructible<T>::value) {
+    if (this != &other) {
+      clear();
+      FreeHeap();
+      TakeFrom(other);
+    }
+    return *this;
+  }
+
+  SmallVector& operator=(std::initializer_list<T> ilist) {
+    assign(ilist);
+    return *this;
+  }
+
+  SmallVector& operator=(const std::vector<T>& other) {
+    assign(other.begin(), other.end());
+    return *this;
+  }
+
+  SmallVector& operator=(std::vector<T>&& other) {
+    assign(std::make_move_iterator(other.begin()),
+           std::make_move_iterator(other.end()));
+    other.clear();
+    return *this;
+  }
+
+  void assign(size_type n, const T& value) {
+    clear();
+    insert(end(), n, value);
+  }
+
+  template <typename InputIterator,
+            typename = typename std::enable_if<!std::is_integral<
+                InputIterator>::value>::type>
+  void assign(InputIterator first, InputIterator last) {
+    clear();
+    insert(end(), first, last);
+  }
+
+  void assign(std::initializer_list<T> ilist) {
+    assign(ilist.begin(), ilist.end());
+  }
+
+  allocator_type get_allocator() const { return allocator_type(); }
+
+  // element access
+  reference at(size_type pos) {
+    if (pos >= size_) throw std::out_of_range("SmallVector::at");
+    return data_[pos];
+  }
+  const_reference at(size_type pos) const {
+    if (pos >= size_) throw std::out_of_range("SmallVector::at");
+    return data_[pos];
+  }
+  reference operator[](size_type pos) { return data_[pos]; }
+  const_reference operator[](size_type pos) const { return data_[pos]; }
+  reference front() { return data_[0]; }
+  const_reference front() const { return data_[0]; }
+  reference back() { return data_[size_ - 1]; }
+  const_reference back() const { return data_[size_ - 1]; }
+  T* data() { return data_; }
+  const T* data() const { return data_; }
+
+  // iterators
+  iterator begin() { return data_; }
+  const_iterator begin() const { return data_; }
+  const_iterator cbegin() const { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator end() const { return data_ + size_; }
+  const_iterator cend() const { return data_ + size_; }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator crbegin() const {
+    return const_reverse_iterator(end());
+  }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+  const_reverse_iterator crend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  // capacity
+  bool empty() const { return size_ == 0; }
+  size_type size() const { return size_; }
+  size_type max_size() const { return allocator_type().max_size(); }
+  size_type capacity() const { return capacity_; }
+  bool use_stack_memory() const { return data_ == InlineData(); }
+
+  void reserve(size_type n) {
+    if (n > capacity_) {
+      Reallocate(n);
+    }
+  }
+
+  // go back to the inline buffer whenever the elements fit in it
+  void shrink_to_fit() {
+    if (use_stack_memory() || size_ == capacity_) {
+      return;
+    }
+    Reallocate(size_ <= Capacity ? Capacity : size_);
+  }
+
+  // modifiers
+  void clear() {
+    Destroy(begin(), end());
+    size_ = 0;
+  }
+
+  iterator insert(const_iterator pos, const T& value) {
+    return emplace(pos, value);
+  }
+
+  iterator insert(const_iterator pos, T&& value) {
+    return emplace(pos, std::move(value));
+  }
+
+  iterator insert(const_iterator pos, size_type n, const T& value) {
+    size_type index = pos - cbegin();
+    if (n == 0) {
+      return begin() + index;
+    }
+    T copy(value);  // value may live inside this vector
+    T* hole = MakeRoom(index, n);
+    FillRoom(hole, n, [&copy](T* slot) { new (slot) T(copy); });
+    size_ += n;
+    return hole;
+  }
+
+  template <typename InputIterator,
+            typename = typename std::enable_if<!std::is_integral<
+                InputIterator>::value>::type>
+  iterator insert(const_iterator pos, InputIterator first,
+                  InputIterator last) {
+    return InsertRange(
+        pos, first, last,
+        typename std::iterator_traits<InputIterator>::iterator_category());
+  }
+
+  iterator insert(const_iterator pos, std::initializer_list<T> ilist) {
+    return insert(pos, ilist.begin(), ilist.end());
+  }
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args) {
+    size_type index = pos - cbegin();
+    if (index == size_) {
+      emplace_back(std::forward<Args>(args)...);
+      return end() - 1;
+    }
+    T value(std::forward<Args>(args)...);
+    T* hole = MakeRoom(index, 1);
+    FillRoom(hole, 1, [&value](T* slot) { new (slot) T(std::move(value)); });
+    ++size_;
+    return hole;
+  }
+
+  iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    T* dest = const_cast<T*>(first);
+    if (first != last) {
+      T* new_end = std::move(const_cast<T*>(last), end(), dest);
+      Destroy(new_end, end());
+      size_ = new_end - begin();
+    }
+    return dest;
+  }
+
+  // the hot path is a single compare against capacity
+  void push_back(const T& value) {
+    if (size_ < capacity_) {
+      new (data_ + size_) T(value);
+      ++size_;
+    } else {
+      GrowAndEmplaceBack(value);
+    }
+  }
+
+  void push_back(T&& value) {
+    if (size_ < capacity_) {
+      new (data_ + size_) T(std::move(value));
+      ++size_;
+    } else {
+      GrowAndEmplaceBack(std::move(value));
+    }
+  }
+
+  template <typename... Args>
+  void emplace_back(Args&&... args) {
+    if (size_ < capacity_) {
+      new (data_ + size_) T(std::forward<Args>(args)...);
+      ++size_;
+    } else {
+      GrowAndEmplaceBack(std::forward<Args>(args)...);
+    }
+  }
+
+  void pop_back() {
+    --size_;
+    data_[size_].~T();
+  }
+
+  void resize(size_type n) {
+    if (n < size_) {
+      Destroy(begin() + n, end());
+    } else if (n > size_) {
+      reserve(n);
+      for (T* p = end(); p != data_ + n; ++p) new (p) T();
+    }
+    size_ = n;
+  }
+
+  void resize(size_type n, const T& value) {
+    if (n < size_) {
+      Destroy(begin() + n, end());
+      size_ = n;
+    } else if (n > size_) {
+      insert(end(), n - size_, value);
+    }
+  }
+
+  // heap buffers are exchanged by pointer, inline elements are moved
+  void swap(SmallVector& other) {
+    if (this == &other) {
+      return;
+    }
+    if (!use_stack_memory() && !other.use_stack_memory()) {
+      std::swap(data_, other.data_);
+      std::swap(size_, other.size_);
+      std::swap(capacity_, other.capacity_);
+      return;
+    }
+    SmallVector tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+  }
+
+ private:
+  using AlignedStorage =
+      typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+  using TriviallyRelocatable =
+      std::integral_constant<bool, std::is_trivially_copyable<T>::value>;
+
+  T* InlineData() { return reinterpret_cast<T*>(buffer_); }
+  const T* InlineData() const { return reinterpret_cast<const T*>(buffer_); }
+
+  static void Destroy(T* first, T* last) {
+    for (; first != last; ++first) first->~T();
+  }
+
+  // move [first, last) to the uninitialized dest and end the source lifetime
+  static void Relocate(T* first, T* last, T* dest, std::true_type) {
+    if (first != last) {
+      std::memmove(static_cast<void*>(dest), first,
+                   (last - first) * sizeof(T));
+    }
+  }
+
+  static void Relocate(T* first, T* last, T* dest, std::false_type) {
+    if (dest <= first) {
+      for (; first != last; ++first, ++dest) {
+        new (dest) T(std::move(*first));
+        first->~T();
+      }
+    } else {
+      dest += last - first;
+      while (last != first) {
+        --last;
+        --dest;
+        new (dest) T(std::move(*last));
+        last->~T();
+      }
+    }
+  }
+
+  static void Relocate(T* first, T* last, T* dest) {
+    Relocate(first, last, dest, TriviallyRelocatable());
+  }
+
+  void FreeHeap() {
+    if (!use_stack_memory()) {
+      allocator_type().deallocate(data_, capacity_);
+      data_ = InlineData();
+      capacity_ = Capacity;
+    }
+  }
+
+  // move the elements to a buffer of new_capacity, which is the inline
+  // buffer when new_capacity is Capacity
+  void Reallocate(size_type new_capacity) {
+    assert(new_capacity >= size_);
+    T* new_data = new_capacity == Capacity
+                      ? InlineData()
+                      : allocator_type().allocate(new_capacity);
+    if (new_data == data_) {
+      return;
+    }
+    Relocate(begin(), end(), new_data);
+    if (!use_stack_memory()) {
+      allocator_type().deallocate(data_, capacity_);
+    }
+    data_ = new_data;
+    capacity_ = new_capacity;
+  }
+
+  size_type NextCapacity(size_type required) const {
+    return std::max(capacity_ * 2, required);
+  }
+
+  // open a gap of n uninitialized slots at index, size_ is left untouched
+  T* MakeRoom(size_type index, size_type n) {
+    if (size_ + n > capacity_) {
+      Reallocate(NextCapacity(size_ + n));
+    }
+    T* hole = data_ + index;
+    Relocate(hole, end(), hole + n);
+    return hole;
+  }
+
+  // build(slot) constructs each element of the gap MakeRoom opened at
+  // hole in turn; if one throws, those built are destroyed and the tail
+  // moves back, which leaves the elements as they were
+  template <typename Build>
+  void FillRoom(T* hole, size_type n, Build build) {
+    T* slot = hole;
+    try {
+      for (; slot != hole + n; ++slot) build(slot);
+    } catch (...) {
+      Destroy(hole, slot);
+      Relocate(hole + n, end() + n, hole);
+      throw;
+    }
+  }
+
+  // build the new element before relocating, args may point into us
+  template <typename... Args>
+  void GrowAndEmplaceBack(Args&&... args) {
+    size_type new_capacity = NextCapacity(size_ + 1);
+    T* new_data = allocator_type().allocate(new_capacity);
+    try {
+      new (new_data + size_) T(std::forward<Args>(args)...);
+    } catch (...) {
+      allocator_type().deallocate(new_data, new_capacity);
+      throw;
+    }
+    Relocate(begin(), end(), new_data);
+    if (!use_stack_memory()) {
+      allocator_type().deallocate(data_, capacity_);
+    }
+    data_ = new_data;
+    capacity_ = new_capacity;
+    ++size_;
+  }
+
+  template <typename InputIterator>
+  iterator InsertRange(const_iterator pos, InputIterator first,
+                       InputIterator last, std::input_iterator_tag) {
+    size_type index = pos - cbegin();
+    for (size_type i = index; first != last; ++first, ++i) {
+      emplace(begin() + i, *first);
+    }
+    return begin() + index;
+  }
+
+  template <typename ForwardIterator>
+  iterator InsertRange(const_iterator pos, ForwardIterator first,
+                       ForwardIterator last, std::forward_iterator_tag) {
+    size_type index = pos - cbegin();
+    size_type n = std::distance(first, last);
+    if (n == 0) {
+      return begin() + index;
+    }
+    T* hole = MakeRoom(index, n);
+    FillRoom(hole, n, [&first](T* slot) {
+      new (slot) T(*first);
+      ++first;
+    });
+    size_ += n;
+    return hole;
+  }
+
+  // steal other's heap buffer, or relocate its inline elements into ours
+  void TakeFrom(SmallVector& other) {
+    if (other.use_stack_memory()) {
+      Relocate(other.begin(), other.end(), data_);
+    } else {
+      data_ = other.data_;
+      capacity_ = other.capacity_;
+      other.data_ = other.InlineData();
+      other.capacity_ = Capacity;
+    }
+    size_ = other.size_;
+    other.size_ = 0;
+  }
+
+  T* data_;
+  size_type size_;
+  size_type capacity_;
+  AlignedStorage buffer_[Capacity];
+};
+
+template <typename T, size_t Capacity>
+void swap(SmallVector<T, Capacity>& lhs, SmallVector<T, Capacity>& rhs) {
+  lhs.swap(rhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2>
+inline bool operator==(const SmallVector<T, Capacity1>& lhs,
+                       const SmallVector<T, Capacity2>& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(std::begin(lhs), std::end(lhs), std::begin(rhs));
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2>
+inline bool operator!=(const SmallVector<T, Capacity1>& lhs,
+                       const SmallVector<T, Capacity2>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2>
+inline bool operator<(const SmallVector<T, Capacity1>& lhs,
+                      const SmallVector<T, Capacity2>& rhs) {
+  return std::lexicographical_compare(std::begin(lhs), std::end(lhs),
+                                      std::begin(rhs), std::end(rhs));
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2>
+inline bool operator<=(const SmallVector<T, Capacity1>& lhs,
+                       const SmallVector<T, Capacity2>& rhs) {
+  return !(rhs < lhs);
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2>
+inline bool operator>(const SmallVector<T, Capacity1>& lhs,
+                      const SmallVector<T, Capacity2>& rhs) {
+  return rhs < lhs;
+}
+
+template <typename T, size_t Capacity1, size_t Capacity2>
+inline bool operator>=(const SmallVector<T, Capacity1>& lhs,
+                       const SmallVector<T, Capacity2>& rhs) {
+  return !(lhs < rhs);
+}
@@ -0,0 +1,225 @@
+#pragma once
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <stdexcept>
+#include "utils.hpp"
+
+// Read-copy-update over any of the fixed maps, for lookup tables that are
+// read all the time and replaced now and then. Readers look at an
+// immutable version of the map and never wait: a read announces itself
+// in the reader's own slot and loads the pointer to the current version,
+// nothing is written that another reader touches. A writer builds a new
+// version aside and publishes it with one pointer swap; the old one is
+// freed once no read that could have seen it is still going on, which is
+// tracked with epochs.
+//
+// The global epoch goes up at every publish. A read stores the epoch it
+// started in into its slot and clears it when done; a version replaced in
+// the step to epoch e can only be held by reads that announced an epoch
+// below e, so it is freed when every busy slot shows e or later. Reads
+// and the scan of the slots are seq_cst so that a read either announces
+// itself before the scan or sees the new version.
+//
+// Each thread that reads makes a Reader, which takes one of MaxReaders
+// slots for its lifetime. Writers are serialized by a mutex.
+template <typename Map, size_t MaxReaders = 64>
+class SnapshotMap {
+  struct Version;
+  struct Slot;
+
+ public:
+  using map_type = Map;
+  using key_type = typename Map::key_type;
+  using mapped_type = typename Map::mapped_type;
+
+  // one read: the version it sees stays alive until it goes away
+  class Snapshot {
+   public:
+    Snapshot(Snapshot&& other) : slot_(other.slot_), map_(other.map_) {
+      other.slot_ = nullptr;
+    }
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    ~Snapshot() {
+      if (slot_ != nullptr) {
+        slot_->epoch_.store(0, std::memory_order_release);
+      }
+    }
+
+    const Map& operator*() const { return *map_; }
+    const Map* operator->() const { return map_; }
+
+   private:
+    friend class SnapshotMap;
+
+    Snapshot(Slot* slot, const Map* map) : slot_(slot), map_(map) {}
+
+    Slot* slot_;
+    const Map* map_;
+  };
+
+  // a reading thread's slot; a thread holds one read at a time
+  class Reader {
+   public:
+    explicit Reader(SnapshotMap& owner) : owner_(owner) {
+      for (Slot& slot : owner_.slots_) {
+        bool expected = false;
+        if (!slot.taken_.load(std::memory_order_relaxed) &&
+            slot.taken_.compare_exchange_strong(expected, true)) {
+          slot_ = &slot;
+          return;
+        }
+      }
+      throw std::length_error("SnapshotMap: all reader slots are taken");
+    }
+
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    ~Reader() {
+      assert(slot_->epoch_.load() == 0);
+      slot_->taken_.store(false, std::memory_order_release);
+    }
+
+    Snapshot read() {
+      assert(slot_->epoch_.load(std::memory_order_relaxed) == 0);
+      slot_->epoch_.store(owner_.epoch_.load(std::memory_order_acquire),
+                          std::memory_order_seq_cst);
+      Version* version = owner_.current_.load(std::memory_order_seq_cst);
+      return Snapshot(slot_, &version->map_);
+    }
+
+    // copy the value of key to value, false when there is none
+    bool get(const key_type& key, mapped_type& value) {
+      Snapshot snapshot = read();
+      auto it = snapshot->find(key);
+      if (it == snapshot->end()) {
+        return false;
+      }
+      value = it->second;
+      return true;
+    }
+
+   private:
+    SnapshotMap& owner_;
+    Slot* slot_ = nullptr;
+  };
+
+  SnapshotMap() : SnapshotMap(Map()) {}
+
+  explicit SnapshotMap(Map map) : current_(new Version(std::move(map))) {}
+
+  SnapshotMap(const SnapshotMap&) = delete;
+  SnapshotMap& operator=(const SnapshotMap&) = delete;
+
+  // every Reader must be gone
+  ~SnapshotMap() {
+    delete current_.load();
+    FreeRetired(UINT64_MAX);
+  }
+
+  // replace the whole map
+  void publish(Map map) {
+    std::unique_ptr<Version> next(new Version(std::move(map)));
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    PublishLocked(next.release());
+  }
+
+  // publish a copy of the current version changed by func(Map&); if func
+  // throws nothing is published
+  template <typename Func>
+  void update(Func func) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    std::unique_ptr<Version> next(
+        new Version(current_.load(std::memory_order_relaxed)->map_));
+    func(next->map_);
+    PublishLocked(next.release());
+  }
+
+  void insert_or_assign(const key_type& key, const mapped_type& value) {
+    update([&](Map& map) {
+      auto result = map.emplace(key, value);
+      if (!result.second) {
+        result.first->second = value;
+      }
+    });
+  }
+
+  void erase(const key_type& key) {
+    update([&](Map& map) { map.erase(key); });
+  }
+
+  // free what readers have let go of since the last publish, returns how
+  // many versions are still held
+  size_t reclaim() {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    return ReclaimLocked();
+  }
+
+  uint64_t epoch() const { return epoch_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Version {
+    explicit Version(Map map) : map_(std::move(map)) {}
+
+    Map map_;
+    uint64_t retired_epoch_ = 0;
+    Version* next_retired_ = nullptr;
+  };
+
+  // 0 while the reader is not reading
+  struct Slot {
+    std::atomic<uint64_t> epoch_{0};
+    std::atomic<bool> taken_{false};
+    char pad_[kCacheLineSize];
+  };
+
+  void PublishLocked(Version* next) {
+    Version* old = current_.exchange(next, std::memory_order_seq_cst);
+    old->retired_epoch_ = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+    old->next_retired_ = retired_;
+    retired_ = old;
+    ReclaimLocked();
+  }
+
+  size_t ReclaimLocked() {
+    uint64_t oldest = UINT64_MAX;
+    for (Slot& slot : slots_) {
+      uint64_t epoch = slot.epoch_.load(std::memory_order_seq_cst);
+      if (epoch != 0 && epoch < oldest) {
+        oldest = epoch;
+      }
+    }
+    return FreeRetired(oldest);
+  }
+
+  // free the versions retired at oldest or before, returns how many remain
+  size_t FreeRetired(uint64_t oldest) {
+    size_t held = 0;
+    Version** link = &retired_;
+    while (*link != nullptr) {
+      Version* version = *link;
+      if (version->retired_epoch_ <= oldest) {
+        *link = version->next_retired_;
+        delete version;
+      } else {
+        link = &version->next_retired_;
+        ++held;
+      }
+    }
+    return held;
+  }
+
+  std::atomic<Version*> current_;
+  std::atomic<uint64_t> epoch_{1};
+  char epoch_pad_[kCacheLineSize];
+  Slot slots_[MaxReaders];
+  std::mutex write_mutex_;
+  Version* retired_ = nullptr;
+};
@@ -1,41 +1,151 @@
 #pragma once
 #include <set>  // for _Rb_tree_node
 #include <memory>
+#include <tuple>
+#include <vector>
+#include <iterator>
+#include <algorithm>
 #include <type_traits>
 #include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <cassert>
 #include "utils.hpp"
+#include "arena.hpp"
+#include "alloc_trace.hpp"
 
 template <typename T>
 using __std_tree_node_t = std::_Rb_tree_node<T>;
 
-template <typename T, size_t Capacity>
+template <typename Node>
+using NodeValueOf = typename std::remove_pointer<decltype(
+    std::declval<Node&>()._M_valptr())>::type;
+
+// whether the value of a Node can change slot without a chance of
+// throwing; the containers trade or compact their pools only when it can,
+// as a throw halfway would leave the pools torn
+template <typename Node>
+struct NodesRelocatable
+    : std::integral_constant<
+          bool, std::is_trivially_copyable<NodeValueOf<Node>>::value ||
+                    std::is_nothrow_move_constructible<
+                        NodeValueOf<Node>>::value> {};
+
+// When the inline buffer runs out, SlabOverflow makes the allocator carve
+// further nodes out of geometrically growing heap slabs instead of calling
+// malloc once per node. Freed inline slots are handed out again lowest
+// address first, freed slab nodes go through a free list, and slabs are
+// only released with the ReservedMemory, so the owning container must
+// clear() itself before its ReservedMemory goes away: a container that
+// holds the ReservedMemory as a member and derives from the std one
+// clears in its own destructor, as the member is destroyed before the
+// base class gets to free the nodes. A ReservedMemory given an Arena
+// takes its slabs from there and leaves them to the arena.
+template <typename T, size_t Capacity, bool SlabOverflow = true>
 class StackAllocator : public std::allocator<T> {
  public:
   // be friend to a rebinded allocator
-  template <typename U, size_t Cap>
+  template <typename U, size_t Cap, bool Slab>
   friend class StackAllocator;
 
   using pointer = typename std::allocator<T>::pointer;
   using size_type = typename std::allocator<T>::size_type;
 
+  // std::allocator says any two instances are equal and its memory may
+  // follow a moved container, neither holds for a pool owned by one
+  // container; allocators compare equal only when they share the pool
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::false_type;
+  using propagate_on_container_swap = std::false_type;
+  using is_always_equal = std::false_type;
+
+  template <typename U, size_t Cap, bool Slab>
+  friend bool operator==(const StackAllocator<U, Cap, Slab>& lhs,
+                         const StackAllocator<U, Cap, Slab>& rhs);
+
   struct ReservedMemory {
     using AlignedStorage =
         typename std::aligned_storage<sizeof(T), alignof(T)>::type;
     struct Link {
       Link* link_;
     };
+    // sits in the first slot of every slab
+    struct Slab {
+      Slab* next_;
+      size_t nodes_;
+    };
 
-    ReservedMemory()
+    explicit ReservedMemory(Arena* slab_arena = nullptr)
         : head_(nullptr),
           next_(reinterpret_cast<Link*>(buffer_)),
-          tail_(reinterpret_cast<Link*>(buffer_ + Capacity)) {}
+          tail_(reinterpret_cast<Link*>(buffer_ + Capacity)),
+          slab_arena_(slab_arena) {}
+
+    ReservedMemory(const ReservedMemory&) = delete;
+    ReservedMemory& operator=(const ReservedMemory&) = delete;
+
+    // an arena gets the slabs back for the next pool of the same type
+    ~ReservedMemory() {
+      while (slabs_ != nullptr) {
+        Slab* slab = slabs_;
+        slabs_ = slabs_->next_;
+        if (slab_arena_ != nullptr) {
+          slab_arena_->Recycle(slab,
+                               (slab->nodes_ + 1) * sizeof(AlignedStorage),
+                               alignof(AlignedStorage));
+        } else {
+          DeleteAligned(slab);
+        }
+      }
+    }
+
+    // operator new only promises alignof(std::max_align_t), memory for an
+    // over-aligned node is aligned by hand with the block to free stored
+    // just in front of it
+    static void* NewAligned(size_t bytes) {
+      size_t align = alignof(AlignedStorage);
+      if (align <= alignof(std::max_align_t)) {
+        return ::operator new(bytes);
+      }
+      char* raw = static_cast<char*>(::operator new(bytes + align));
+      char* aligned = reinterpret_cast<char*>(
+          (reinterpret_cast<uintptr_t>(raw) + align) & ~uintptr_t(align - 1));
+      reinterpret_cast<void**>(aligned)[-1] = raw;
+      return aligned;
+    }
+
+    static void DeleteAligned(void* p) {
+      if (alignof(AlignedStorage) <= alignof(std::max_align_t)) {
+        ::operator delete(p);
+      } else {
+        ::operator delete(static_cast<void**>(p)[-1]);
+      }
+    }
 
     pointer Data() { return reinterpret_cast<pointer>(buffer_); }
     pointer DataEnd() { return Data() + Capacity; }
-    bool Remain() { return head_ != nullptr || next_ != tail_; }
+    bool Remain() {
+      return free_slots_ != 0 || head_ != nullptr || next_ != tail_;
+    }
     bool InRange(pointer p) { return p >= Data() && p < DataEnd(); }
+    // where the next Get takes its node from
+    bool NextReused() { return free_slots_ != 0 || head_ != nullptr; }
+    bool NextInline() {
+      return free_slots_ != 0 ||
+             (head_ == nullptr && InRange(reinterpret_cast<pointer>(next_)));
+    }
+    // taking the lowest free inline slot keeps the live nodes packed at
+    // the front of the buffer however they were freed
     pointer Get() {
+      if (free_slots_ != 0) {
+        while (free_bits_[free_word_] == 0) ++free_word_;
+        uint64_t& word = free_bits_[free_word_];
+        size_t index = free_word_ * 64 + __builtin_ctzll(word);
+        word &= word - 1;
+        --free_slots_;
+        return Data() + index;
+      }
       pointer cur = reinterpret_cast<pointer>(head_);
       if (cur != nullptr) {
         head_ = head_->link_;
@@ -52,24 +162,331 @@ class StackAllocator : public std::allocator<T> {
       }
     }
     void Put(pointer p) {
+      if (InRange(p)) {
+        size_t index = p - Data();
+        free_bits_[index / 64] |= uint64_t(1) << index % 64;
+        free_word_ =
+            free_slots_ == 0 ? index / 64 : std::min(free_word_, index / 64);
+        ++free_slots_;
+        return;
+      }
       Link* cur = reinterpret_cast<Link*>(p);
       cur->link_ = head_;
       head_ = cur;
     }
+
+    // only called when nothing remains, so the unused tail of the previous
+    // slab is empty and next_/tail_ can move on to the new one
+    // the first slot of every slab links it into slabs_
+    // returns the number of bytes taken from the heap
+    size_t AddSlab() {
+      static_assert(sizeof(Slab) <= sizeof(AlignedStorage),
+                    "a slab header must fit in one node slot");
+      assert(!Remain());
+      size_t bytes = (slab_nodes_ + 1) * sizeof(AlignedStorage);
+      AlignedStorage* slab = static_cast<AlignedStorage*>(
+          slab_arena_ != nullptr
+              ? slab_arena_->Allocate(bytes, alignof(AlignedStorage))
+              : NewAligned(bytes));
+      Slab* header = reinterpret_cast<Slab*>(slab);
+      header->next_ = slabs_;
+      header->nodes_ = slab_nodes_;
+      slabs_ = header;
+      next_ = reinterpret_cast<Link*>(slab + 1);
+      tail_ = reinterpret_cast<Link*>(slab + 1 + slab_nodes_);
+      slab_nodes_ *= 2;
+      return bytes;
+    }
+
+    // whether the slabs of other can become ours, both pools must give
+    // them back the same way
+    bool CanAdopt(const ReservedMemory& other) const {
+      return slab_arena_ == other.slab_arena_;
+    }
+
+    // Take over every slab of other together with the nodes in it: the
+    // live_nodes of other's live nodes that sit in slabs now belong to
+    // this pool, and its free slab nodes and the unused rest of its
+    // current slab join our free list. other is left with its inline
+    // buffer only, so none of those live nodes may ever be handed back to
+    // it. Slab nodes may then be live while part of our inline buffer has
+    // never been handed out, Compact allows for that. Costs O(slabs + free
+    // slab nodes of other), allocates nothing.
+    void AdoptSlabs(ReservedMemory& other, size_t live_nodes) {
+      assert(CanAdopt(other));
+      if (other.slabs_ == nullptr) {
+        return;
+      }
+      unsigned char* raw_next = reinterpret_cast<unsigned char*>(other.next_);
+      if (raw_next < other.Bytes() ||
+          raw_next > other.Bytes() + kBufferBytes) {
+        for (Link* link = other.next_; link != other.tail_;) {
+          Link* next = reinterpret_cast<Link*>(
+              reinterpret_cast<unsigned char*>(link) + sizeof(T));
+          Put(reinterpret_cast<pointer>(link));
+          link = next;
+        }
+        other.next_ = other.tail_ =
+            reinterpret_cast<Link*>(other.Bytes() + kBufferBytes);
+      }
+      while (other.head_ != nullptr) {
+        Link* link = other.head_;
+        other.head_ = link->link_;
+        Put(reinterpret_cast<pointer>(link));
+      }
+      Slab* last = other.slabs_;
+      while (last->next_ != nullptr) last = last->next_;
+      last->next_ = slabs_;
+      slabs_ = other.slabs_;
+      other.slabs_ = nullptr;
+      slab_nodes_ = std::max(slab_nodes_, other.slab_nodes_);
+#if defined(EXT_STL_ALLOC_TRACE)
+      live_ += live_nodes;
+      other.live_ -= live_nodes;
+#else
+      (void)live_nodes;
+#endif
+    }
+
+    // maps addresses in one inline buffer to the same offset in another
+    class Relocation {
+     public:
+      Relocation(const ReservedMemory& from, ReservedMemory& to)
+          : from_(from.Bytes()), to_(to.Bytes()) {}
+
+      template <typename P>
+      P* operator()(P* p) const {
+        const unsigned char* raw = reinterpret_cast<const unsigned char*>(p);
+        if (raw < from_ || raw >= from_ + kBufferBytes) {
+          return p;
+        }
+        return reinterpret_cast<P*>(to_ + (raw - from_));
+      }
+
+      // like operator() but also maps the end of the buffer, which a bump
+      // pointer holds once the buffer is used up
+      template <typename P>
+      P* Bound(P* p) const {
+        const unsigned char* raw = reinterpret_cast<const unsigned char*>(p);
+        if (raw == from_ + kBufferBytes) {
+          return reinterpret_cast<P*>(to_ + kBufferBytes);
+        }
+        return (*this)(p);
+      }
+
+      // whether p lies in the buffer that nodes are relocated to
+      template <typename P>
+      bool InTarget(const P* p) const {
+        const unsigned char* raw = reinterpret_cast<const unsigned char*>(p);
+        return raw >= to_ && raw < to_ + kBufferBytes;
+      }
+
+     private:
+      const unsigned char* from_;
+      unsigned char* to_;
+    };
+
+    // Trade every node with other without copying an element: the inline
+    // buffers exchange their slots and the slabs change owner by pointer,
+    // so each node keeps its offset but moves to the other pool. The free
+    // slots are fixed here, then relink(node, old, relocation) is called
+    // for every live node that moved between the inline buffers and must
+    // repoint its own links and the back links of neighbours outside the
+    // buffer. Links held by the container itself are left to the caller.
+    // Costs O(Capacity), however many nodes sit in slabs. Only for nodes
+    // that are NodesRelocatable.
+    template <typename Relink>
+    void SwapWith(ReservedMemory& other, Relink relink) {
+      uint64_t live[kSlotWords] = {};
+      uint64_t other_live[kSlotWords] = {};
+      size_t used = MarkLive(live);
+      size_t other_used = other.MarkLive(other_live);
+      SwapSlots(other, live, other_live, std::max(used, other_used));
+
+      std::swap(head_, other.head_);
+      std::swap(next_, other.next_);
+      std::swap(tail_, other.tail_);
+      std::swap(slabs_, other.slabs_);
+      std::swap(slab_nodes_, other.slab_nodes_);
+      std::swap(slab_arena_, other.slab_arena_);
+      std::swap_ranges(free_bits_, free_bits_ + kSlotWords, other.free_bits_);
+      std::swap(free_word_, other.free_word_);
+      std::swap(free_slots_, other.free_slots_);
+#if defined(EXT_STL_ALLOC_TRACE)
+      std::swap(live_, other.live_);
+#endif
+      Relocation to_this(other, *this);
+      Relocation to_other(*this, other);
+      RelocateBump(to_this);
+      other.RelocateBump(to_other);
+
+      for (size_t i = 0; i < other_used; ++i) {
+        if (other_live[i / 64] >> (i % 64) & 1) {
+          relink(Data() + i, other.Data() + i, to_this);
+        }
+      }
+      for (size_t i = 0; i < used; ++i) {
+        if (live[i / 64] >> (i % 64) & 1) {
+          relink(other.Data() + i, Data() + i, to_other);
+        }
+      }
+    }
+
+    static constexpr size_t kBufferBytes = Capacity * sizeof(AlignedStorage);
+    static constexpr size_t kSlotWords = (Capacity + 63) / 64;
+
+    unsigned char* Bytes() { return reinterpret_cast<unsigned char*>(buffer_); }
+    const unsigned char* Bytes() const {
+      return reinterpret_cast<const unsigned char*>(buffer_);
+    }
+
+    // how many inline slots have ever been handed out
+    size_t UsedSlots() {
+      unsigned char* raw_next = reinterpret_cast<unsigned char*>(next_);
+      return raw_next >= Bytes() && raw_next <= Bytes() + kBufferBytes
+                 ? (raw_next - Bytes()) / sizeof(AlignedStorage)
+                 : Capacity;
+    }
+
+    // set a bit for every inline slot holding a node, returns UsedSlots()
+    size_t MarkLive(uint64_t* live) {
+      size_t used = UsedSlots();
+      for (size_t w = 0; w * 64 < used; ++w) {
+        size_t bits = std::min<size_t>(used - w * 64, 64);
+        uint64_t mask = bits == 64 ? ~uint64_t(0) : (uint64_t(1) << bits) - 1;
+        live[w] = mask & ~free_bits_[w];
+      }
+      return used;
+    }
+
+    // a value that may point into itself, like a short std::string, is
+    // moved into its new slot, anything else travels as plain bytes;
+    // callers check NodesRelocatable first
+    void SwapSlots(ReservedMemory& other, const uint64_t* live,
+                   const uint64_t* other_live, size_t count) noexcept {
+      if (std::is_trivially_copyable<NodeValueOf<T>>::value) {
+        SwapBytes(Bytes(), other.Bytes(), count * sizeof(AlignedStorage));
+        return;
+      }
+      AlignedStorage tmp;
+      for (size_t i = 0; i < count; ++i) {
+        bool lhs_live = live[i / 64] >> (i % 64) & 1;
+        bool rhs_live = other_live[i / 64] >> (i % 64) & 1;
+        MoveSlot(&tmp, &buffer_[i], lhs_live);
+        MoveSlot(&buffer_[i], &other.buffer_[i], rhs_live);
+        MoveSlot(&other.buffer_[i], &tmp, lhs_live);
+      }
+    }
+
+    static void MoveSlot(AlignedStorage* to, AlignedStorage* from, bool live) {
+      std::memcpy(to, from, sizeof(AlignedStorage));
+      if (live) {
+        using Value = NodeValueOf<T>;
+        Value* value = reinterpret_cast<T*>(from)->_M_valptr();
+        ::new (reinterpret_cast<T*>(to)->_M_valptr()) Value(std::move(*value));
+        value->~Value();
+      }
+    }
+
+    // a byte loop is far slower than block copies through the stack
+    static void SwapBytes(unsigned char* lhs, unsigned char* rhs,
+                          size_t bytes) {
+      unsigned char tmp[256];
+      for (size_t offset = 0; offset < bytes; offset += sizeof(tmp)) {
+        size_t len = std::min(sizeof(tmp), bytes - offset);
+        std::memcpy(tmp, lhs + offset, len);
+        std::memcpy(lhs + offset, rhs + offset, len);
+        std::memcpy(rhs + offset, tmp, len);
+      }
+    }
+
+    // the free list only holds slab nodes, which never move
+    void RelocateBump(const Relocation& relocate) {
+      next_ = relocate.Bound(next_);
+      tail_ = relocate.Bound(tail_);
+    }
+
+    // Move the live nodes, given in traversal order, so that the first
+    // Capacity of them fill the inline buffer from its start and a walk
+    // reads it front to back; the rest take the lowest of the slab slots
+    // in use. Only misplaced nodes move, through a heap scratch buffer.
+    // nodes receives the new addresses and the caller relinks them. Only
+    // for nodes that are NodesRelocatable.
+    void Compact(pointer* nodes, size_t count) {
+      size_t inline_count = std::min(count, Capacity);
+      std::vector<pointer> slab_slots;
+      for (size_t i = 0; i < count; ++i) {
+        if (!InRange(nodes[i])) slab_slots.push_back(nodes[i]);
+      }
+      std::sort(slab_slots.begin(), slab_slots.end());
+      std::vector<pointer> from;
+      std::vector<pointer> to;
+      for (size_t i = 0; i < count; ++i) {
+        pointer target =
+            i < inline_count ? Data() + i : slab_slots[i - inline_count];
+        if (nodes[i] != target) {
+          from.push_back(nodes[i]);
+          to.push_back(target);
+          nodes[i] = target;
+        }
+      }
+      std::vector<AlignedStorage> scratch(from.size());
+      MoveNodes(from.data(), to.data(), from.size(), scratch.data());
+
+      // the inline slots past the packed nodes are all free now and the
+      // slab slots given up join the free list; after AdoptSlabs the bump
+      // pointer may not have reached the packed nodes, which took inline
+      // slots never handed out, so it is moved past them
+      size_t used = UsedSlots();
+      if (inline_count > used) {
+        next_ = reinterpret_cast<Link*>(Data() + inline_count);
+        used = inline_count;
+      }
+      std::fill(free_bits_, free_bits_ + kSlotWords, 0);
+      for (size_t i = inline_count; i < used; ++i) {
+        free_bits_[i / 64] |= uint64_t(1) << i % 64;
+      }
+      free_word_ = inline_count / 64;
+      free_slots_ = used - inline_count;
+      for (size_t i = count - inline_count; i < slab_slots.size(); ++i) {
+        Put(slab_slots[i]);
+      }
+    }
+
+    static void MoveNodes(pointer* from, pointer* to, size_t count,
+                          AlignedStorage* scratch) noexcept {
+      for (size_t i = 0; i < count; ++i) {
+        MoveSlot(&scratch[i], reinterpret_cast<AlignedStorage*>(from[i]), true);
+      }
+      for (size_t i = 0; i < count; ++i) {
+        MoveSlot(reinterpret_cast<AlignedStorage*>(to[i]), &scratch[i], true);
+      }
+    }
+
     Link* head_;
     Link* next_;
     Link* tail_;
+    Slab* slabs_ = nullptr;
+    size_t slab_nodes_ = Capacity;
+    Arena* slab_arena_;
+    // one bit per free inline slot, none is set in a word below free_word_
+    uint64_t free_bits_[kSlotWords] = {};
+    size_t free_word_ = 0;
+    size_t free_slots_ = 0;
+#if defined(EXT_STL_ALLOC_TRACE)
+    size_t live_ = 0;
+#endif
 
     AlignedStorage buffer_[Capacity];
   };
 
   template <typename U>
   struct rebind {
-    using other = StackAllocator<U, Capacity>;
+    using other = StackAllocator<U, Capacity, SlabOverflow>;
   };
   StackAllocator() = default;
 
-  StackAllocator(const StackAllocator<T, Capacity>& other)
+  StackAllocator(const StackAllocator<T, Capacity, SlabOverflow>& other)
       : std::allocator<T>(), reserved_memory_(other.reserved_memory_) {}
 
   /*
@@ -83,7 +500,7 @@ class StackAllocator : public std::allocator<T> {
   // they should share the memory
   template <typename U, size_t OtherCapacity, typename Dummy = T>
   StackAllocator(
-      const StackAllocator<U, OtherCapacity>& other,
+      const StackAllocator<U, OtherCapacity, SlabOverflow>& other,
       typename std::enable_if<
           std::is_same<__std_tree_node_t<Dummy>, U>::value ||
           std::is_same<__std_tree_node_t<U>, Dummy>::value>::type* = nullptr)
@@ -92,7 +509,7 @@ class StackAllocator : public std::allocator<T> {
 
   template <typename U, size_t OtherCapacity, typename Dummy = T>
   StackAllocator(
-      const StackAllocator<U, OtherCapacity>& other,
+      const StackAllocator<U, OtherCapacity, SlabOverflow>& other,
       typename std::enable_if<
           !std::is_same<__std_tree_node_t<Dummy>, U>::value &&
           !std::is_same<__std_tree_node_t<U>, Dummy>::value>::type* = nullptr)
@@ -106,26 +523,429 @@ class StackAllocator : public std::allocator<T> {
   pointer allocate(size_type n, void* hint = 0) {
     assert(n == 1);
     if (reserved_memory_->Remain()) {
+      TraceAllocate(reserved_memory_->NextReused(), 0);
       return reserved_memory_->Get();
     }
-    return std::allocator<T>::allocate(n, hint);
+    if (SlabOverflow) {
+      size_t slab_bytes = reserved_memory_->AddSlab();
+      TraceAllocate(false, slab_bytes);
+      return reserved_memory_->Get();
+    }
+    TraceAllocate(false, sizeof(T));
+    return static_cast<pointer>(ReservedMemory::NewAligned(sizeof(T)));
   }
 
   void deallocate(pointer p, size_type n) {
     assert(n == 1);
-    if (reserved_memory_->InRange(p)) {
+    TraceDeallocate();
+    if (SlabOverflow || reserved_memory_->InRange(p)) {
       reserved_memory_->Put(p);
     } else {
-      std::allocator<T>::deallocate(p, n);
+      ReservedMemory::DeleteAligned(p);
     }
   }
 
  private:
+#if defined(EXT_STL_ALLOC_TRACE)
+  // called before the node is taken, heap_bytes is what this allocation
+  // took from the heap: a whole slab, one node or nothing
+  void TraceAllocate(bool reused, size_t heap_bytes) {
+    AllocTraceCounters* counters = AllocTraceFor<T, Capacity>();
+    bool in_buffer = heap_bytes == 0 && reserved_memory_->NextInline();
+    if (in_buffer) {
+      counters->inline_hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      counters->heap_fallbacks.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (reused) {
+      counters->free_list_reuse.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (heap_bytes != 0) {
+      counters->bytes_spilled.fetch_add(heap_bytes,
+                                        std::memory_order_relaxed);
+    }
+    counters->RecordPeak(++reserved_memory_->live_);
+  }
+  void TraceDeallocate() { --reserved_memory_->live_; }
+#else
+  void TraceAllocate(bool, size_t) {}
+  void TraceDeallocate() {}
+#endif
+
   ReservedMemory* reserved_memory_ = nullptr;
 };
 
-template <typename T, size_t Capacity>
-inline bool operator==(const StackAllocator<T, Capacity>& lhs,
-                       const StackAllocator<T, Capacity>& rhs) {
-  return false;
+// repoint a red-black tree node that moved from old, and the neighbours
+// outside the relocated buffer that linked to it
+template <typename Relocation>
+inline void ReplaceTreeLink(std::_Rb_tree_node_base* neighbour,
+                            std::_Rb_tree_node_base* old,
+                            std::_Rb_tree_node_base* node,
+                            const Relocation& relocate) {
+  if (neighbour == nullptr || relocate.InTarget(neighbour)) {
+    return;
+  }
+  if (neighbour->_M_parent == old) neighbour->_M_parent = node;
+  if (neighbour->_M_left == old) neighbour->_M_left = node;
+  if (neighbour->_M_right == old) neighbour->_M_right = node;
+}
+
+struct TreeRelink {
+  template <typename Relocation>
+  void operator()(std::_Rb_tree_node_base* node, std::_Rb_tree_node_base* old,
+                  const Relocation& relocate) const {
+    node->_M_parent = relocate(node->_M_parent);
+    node->_M_left = relocate(node->_M_left);
+    node->_M_right = relocate(node->_M_right);
+    ReplaceTreeLink(node->_M_parent, old, node, relocate);
+    ReplaceTreeLink(node->_M_left, old, node, relocate);
+    ReplaceTreeLink(node->_M_right, old, node, relocate);
+  }
+};
+
+// Build a value at to for one that moves to another pool although its
+// move may throw: what moves without throwing is moved and the rest is
+// copied, the key of a map entry is const and always copied.
+// UndoTransfer gives back what was moved when a later transfer throws.
+template <typename T>
+void TransferValue(T* to, T& from) {
+  ::new (static_cast<void*>(to)) T(std::move_if_noexcept(from));
+}
+
+template <typename K, typename V>
+void TransferValue(std::pair<const K, V>* to, std::pair<const K, V>& from) {
+  ::new (static_cast<void*>(to)) std::pair<const K, V>(
+      std::piecewise_construct, std::forward_as_tuple(from.first),
+      std::forward_as_tuple(std::move_if_noexcept(from.second)));
+}
+
+template <typename T>
+void UndoTransfer(T& to, T& from, std::true_type) {
+  from = std::move(to);
+}
+
+template <typename T>
+void UndoTransfer(T&, T&, std::false_type) {}
+
+// the same choice as std::move_if_noexcept
+template <typename T>
+void UndoTransfer(T& to, T& from) {
+  UndoTransfer(to, from,
+               std::integral_constant<
+                   bool, std::is_nothrow_move_constructible<T>::value ||
+                             !std::is_copy_constructible<T>::value>());
+}
+
+template <typename K, typename V>
+void UndoTransfer(std::pair<const K, V>& to, std::pair<const K, V>& from) {
+  UndoTransfer(to.second, from.second);
+}
+
+// swap two fixed containers by trade(), which trades their node pools,
+// when their nodes are NodesRelocatable and through copies otherwise; if a
+// copy throws both stay valid, though lhs may hold the values of rhs
+template <typename Container, typename Trade>
+void SwapFixed(Container&, Container&, Trade trade, std::true_type) {
+  trade();
+}
+
+template <typename Container, typename Trade>
+void SwapFixed(Container& lhs, Container& rhs, Trade, std::false_type) {
+  Container tmp(lhs);
+  lhs = rhs;
+  rhs = tmp;
+}
+
+// swap two trees whose nodes live in StackAllocator pools: the bases trade
+// their roots, then the pools trade their nodes so each tree's nodes are
+// owned by its own pool again
+template <typename Tree, typename Memory>
+void SwapFixedTree(Tree& lhs, Memory& lhs_memory, Tree& rhs,
+                   Memory& rhs_memory) {
+  lhs.swap(rhs);
+  lhs_memory.SwapWith(rhs_memory, TreeRelink());
+  // the headers hold the root, leftmost and rightmost nodes
+  auto relocate_header = [](const Tree& tree,
+                            const typename Memory::Relocation& relocate) {
+    std::_Rb_tree_node_base* header =
+        const_cast<std::_Rb_tree_node_base*>(tree.cend()._M_node);
+    header->_M_parent = relocate(header->_M_parent);
+    header->_M_left = relocate(header->_M_left);
+    header->_M_right = relocate(header->_M_right);
+  };
+  relocate_header(lhs, typename Memory::Relocation(rhs_memory, lhs_memory));
+  relocate_header(rhs, typename Memory::Relocation(lhs_memory, rhs_memory));
+}
+
+// move the tree of src into the empty dst: with NodesRelocatable nodes
+// the pools trade their nodes as in a swap
+template <typename Tree, typename Memory>
+void MoveFixedTree(Tree& dst, Memory& dst_memory, Tree& src,
+                   Memory& src_memory, std::true_type) {
+  SwapFixedTree(dst, dst_memory, src, src_memory);
+}
+
+// Otherwise the values in the inline buffer of src are transferred into
+// nodes of dst, all before anything is relinked so that a throw undoes
+// them and leaves both trees as they were. dst then adopts the slabs of
+// src with the nodes in them, which keep their address; if the pools
+// draw slabs from different arenas every value is transferred.
+template <typename Tree, typename Memory>
+void MoveFixedTree(Tree& dst, Memory& dst_memory, Tree& src,
+                   Memory& src_memory, std::false_type) {
+  using Alloc = typename Tree::allocator_type;
+  using Traits = std::allocator_traits<Alloc>;
+  using NodePtr = typename Traits::pointer;
+  using NodeBase = std::_Rb_tree_node_base;
+  assert(dst.empty());
+  bool adopt = dst_memory.CanAdopt(src_memory);
+  // the nodes of src that are replaced, each with its replacement; the
+  // live inline slots are found without walking the tree
+  std::vector<std::pair<NodeBase*, NodePtr>> moved;
+  if (adopt) {
+    uint64_t live[Memory::kSlotWords] = {};
+    size_t used = src_memory.MarkLive(live);
+    for (size_t i = 0; i < used; ++i) {
+      if (live[i / 64] >> (i % 64) & 1) {
+        moved.emplace_back(src_memory.Data() + i, nullptr);
+      }
+    }
+  } else {
+    for (auto it = src.cbegin(); it != src.cend(); ++it) {
+      moved.emplace_back(const_cast<NodeBase*>(it._M_node), nullptr);
+    }
+  }
+  size_t slab_nodes = src.size() - moved.size();
+  Alloc alloc = dst.get_allocator();
+  size_t done = 0;
+  try {
+    for (; done < moved.size(); ++done) {
+      NodePtr fresh = Traits::allocate(alloc, 1);
+      try {
+        TransferValue(fresh->_M_valptr(),
+                      *static_cast<NodePtr>(moved[done].first)->_M_valptr());
+      } catch (...) {
+        Traits::deallocate(alloc, fresh, 1);
+        throw;
+      }
+      moved[done].second = fresh;
+    }
+  } catch (...) {
+    for (size_t i = 0; i < done; ++i) {
+      NodePtr fresh = moved[i].second;
+      UndoTransfer(*fresh->_M_valptr(),
+                   *static_cast<NodePtr>(moved[i].first)->_M_valptr());
+      Traits::destroy(alloc, fresh->_M_valptr());
+      Traits::deallocate(alloc, fresh, 1);
+    }
+    throw;
+  }
+
+  dst.swap(src);
+  if (!adopt) {
+    std::sort(moved.begin(), moved.end());
+  }
+  auto relocate = [&moved](NodeBase* node) -> NodeBase* {
+    auto it = std::lower_bound(
+        moved.begin(), moved.end(), node,
+        [](const std::pair<NodeBase*, NodePtr>& entry, NodeBase* key) {
+          return entry.first < key;
+        });
+    return it != moved.end() && it->first == node ? it->second : node;
+  };
+  for (const auto& entry : moved) {
+    NodeBase* node = entry.second;
+    node->_M_color = entry.first->_M_color;
+    node->_M_parent = relocate(entry.first->_M_parent);
+    node->_M_left = relocate(entry.first->_M_left);
+    node->_M_right = relocate(entry.first->_M_right);
+  }
+  // neighbours that stay, and the header as the parent of the root, still
+  // link to the old nodes
+  auto replace = [](NodeBase* neighbour, NodeBase* old, NodeBase* node) {
+    if (neighbour == nullptr) {
+      return;
+    }
+    if (neighbour->_M_parent == old) neighbour->_M_parent = node;
+    if (neighbour->_M_left == old) neighbour->_M_left = node;
+    if (neighbour->_M_right == old) neighbour->_M_right = node;
+  };
+  for (const auto& entry : moved) {
+    NodeBase* node = entry.second;
+    replace(node->_M_parent, entry.first, node);
+    replace(node->_M_left, entry.first, node);
+    replace(node->_M_right, entry.first, node);
+  }
+  NodeBase* header = const_cast<NodeBase*>(dst.cend()._M_node);
+  header->_M_left = relocate(header->_M_left);
+  header->_M_right = relocate(header->_M_right);
+
+  Alloc src_alloc = src.get_allocator();
+  for (const auto& entry : moved) {
+    NodePtr old = static_cast<NodePtr>(entry.first);
+    Traits::destroy(src_alloc, old->_M_valptr());
+    Traits::deallocate(src_alloc, old, 1);
+  }
+  if (adopt) {
+    dst_memory.AdoptSlabs(src_memory, slab_nodes);
+  }
+}
+
+template <typename Alloc>
+void DropSortedSubtree(Alloc& alloc, std::_Rb_tree_node_base* node) {
+  using Traits = std::allocator_traits<Alloc>;
+  using Node = typename Traits::value_type;
+  while (node != nullptr) {
+    DropSortedSubtree(alloc, node->_M_right);
+    std::_Rb_tree_node_base* left = node->_M_left;
+    Node* full = static_cast<Node*>(node);
+    Traits::destroy(alloc, full->_M_valptr());
+    Traits::deallocate(alloc, full, 1);
+    node = left;
+  }
+}
+
+// build count nodes in order, the left half first so that the allocator
+// hands out its slots in iteration order; leaves on the deepest level are
+// red, which keeps the black height equal on a tree that is not perfect
+template <typename Alloc, typename ForwardIterator>
+std::_Rb_tree_node_base* BuildSortedSubtree(Alloc& alloc, ForwardIterator& it,
+                                            size_t count, size_t depth,
+                                            size_t red_depth) {
+  if (count == 0) {
+    return nullptr;
+  }
+  using Traits = std::allocator_traits<Alloc>;
+  std::_Rb_tree_node_base* left =
+      BuildSortedSubtree(alloc, it, (count - 1) / 2, depth + 1, red_depth);
+  auto node = Traits::allocate(alloc, 1);
+  try {
+    Traits::construct(alloc, node->_M_valptr(), *it);
+  } catch (...) {
+    Traits::deallocate(alloc, node, 1);
+    DropSortedSubtree(alloc, left);
+    throw;
+  }
+  ++it;
+  node->_M_color =
+      depth == red_depth && depth > 0 ? std::_S_red : std::_S_black;
+  node->_M_left = left;
+  node->_M_right = nullptr;
+  if (left != nullptr) left->_M_parent = node;
+  std::_Rb_tree_node_base* right;
+  try {
+    right = BuildSortedSubtree(alloc, it, count - 1 - (count - 1) / 2,
+                               depth + 1, red_depth);
+  } catch (...) {
+    DropSortedSubtree(alloc, node);
+    throw;
+  }
+  node->_M_right = right;
+  if (right != nullptr) right->_M_parent = node;
+  return node;
+}
+
+// an input range can be walked once only, the end hint of insert still
+// appends sorted input without searching
+template <typename Tree, typename InputIterator>
+void BuildSortedTree(Tree& tree, InputIterator first, InputIterator last,
+                     std::input_iterator_tag) {
+  tree.insert(first, last);
+}
+
+// the depth whose nodes are red in a balanced tree of count nodes
+inline size_t SortedTreeRedDepth(size_t count) {
+  size_t red_depth = 0;
+  while ((size_t(2) << red_depth) <= count) ++red_depth;
+  return red_depth;
+}
+
+template <typename Tree>
+void AttachSortedTree(Tree& tree, std::_Rb_tree_node_base* root,
+                      size_t count) {
+  std::_Rb_tree_node_base* header =
+      const_cast<std::_Rb_tree_node_base*>(tree.cend()._M_node);
+  root->_M_parent = header;
+  header->_M_parent = root;
+  header->_M_left = std::_Rb_tree_node_base::_S_minimum(root);
+  header->_M_right = std::_Rb_tree_node_base::_S_maximum(root);
+  reinterpret_cast<std::_Rb_tree_header*>(header)->_M_node_count = count;
+}
+
+template <typename Tree, typename ForwardIterator>
+void BuildSortedTree(Tree& tree, ForwardIterator first, ForwardIterator last,
+                     std::forward_iterator_tag) {
+  size_t count = std::distance(first, last);
+  if (count == 0) {
+    return;
+  }
+  typename Tree::allocator_type alloc = tree.get_allocator();
+  AttachSortedTree(tree,
+                   BuildSortedSubtree(alloc, first, count, 0,
+                                      SortedTreeRedDepth(count)),
+                   count);
+}
+
+// fill an empty tree from a range sorted by its Compare in O(n), no key is
+// compared and no rebalancing happens
+template <typename Tree, typename InputIterator>
+void BuildSortedTree(Tree& tree, InputIterator first, InputIterator last) {
+  assert(tree.empty());
+  BuildSortedTree(
+      tree, first, last,
+      typename std::iterator_traits<InputIterator>::iterator_category());
+}
+
+// the same shape as BuildSortedSubtree over nodes that already exist
+template <typename NodePtr>
+std::_Rb_tree_node_base* LinkSortedSubtree(const NodePtr* nodes, size_t count,
+                                           size_t depth, size_t red_depth) {
+  if (count == 0) {
+    return nullptr;
+  }
+  size_t left_count = (count - 1) / 2;
+  std::_Rb_tree_node_base* node = nodes[left_count];
+  node->_M_color =
+      depth == red_depth && depth > 0 ? std::_S_red : std::_S_black;
+  node->_M_left = LinkSortedSubtree(nodes, left_count, depth + 1, red_depth);
+  node->_M_right = LinkSortedSubtree(nodes + left_count + 1,
+                                     count - 1 - left_count, depth + 1,
+                                     red_depth);
+  if (node->_M_left != nullptr) node->_M_left->_M_parent = node;
+  if (node->_M_right != nullptr) node->_M_right->_M_parent = node;
+  return node;
+}
+
+// rewrite the node layout of a tree so that an in-order walk reads the
+// inline buffer front to back, the tree comes out balanced; invalidates
+// every iterator and reference
+template <typename Tree, typename Memory>
+void CompactFixedTree(Tree& tree, Memory& memory) {
+  using NodePtr = typename Tree::allocator_type::pointer;
+  std::vector<NodePtr> nodes;
+  nodes.reserve(tree.size());
+  for (auto it = tree.cbegin(); it != tree.cend(); ++it) {
+    nodes.push_back(static_cast<NodePtr>(
+        const_cast<std::_Rb_tree_node_base*>(it._M_node)));
+  }
+  if (nodes.empty()) {
+    return;
+  }
+  memory.Compact(nodes.data(), nodes.size());
+  AttachSortedTree(tree,
+                   LinkSortedSubtree(nodes.data(), nodes.size(), 0,
+                                     SortedTreeRedDepth(nodes.size())),
+                   nodes.size());
+}
+
+template <typename T, size_t Capacity, bool SlabOverflow>
+inline bool operator==(const StackAllocator<T, Capacity, SlabOverflow>& lhs,
+                       const StackAllocator<T, Capacity, SlabOverflow>& rhs) {
+  return lhs.reserved_memory_ == rhs.reserved_memory_;
+}
+
+template <typename T, size_t Capacity, bool SlabOverflow>
+inline bool operator!=(const StackAllocator<T, Capacity, SlabOverflow>& lhs,
+                       const StackAllocator<T, Capacity, SlabOverflow>& rhs) {
+  return !(lhs == rhs);
 }
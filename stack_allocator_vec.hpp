@@ -3,6 +3,7 @@
 #include <type_traits>
 #include <cassert>
 #include "utils.hpp"
+#include "alloc_trace.hpp"
 
 template <typename T, size_t Capacity>
 class StackAllocatorVector : public std::allocator<T> {
@@ -10,6 +11,16 @@ class StackAllocatorVector : public std::allocator<T> {
   using pointer = typename std::allocator<T>::pointer;
   using size_type = typename std::allocator<T>::size_type;
 
+  // equal only when sharing the inline buffer, see StackAllocator
+  using propagate_on_container_copy_assignment = std::false_type;
+  using propagate_on_container_move_assignment = std::false_type;
+  using propagate_on_container_swap = std::false_type;
+  using is_always_equal = std::false_type;
+
+  template <typename U, size_t Cap>
+  friend bool operator==(const StackAllocatorVector<U, Cap>& lhs,
+                         const StackAllocatorVector<U, Cap>& rhs);
+
   struct ReservedMemory {
     using AlignedStorage =
         typename std::aligned_storage<sizeof(T), alignof(T)>::type;
@@ -38,9 +49,11 @@ class StackAllocatorVector : public std::allocator<T> {
   pointer allocate(size_type n, void* hint = 0) {
     if (reserved_memory_ != nullptr && !reserved_memory_->in_use_ &&
         n <= Capacity) {
+      TraceAllocate(n, true);
       reserved_memory_->in_use_ = true;
       return reserved_memory_->Data();
     }
+    TraceAllocate(n, false);
     return std::allocator<T>::allocate(n, hint);
   }
 
@@ -57,11 +70,33 @@ class StackAllocatorVector : public std::allocator<T> {
   }
 
  private:
+#if defined(EXT_STL_ALLOC_TRACE)
+  void TraceAllocate(size_type n, bool in_buffer) {
+    AllocTraceCounters* counters = AllocTraceFor<T, Capacity>();
+    if (in_buffer) {
+      counters->inline_hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      counters->heap_fallbacks.fetch_add(1, std::memory_order_relaxed);
+      counters->bytes_spilled.fetch_add(n * sizeof(T),
+                                        std::memory_order_relaxed);
+    }
+    counters->RecordPeak(n);
+  }
+#else
+  void TraceAllocate(size_type, bool) {}
+#endif
+
   ReservedMemory* reserved_memory_ = nullptr;
 };
 
 template <typename T, size_t Capacity>
 inline bool operator==(const StackAllocatorVector<T, Capacity>& lhs,
                        const StackAllocatorVector<T, Capacity>& rhs) {
-  return false;
+  return lhs.reserved_memory_ == rhs.reserved_memory_;
+}
+
+template <typename T, size_t Capacity>
+inline bool operator!=(const StackAllocatorVector<T, Capacity>& lhs,
+                       const StackAllocatorVector<T, Capacity>& rhs) {
+  return !(lhs == rhs);
 }
@@ -0,0 +1,79 @@
+#define EXT_STL_ALLOC_TRACE
+#include "fixed_map.hpp"
+#include "fixed_vector.hpp"
+
+#include <sstream>
+#include "gtest/gtest.h"
+
+const AllocTraceCounters* FindSite(const char* site) {
+  const AllocTraceCounters* found = nullptr;
+  AllocTraceRegistry::Instance().ForEach([&](const AllocTraceCounters& c) {
+    if (c.site != nullptr && std::strcmp(c.site, site) == 0) found = &c;
+  });
+  return found;
+}
+
+TEST(AllocTrace, node_allocator) {
+  const int kMax = 8;
+  using Node = __std_tree_node_t<std::pair<const int, int>>;
+  {
+    AllocTraceSite site("map");
+    FixedMap<int, int, kMax> fmap;
+    for (int i = 0; i < kMax; ++i) fmap[i] = i;
+    for (int i = kMax; i < kMax + 4; ++i) fmap[i] = i;
+    fmap.erase(0);
+    fmap.erase(kMax);
+    fmap[0] = 0;
+    fmap[kMax] = kMax;
+  }
+
+  const AllocTraceCounters* counters = FindSite("map");
+  ASSERT_TRUE(counters != nullptr);
+  EXPECT_EQ(counters->capacity, kMax);
+  EXPECT_EQ(counters->inline_hits, kMax + 1);
+  EXPECT_EQ(counters->heap_fallbacks, 5);
+  EXPECT_EQ(counters->free_list_reuse, 2);
+  EXPECT_EQ(counters->peak_live, kMax + 4);
+  // one slab of Capacity nodes plus its link slot
+  EXPECT_EQ(counters->bytes_spilled, (kMax + 1) * sizeof(Node));
+
+  std::ostringstream os;
+  AllocTraceRegistry::Instance().Dump(os);
+  EXPECT_NE(os.str().find("map"), std::string::npos);
+}
+
+TEST(AllocTrace, vector_allocator) {
+  const int kMax = 16;
+  {
+    AllocTraceSite site("vector");
+    FixedVector<int, kMax> fvec;
+    for (int i = 0; i < kMax; ++i) fvec.push_back(i);
+    fvec.push_back(kMax);
+  }
+
+  const AllocTraceCounters* counters = FindSite("vector");
+  ASSERT_TRUE(counters != nullptr);
+  EXPECT_EQ(counters->inline_hits, 1);
+  EXPECT_EQ(counters->heap_fallbacks, 1);
+  EXPECT_EQ(counters->bytes_spilled, 2 * kMax * sizeof(int));
+  EXPECT_EQ(counters->peak_live, 2 * kMax);
+}
+
+TEST(AllocTrace, sites) {
+  {
+    AllocTraceSite outer("outer");
+    FixedMap<int, int, 4> fmap;
+    fmap[0] = 0;
+    {
+      AllocTraceSite inner("inner");
+      fmap[1] = 1;
+    }
+    fmap[2] = 2;
+  }
+  EXPECT_EQ(FindSite("outer")->inline_hits, 2);
+  EXPECT_EQ(FindSite("inner")->inline_hits, 1);
+  EXPECT_EQ(AllocTraceSite::Current(), nullptr);
+
+  AllocTraceRegistry::Instance().Reset();
+  EXPECT_EQ(FindSite("outer")->inline_hits, 0);
+}
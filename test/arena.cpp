@@ -0,0 +1,111 @@
+#include "arena.hpp"
+#include "fixed_map.hpp"
+#include "fixed_set.hpp"
+#include "fixed_list.hpp"
+#include "fixed_forward_list.hpp"
+
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include "gtest/gtest.h"
+
+TEST(Arena, allocate) {
+  Arena arena(256);
+  EXPECT_EQ(arena.used(), 0);
+  void* first = arena.Allocate(10, 1);
+  void* second = arena.Allocate(8, 8);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 8, 0);
+  EXPECT_GT(second, first);
+  // larger than a block gets a block of its own
+  char* big = static_cast<char*>(arena.Allocate(1000, 16));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(big) % 16, 0);
+  big[999] = 1;
+  EXPECT_EQ(arena.used(), 1018);
+
+  arena.Reset();
+  EXPECT_EQ(arena.used(), 0);
+  void* again = arena.Allocate(10, 1);
+  EXPECT_EQ(again, first);
+}
+
+TEST(Arena, recycle) {
+  Arena arena(256);
+  void* first = arena.Allocate(64, 8);
+  void* second = arena.Allocate(32, 8);
+  arena.Recycle(first, 64, 8);
+  arena.Recycle(second, 32, 8);
+  // only the same size and alignment gets a recycled block
+  void* other = arena.Allocate(64, 16);
+  EXPECT_NE(other, first);
+  EXPECT_EQ(arena.Allocate(64, 8), first);
+  EXPECT_EQ(arena.Allocate(32, 8), second);
+  EXPECT_NE(arena.Allocate(64, 8), first);
+}
+
+TEST(Arena, scope) {
+  Arena request;
+  Arena nested;
+  EXPECT_EQ(&Arena::Current(), &Arena::ThisThread());
+  {
+    ArenaScope scope(request);
+    EXPECT_EQ(&Arena::Current(), &request);
+    {
+      ArenaScope inner(nested);
+      EXPECT_EQ(&Arena::Current(), &nested);
+    }
+    EXPECT_EQ(&Arena::Current(), &request);
+  }
+  EXPECT_EQ(&Arena::Current(), &Arena::ThisThread());
+
+  Arena* other_thread = nullptr;
+  std::thread([&other_thread]() { other_thread = &Arena::Current(); }).join();
+  EXPECT_NE(other_thread, &Arena::ThisThread());
+}
+
+TEST(Arena, containers) {
+  Arena request(4096);
+  ArenaScope scope(request);
+  {
+    FixedMap<int, std::string, 4, std::less<int>, ArenaSlabs> fmap;
+    for (int i = 0; i < 4; ++i) fmap[i] = std::to_string(i);
+    EXPECT_EQ(request.used(), 0);
+    for (int i = 4; i < 40; ++i) fmap[i] = std::to_string(i);
+    EXPECT_GT(request.used(), 0);
+    size_t used = request.used();
+    // freed slab nodes are reused before the arena is asked again
+    for (int i = 4; i < 40; ++i) fmap.erase(i);
+    for (int i = 100; i < 136; ++i) fmap[i] = std::to_string(i);
+    EXPECT_EQ(request.used(), used);
+
+    FixedMap<int, std::string, 4, std::less<int>, ArenaSlabs> other;
+    other[-1] = "minus";
+    other.swap(fmap);
+    EXPECT_EQ(other.size(), 40);
+    EXPECT_EQ(other[120], "120");
+    EXPECT_EQ(fmap[-1], "minus");
+    other.compact();
+    EXPECT_EQ(other.begin()->second, "0");
+
+    FixedSet<int, 2, std::less<int>, ArenaSlabs> fset{5, 4, 3, 2, 1};
+    EXPECT_EQ(*fset.begin(), 1);
+    FixedMultiSet<int, 2, std::less<int>, ArenaSlabs> mset{1, 1, 1};
+    EXPECT_EQ(mset.count(1), 3);
+    FixedMultiMap<int, int, 2, std::less<int>, ArenaSlabs> mmap{
+        {1, 1}, {1, 2}, {1, 3}};
+    EXPECT_EQ(mmap.count(1), 3);
+    FixedList<int, 2, ArenaSlabs> flist{1, 2, 3, 4};
+    EXPECT_EQ(flist.back(), 4);
+    FixedForwardList<int, 2, ArenaSlabs> fflist{1, 2, 3, 4};
+    EXPECT_EQ(fflist.front(), 1);
+  }
+  // the slabs of dead containers go to the next ones of the same type
+  size_t used = request.used();
+  {
+    FixedMap<int, std::string, 4, std::less<int>, ArenaSlabs> fmap;
+    for (int i = 0; i < 40; ++i) fmap[i] = std::to_string(i);
+  }
+  EXPECT_EQ(request.used(), used);
+  request.Reset();
+  EXPECT_EQ(request.used(), 0);
+}
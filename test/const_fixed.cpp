@@ -0,0 +1,131 @@
+#include "const_fixed.hpp"
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "gtest/gtest.h"
+
+constexpr int kPrimes[] = {2, 3, 5, 7, 11, 13};
+constexpr ConstFixedVector<int, 8> kPrimeVector(kPrimes);
+
+static_assert(kPrimeVector.size() == 6, "");
+static_assert(kPrimeVector[2] == 5 && kPrimeVector.back() == 13, "");
+static_assert(kPrimeVector.at(5) == 13, "");
+
+struct Square {
+  constexpr int operator()(size_t i) const { return int(i * i); }
+};
+
+TEST(ConstFixedVector, general) {
+  constexpr ConstFixedVector<int, 4> empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.begin(), empty.end());
+  EXPECT_EQ(empty.capacity(), 4);
+
+  EXPECT_EQ(std::vector<int>(kPrimeVector.begin(), kPrimeVector.end()),
+            std::vector<int>(kPrimes, kPrimes + 6));
+  EXPECT_EQ(std::vector<int>(kPrimeVector.rbegin(), kPrimeVector.rend()),
+            (std::vector<int>{13, 11, 7, 5, 3, 2}));
+  EXPECT_EQ(kPrimeVector.front(), 2);
+  EXPECT_THROW(kPrimeVector.at(6), std::out_of_range);
+
+  constexpr auto squares = ConstFixedVector<int, 100>::Generate<100>(Square());
+  static_assert(squares.size() == 100 && squares[99] == 99 * 99, "");
+  for (size_t i = 0; i < squares.size(); ++i) EXPECT_EQ(squares[i], i * i);
+}
+
+using Name = ConstFixedString<15>;
+
+constexpr Name kApple("apple");
+static_assert(kApple.size() == 5 && kApple[1] == 'p', "");
+static_assert(kApple == Name("apple") && kApple != Name("apples"), "");
+static_assert(Name("apple") < Name("apples"), "");
+static_assert(Name("apple") < ConstFixedString<4>("b"), "");
+static_assert(!(Name("b") < Name("apple")), "");
+static_assert(Name("").empty() && Name("") < kApple, "");
+
+TEST(ConstFixedString, general) {
+  EXPECT_STREQ(kApple.c_str(), "apple");
+  EXPECT_EQ(std::string(kApple.begin(), kApple.end()), "apple");
+  EXPECT_EQ(kApple.compare(Name("apricot")), -1);
+  EXPECT_EQ(Name("apricot").compare(kApple), 1);
+  EXPECT_EQ(kApple.compare(kApple), 0);
+  // bytes compare unsigned, like std::char_traits<char>
+  EXPECT_LT(Name("a").compare(Name("\xe9")), 0);
+
+  constexpr ConstFixedString<64> longer(
+      "a string long enough to split its comparison a few times over");
+  static_assert(longer.compare(longer) == 0, "");
+  static_assert(longer != ConstFixedString<64>(
+      "a string long enough to split its comparison a few times ovex"), "");
+}
+
+using NameMap = ConstFixedFlatMap<Name, int, 8>;
+
+constexpr NameMap::value_type kFruitEntries[] = {
+    {"apple", 1}, {"banana", 2}, {"cherry", 3}, {"date", 4}, {"fig", 5}};
+constexpr NameMap kFruits(sorted_unique, kFruitEntries);
+
+static_assert(kFruits.size() == 5, "");
+static_assert(kFruits.at("cherry") == 3, "");
+static_assert(kFruits.contains("fig") && !kFruits.contains("grape"), "");
+static_assert(kFruits.find("apricot") == kFruits.end(), "");
+static_assert(kFruits.lower_bound("apricot")->second == 2, "");
+
+TEST(ConstFixedFlatMap, lookup) {
+  for (const auto& entry : kFruitEntries) {
+    EXPECT_EQ(kFruits.at(entry.first), entry.second);
+    EXPECT_EQ(kFruits.find(entry.first)->first, entry.first);
+    EXPECT_EQ(kFruits.count(entry.first), 1);
+  }
+  size_t i = 0;
+  for (auto entry : kFruits) {
+    EXPECT_EQ(entry.first, kFruitEntries[i].first);
+    EXPECT_EQ(entry.second, kFruitEntries[i].second);
+    ++i;
+  }
+  EXPECT_EQ(i, 5);
+  EXPECT_EQ(kFruits.keys().back(), Name("fig"));
+  EXPECT_EQ(kFruits.values()[1], 2);
+  EXPECT_EQ(kFruits.count("kiwi"), 0);
+  EXPECT_EQ(kFruits.lower_bound("zucchini"), kFruits.end());
+  EXPECT_EQ(kFruits.lower_bound(""), kFruits.begin());
+  EXPECT_THROW(kFruits.at("kiwi"), std::out_of_range);
+
+  constexpr ConstFixedFlatMap<int, int, 4> empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.find(1), empty.end());
+}
+
+struct Doubled {
+  constexpr std::pair<int, int> operator()(size_t i) const {
+    return std::pair<int, int>(int(2 * i), int(i));
+  }
+};
+
+TEST(ConstFixedFlatMap, generate) {
+  constexpr auto evens =
+      ConstFixedFlatMap<int, int, 1000>::Generate<1000>(sorted_unique,
+                                                        Doubled());
+  static_assert(evens.at(1998) == 999, "");
+  for (int key = -1; key <= 2000; ++key) {
+    auto it = evens.find(key);
+    if (key >= 0 && key < 2000 && key % 2 == 0) {
+      ASSERT_NE(it, evens.end());
+      EXPECT_EQ(it->second, key / 2);
+    } else {
+      EXPECT_EQ(it, evens.end());
+    }
+  }
+}
+
+TEST(ConstFixedFlatMap, unsorted_entries) {
+  // a constexpr map would not compile, at run time the constructor throws
+  std::pair<int, int> unsorted[] = {{1, 1}, {3, 3}, {2, 2}};
+  std::pair<int, int> repeated[] = {{1, 1}, {2, 2}, {2, 2}};
+  using Map = ConstFixedFlatMap<int, int, 4>;
+  EXPECT_THROW(Map(sorted_unique, unsorted), std::invalid_argument);
+  EXPECT_THROW(Map(sorted_unique, repeated), std::invalid_argument);
+  std::pair<int, int> sorted[] = {{1, 1}, {2, 2}, {3, 3}};
+  EXPECT_EQ(Map(sorted_unique, sorted).at(3), 3);
+}
@@ -0,0 +1,251 @@
+#include "fixed_deque.hpp"
+
+#include <deque>
+#include <vector>
+#include <numeric>
+#include <string>
+#include <cstdlib>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include "gtest/gtest.h"
+
+static constexpr size_t kMax = 8;
+
+TEST(FixedDeque, general) {
+  FixedDeque<int, kMax> deque;
+  EXPECT_TRUE(deque.empty());
+  EXPECT_EQ(deque.capacity(), kMax);
+  EXPECT_EQ((FixedDeque<int, 5>::kInlineCapacity), 8);
+
+  deque.push_back(1);
+  deque.push_front(0);
+  deque.emplace_back(2);
+  EXPECT_EQ(deque.size(), 3);
+  EXPECT_EQ(deque.front(), 0);
+  EXPECT_EQ(deque.back(), 2);
+  EXPECT_EQ(deque[1], 1);
+  EXPECT_EQ(deque.at(2), 2);
+  EXPECT_THROW(deque.at(3), std::out_of_range);
+  EXPECT_EQ(deque.end() - deque.begin(), 3);
+  EXPECT_TRUE(std::is_sorted(deque.begin(), deque.end()));
+
+  deque.pop_front();
+  deque.pop_back();
+  EXPECT_TRUE((deque == FixedDeque<int, kMax>{1}));
+}
+
+TEST(FixedDeque, wrap_and_grow) {
+  FixedDeque<size_t, kMax> deque;
+  std::deque<size_t> expect;
+  // walk the head around the inline ring a few times
+  for (size_t i = 0; i < kMax * 5; ++i) {
+    deque.push_back(i);
+    expect.push_back(i);
+    if (deque.size() > kMax / 2) {
+      deque.pop_front();
+      expect.pop_front();
+    }
+  }
+  EXPECT_TRUE(deque.use_stack_memory());
+  EXPECT_TRUE(std::equal(deque.begin(), deque.end(), expect.begin()));
+
+  for (size_t i = 0; i < kMax * 3; ++i) {
+    deque.push_front(i);
+    expect.push_front(i);
+  }
+  EXPECT_FALSE(deque.use_stack_memory());
+  EXPECT_EQ(deque.capacity(), kMax * 4);
+  EXPECT_TRUE(std::equal(deque.begin(), deque.end(), expect.begin()));
+  EXPECT_TRUE(std::equal(deque.rbegin(), deque.rend(), expect.rbegin()));
+
+  while (deque.size() > kMax / 2) {
+    deque.pop_back();
+    expect.pop_back();
+  }
+  deque.shrink_to_fit();
+  EXPECT_TRUE(deque.use_stack_memory());
+  EXPECT_TRUE(std::equal(deque.begin(), deque.end(), expect.begin()));
+}
+
+TEST(FixedDeque, grow_with_self_reference) {
+  FixedDeque<std::string, 2> deque{"front", "back"};
+  deque.push_back(deque.front());
+  deque.push_front(deque.back());
+  EXPECT_TRUE((deque == FixedDeque<std::string, 2>{"front", "front", "back",
+                                                   "front"}));
+}
+
+TEST(FixedDeque, insert_erase_random) {
+  FixedDeque<int, kMax> deque;
+  std::deque<int> expect;
+  srand(7);
+  for (int i = 0; i < 3000; ++i) {
+    size_t at = rand() % (expect.size() + 1);
+    int op = rand() % 4;
+    if (op == 0 && at < expect.size()) {
+      size_t n = std::min<size_t>(rand() % 4, expect.size() - at);
+      auto ret = deque.erase(deque.begin() + at, deque.begin() + at + n);
+      expect.erase(expect.begin() + at, expect.begin() + at + n);
+      EXPECT_EQ(ret - deque.begin(), at);
+    } else if (op == 1) {
+      auto ret = deque.insert(deque.begin() + at, 3, i);
+      expect.insert(expect.begin() + at, 3, i);
+      EXPECT_EQ(ret - deque.begin(), at);
+    } else {
+      auto ret = deque.insert(deque.begin() + at, i);
+      expect.insert(expect.begin() + at, i);
+      EXPECT_EQ(*ret, i);
+    }
+    if (expect.size() > 200) {
+      deque.pop_front(100);
+      expect.erase(expect.begin(), expect.begin() + 100);
+    }
+  }
+  EXPECT_EQ(deque.size(), expect.size());
+  EXPECT_TRUE(std::equal(deque.begin(), deque.end(), expect.begin()));
+}
+
+TEST(FixedDeque, strings) {
+  FixedDeque<std::string, 4> deque;
+  std::deque<std::string> expect;
+  for (int i = 0; i < 40; ++i) {
+    std::string value = std::to_string(i) + std::string(i % 3 * 20, 'x');
+    if (i % 3 == 0) {
+      deque.push_front(value);
+      expect.push_front(value);
+    } else {
+      deque.insert(deque.begin() + deque.size() / 3, value);
+      expect.insert(expect.begin() + expect.size() / 3, value);
+    }
+  }
+  deque.erase(deque.begin() + 5, deque.begin() + 12);
+  expect.erase(expect.begin() + 5, expect.begin() + 12);
+  EXPECT_TRUE(std::equal(deque.begin(), deque.end(), expect.begin()));
+
+  std::vector<std::string> out(10);
+  deque.pop_front(10, out.begin());
+  EXPECT_TRUE(std::equal(out.begin(), out.end(), expect.begin()));
+  expect.erase(expect.begin(), expect.begin() + 10);
+  EXPECT_TRUE(std::equal(deque.begin(), deque.end(), expect.begin()));
+
+  deque.resize(4);
+  deque.resize(6, "z");
+  EXPECT_EQ(deque.size(), 6);
+  EXPECT_EQ(deque.back(), "z");
+  EXPECT_EQ(deque[3], expect[3]);
+}
+
+TEST(FixedDeque, bulk) {
+  FixedDeque<int, 16> deque;
+  std::vector<int> vec(40);
+  std::iota(vec.begin(), vec.end(), 0);
+
+  // straddle the end of the ring, then grow
+  deque.push_back(vec.data(), vec.data() + 12);
+  deque.pop_front(10);
+  deque.push_back(vec.data() + 12, vec.data() + 24);
+  EXPECT_TRUE(deque.use_stack_memory());
+  EXPECT_TRUE(std::equal(deque.begin(), deque.end(), vec.begin() + 10));
+  deque.push_back(vec.begin() + 24, vec.end());
+  EXPECT_FALSE(deque.use_stack_memory());
+  EXPECT_TRUE(std::equal(deque.begin(), deque.end(), vec.begin() + 10));
+
+  int out[30];
+  int* last = deque.pop_front(30, out);
+  EXPECT_EQ(last, out + 30);
+  EXPECT_TRUE(std::equal(out, out + 30, vec.begin() + 10));
+  EXPECT_TRUE(deque.empty());
+
+  std::deque<long> longs;
+  deque.push_back(vec.data(), vec.data() + 3);
+  deque.pop_front(3, std::back_inserter(longs));
+  EXPECT_EQ(longs.size(), 3);
+  EXPECT_EQ(longs.back(), 2);
+}
+
+struct ThrowOnCopy {
+  static int budget;
+  std::string value;
+  ThrowOnCopy(const std::string& v) : value(v) {}
+  ThrowOnCopy(const ThrowOnCopy& other) : value(other.value) {
+    if (--budget < 0) throw std::runtime_error("copy");
+  }
+  ThrowOnCopy(ThrowOnCopy&&) noexcept = default;
+};
+int ThrowOnCopy::budget = 0;
+
+TEST(FixedDeque, insert_throw) {
+  // a copy that throws leaves the deque as it was, whichever side of the
+  // gap moved to open it
+  std::vector<ThrowOnCopy> values;
+  for (int i = 0; i < 3; ++i) {
+    values.emplace_back("new " + std::to_string(i) + std::string(20, '.'));
+  }
+  for (size_t at : {size_t(1), size_t(5)}) {
+    FixedDeque<ThrowOnCopy, 8> deque;
+    for (int i = 0; i < 6; ++i) {
+      deque.emplace_back("old " + std::to_string(i) + std::string(20, '.'));
+    }
+    ThrowOnCopy::budget = 1;
+    EXPECT_THROW(deque.insert(deque.begin() + at, values.begin(),
+                              values.end()),
+                 std::runtime_error);
+    ThrowOnCopy::budget = 2;
+    EXPECT_THROW(deque.insert(deque.begin() + at, 4, values[0]),
+                 std::runtime_error);
+    ThrowOnCopy::budget = 0;
+    EXPECT_THROW(deque.insert(deque.begin() + at, values[1]),
+                 std::runtime_error);
+    ASSERT_EQ(deque.size(), 6);
+    for (int i = 0; i < 6; ++i) {
+      EXPECT_EQ(deque[i].value,
+                "old " + std::to_string(i) + std::string(20, '.'));
+    }
+    ThrowOnCopy::budget = 3;
+    deque.insert(deque.begin() + at, values.begin(), values.end());
+    EXPECT_EQ(deque.size(), 9);
+    EXPECT_EQ(deque[at + 2].value, values[2].value);
+  }
+}
+
+TEST(FixedDeque, move_swap) {
+  FixedDeque<std::string, 4> inline_strs(3, "inline");
+  FixedDeque<std::string, 4> heap_strs(20, "heap");
+  heap_strs.pop_front();
+  heap_strs.push_back("last");
+
+  FixedDeque<std::string, 4> moved(std::move(heap_strs));
+  EXPECT_TRUE(heap_strs.empty());
+  EXPECT_TRUE(heap_strs.use_stack_memory());
+  EXPECT_EQ(moved.back(), "last");
+
+  inline_strs.pop_front();
+  inline_strs.push_back("wrapped");
+  FixedDeque<std::string, 4> moved2(std::move(inline_strs));
+  EXPECT_TRUE(inline_strs.empty());
+  EXPECT_TRUE((moved2 == FixedDeque<std::string, 4>{"inline", "inline",
+                                                    "wrapped"}));
+
+  swap(moved, moved2);
+  EXPECT_EQ(moved.size(), 3);
+  EXPECT_EQ(moved2.size(), 20);
+  EXPECT_EQ(moved2.back(), "last");
+  moved2.swap(heap_strs);
+  EXPECT_TRUE(moved2.empty());
+  EXPECT_EQ(heap_strs.size(), 20);
+
+  FixedDeque<std::string, 4> copy;
+  copy = moved;
+  EXPECT_TRUE(copy == moved);
+  copy = {"a"};
+  EXPECT_TRUE(copy < moved);
+}
+
+TEST(FixedDeque, ring_buffer_name) {
+  FixedRingBuffer<int, 4> ring{1, 2, 3};
+  ring.pop_front();
+  ring.push_back(4);
+  EXPECT_EQ(ring.front(), 2);
+  EXPECT_EQ(ring.back(), 4);
+}
@@ -0,0 +1,77 @@
+#include "fixed_flat_map.hpp"
+
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include "gtest/gtest.h"
+
+static constexpr size_t kMax = 16;
+using MapType = FixedFlatMap<size_t, std::string, kMax>;
+
+TEST(FixedFlatMap, ctor_dtor) {
+  std::map<size_t, std::string> smap = {{3, "c"}, {1, "a"}, {2, "b"}};
+  MapType fmap(std::begin(smap), std::end(smap));
+  MapType fmap1(sorted_unique, std::begin(smap), std::end(smap));
+  MapType fmap2 = {{2, "b"}, {1, "a"}, {3, "c"}, {1, "x"}};
+  MapType fmap3(fmap2);
+
+  EXPECT_TRUE(fmap == fmap1);
+  EXPECT_TRUE(fmap == fmap2);
+  EXPECT_TRUE(fmap == fmap3);
+  EXPECT_EQ(fmap2.at(1), "a");
+
+  FixedFlatMap<size_t, size_t, kMax, std::greater<size_t>> fmap4(
+      {{1, 1}, {2, 2}});
+  EXPECT_EQ(fmap4.begin()->first, 2);
+}
+
+TEST(FixedFlatMap, lookup) {
+  MapType fmap;
+  for (size_t i = 0; i < kMax * 4; i += 2) fmap[i] = std::to_string(i);
+  EXPECT_EQ(fmap.size(), kMax * 2);
+
+  EXPECT_EQ(fmap.find(4)->second, "4");
+  EXPECT_TRUE(fmap.find(5) == fmap.end());
+  EXPECT_EQ(fmap.count(6), 1);
+  EXPECT_EQ(fmap.count(7), 0);
+  EXPECT_EQ(fmap.lower_bound(7)->first, 8);
+  EXPECT_EQ(fmap.upper_bound(8)->first, 10);
+  EXPECT_THROW(fmap.at(7), std::out_of_range);
+
+  const MapType& cmap = fmap;
+  EXPECT_EQ(cmap.find(10)->second, "10");
+  EXPECT_TRUE(std::is_sorted(cmap.keys().begin(), cmap.keys().end()));
+  EXPECT_EQ(std::distance(cmap.begin(), cmap.end()), kMax * 2);
+}
+
+TEST(FixedFlatMap, modifiers) {
+  MapType fmap = {{1, "a"}, {3, "c"}, {5, "e"}};
+  auto result = fmap.insert(std::make_pair(2ul, std::string("b")));
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(result.first->second, "b");
+  result = fmap.insert(std::make_pair(2ul, std::string("x")));
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(result.first->second, "b");
+  fmap.emplace(4, "d");
+
+  std::vector<std::pair<size_t, std::string>> sorted = {
+      {0, "0"}, {3, "x"}, {6, "f"}, {7, "g"}};
+  fmap.insert(sorted_unique, sorted.begin(), sorted.end());
+  EXPECT_EQ(fmap.size(), 8);
+  std::string joined;
+  for (auto kv : fmap) joined += kv.second;
+  EXPECT_EQ(joined, "0abcdefg");
+
+  EXPECT_EQ(fmap.erase(3), 1);
+  EXPECT_EQ(fmap.erase(3), 0);
+  fmap.erase(fmap.begin(), fmap.begin() + 2);
+  EXPECT_EQ(fmap.begin()->first, 2);
+  EXPECT_EQ(fmap.size(), 5);
+
+  MapType fmap2;
+  fmap2.swap(fmap);
+  EXPECT_TRUE(fmap.empty());
+  EXPECT_EQ(fmap2.rbegin()->second, "g");
+}
@@ -0,0 +1,55 @@
+#include "fixed_flat_set.hpp"
+
+#include <set>
+#include <vector>
+#include <memory>
+#include <numeric>
+#include <algorithm>
+#include "gtest/gtest.h"
+
+static constexpr size_t kMax = 16;
+static std::vector<int> vec(kMax * 2);
+
+TEST(FixedFlatSet, ctor_dtor) {
+  std::iota(std::begin(vec), std::end(vec), 0);
+
+  FixedFlatSet<int, kMax> fset;
+  FixedFlatSet<int, kMax> fset1(vec.rbegin(), vec.rend());
+  FixedFlatSet<int, kMax> fset2(sorted_unique, std::begin(vec), std::end(vec));
+  FixedFlatSet<int, kMax> fset3 = {2, 1, 2, 0};
+  FixedFlatSet<int, kMax> fset4(fset1);
+
+  EXPECT_TRUE(fset.empty());
+  EXPECT_TRUE(fset1 == fset2);
+  EXPECT_TRUE(fset1 == fset4);
+  EXPECT_TRUE(std::equal(std::begin(fset1), std::end(fset1), std::begin(vec)));
+  EXPECT_EQ(fset3.size(), 3);
+  EXPECT_TRUE(fset3 < fset1 || fset1 < fset3);
+
+  FixedFlatSet<int, kMax, std::greater<int>> fset5(std::begin(vec),
+                                                   std::end(vec));
+  EXPECT_EQ(*fset5.begin(), kMax * 2 - 1);
+}
+
+TEST(FixedFlatSet, modifiers) {
+  FixedFlatSet<int, kMax> fset = {10, 20, 30};
+  EXPECT_TRUE(fset.insert(15).second);
+  EXPECT_FALSE(fset.insert(15).second);
+  EXPECT_EQ(*fset.find(15), 15);
+  EXPECT_TRUE(fset.find(16) == fset.end());
+
+  std::set<int> sorted = {5, 10, 25, 35};
+  fset.insert(sorted_unique, sorted.begin(), sorted.end());
+  std::vector<int> expect = {5, 10, 15, 20, 25, 30, 35};
+  EXPECT_TRUE(std::equal(expect.begin(), expect.end(), fset.begin()));
+  EXPECT_EQ(fset.size(), expect.size());
+
+  fset.insert({40, 1, 40});
+  EXPECT_EQ(*fset.begin(), 1);
+  EXPECT_EQ(*fset.rbegin(), 40);
+
+  EXPECT_EQ(fset.erase(20), 1);
+  EXPECT_EQ(fset.count(20), 0);
+  EXPECT_EQ(*fset.lower_bound(20), 25);
+  EXPECT_EQ(*fset.upper_bound(25), 30);
+}
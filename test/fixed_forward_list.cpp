@@ -2,10 +2,13 @@
 
 #include <vector>
 #include <list>
+#include <string>
 #include <memory>
 #include <iostream>
 #include <algorithm>
 #include <cstdlib>
+#include <stdexcept>
+#include <functional>
 #include "gtest/gtest.h"
 
 static constexpr size_t kMax = 100;
@@ -111,3 +114,263 @@ TEST(FixedForwardList, global_operator) {
   EXPECT_TRUE(flist < flist3);
   EXPECT_TRUE(flist != flist3);
 }
+
+TEST(FixedForwardList, swap) {
+  const int kSmall = 8;
+  FixedForwardList<int, kSmall> lhs;
+  FixedForwardList<int, kSmall> rhs;
+  for (int i = 0; i < kSmall * 3; ++i) lhs.push_front(i);
+  lhs.remove_if([](int i) { return i % 3 == 0; });
+  rhs.push_front(-1);
+
+  swap(lhs, rhs);
+  EXPECT_TRUE((lhs == FixedForwardList<int, kSmall>({-1})));
+  EXPECT_EQ(std::distance(rhs.begin(), rhs.end()), kSmall * 2);
+  EXPECT_EQ(rhs.front(), kSmall * 3 - 1);
+
+  for (int i = 0; i < kSmall * 2; ++i) lhs.push_front(i);
+  rhs.remove_if([](int i) { return i % 2 == 0; });
+  rhs.push_front(1000);
+  EXPECT_EQ(std::distance(lhs.begin(), lhs.end()), kSmall * 2 + 1);
+  EXPECT_EQ(rhs.front(), 1000);
+
+  lhs.swap(rhs);
+  EXPECT_EQ(lhs.front(), 1000);
+  EXPECT_EQ(rhs.front(), kSmall * 2 - 1);
+}
+
+TEST(FixedForwardList, swap_strings) {
+  FixedForwardList<std::string, 4> lhs{"a", "b", "c", "d", "e"};
+  FixedForwardList<std::string, 4> rhs{"short"};
+  lhs.pop_front();
+  swap(lhs, rhs);
+  EXPECT_EQ(lhs.front(), "short");
+  EXPECT_TRUE((rhs == FixedForwardList<std::string, 4>{"b", "c", "d", "e"}));
+}
+
+TEST(FixedForwardList, compact) {
+  FixedForwardList<int, 8> flist;
+  for (int i = 0; i < 12; ++i) flist.push_front(i);
+  flist.remove_if([](int v) { return v % 3 == 0; });
+  flist.compact();
+  EXPECT_TRUE((flist == FixedForwardList<int, 8>{11, 10, 8, 7, 5, 4, 2, 1}));
+  for (auto it = flist.begin(); std::next(it) != flist.end(); ++it) {
+    EXPECT_EQ(reinterpret_cast<const char*>(&*std::next(it)) -
+                  reinterpret_cast<const char*>(&*it),
+              sizeof(std::_Fwd_list_node<int>));
+  }
+  flist.push_front(100);
+  EXPECT_EQ(flist.front(), 100);
+}
+
+TEST(FixedForwardList, compact_partly_used_buffer) {
+  // after the merge lhs holds slab nodes while one of its inline slots was
+  // freed and five were never handed out
+  FixedForwardList<int, 8> lhs{1, 3, 5};
+  lhs.pop_front();
+  FixedForwardList<int, 8> rhs;
+  for (int i = 19; i >= 0; --i) rhs.push_front(i * 2);
+  // the values left sit in slabs
+  rhs.remove_if([](int v) { return v >= 24; });
+  lhs.merge(rhs);
+  lhs.compact();
+  std::vector<int> expect{3, 5};
+  for (int i = 0; i < 12; ++i) expect.push_back(i * 2);
+  std::sort(expect.begin(), expect.end());
+  EXPECT_TRUE(std::equal(expect.begin(), expect.end(), lhs.begin()));
+  auto it = lhs.begin();
+  for (int i = 1; i < 8; ++i, ++it) {
+    EXPECT_EQ(reinterpret_cast<const char*>(&*std::next(it)) -
+                  reinterpret_cast<const char*>(&*it),
+              sizeof(std::_Fwd_list_node<int>));
+  }
+
+  // the packed inline slots are not handed out again
+  for (int i = 0; i < 10; ++i) {
+    lhs.push_front(-i);
+    expect.insert(expect.begin(), -i);
+  }
+  EXPECT_EQ(std::distance(lhs.begin(), lhs.end()), expect.size());
+  EXPECT_TRUE(std::equal(expect.begin(), expect.end(), lhs.begin()));
+}
+
+using Strings = FixedForwardList<std::string, 4>;
+
+Strings SortedStrings(int first, int count, int step) {
+  Strings list;
+  auto pos = list.before_begin();
+  for (int i = 0; i < count; ++i) {
+    // long enough not to fit a short string
+    pos = list.insert_after(pos, "value " + std::to_string(first + i * step) +
+                                     std::string(20, '.'));
+  }
+  return list;
+}
+
+TEST(FixedForwardList, merge) {
+  Strings lhs = SortedStrings(100, 10, 2);
+  std::vector<std::string> expected(lhs.begin(), lhs.end());
+  {
+    // half inline, half in slabs; other dies first, what came from its
+    // slabs must not go with it
+    Strings rhs = SortedStrings(101, 10, 2);
+    expected.insert(expected.end(), rhs.begin(), rhs.end());
+    lhs.merge(rhs);
+    EXPECT_TRUE(rhs.empty());
+    rhs.push_front("still usable");
+    for (int i = 0; i < 10; ++i) rhs.push_front(std::to_string(i));
+  }
+  std::sort(expected.begin(), expected.end());
+  EXPECT_TRUE(std::equal(expected.begin(), expected.end(), lhs.begin()));
+  EXPECT_EQ(std::distance(lhs.begin(), lhs.end()), 20);
+  // nodes freed from the adopted slabs are reused
+  lhs.remove_if([](const std::string& s) { return s.back() == '.'; });
+  for (int i = 0; i < 40; ++i) lhs.push_front(std::to_string(i));
+  EXPECT_EQ(lhs.front(), "39");
+
+  FixedForwardList<int, 4> ints{1, 3, 5};
+  ints.merge(FixedForwardList<int, 4>{6, 4, 2}, std::greater<int>());
+  EXPECT_TRUE((ints == FixedForwardList<int, 4>{6, 4, 2, 1, 3, 5}));
+  ints.merge(ints);
+  EXPECT_EQ(std::distance(ints.begin(), ints.end()), 6);
+}
+
+TEST(FixedForwardList, merge_throw) {
+  Strings lhs = SortedStrings(100, 6, 2);
+  {
+    Strings rhs = SortedStrings(101, 6, 2);
+    int calls = 0;
+    auto comp = [&calls](const std::string& a, const std::string& b) {
+      if (++calls == 4) throw std::runtime_error("compare");
+      return a < b;
+    };
+    EXPECT_THROW(lhs.merge(rhs, comp), std::runtime_error);
+    EXPECT_TRUE(rhs.empty());
+  }
+  EXPECT_EQ(std::distance(lhs.begin(), lhs.end()), 12);
+}
+
+struct ThrowOnCopy {
+  static int budget;
+  std::string value;
+  ThrowOnCopy(const std::string& v) : value(v) {}
+  ThrowOnCopy(const ThrowOnCopy& other) : value(other.value) {
+    if (--budget < 0) throw std::runtime_error("copy");
+  }
+  bool operator<(const ThrowOnCopy& other) const {
+    return value < other.value;
+  }
+};
+int ThrowOnCopy::budget = 0;
+
+TEST(FixedForwardList, take_nodes_throw) {
+  // the inline values of other are copied, a copy that throws leaves both
+  // lists as they were
+  using Copies = FixedForwardList<ThrowOnCopy, 4>;
+  auto values = [](const Copies& list) {
+    std::vector<std::string> out;
+    for (const ThrowOnCopy& v : list) out.push_back(v.value);
+    return out;
+  };
+  Copies lhs;
+  Copies rhs;
+  for (int i = 5; i >= 0; --i) {
+    lhs.emplace_front("a" + std::to_string(i) + std::string(20, '.'));
+    rhs.emplace_front("b" + std::to_string(i) + std::string(20, '.'));
+  }
+  std::vector<std::string> lhs_values = values(lhs);
+  std::vector<std::string> rhs_values = values(rhs);
+  ThrowOnCopy::budget = 2;
+  EXPECT_THROW(lhs.merge(rhs), std::runtime_error);
+  ThrowOnCopy::budget = 0;
+  EXPECT_THROW(lhs.splice_after(lhs.begin(), rhs), std::runtime_error);
+  EXPECT_EQ(values(lhs), lhs_values);
+  EXPECT_EQ(values(rhs), rhs_values);
+
+  ThrowOnCopy::budget = 4;
+  lhs.merge(rhs);
+  EXPECT_TRUE(rhs.empty());
+  EXPECT_EQ(std::distance(lhs.begin(), lhs.end()), 12);
+  EXPECT_TRUE(std::is_sorted(lhs.begin(), lhs.end()));
+}
+
+TEST(FixedForwardList, splice_after_all) {
+  Strings lhs = SortedStrings(0, 6, 1);
+  {
+    Strings rhs = SortedStrings(10, 6, 1);
+    lhs.splice_after(std::next(lhs.begin()), rhs);
+    EXPECT_TRUE(rhs.empty());
+  }
+  std::vector<int> order;
+  for (const std::string& s : lhs) order.push_back(std::stoi(s.substr(6)));
+  EXPECT_EQ(order,
+            std::vector<int>({0, 1, 10, 11, 12, 13, 14, 15, 2, 3, 4, 5}));
+  lhs.clear();
+  for (int i = 0; i < 30; ++i) lhs.push_front(std::to_string(i));
+  EXPECT_EQ(std::distance(lhs.begin(), lhs.end()), 30);
+}
+
+TEST(FixedForwardList, splice_after_part) {
+  using Ptrs = FixedForwardList<std::unique_ptr<int>, 2>;
+  Ptrs lhs;
+  Ptrs rhs;
+  for (int i = 4; i > 0; --i) rhs.push_front(std::unique_ptr<int>(new int(i)));
+  lhs.push_front(std::unique_ptr<int>(new int(0)));
+
+  lhs.splice_after(lhs.begin(), rhs, rhs.before_begin());
+  EXPECT_EQ(*lhs.begin()->get(), 0);
+  EXPECT_EQ(**std::next(lhs.begin()), 1);
+  EXPECT_EQ(**rhs.begin(), 2);
+
+  lhs.splice_after(lhs.before_begin(), rhs, rhs.begin(), rhs.end());
+  std::vector<int> values;
+  for (auto& p : lhs) values.push_back(*p);
+  EXPECT_EQ(values, std::vector<int>({3, 4, 0, 1}));
+  EXPECT_EQ(std::distance(rhs.begin(), rhs.end()), 1);
+  EXPECT_EQ(**rhs.begin(), 2);
+
+  // within one list the nodes are relinked
+  const int* first = lhs.begin()->get();
+  lhs.splice_after(std::next(lhs.begin(), 3), lhs, lhs.before_begin());
+  EXPECT_EQ(std::next(lhs.begin(), 3)->get(), first);
+}
+
+TEST(FixedForwardList, merge_across_arenas) {
+  using ArenaStrings = FixedForwardList<std::string, 2, ArenaSlabs>;
+  Arena first_arena;
+  Arena second_arena;
+  ArenaScope first_scope(first_arena);
+  ArenaStrings lhs{"a", "c", "e", "g"};
+  {
+    ArenaScope second_scope(second_arena);
+    ArenaStrings rhs{"b", "d", "f", "h"};
+    lhs.merge(rhs);
+    EXPECT_TRUE(rhs.empty());
+  }
+  second_arena.Reset();
+  EXPECT_TRUE((lhs == ArenaStrings{"a", "b", "c", "d", "e", "f", "g", "h"}));
+}
+
+TEST(FixedForwardList, compact_after_adopting_slabs) {
+  using Ints = FixedForwardList<int, 4>;
+  // every value left in the list returned sits in a slab
+  auto slab_values = [] {
+    Ints list;
+    for (int i = 0; i < 10; ++i) list.push_front(i);
+    list.remove_if([](int v) { return v < 4; });
+    return list;
+  };
+  Ints spliced{100};
+  Ints other = slab_values();
+  spliced.splice_after(spliced.before_begin(), other);
+  spliced.compact();
+  for (int i = 10; i < 13; ++i) spliced.push_front(i);
+  EXPECT_TRUE((spliced == Ints{12, 11, 10, 9, 8, 7, 6, 5, 4, 100}));
+
+  Ints merged{100};
+  other = slab_values();
+  merged.merge(other, std::greater<int>());
+  merged.compact();
+  for (int i = 10; i < 13; ++i) merged.push_front(i);
+  EXPECT_TRUE((merged == Ints{12, 11, 10, 100, 9, 8, 7, 6, 5, 4}));
+}
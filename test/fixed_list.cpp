@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <list>
+#include <string>
 #include <memory>
 #include <iostream>
 #include <algorithm>
@@ -22,3 +23,100 @@ TEST(FixedList, general) {
   EXPECT_EQ(*it, 1);
   EXPECT_EQ(*std::next(it), 2);
 }
+
+TEST(FixedList, overflow) {
+  const int kMax = 4;
+  FixedList<int, kMax> flist;
+  for (int i = 0; i < kMax * 20; ++i) flist.push_back(i);
+  EXPECT_EQ(flist.size(), kMax * 20);
+
+  flist.remove_if([](int val) { return val % 3 == 0; });
+  for (int i = 0; i < kMax * 5; ++i) flist.push_front(-i);
+  EXPECT_EQ(flist.front(), -(kMax * 5 - 1));
+  EXPECT_EQ(flist.back(), kMax * 20 - 1);
+}
+
+TEST(FixedList, swap) {
+  const int kSmall = 8;
+  FixedList<int, kSmall> lhs;
+  FixedList<int, kSmall> rhs;
+  for (int i = 0; i < kSmall * 3; ++i) lhs.push_back(i);
+  lhs.remove_if([](int i) { return i % 3 == 0; });
+  rhs.push_back(-1);
+  rhs.push_front(-2);
+
+  swap(lhs, rhs);
+  EXPECT_TRUE((lhs == FixedList<int, kSmall>({-2, -1})));
+  EXPECT_EQ(rhs.size(), kSmall * 2);
+  EXPECT_EQ(rhs.front(), 1);
+  EXPECT_EQ(rhs.back(), kSmall * 3 - 1);
+
+  for (int i = 0; i < kSmall * 2; ++i) lhs.push_front(i);
+  rhs.remove_if([](int i) { return i % 2 == 0; });
+  rhs.push_back(1000);
+  EXPECT_EQ(lhs.size(), kSmall * 2 + 2);
+  EXPECT_EQ(lhs.back(), -1);
+  EXPECT_EQ(rhs.back(), 1000);
+
+  std::list<int> expect(rhs.begin(), rhs.end());
+  rhs.swap(lhs);
+  EXPECT_TRUE(std::equal(lhs.begin(), lhs.end(), expect.begin()));
+  EXPECT_TRUE(std::equal(lhs.rbegin(), lhs.rend(), expect.rbegin()));
+}
+
+TEST(FixedList, swap_strings) {
+  FixedList<std::string, 4> lhs{"a", "b", "c", "d", "e", "f"};
+  FixedList<std::string, 4> rhs{"short", std::string(40, 'y')};
+  lhs.pop_front();
+  lhs.swap(rhs);
+  EXPECT_EQ(lhs.front(), "short");
+  EXPECT_EQ(lhs.back(), std::string(40, 'y'));
+  EXPECT_TRUE((rhs == FixedList<std::string, 4>{"b", "c", "d", "e", "f"}));
+  rhs.push_front("a");
+  EXPECT_EQ(rhs.size(), 6);
+}
+
+TEST(FixedList, swap_then_fill) {
+  // the pools trade their bump pointers, both mid buffer and at its end
+  FixedList<int, 8> lhs{1};
+  FixedList<int, 8> rhs{1, 2, 3, 4, 5, 6, 7, 8};
+  lhs.swap(rhs);
+  for (int i = 0; i < 20; ++i) {
+    lhs.push_back(i);
+    rhs.push_back(i);
+  }
+  EXPECT_EQ(lhs.size(), 28);
+  EXPECT_EQ(rhs.size(), 21);
+  EXPECT_EQ(lhs.back(), 19);
+}
+
+TEST(FixedList, compact) {
+  constexpr size_t kSmall = 8;
+  FixedList<std::string, kSmall> flist;
+  std::list<std::string> expect;
+  for (int i = 0; i < 20; ++i) {
+    flist.push_front(std::to_string(i));
+    expect.push_front(std::to_string(i));
+  }
+  for (auto it = flist.begin(); it != flist.end();) {
+    it = flist.erase(it);
+    if (it != flist.end()) ++it;
+  }
+  for (auto it = expect.begin(); it != expect.end();) {
+    it = expect.erase(it);
+    if (it != expect.end()) ++it;
+  }
+  flist.compact();
+  EXPECT_TRUE(std::equal(flist.begin(), flist.end(), expect.begin()));
+  EXPECT_TRUE(std::equal(flist.rbegin(), flist.rend(), expect.rbegin()));
+  auto it = flist.begin();
+  for (size_t i = 1; i < kSmall; ++i, ++it) {
+    EXPECT_EQ(reinterpret_cast<const char*>(&*std::next(it)) -
+                  reinterpret_cast<const char*>(&*it),
+              sizeof(__std_list_node_t<std::string>));
+  }
+  flist.push_back("end");
+  flist.pop_front();
+  EXPECT_EQ(flist.back(), "end");
+  EXPECT_EQ(flist.size(), expect.size());
+}
@@ -1,8 +1,11 @@
 #include "fixed_map.hpp"
 
+#include <map>
+#include <string>
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <stdexcept>
 
 #include "gtest/gtest.h"
 
@@ -82,3 +85,414 @@ TEST(FixedSet, begin_end) {
         }));
   }
 }
+
+TEST(FixedMap, overflow) {
+  constexpr size_t kSmall = 8;
+  FixedMap<size_t, size_t, kSmall> fmap;
+  for (size_t i = 0; i < kSmall * 10; ++i) fmap[i] = i;
+  EXPECT_EQ(fmap.size(), kSmall * 10);
+
+  // erased slab nodes go back on the free list and are reused
+  for (size_t i = 0; i < kSmall * 10; i += 2) fmap.erase(i);
+  for (size_t i = kSmall * 10; i < kSmall * 15; ++i) fmap[i] = i;
+  EXPECT_EQ(fmap.size(), kSmall * 10);
+
+  size_t expect = 1;
+  for (auto& kv : fmap) {
+    EXPECT_EQ(kv.first, expect);
+    EXPECT_EQ(kv.second, expect);
+    expect += expect + 2 < kSmall * 10 ? 2 : 1;
+  }
+
+  FixedMap<size_t, size_t, kSmall> fmap1(fmap);
+  EXPECT_TRUE(fmap1 == fmap);
+}
+
+TEST(FixedMap, swap) {
+  constexpr size_t kSmall = 8;
+  using Map = FixedMap<size_t, size_t, kSmall>;
+  Map lhs;
+  Map rhs;
+  std::map<size_t, size_t> lexpect;
+  std::map<size_t, size_t> rexpect;
+  // lhs spills into slabs, both free lists mix inline and slab nodes
+  for (size_t i = 0; i < kSmall * 4; ++i) lhs[i] = lexpect[i] = i;
+  for (size_t i = 0; i < kSmall * 4; i += 3) {
+    lhs.erase(i);
+    lexpect.erase(i);
+  }
+  for (size_t i = 100; i < 105; ++i) rhs[i] = rexpect[i] = i;
+  rhs.erase(102);
+  rexpect.erase(102);
+
+  lhs.swap(rhs);
+  EXPECT_TRUE(std::equal(lhs.begin(), lhs.end(), rexpect.begin()));
+  EXPECT_TRUE(std::equal(rhs.begin(), rhs.end(), lexpect.begin()));
+  EXPECT_EQ(lhs.size(), rexpect.size());
+  EXPECT_EQ(rhs.size(), lexpect.size());
+
+  // both pools keep working after the trade
+  for (size_t i = 200; i < 200 + kSmall * 3; ++i) lhs[i] = rexpect[i] = i;
+  for (size_t i = 1; i < kSmall * 4; i += 3) {
+    rhs.erase(i);
+    lexpect.erase(i);
+  }
+  for (size_t i = 300; i < 300 + kSmall; ++i) rhs[i] = lexpect[i] = i;
+  EXPECT_TRUE(std::equal(lhs.begin(), lhs.end(), rexpect.begin()));
+  EXPECT_TRUE(std::equal(rhs.begin(), rhs.end(), lexpect.begin()));
+
+  Map empty;
+  swap(empty, lhs);
+  EXPECT_TRUE(lhs.empty());
+  EXPECT_EQ(empty.size(), rexpect.size());
+  EXPECT_TRUE(std::equal(empty.begin(), empty.end(), rexpect.begin()));
+  lhs[1] = 1;
+  EXPECT_EQ(lhs.size(), 1);
+
+  FixedMultiMap<size_t, size_t, kSmall> mlhs;
+  FixedMultiMap<size_t, size_t, kSmall> mrhs;
+  for (size_t i = 0; i < kSmall * 2; ++i) mlhs.emplace(i % 3, i);
+  mrhs.emplace(7, 7);
+  swap(mlhs, mrhs);
+  EXPECT_EQ(mlhs.size(), 1);
+  EXPECT_EQ(mrhs.size(), kSmall * 2);
+  EXPECT_EQ(mrhs.count(0), 6);
+}
+
+TEST(FixedMap, move) {
+  constexpr size_t kSmall = 8;
+  using Map = FixedMap<size_t, size_t, kSmall>;
+  std::map<size_t, size_t> expect;
+  Map src;
+  for (size_t i = 0; i < kSmall * 3; ++i) src[i] = expect[i] = i;
+  src.erase(3);
+  expect.erase(3);
+  const size_t* slab_value = &src.rbegin()->second;
+
+  Map dst(std::move(src));
+  EXPECT_TRUE(src.empty());
+  EXPECT_EQ(dst.size(), expect.size());
+  EXPECT_TRUE(std::equal(dst.begin(), dst.end(), expect.begin()));
+  // nodes outside the inline pool are stolen, not copied
+  EXPECT_EQ(&dst.rbegin()->second, slab_value);
+
+  Map other;
+  other[1000] = 1000;
+  other = std::move(dst);
+  EXPECT_TRUE(dst.empty());
+  EXPECT_TRUE(std::equal(other.begin(), other.end(), expect.begin()));
+  EXPECT_EQ(other.count(1000), 0);
+
+  // both sides stay usable
+  src[1] = 1;
+  dst[2] = 2;
+  other[3] = expect[3] = 3;
+  EXPECT_TRUE(std::equal(other.begin(), other.end(), expect.begin()));
+  other = std::move(other);
+  EXPECT_EQ(other.size(), expect.size());
+
+  // move only values never get copied
+  FixedMap<size_t, std::unique_ptr<size_t>, kSmall> owners;
+  for (size_t i = 0; i < kSmall * 2; ++i) {
+    owners[i].reset(new size_t(i));
+  }
+  FixedMap<size_t, std::unique_ptr<size_t>, kSmall> moved(std::move(owners));
+  EXPECT_EQ(moved.size(), kSmall * 2);
+  EXPECT_EQ(*moved[5], 5);
+
+  FixedMultiMap<size_t, size_t, kSmall> mmap;
+  for (size_t i = 0; i < kSmall * 2; ++i) mmap.emplace(i % 3, i);
+  FixedMultiMap<size_t, size_t, kSmall> mmoved(std::move(mmap));
+  EXPECT_TRUE(mmap.empty());
+  EXPECT_EQ(mmoved.count(0), 6);
+  mmap = std::move(mmoved);
+  EXPECT_EQ(mmap.size(), kSmall * 2);
+}
+
+TEST(FixedMap, copy_assign) {
+  constexpr size_t kSmall = 8;
+  using Map = FixedMap<size_t, size_t, kSmall>;
+  Map source;
+  Map target;
+  for (size_t i = 0; i < kSmall * 2; ++i) source[i] = i * 10;
+  for (size_t i = 100; i < 100 + kSmall * 2; ++i) target[i] = i;
+
+  std::vector<const size_t*> nodes;
+  for (const auto& kv : target) nodes.push_back(&kv.second);
+  std::sort(nodes.begin(), nodes.end());
+
+  // replaces instead of merging, into the nodes target already held
+  target = source;
+  EXPECT_TRUE(target == source);
+  EXPECT_EQ(target.count(100), 0);
+  for (const auto& kv : target) {
+    EXPECT_TRUE(std::binary_search(nodes.begin(), nodes.end(), &kv.second));
+  }
+
+  // grows and shrinks
+  source[1000] = 1000;
+  target = source;
+  EXPECT_TRUE(target == source);
+  Map small{{5ul, 5ul}};
+  target = small;
+  EXPECT_EQ(target.size(), 1);
+  EXPECT_EQ(target[5], 5);
+  target = target;
+  EXPECT_EQ(target.size(), 1);
+  target = Map();
+  EXPECT_TRUE(target.empty());
+
+  // the comparator is copied with the tree
+  using Greater = FixedMap<size_t, size_t, kSmall, std::greater<size_t>>;
+  Greater greater;
+  for (size_t i = 0; i < kSmall; ++i) greater[i] = i;
+  Greater greater_copy(greater);
+  EXPECT_EQ(greater_copy.begin()->first, kSmall - 1);
+  greater_copy[kSmall] = kSmall;
+  EXPECT_EQ(greater_copy.begin()->first, kSmall);
+
+  target = {{1ul, 1ul}, {2ul, 2ul}};
+  EXPECT_EQ(target.size(), 2);
+  target = std::map<size_t, size_t>{{3ul, 3ul}};
+  EXPECT_EQ(target.size(), 1);
+  EXPECT_EQ(target.count(3), 1);
+
+  FixedMultiMap<size_t, size_t, kSmall> msource;
+  FixedMultiMap<size_t, size_t, kSmall> mtarget;
+  for (size_t i = 0; i < kSmall * 2; ++i) msource.emplace(i % 3, i);
+  mtarget.emplace(9, 9);
+  mtarget = msource;
+  EXPECT_TRUE(mtarget == msource);
+  EXPECT_EQ(mtarget.count(9), 0);
+  FixedMultiMap<size_t, size_t, kSmall> mcopy(mtarget);
+  EXPECT_TRUE(mcopy == msource);
+}
+
+TEST(FixedMap, sorted_unique) {
+  constexpr size_t kSmall = 8;
+  std::map<size_t, size_t> snapshot;
+  for (size_t i = 0; i < kSmall * 5; ++i) snapshot[i * 3] = i;
+  FixedMap<size_t, size_t, kSmall> fmap(sorted_unique, snapshot.begin(),
+                                        snapshot.end());
+  EXPECT_EQ(fmap.size(), snapshot.size());
+  EXPECT_TRUE(std::equal(fmap.begin(), fmap.end(), snapshot.begin()));
+  EXPECT_EQ(fmap.find(9)->second, 3);
+  EXPECT_EQ(fmap.lower_bound(10)->first, 12);
+  fmap[1] = 1;
+  fmap.erase(0);
+  EXPECT_EQ(fmap.begin()->first, 1);
+
+  std::vector<std::pair<size_t, size_t>> repeated{
+      {1, 1}, {1, 2}, {2, 3}, {5, 4}, {5, 5}, {5, 6}};
+  FixedMultiMap<size_t, size_t, kSmall> mmap(sorted_equivalent,
+                                             repeated.begin(), repeated.end());
+  EXPECT_EQ(mmap.size(), repeated.size());
+  EXPECT_EQ(mmap.count(5), 3);
+  EXPECT_EQ(mmap.lower_bound(5)->second, 4);
+}
+
+TEST(FixedMap, swap_strings) {
+  // short strings point into themselves and must not be moved as bytes
+  FixedMap<int, std::string, 8> lhs;
+  FixedMap<int, std::string, 8> rhs;
+  for (int i = 0; i < 12; ++i) lhs[i] = std::to_string(i);
+  lhs.erase(2);
+  rhs[100] = "hundred";
+  rhs[101] = std::string(40, 'x');
+  lhs.swap(rhs);
+  EXPECT_EQ(lhs[100], "hundred");
+  EXPECT_EQ(lhs[101], std::string(40, 'x'));
+  EXPECT_EQ(rhs.size(), 11);
+  EXPECT_EQ(rhs[3], "3");
+  EXPECT_EQ(rhs[11], "11");
+
+  FixedMap<int, std::string, 8> moved(std::move(rhs));
+  EXPECT_EQ(moved[5], "5");
+  rhs[1] = "one";
+  EXPECT_EQ(rhs.size(), 1);
+}
+
+TEST(FixedMap, swap_string_keys) {
+  // a const std::string key is copied when moved, which may throw, so the
+  // maps are copied rather than their pools traded
+  using Map = FixedMap<std::string, int, 8>;
+  static_assert(
+      !NodesRelocatable<Map::allocator_type::value_type>::value, "");
+  Map lhs;
+  Map rhs;
+  for (int i = 0; i < 12; ++i) lhs[std::string(i * 4, 'k')] = i;
+  rhs["short"] = -1;
+  lhs.swap(rhs);
+  EXPECT_EQ(lhs.size(), 1);
+  EXPECT_EQ(lhs["short"], -1);
+  EXPECT_EQ(rhs.size(), 12);
+  EXPECT_EQ(rhs[std::string(44, 'k')], 11);
+
+  Map moved(std::move(rhs));
+  EXPECT_EQ(moved.size(), 12);
+  EXPECT_EQ(moved[""], 0);
+  EXPECT_TRUE(rhs.empty());
+  moved.compact();
+  EXPECT_EQ(moved[std::string(8, 'k')], 2);
+  lhs = std::move(moved);
+  EXPECT_EQ(lhs.size(), 12);
+  EXPECT_TRUE(moved.empty());
+}
+
+TEST(FixedMap, move_string_keys) {
+  // only the entries in the inline buffer are rebuilt, the slab nodes
+  // change owner
+  using Map = FixedMap<std::string, int, 8>;
+  Map src;
+  std::map<std::string, int> expect;
+  for (int i = 0; i < 40; ++i) {
+    std::string key = "key " + std::to_string(i) + std::string(20, '.');
+    src[key] = expect[key] = i;
+  }
+  src.erase(src.begin());
+  expect.erase(expect.begin());
+  const int* slab_value = &src["key 39" + std::string(20, '.')];
+
+  Map dst(std::move(src));
+  EXPECT_TRUE(src.empty());
+  EXPECT_TRUE(std::equal(dst.begin(), dst.end(), expect.begin()));
+  EXPECT_EQ(&dst["key 39" + std::string(20, '.')], slab_value);
+  for (int i = 0; i < 20; ++i) src[std::to_string(i)] = i;
+  EXPECT_EQ(src.size(), 20);
+
+  Map other;
+  other["gone"] = 1;
+  other = std::move(dst);
+  EXPECT_TRUE(dst.empty());
+  EXPECT_TRUE(std::equal(other.begin(), other.end(), expect.begin()));
+  other.erase(other.begin(), std::next(other.begin(), 10));
+  for (int i = 0; i < 30; ++i) other[std::to_string(i)] = i;
+  EXPECT_EQ(other.size(), expect.size() + 20);
+
+  FixedMultiMap<std::string, int, 4> mmap;
+  for (int i = 0; i < 12; ++i) mmap.emplace(std::to_string(i % 3), i);
+  FixedMultiMap<std::string, int, 4> mmoved(std::move(mmap));
+  EXPECT_TRUE(mmap.empty());
+  EXPECT_EQ(mmoved.count("1"), 4);
+}
+
+TEST(FixedMap, move_only_values) {
+  using Map = FixedMap<std::string, std::unique_ptr<int>, 4>;
+  Map src;
+  for (int i = 0; i < 10; ++i) src[std::to_string(i)].reset(new int(i));
+  Map dst(std::move(src));
+  EXPECT_TRUE(src.empty());
+  EXPECT_EQ(dst.size(), 10);
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(*dst[std::to_string(i)], i);
+  src = std::move(dst);
+  EXPECT_EQ(*src["7"], 7);
+}
+
+struct ThrowOnCopyKey {
+  static int budget;
+  int value;
+  ThrowOnCopyKey(int v) : value(v) {}
+  ThrowOnCopyKey(const ThrowOnCopyKey& other) : value(other.value) {
+    if (--budget < 0) throw std::runtime_error("copy");
+  }
+  bool operator<(const ThrowOnCopyKey& other) const {
+    return value < other.value;
+  }
+};
+int ThrowOnCopyKey::budget = 0;
+
+TEST(FixedMap, move_throw) {
+  // a key copy that throws leaves the source as it was, moved values
+  // included
+  using Map = FixedMap<ThrowOnCopyKey, std::unique_ptr<int>, 8>;
+  Map src;
+  ThrowOnCopyKey::budget = 100;
+  for (int i = 0; i < 12; ++i) src[i].reset(new int(i));
+  ThrowOnCopyKey::budget = 5;
+  EXPECT_THROW(Map dst(std::move(src)), std::runtime_error);
+  EXPECT_EQ(src.size(), 12);
+  int i = 0;
+  for (const auto& entry : src) {
+    EXPECT_EQ(entry.first.value, i);
+    ASSERT_TRUE(entry.second != nullptr);
+    EXPECT_EQ(*entry.second, i++);
+  }
+  ThrowOnCopyKey::budget = 100;
+  Map dst(std::move(src));
+  EXPECT_EQ(dst.size(), 12);
+  EXPECT_EQ(*dst[11], 11);
+}
+
+TEST(FixedMap, swap_then_fill) {
+  FixedMap<int, int, 8> lhs{{1, 1}};
+  FixedMap<int, int, 8> rhs;
+  for (int i = 0; i < 8; ++i) rhs[i] = i;
+  swap(lhs, rhs);
+  for (int i = 100; i < 120; ++i) {
+    lhs[i] = i;
+    rhs[i] = i;
+  }
+  EXPECT_EQ(lhs.size(), 28);
+  EXPECT_EQ(rhs.size(), 21);
+}
+
+TEST(FixedMap, compact) {
+  constexpr size_t kSmall = 16;
+  using Map = FixedMap<size_t, std::string, kSmall>;
+  for (size_t count : {size_t(0), size_t(1), size_t(10), size_t(40)}) {
+    Map fmap;
+    std::map<size_t, std::string> expect;
+    // churn so the nodes sit in the buffer in no particular order
+    for (size_t i = 0; i < count * 2; ++i) {
+      size_t key = (i * 7919) % (count * 2 + 1);
+      fmap[key] = expect[key] = std::to_string(key);
+    }
+    for (size_t i = 0; i < count * 2; i += 2) {
+      fmap.erase(i);
+      expect.erase(i);
+    }
+    fmap.compact();
+    EXPECT_EQ(fmap.size(), expect.size());
+    EXPECT_TRUE(std::equal(fmap.begin(), fmap.end(), expect.begin()));
+    size_t inline_nodes = std::min(fmap.size(), kSmall);
+    auto it = fmap.begin();
+    for (size_t i = 1; i < inline_nodes; ++i, ++it) {
+      EXPECT_EQ(reinterpret_cast<const char*>(&*std::next(it)) -
+                    reinterpret_cast<const char*>(&*it),
+                sizeof(__std_tree_node_t<Map::value_type>));
+    }
+
+    // the tree and the pool keep working
+    for (size_t i = 0; i < count; ++i) {
+      fmap[i * 3] = expect[i * 3] = "x";
+      fmap.erase(i * 5);
+      expect.erase(i * 5);
+    }
+    EXPECT_TRUE(std::equal(fmap.begin(), fmap.end(), expect.begin()));
+    Map other;
+    other.swap(fmap);
+    EXPECT_TRUE(std::equal(other.begin(), other.end(), expect.begin()));
+  }
+}
+
+TEST(FixedMap, lowest_slot_first) {
+  FixedMap<int, int, 8> fmap;
+  for (int i = 0; i < 8; ++i) fmap[i] = i;
+  const int* lowest = &fmap[0];
+  fmap.erase(5);
+  fmap.erase(0);
+  fmap.erase(3);
+  // the freed slot at the lowest address is taken first
+  EXPECT_EQ(&fmap[100], lowest);
+}
+
+TEST(FixedMap, allocator_equality) {
+  FixedMap<int, int, 4> lhs;
+  FixedMap<int, int, 4> rhs;
+  // equal only when they share the node pool
+  EXPECT_TRUE(lhs.get_allocator() == lhs.get_allocator());
+  EXPECT_FALSE(lhs.get_allocator() != lhs.get_allocator());
+  EXPECT_FALSE(lhs.get_allocator() == rhs.get_allocator());
+  using Traits = std::allocator_traits<FixedMap<int, int, 4>::allocator_type>;
+  EXPECT_FALSE(Traits::is_always_equal::value);
+}
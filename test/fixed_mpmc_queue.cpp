@@ -0,0 +1,113 @@
+#include "fixed_mpmc_queue.hpp"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include "gtest/gtest.h"
+
+TEST(FixedMpmcQueue, general) {
+  FixedMpmcQueue<int, 3> queue;
+  EXPECT_EQ(queue.capacity(), 4);
+  EXPECT_TRUE(queue.empty_approx());
+
+  int value = -1;
+  EXPECT_FALSE(queue.try_pop(value));
+  for (int round = 0; round < 3; ++round) {
+    for (int i = 0; i < 4; ++i) EXPECT_TRUE(queue.try_push(i));
+    EXPECT_FALSE(queue.try_push(4));
+    EXPECT_EQ(queue.size_approx(), 4);
+    for (int i = 0; i < 4; ++i) {
+      EXPECT_TRUE(queue.try_pop(value));
+      EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+  }
+}
+
+TEST(FixedMpmcQueue, strings) {
+  FixedMpmcQueue<std::string, 4> queue;
+  EXPECT_TRUE(queue.try_emplace(40, 'x'));
+  EXPECT_TRUE(queue.try_push("short"));
+  std::string value;
+  EXPECT_TRUE(queue.try_pop(value));
+  EXPECT_EQ(value, std::string(40, 'x'));
+
+  // a throwing constructor leaves no claimed cell behind
+  EXPECT_THROW(queue.try_emplace(static_cast<const char*>(nullptr)),
+               std::logic_error);
+  EXPECT_TRUE(queue.try_push("next"));
+  EXPECT_TRUE(queue.try_pop(value));
+  EXPECT_EQ(value, "short");
+  EXPECT_TRUE(queue.try_pop(value));
+  EXPECT_EQ(value, "next");
+}
+
+TEST(FixedMpmcQueue, destroys_leftovers) {
+  auto counter = std::make_shared<int>(0);
+  {
+    FixedMpmcQueue<std::shared_ptr<int>, 4> queue;
+    for (int i = 0; i < 3; ++i) queue.try_push(counter);
+    std::shared_ptr<int> out;
+    queue.try_pop(out);
+    out.reset();
+    EXPECT_EQ(counter.use_count(), 3);
+  }
+  EXPECT_EQ(counter.use_count(), 1);
+}
+
+TEST(FixedMpmcQueue, many_threads) {
+  constexpr size_t kProducers = 3;
+  constexpr size_t kConsumers = 3;
+  constexpr size_t kPerProducer = 50000;
+  // the producer in the high bits, its running count in the low ones
+  FixedMpmcQueue<size_t, 32> queue;
+  std::vector<std::thread> threads;
+  for (size_t p = 0; p < kProducers; ++p) {
+    threads.emplace_back([&queue, p] {
+      for (size_t i = 0; i < kPerProducer;) {
+        if (queue.try_push(p << 32 | i)) {
+          ++i;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  std::atomic<size_t> popped{0};
+  std::vector<std::vector<size_t>> seen(kConsumers);
+  for (size_t c = 0; c < kConsumers; ++c) {
+    threads.emplace_back([&queue, &popped, &seen, c] {
+      size_t value;
+      while (popped.load() < kProducers * kPerProducer) {
+        if (queue.try_pop(value)) {
+          seen[c].push_back(value);
+          ++popped;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+
+  // every item once, and each consumer sees a producer's items in order
+  std::vector<size_t> count(kProducers);
+  bool in_order = true;
+  for (const std::vector<size_t>& values : seen) {
+    std::vector<size_t> last(kProducers, 0);
+    std::vector<bool> any(kProducers, false);
+    for (size_t value : values) {
+      size_t p = value >> 32;
+      size_t i = value & 0xffffffff;
+      in_order &= !any[p] || i > last[p];
+      any[p] = true;
+      last[p] = i;
+      ++count[p];
+    }
+  }
+  EXPECT_TRUE(in_order);
+  for (size_t n : count) EXPECT_EQ(n, kPerProducer);
+  EXPECT_TRUE(queue.empty_approx());
+}
@@ -0,0 +1,150 @@
+#include "fixed_pmr.hpp"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "gtest/gtest.h"
+
+#if defined(EXT_STL_HAS_PMR)
+// counts what reaches it, to see when the inline buffer ran out
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  size_t allocations = 0;
+  size_t live_bytes = 0;
+
+ protected:
+  void* do_allocate(size_t bytes, size_t align) override {
+    ++allocations;
+    live_bytes += bytes;
+    return std::pmr::new_delete_resource()->allocate(bytes, align);
+  }
+
+  void do_deallocate(void* p, size_t bytes, size_t align) override {
+    live_bytes -= bytes;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+TEST(FixedBufferResource, allocate) {
+  CountingResource upstream;
+  FixedBufferResource<64> resource(&upstream);
+  EXPECT_EQ(resource.upstream_resource(), &upstream);
+  void* first = resource.allocate(16, 8);
+  void* second = resource.allocate(16, 16);
+  EXPECT_TRUE(resource.owns(first));
+  EXPECT_TRUE(resource.owns(second));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(second) % 16, 0);
+  EXPECT_EQ(resource.buffer_used(), 32);
+
+  // the block on top goes back to the bump pointer
+  resource.deallocate(second, 16, 16);
+  EXPECT_EQ(resource.buffer_used(), 16);
+  void* third = resource.allocate(32, 8);
+  EXPECT_TRUE(resource.owns(third));
+
+  // others are handed out again for the same size
+  resource.deallocate(first, 16, 8);
+  EXPECT_EQ(resource.allocate(16, 8), first);
+
+  void* big = resource.allocate(64, 8);
+  EXPECT_FALSE(resource.owns(big));
+  EXPECT_EQ(upstream.allocations, 1);
+  resource.deallocate(big, 64, 8);
+  EXPECT_EQ(upstream.live_bytes, 0);
+
+  FixedBufferResource<64> other;
+  EXPECT_TRUE(resource.is_equal(resource));
+  EXPECT_FALSE(resource.is_equal(other));
+}
+
+TEST(FixedBufferResource, with_std_pmr) {
+  CountingResource upstream;
+  FixedBufferResource<1024> resource(&upstream);
+  {
+    std::pmr::map<int, int> map(&resource);
+    for (int i = 0; i < 10; ++i) map[i] = i;
+    // churn stays inline, freed nodes are reused
+    for (int round = 0; round < 100; ++round) {
+      map.erase(round % 10);
+      map[round % 10] = round;
+    }
+    EXPECT_EQ(upstream.allocations, 0);
+    for (int i = 10; i < 100; ++i) map[i] = i;
+    EXPECT_GT(upstream.allocations, 0);
+  }
+  EXPECT_EQ(upstream.live_bytes, 0);
+}
+
+TEST(FixedPmr, inline_first) {
+  pmr::FixedVector<int, 16> vec;
+  for (int i = 0; i < 16; ++i) vec.push_back(i);
+  EXPECT_TRUE(vec.resource()->owns(vec.data()));
+  vec.push_back(16);
+  EXPECT_FALSE(vec.resource()->owns(vec.data()));
+  EXPECT_EQ(vec[16], 16);
+
+  pmr::FixedMap<int, std::string, 8> map;
+  for (int i = 0; i < 8; ++i) map[i] = std::to_string(i);
+  EXPECT_EQ(map.resource()->buffer_used(),
+            8 * sizeof(std::_Rb_tree_node<std::pair<const int, std::string>>));
+  for (auto& entry : map) EXPECT_TRUE(map.resource()->owns(&entry));
+  map[100] = "100";
+  EXPECT_FALSE(map.resource()->owns(&map[100]));
+
+  pmr::FixedUnorderedMap<int, int, 32> umap;
+  for (int i = 0; i < 32; ++i) umap[i] = i;
+  for (auto& entry : umap) EXPECT_TRUE(umap.resource()->owns(&entry));
+
+  pmr::FixedString<32> str;
+  str.assign(30, 'x');
+  EXPECT_TRUE(str.resource()->owns(str.data()));
+}
+
+TEST(FixedPmr, all_containers) {
+  pmr::FixedList<int, 4> list{1, 2, 3};
+  EXPECT_EQ(list.back(), 3);
+  pmr::FixedForwardList<int, 4> flist{1, 2, 3};
+  EXPECT_EQ(flist.front(), 1);
+  pmr::FixedSet<int, 4> set{3, 1, 2};
+  EXPECT_EQ(*set.begin(), 1);
+  pmr::FixedMultiSet<int, 4> mset{1, 1};
+  EXPECT_EQ(mset.count(1), 2);
+  pmr::FixedMultiMap<int, int, 4> mmap{{1, 1}, {1, 2}};
+  EXPECT_EQ(mmap.count(1), 2);
+  pmr::FixedUnorderedSet<int, 4> uset{1, 2, 3};
+  EXPECT_EQ(uset.count(2), 1);
+  pmr::FixedMap<int, int, 4> map{{1, 1}};
+  EXPECT_EQ(map.at(1), 1);
+}
+
+TEST(FixedPmr, copy_move_swap) {
+  pmr::FixedMap<int, std::string, 8> lhs{{1, "one"}, {2, "two"}};
+  pmr::FixedMap<int, std::string, 8> copy(lhs);
+  EXPECT_EQ(copy, lhs);
+  for (auto& entry : copy) EXPECT_TRUE(copy.resource()->owns(&entry));
+  EXPECT_EQ(copy.get_allocator().resource(), copy.resource());
+
+  pmr::FixedMap<int, std::string, 8> moved(std::move(copy));
+  EXPECT_EQ(moved, lhs);
+  for (auto& entry : moved) EXPECT_TRUE(moved.resource()->owns(&entry));
+
+  pmr::FixedMap<int, std::string, 8> rhs{{3, "three"}};
+  lhs.swap(rhs);
+  EXPECT_EQ(lhs.size(), 1);
+  EXPECT_EQ(rhs.at(2), "two");
+  for (auto& entry : lhs) EXPECT_TRUE(lhs.resource()->owns(&entry));
+  for (auto& entry : rhs) EXPECT_TRUE(rhs.resource()->owns(&entry));
+
+  std::pmr::vector<int> plain{1, 2, 3};
+  pmr::FixedVector<int, 4> vec(plain);
+  EXPECT_TRUE(vec.resource()->owns(vec.data()));
+  vec = {4, 5};
+  EXPECT_EQ(vec.size(), 2);
+  EXPECT_TRUE(vec.resource()->owns(vec.data()));
+}
+#endif
@@ -1,5 +1,9 @@
 #include "fixed_set.hpp"
 
+#include <set>
+#include <sstream>
+#include <iterator>
+#include <stdexcept>
 #include <vector>
 #include <memory>
 #include <algorithm>
@@ -69,3 +73,228 @@ TEST(FixedSet, begin_end) {
     EXPECT_TRUE(std::equal(it, it_end, std::begin(vec)));
   }
 }
+
+TEST(FixedSet, swap) {
+  constexpr size_t kSmall = 8;
+  FixedSet<int, kSmall> lhs;
+  FixedSet<int, kSmall> rhs;
+  for (int i = 0; i < 40; ++i) lhs.insert(i);
+  for (int i = 0; i < 40; i += 2) lhs.erase(i);
+  rhs = {-1, -2, -3};
+
+  swap(lhs, rhs);
+  EXPECT_TRUE((lhs == FixedSet<int, kSmall>({-3, -2, -1})));
+  EXPECT_EQ(rhs.size(), 20);
+  EXPECT_EQ(*rhs.begin(), 1);
+  for (int i = 0; i < 40; i += 2) rhs.insert(i);
+  for (int i = 0; i < 40; ++i) EXPECT_EQ(rhs.count(i), 1);
+  for (int i = 0; i < 20; ++i) lhs.insert(100 + i);
+  EXPECT_EQ(lhs.size(), 23);
+
+  lhs.swap(rhs);
+  EXPECT_EQ(lhs.size(), 40);
+  EXPECT_EQ(rhs.size(), 23);
+  EXPECT_TRUE(std::is_sorted(rhs.begin(), rhs.end()));
+
+  FixedMultiSet<int, kSmall> mlhs;
+  FixedMultiSet<int, kSmall> mrhs;
+  for (int i = 0; i < 20; ++i) mlhs.insert(i % 4);
+  swap(mlhs, mrhs);
+  EXPECT_TRUE(mlhs.empty());
+  EXPECT_EQ(mrhs.count(3), 5);
+}
+
+TEST(FixedSet, move) {
+  constexpr size_t kSmall = 8;
+  FixedSet<int, kSmall> src;
+  for (int i = 0; i < 30; ++i) src.insert(i);
+  const int* slab_key = &*src.rbegin();
+
+  FixedSet<int, kSmall> dst(std::move(src));
+  EXPECT_TRUE(src.empty());
+  EXPECT_EQ(dst.size(), 30);
+  EXPECT_EQ(&*dst.rbegin(), slab_key);
+  EXPECT_TRUE(std::is_sorted(dst.begin(), dst.end()));
+
+  src = {100, 101};
+  src = std::move(dst);
+  EXPECT_TRUE(dst.empty());
+  EXPECT_EQ(src.size(), 30);
+  EXPECT_EQ(src.count(100), 0);
+  dst.insert(7);
+  src.insert(-1);
+  EXPECT_EQ(*src.begin(), -1);
+
+  FixedMultiSet<int, kSmall> msrc;
+  for (int i = 0; i < 20; ++i) msrc.insert(i % 4);
+  FixedMultiSet<int, kSmall> mdst(std::move(msrc));
+  EXPECT_TRUE(msrc.empty());
+  EXPECT_EQ(mdst.count(2), 5);
+  msrc = std::move(mdst);
+  EXPECT_EQ(msrc.size(), 20);
+}
+
+TEST(FixedSet, copy_assign) {
+  constexpr size_t kSmall = 8;
+  FixedSet<int, kSmall> source;
+  FixedSet<int, kSmall> target;
+  for (int i = 0; i < 20; ++i) source.insert(i);
+  for (int i = 100; i < 120; ++i) target.insert(i);
+
+  std::vector<const int*> nodes;
+  for (const int& key : target) nodes.push_back(&key);
+  std::sort(nodes.begin(), nodes.end());
+
+  target = source;
+  EXPECT_TRUE(target == source);
+  for (const int& key : target) {
+    EXPECT_TRUE(std::binary_search(nodes.begin(), nodes.end(), &key));
+  }
+
+  target = {1, 2};
+  EXPECT_TRUE((target == FixedSet<int, kSmall>({1, 2})));
+  target = std::set<int>{7};
+  EXPECT_EQ(target.size(), 1);
+  EXPECT_EQ(*target.begin(), 7);
+
+  FixedMultiSet<int, kSmall> msource;
+  FixedMultiSet<int, kSmall> mtarget{42};
+  for (int i = 0; i < 20; ++i) msource.insert(i % 4);
+  mtarget = msource;
+  EXPECT_TRUE(mtarget == msource);
+  EXPECT_EQ(mtarget.count(42), 0);
+}
+
+// black height of a subtree, 0 when a red-black rule is broken
+static size_t BlackHeight(const std::_Rb_tree_node_base* node) {
+  if (node == nullptr) {
+    return 1;
+  }
+  bool red = node->_M_color == std::_S_red;
+  for (const std::_Rb_tree_node_base* child : {node->_M_left, node->_M_right}) {
+    if (child == nullptr) continue;
+    if (child->_M_parent != node) return 0;
+    if (red && child->_M_color == std::_S_red) return 0;
+  }
+  size_t left = BlackHeight(node->_M_left);
+  size_t right = BlackHeight(node->_M_right);
+  if (left == 0 || left != right) {
+    return 0;
+  }
+  return left + !red;
+}
+
+TEST(FixedSet, sorted_unique) {
+  constexpr size_t kSmall = 8;
+  using Set = FixedSet<int, kSmall>;
+  for (int count = 0; count < 70; ++count) {
+    std::vector<int> sorted(count);
+    for (int i = 0; i < count; ++i) sorted[i] = i * 2;
+    Set fset(sorted_unique, sorted.begin(), sorted.end());
+    EXPECT_EQ(fset.size(), sorted.size());
+    EXPECT_TRUE(std::equal(fset.begin(), fset.end(), sorted.begin()));
+    const std::_Rb_tree_node_base* header = fset.cend()._M_node;
+    if (count > 0) {
+      EXPECT_EQ(header->_M_parent->_M_color, std::_S_black);
+      EXPECT_EQ(header->_M_parent->_M_parent, header);
+      EXPECT_EQ(*fset.rbegin(), sorted.back());
+    }
+    EXPECT_NE(BlackHeight(header->_M_parent), 0);
+
+    // the built tree keeps balancing through later updates
+    for (int i = 0; i < count; ++i) fset.insert(i * 2 + 1);
+    for (int i = 0; i < count; i += 3) fset.erase(i);
+    EXPECT_NE(BlackHeight(fset.cend()._M_node->_M_parent), 0);
+    EXPECT_TRUE(std::is_sorted(fset.begin(), fset.end()));
+  }
+
+  // the inline nodes are laid out in iteration order
+  std::vector<int> sorted{1, 2, 3, 4, 5, 6, 7, 8};
+  Set fset(sorted_unique, sorted.begin(), sorted.end());
+  for (auto it = fset.begin(); std::next(it) != fset.end(); ++it) {
+    EXPECT_EQ(reinterpret_cast<const char*>(&*std::next(it)) -
+                  reinterpret_cast<const char*>(&*it),
+              sizeof(__std_tree_node_t<int>));
+  }
+
+  FixedSet<int, kSmall, std::greater<int>> greater(
+      sorted_unique, sorted.rbegin(), sorted.rend());
+  EXPECT_EQ(*greater.begin(), 8);
+  EXPECT_EQ(greater.count(3), 1);
+
+  std::istringstream input("1 3 5 7");
+  Set from_stream(sorted_unique, std::istream_iterator<int>(input),
+                  std::istream_iterator<int>());
+  EXPECT_EQ(from_stream.size(), 4);
+
+  std::vector<int> repeated{1, 1, 2, 2, 2, 3, 4, 4, 4, 4, 5};
+  FixedMultiSet<int, kSmall> mset(sorted_equivalent, repeated.begin(),
+                                  repeated.end());
+  EXPECT_TRUE(std::equal(mset.begin(), mset.end(), repeated.begin()));
+  EXPECT_EQ(mset.count(4), 4);
+  EXPECT_NE(BlackHeight(mset.cend()._M_node->_M_parent), 0);
+}
+
+struct ThrowOnCopy {
+  static int budget;
+  int value;
+  ThrowOnCopy(int v) : value(v) {}
+  ThrowOnCopy(const ThrowOnCopy& other) : value(other.value) {
+    if (--budget < 0) throw std::runtime_error("copy");
+  }
+  bool operator<(const ThrowOnCopy& other) const {
+    return value < other.value;
+  }
+};
+int ThrowOnCopy::budget = 0;
+
+TEST(FixedSet, sorted_unique_throw) {
+  std::vector<ThrowOnCopy> sorted;
+  sorted.reserve(30);
+  for (int i = 0; i < 30; ++i) sorted.emplace_back(i);
+  for (int budget : {0, 1, 7, 8, 15, 29}) {
+    ThrowOnCopy::budget = budget;
+    EXPECT_THROW((FixedSet<ThrowOnCopy, 8>(sorted_unique, sorted.begin(),
+                                           sorted.end())),
+                 std::runtime_error);
+  }
+}
+
+TEST(FixedSet, move_throw) {
+  // the values move by copy, which may throw, so the inline ones are
+  // rebuilt in the target and a throw leaves the source as it was
+  using Set = FixedSet<ThrowOnCopy, 8>;
+  Set src;
+  for (int i = 0; i < 20; ++i) src.emplace(i);
+  ThrowOnCopy::budget = 3;
+  EXPECT_THROW(Set dst(std::move(src)), std::runtime_error);
+  EXPECT_EQ(src.size(), 20);
+  ThrowOnCopy::budget = 100;
+  Set dst(std::move(src));
+  EXPECT_TRUE(src.empty());
+  int i = 0;
+  for (const ThrowOnCopy& v : dst) EXPECT_EQ(v.value, i++);
+  EXPECT_EQ(i, 20);
+  src.emplace(1);
+  src = std::move(dst);
+  EXPECT_EQ(src.size(), 20);
+}
+
+TEST(FixedSet, compact) {
+  FixedSet<int, 8> fset;
+  for (int i = 20; i > 0; --i) fset.insert(i);
+  for (int i = 1; i <= 20; i += 2) fset.erase(i);
+  fset.compact();
+  EXPECT_EQ(fset.size(), 10);
+  EXPECT_NE(BlackHeight(fset.cend()._M_node->_M_parent), 0);
+  EXPECT_EQ(*fset.begin(), 2);
+  EXPECT_EQ(*fset.rbegin(), 20);
+  for (int i = 1; i <= 20; i += 2) fset.insert(i);
+  EXPECT_EQ(fset.size(), 20);
+  EXPECT_TRUE(std::is_sorted(fset.begin(), fset.end()));
+
+  FixedMultiSet<int, 8> mset{3, 1, 3, 2, 1};
+  mset.compact();
+  EXPECT_EQ(mset.count(3), 2);
+  EXPECT_EQ(*mset.begin(), 1);
+}
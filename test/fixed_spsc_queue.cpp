@@ -0,0 +1,151 @@
+#include "fixed_spsc_queue.hpp"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <numeric>
+#include <stdexcept>
+#include "gtest/gtest.h"
+
+TEST(FixedSpscQueue, general) {
+  FixedSpscQueue<int, 3> queue;
+  EXPECT_EQ(queue.capacity(), 4);
+  EXPECT_TRUE(queue.empty_approx());
+  EXPECT_EQ(queue.front(), nullptr);
+
+  for (int i = 0; i < 4; ++i) EXPECT_TRUE(queue.try_push(i));
+  EXPECT_FALSE(queue.try_push(4));
+  EXPECT_EQ(queue.size_approx(), 4);
+
+  int value = -1;
+  EXPECT_TRUE(queue.try_pop(value));
+  EXPECT_EQ(value, 0);
+  EXPECT_EQ(*queue.front(), 1);
+  queue.pop();
+  EXPECT_TRUE(queue.try_emplace(4));
+  EXPECT_TRUE(queue.try_emplace(5));
+  EXPECT_FALSE(queue.try_emplace(6));
+  for (int i = 2; i < 6; ++i) {
+    EXPECT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, i);
+  }
+  EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(FixedSpscQueue, batch) {
+  FixedSpscQueue<int, 8> queue;
+  std::vector<int> in(20);
+  std::iota(in.begin(), in.end(), 0);
+  int out[20] = {};
+
+  // straddle the end of the ring
+  EXPECT_EQ(queue.try_push_n(in.data(), 6), 6);
+  EXPECT_EQ(queue.try_pop_n(out, 5), 5);
+  EXPECT_EQ(queue.try_push_n(in.data() + 6, 20), 7);
+  EXPECT_EQ(queue.try_push_n(in.data(), 1), 0);
+  EXPECT_EQ(queue.try_pop_n(out + 5, 20), 8);
+  EXPECT_TRUE(std::equal(out, out + 13, in.begin()));
+  EXPECT_EQ(queue.try_pop_n(out, 1), 0);
+
+  // iterators and non trivial elements go one by one
+  FixedSpscQueue<std::string, 4> strings;
+  std::vector<std::string> words{"a", "b", std::string(30, 'c'), "d", "e"};
+  EXPECT_EQ(strings.try_push_n(words.begin(), words.size()), 4);
+  std::vector<std::string> got(3);
+  EXPECT_EQ(strings.try_pop_n(got.begin(), 3), 3);
+  EXPECT_EQ(got[2], words[2]);
+  EXPECT_EQ(strings.try_push_n(words.begin() + 4, 1), 1);
+  EXPECT_EQ(strings.size_approx(), 2);
+}
+
+TEST(FixedSpscQueue, destroys_leftovers) {
+  auto counter = std::make_shared<int>(0);
+  {
+    FixedSpscQueue<std::shared_ptr<int>, 4> queue;
+    for (int i = 0; i < 3; ++i) queue.try_push(counter);
+    queue.pop();
+    EXPECT_EQ(counter.use_count(), 3);
+  }
+  EXPECT_EQ(counter.use_count(), 1);
+}
+
+struct ThrowOnCopy {
+  static int budget;
+  static int live;
+  std::string value;
+  ThrowOnCopy(const std::string& v = "") : value(v) { ++live; }
+  ThrowOnCopy(const ThrowOnCopy& other) : value(other.value) {
+    if (--budget < 0) throw std::runtime_error("copy");
+    ++live;
+  }
+  ThrowOnCopy& operator=(ThrowOnCopy&& other) {
+    if (--budget < 0) throw std::runtime_error("assign");
+    value = std::move(other.value);
+    return *this;
+  }
+  ~ThrowOnCopy() { --live; }
+};
+int ThrowOnCopy::budget = 0;
+int ThrowOnCopy::live = 0;
+
+TEST(FixedSpscQueue, batch_throw) {
+  {
+    FixedSpscQueue<ThrowOnCopy, 4> queue;
+    std::vector<ThrowOnCopy> in;
+    in.reserve(4);
+    for (int i = 0; i < 4; ++i) in.emplace_back(std::string(i + 20, 'a'));
+    // a copy that throws leaves nothing behind in the ring
+    ThrowOnCopy::budget = 2;
+    EXPECT_THROW(queue.try_push_n(in.begin(), 4), std::runtime_error);
+    EXPECT_EQ(queue.size_approx(), 0);
+    EXPECT_EQ(ThrowOnCopy::live, 4);
+    ThrowOnCopy::budget = 4;
+    EXPECT_EQ(queue.try_push_n(in.begin(), 4), 4);
+
+    // what was moved out before the throw is gone from the queue
+    std::vector<ThrowOnCopy> out(4);
+    ThrowOnCopy::budget = 1;
+    EXPECT_THROW(queue.try_pop_n(out.begin(), 4), std::runtime_error);
+    EXPECT_EQ(out[0].value, in[0].value);
+    EXPECT_EQ(queue.size_approx(), 3);
+    EXPECT_EQ(queue.front()->value, in[1].value);
+    ThrowOnCopy::budget = 1;
+    EXPECT_TRUE(queue.try_push(in[0]));
+    EXPECT_EQ(queue.size_approx(), 4);
+  }
+  EXPECT_EQ(ThrowOnCopy::live, 0);
+}
+
+TEST(FixedSpscQueue, two_threads) {
+  constexpr size_t kCount = 200000;
+  FixedSpscQueue<size_t, 64> queue;
+  std::thread producer([&queue] {
+    size_t batch[7];
+    size_t next = 0;
+    while (next < kCount) {
+      if (next % 3 == 0) {
+        size_t n = std::min<size_t>(7, kCount - next);
+        for (size_t i = 0; i < n; ++i) batch[i] = next + i;
+        size_t pushed = queue.try_push_n(batch, n);
+        if (pushed == 0) std::this_thread::yield();
+        next += pushed;
+      } else if (queue.try_push(next)) {
+        ++next;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  size_t expect = 0;
+  bool in_order = true;
+  size_t out[5];
+  while (expect < kCount) {
+    size_t n = queue.try_pop_n(out, 5);
+    if (n == 0) std::this_thread::yield();
+    for (size_t i = 0; i < n; ++i) in_order &= out[i] == expect++;
+  }
+  producer.join();
+  EXPECT_TRUE(in_order);
+  EXPECT_TRUE(queue.empty_approx());
+}
@@ -24,3 +24,109 @@ TEST(FixedString, general) {
   FixedString<kMax>::iterator it = fs.begin();
   EXPECT_TRUE(*it == '1');
 }
+
+TEST(FixedString, spill) {
+  const int kMax = 8;
+  FixedString<kMax> fs(kMax, 'a');
+  EXPECT_TRUE(fs.use_stack_memory());
+  EXPECT_TRUE(fs.c_str()[kMax] == '\0');
+
+  fs.push_back('b');
+  EXPECT_FALSE(fs.use_stack_memory());
+  EXPECT_TRUE(fs.size() == kMax + 1);
+  EXPECT_TRUE(fs == std::string(kMax, 'a') + "b");
+
+  fs.append(fs);
+  EXPECT_TRUE(fs.size() == 2 * (kMax + 1));
+  EXPECT_TRUE(fs.substr(kMax + 1) == std::string(kMax, 'a') + "b");
+
+  fs.resize(3);
+  fs.shrink_to_fit();
+  EXPECT_TRUE(fs.use_stack_memory());
+  EXPECT_TRUE(fs == "aaa");
+  EXPECT_TRUE(fs.capacity() == kMax);
+}
+
+TEST(FixedString, move) {
+  const int kMax = 8;
+  FixedString<kMax> small("abc");
+  FixedString<kMax> moved(std::move(small));
+  EXPECT_TRUE(moved == "abc");
+  EXPECT_TRUE(small.empty());
+
+  FixedString<kMax> large("0123456789abcdef");
+  const char* heap = large.data();
+  moved = std::move(large);
+  EXPECT_TRUE(moved.data() == heap);
+  EXPECT_TRUE(moved == "0123456789abcdef");
+  EXPECT_TRUE(large.empty());
+  EXPECT_TRUE(large.use_stack_memory());
+
+  swap(moved, small);
+  EXPECT_TRUE(small == "0123456789abcdef");
+  EXPECT_TRUE(moved.empty());
+}
+
+TEST(FixedString, modify) {
+  const int kMax = 16;
+  FixedString<kMax> fs = "hello world";
+  fs.insert(5, ",");
+  EXPECT_TRUE(fs == "hello, world");
+  fs.erase(0, 7);
+  EXPECT_TRUE(fs == "world");
+  fs.replace(0, 1, "W");
+  EXPECT_TRUE(fs == "World");
+  fs.insert(fs.begin(), 3, '-');
+  EXPECT_TRUE(fs == "---World");
+  fs.erase(fs.begin(), fs.begin() + 3);
+  fs.pop_back();
+  EXPECT_TRUE(fs == "Worl");
+
+  // the source of the insert lives in the string itself
+  fs.insert(0, fs.c_str() + 2, 2);
+  EXPECT_TRUE(fs == "rlWorl");
+  fs.replace(0, 2, fs.c_str(), fs.size());
+  EXPECT_TRUE(fs == "rlWorlWorl");
+
+  EXPECT_THROW(fs.at(fs.size()), std::out_of_range);
+  EXPECT_THROW(fs.erase(fs.size() + 1), std::out_of_range);
+}
+
+TEST(FixedString, search) {
+  FixedString<32> fs = "abcabcab";
+  EXPECT_TRUE(fs.find("bc") == 1);
+  EXPECT_TRUE(fs.find("bc", 2) == 4);
+  EXPECT_TRUE(fs.find("bd") == FixedString<32>::npos);
+  EXPECT_TRUE(fs.find('c') == 2);
+  EXPECT_TRUE(fs.rfind("bc") == 4);
+  EXPECT_TRUE(fs.rfind('a') == 6);
+  EXPECT_TRUE(fs.find_first_of("cx") == 2);
+  EXPECT_TRUE(fs.find_last_of("cx") == 5);
+  EXPECT_TRUE(fs.find_first_not_of("ab") == 2);
+  EXPECT_TRUE(fs.find_last_not_of("ab") == 5);
+  EXPECT_TRUE(fs.find("") == 0);
+}
+
+TEST(FixedString, compare) {
+  FixedString<4> a = "abc";
+  FixedString<16> b = "abd";
+  EXPECT_TRUE(a < b);
+  EXPECT_TRUE(a != b);
+  EXPECT_TRUE(a == std::string("abc"));
+  EXPECT_TRUE("abc" == a);
+  EXPECT_TRUE(a.compare("ab") > 0);
+  EXPECT_TRUE(a + "d" == "abcd");
+
+  FixedString<16> c = "abc";
+  FixedString<16> long_c = "abc";
+  long_c.reserve(64);
+  EXPECT_TRUE(std::hash<FixedString<16>>()(c) ==
+              std::hash<FixedString<16>>()(long_c));
+}
+
+TEST(FixedString, wide) {
+  FixedWString<4> ws = L"abcdef";
+  EXPECT_FALSE(ws.use_stack_memory());
+  EXPECT_TRUE(ws == std::wstring(L"abcdef"));
+  EXPECT_TRUE(ws.find(L'd') == 3);
+}
@@ -0,0 +1,114 @@
+#include "fixed_unordered_map.hpp"
+
+#include <map>
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+#include <unordered_map>
+#include "gtest/gtest.h"
+
+static constexpr size_t kMax = 32;
+using MapType = FixedUnorderedMap<size_t, std::string, kMax>;
+
+TEST(FixedUnorderedMap, ctor_dtor) {
+  MapType fmap;
+  EXPECT_TRUE(fmap.empty());
+  EXPECT_TRUE(fmap.use_stack_memory());
+  EXPECT_GE(fmap.bucket_count() * fmap.max_load_factor(), kMax);
+
+  std::unordered_map<size_t, std::string> umap = {{1, "a"}, {2, "b"}};
+  MapType fmap1(umap);
+  MapType fmap2(std::begin(umap), std::end(umap));
+  MapType fmap3 = {{2, "b"}, {1, "a"}};
+  MapType fmap4(fmap3);
+  EXPECT_TRUE(fmap1 == fmap2);
+  EXPECT_TRUE(fmap1 == fmap3);
+  EXPECT_TRUE(fmap1 == fmap4);
+  fmap4[3] = "c";
+  EXPECT_TRUE(fmap1 != fmap4);
+}
+
+TEST(FixedUnorderedMap, insert_find_erase) {
+  MapType fmap;
+  std::map<size_t, std::string> expect;
+  // grow well past the inline table to spill and rehash a few times
+  for (size_t i = 0; i < kMax * 10; ++i) {
+    auto res = fmap.insert(std::make_pair(i * 31, std::to_string(i)));
+    EXPECT_TRUE(res.second);
+    EXPECT_EQ(res.first->second, std::to_string(i));
+    expect[i * 31] = std::to_string(i);
+    if (i < kMax) {
+      EXPECT_TRUE(fmap.use_stack_memory());
+    }
+  }
+  EXPECT_FALSE(fmap.use_stack_memory());
+  EXPECT_EQ(fmap.size(), expect.size());
+  EXPECT_FALSE(fmap.insert(std::make_pair(31ul, std::string("x"))).second);
+
+  for (auto& kv : expect) {
+    EXPECT_EQ(fmap.at(kv.first), kv.second);
+  }
+  EXPECT_TRUE(fmap.find(1) == fmap.end());
+  EXPECT_THROW(fmap.at(1), std::out_of_range);
+
+  for (size_t i = 0; i < kMax * 10; i += 2) {
+    EXPECT_EQ(fmap.erase(i * 31), 1);
+    expect.erase(i * 31);
+  }
+  EXPECT_EQ(fmap.erase(0), 0);
+  EXPECT_EQ(fmap.size(), expect.size());
+
+  std::map<size_t, std::string> seen(fmap.begin(), fmap.end());
+  EXPECT_TRUE(seen == expect);
+
+  // erase through iterators while walking the table
+  for (auto it = fmap.begin(); it != fmap.end();) {
+    it = it->first % 3 == 0 ? fmap.erase(it) : std::next(it);
+  }
+  for (auto& kv : fmap) EXPECT_NE(kv.first % 3, 0);
+
+  // shrink back into the inline table
+  fmap.clear();
+  for (size_t i = 0; i < kMax / 2; ++i) fmap[i] = "v";
+  fmap.rehash(0);
+  EXPECT_TRUE(fmap.use_stack_memory());
+  EXPECT_EQ(fmap.size(), kMax / 2);
+  EXPECT_EQ(fmap[kMax / 2 - 1], "v");
+}
+
+TEST(FixedUnorderedMap, tombstones) {
+  MapType fmap;
+  // churn inside the inline table, tombstones must be recycled in place
+  for (size_t round = 0; round < 100; ++round) {
+    for (size_t i = 0; i < kMax; ++i) fmap[round * kMax + i] = "x";
+    for (size_t i = 0; i < kMax; ++i) fmap.erase(round * kMax + i);
+  }
+  EXPECT_TRUE(fmap.empty());
+  EXPECT_TRUE(fmap.use_stack_memory());
+}
+
+TEST(FixedUnorderedMap, move_swap) {
+  MapType small = {{1, "a"}};
+  MapType big;
+  for (size_t i = 0; i < kMax * 4; ++i) big[i] = std::to_string(i);
+
+  MapType moved(std::move(big));
+  EXPECT_EQ(moved.size(), kMax * 4);
+  EXPECT_TRUE(big.empty());
+  EXPECT_TRUE(big.use_stack_memory());
+
+  MapType moved_small(std::move(small));
+  EXPECT_EQ(moved_small.at(1), "a");
+  EXPECT_TRUE(small.empty());
+
+  swap(moved, moved_small);
+  EXPECT_EQ(moved.size(), 1);
+  EXPECT_EQ(moved_small.size(), kMax * 4);
+  EXPECT_EQ(moved_small.at(kMax), std::to_string(kMax));
+
+  moved = moved_small;
+  EXPECT_TRUE(moved == moved_small);
+  moved.reserve(kMax * 100);
+  EXPECT_TRUE(moved == moved_small);
+}
@@ -0,0 +1,53 @@
+#include "fixed_unordered_set.hpp"
+
+#include <set>
+#include <vector>
+#include <string>
+#include <memory>
+#include <numeric>
+#include <algorithm>
+#include <unordered_set>
+#include "gtest/gtest.h"
+
+static constexpr size_t kMax = 32;
+static std::vector<int> vec(kMax * 3);
+
+TEST(FixedUnorderedSet, general) {
+  std::iota(std::begin(vec), std::end(vec), 0);
+
+  FixedUnorderedSet<int, kMax> fset(std::begin(vec), std::end(vec));
+  EXPECT_EQ(fset.size(), vec.size());
+  for (int i : vec) EXPECT_EQ(fset.count(i), 1);
+  EXPECT_EQ(fset.count(-1), 0);
+
+  std::set<int> seen(fset.begin(), fset.end());
+  EXPECT_TRUE(std::equal(seen.begin(), seen.end(), std::begin(vec)));
+
+  FixedUnorderedSet<int, kMax> fset1 = {1, 2, 2, 3};
+  EXPECT_EQ(fset1.size(), 3);
+  EXPECT_FALSE(fset1.insert(3).second);
+  EXPECT_EQ(*fset1.insert(4).first, 4);
+  EXPECT_EQ(fset1.erase(1), 1);
+  EXPECT_TRUE(fset1.find(1) == fset1.end());
+
+  std::unordered_set<int> uset = {2, 3, 4};
+  FixedUnorderedSet<int, kMax> fset2(uset);
+  EXPECT_TRUE(fset1 == fset2);
+}
+
+TEST(FixedUnorderedSet, strings) {
+  FixedUnorderedSet<std::string, 4> fset;
+  for (int i = 0; i < 100; ++i) fset.emplace(std::to_string(i));
+  EXPECT_EQ(fset.size(), 100);
+  EXPECT_EQ(fset.count("42"), 1);
+
+  FixedUnorderedSet<std::string, 4> fset1(std::move(fset));
+  EXPECT_EQ(fset1.size(), 100);
+  EXPECT_TRUE(fset.empty());
+
+  fset = fset1;
+  EXPECT_TRUE(fset == fset1);
+  fset.clear();
+  EXPECT_TRUE(fset.empty());
+  EXPECT_TRUE(fset.begin() == fset.end());
+}
@@ -0,0 +1,214 @@
+#include "fixed_unrolled_list.hpp"
+
+#include <list>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include "gtest/gtest.h"
+
+using ListType = FixedUnrolledList<int, 16, 4>;
+
+TEST(FixedUnrolledList, general) {
+  ListType flist{1, 2};
+  EXPECT_EQ(flist.front(), 1);
+  EXPECT_EQ(flist.back(), 2);
+  EXPECT_EQ(flist.size(), 2);
+
+  ListType::iterator it = flist.begin();
+  EXPECT_EQ(*it, 1);
+  EXPECT_EQ(*std::next(it), 2);
+  EXPECT_EQ(std::next(it, 2), flist.end());
+
+  flist.clear();
+  EXPECT_TRUE(flist.empty());
+  EXPECT_EQ(flist.begin(), flist.end());
+}
+
+TEST(FixedUnrolledList, default_node_size) {
+  EXPECT_EQ(sizeof(FixedUnrolledList<int, 8>::Node), 64);
+  EXPECT_EQ(sizeof(FixedUnrolledList<size_t, 8>::Node), 64);
+  EXPECT_EQ(alignof(FixedUnrolledList<int, 8>::Node), 64);
+
+  // appending fills each node before the next, nodes in heap slabs start
+  // on a cache line as well
+  using Ints = FixedUnrolledList<int, 8>;
+  Ints flist;
+  for (int i = 0; i < 200; ++i) flist.push_back(i);
+  size_t per_node = UnrolledElemsPerNode<int>();
+  size_t offset = reinterpret_cast<uintptr_t>(&flist.front()) % 64;
+  size_t i = 0;
+  for (const int& v : flist) {
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(&v) % 64,
+              offset + i++ % per_node * sizeof(int));
+  }
+}
+
+TEST(FixedUnrolledList, push_and_pop) {
+  ListType flist;
+  std::list<int> expect;
+  for (int i = 0; i < 50; ++i) {
+    flist.push_back(i);
+    flist.push_front(-i);
+    expect.push_back(i);
+    expect.push_front(-i);
+  }
+  EXPECT_EQ(flist.size(), expect.size());
+  EXPECT_TRUE(std::equal(flist.begin(), flist.end(), expect.begin()));
+  EXPECT_TRUE(std::equal(flist.rbegin(), flist.rend(), expect.rbegin()));
+
+  for (int i = 0; i < 30; ++i) {
+    flist.pop_back();
+    flist.pop_front();
+    expect.pop_back();
+    expect.pop_front();
+  }
+  EXPECT_TRUE(std::equal(flist.begin(), flist.end(), expect.begin()));
+  while (!flist.empty()) flist.pop_front();
+  EXPECT_EQ(flist.begin(), flist.end());
+  flist.push_back(7);
+  EXPECT_EQ(flist.front(), 7);
+}
+
+TEST(FixedUnrolledList, insert_erase_random) {
+  ListType flist;
+  std::list<int> expect;
+  srand(42);
+  for (int i = 0; i < 2000; ++i) {
+    size_t at = expect.empty() ? 0 : rand() % (expect.size() + 1);
+    auto fit = std::next(flist.begin(), at);
+    auto eit = std::next(expect.begin(), at);
+    if (rand() % 3 != 0 || eit == expect.end()) {
+      auto ret = flist.insert(fit, i);
+      expect.insert(eit, i);
+      EXPECT_EQ(*ret, i);
+    } else {
+      auto ret = flist.erase(fit);
+      auto eret = expect.erase(eit);
+      EXPECT_EQ(std::distance(flist.begin(), ret),
+                std::distance(expect.begin(), eret));
+    }
+  }
+  EXPECT_EQ(flist.size(), expect.size());
+  EXPECT_TRUE(std::equal(flist.begin(), flist.end(), expect.begin()));
+  EXPECT_TRUE(std::equal(flist.rbegin(), flist.rend(), expect.rbegin()));
+
+  auto first = std::next(flist.begin(), 10);
+  auto last = std::next(flist.begin(), flist.size() - 10);
+  auto ret = flist.erase(first, last);
+  expect.erase(std::next(expect.begin(), 10),
+               std::next(expect.begin(), expect.size() - 10));
+  EXPECT_EQ(std::distance(flist.begin(), ret), 10);
+  EXPECT_TRUE(std::equal(flist.begin(), flist.end(), expect.begin()));
+}
+
+TEST(FixedUnrolledList, stable_iterators) {
+  // an iterator into another node survives inserts and erases elsewhere
+  ListType flist;
+  for (int i = 0; i < 16; ++i) flist.push_back(i);
+  auto it = std::next(flist.begin(), 13);
+  flist.insert(std::next(flist.begin(), 2), 100);
+  flist.erase(flist.begin());
+  flist.push_front(200);
+  EXPECT_EQ(*it, 13);
+  EXPECT_EQ(*++it, 14);
+}
+
+TEST(FixedUnrolledList, strings) {
+  using Strings = FixedUnrolledList<std::string, 4, 3>;
+  Strings flist;
+  std::list<std::string> expect;
+  for (int i = 0; i < 40; ++i) {
+    std::string value = std::to_string(i) + std::string(i % 5 * 10, 'x');
+    size_t at = i % 7 == 0 ? 0 : expect.size() / 2;
+    flist.insert(std::next(flist.begin(), at), value);
+    expect.insert(std::next(expect.begin(), at), value);
+  }
+  for (int i = 0; i < 15; ++i) {
+    flist.erase(std::next(flist.begin(), i));
+    expect.erase(std::next(expect.begin(), i));
+  }
+  EXPECT_TRUE(std::equal(flist.begin(), flist.end(), expect.begin()));
+
+  Strings copy(flist);
+  EXPECT_TRUE(copy == flist);
+  copy.back() += "!";
+  EXPECT_TRUE(copy != flist);
+  EXPECT_TRUE(flist < copy);
+}
+
+TEST(FixedUnrolledList, insert_throw) {
+  struct Thrower {
+    explicit Thrower(int v) : value(v) {
+      if (v < 0) throw std::runtime_error("negative");
+    }
+    int value;
+  };
+  FixedUnrolledList<Thrower, 4, 2> flist;
+  for (int i = 0; i < 6; ++i) flist.emplace_back(i);
+  EXPECT_THROW(flist.emplace(std::next(flist.begin(), 3), -1),
+               std::runtime_error);
+  EXPECT_EQ(flist.size(), 6);
+  int i = 0;
+  for (const Thrower& t : flist) EXPECT_EQ(t.value, i++);
+}
+
+TEST(FixedUnrolledList, splice) {
+  using Strings = FixedUnrolledList<std::string, 4, 2>;
+  Strings lhs{"a", "b", "c", "d", "e", "f"};
+  Strings rhs{"1", "2", "3", "4", "5"};
+  lhs.splice(std::next(lhs.begin(), 3), rhs);
+  EXPECT_TRUE(rhs.empty());
+  EXPECT_TRUE((lhs ==
+               Strings{"a", "b", "c", "1", "2", "3", "4", "5", "d", "e", "f"}));
+
+  // both lists keep working on their pools afterwards
+  rhs.push_back("x");
+  lhs.push_front("y");
+  lhs.splice(lhs.end(), std::move(rhs));
+  EXPECT_EQ(lhs.size(), 13);
+  EXPECT_EQ(lhs.front(), "y");
+  EXPECT_EQ(lhs.back(), "x");
+  lhs.splice(lhs.begin(), lhs);
+  EXPECT_EQ(lhs.size(), 13);
+}
+
+TEST(FixedUnrolledList, move_and_swap) {
+  ListType lhs;
+  for (int i = 0; i < 40; ++i) lhs.push_back(i);
+  ListType rhs{-1, -2};
+  std::vector<int> expect(lhs.begin(), lhs.end());
+
+  ListType moved(std::move(lhs));
+  EXPECT_TRUE(lhs.empty());
+  EXPECT_TRUE(std::equal(moved.begin(), moved.end(), expect.begin()));
+
+  swap(moved, rhs);
+  EXPECT_TRUE((moved == ListType{-1, -2}));
+  EXPECT_TRUE(std::equal(rhs.begin(), rhs.end(), expect.begin()));
+  EXPECT_EQ(rhs.size(), 40);
+
+  rhs = ListType{5};
+  EXPECT_EQ(rhs.size(), 1);
+  lhs = moved;
+  EXPECT_TRUE(lhs == moved);
+}
+
+TEST(FixedUnrolledList, splice_across_arenas) {
+  using ArenaStrings = FixedUnrolledList<std::string, 2, 2, ArenaSlabs>;
+  Arena first_arena;
+  Arena second_arena;
+  ArenaScope first_scope(first_arena);
+  ArenaStrings lhs{"a", "b", "c", "d"};
+  {
+    ArenaScope second_scope(second_arena);
+    ArenaStrings rhs{"e", "f", "g", "h"};
+    lhs.splice(lhs.end(), rhs);
+    EXPECT_TRUE(rhs.empty());
+  }
+  second_arena.Reset();
+  EXPECT_TRUE((lhs == ArenaStrings{"a", "b", "c", "d", "e", "f", "g", "h"}));
+}
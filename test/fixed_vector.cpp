@@ -24,3 +24,78 @@ TEST(FixedVector, general) {
 
   EXPECT_TRUE(std::equal(std::begin(fv), std::end(fv), std::begin(fv_shd)));
 }
+
+TEST(FixedVector, move) {
+  const int kMax = 16;
+  using VecType = FixedVector<int, kMax>;
+
+  // inline contents are moved element by element
+  VecType small(kMax / 2, 1);
+  VecType small_moved(std::move(small));
+  EXPECT_EQ(small_moved.size(), kMax / 2);
+  EXPECT_TRUE(small.empty());
+  EXPECT_EQ(small.capacity(), kMax);
+
+  // spilled contents hand over the heap buffer
+  VecType big;
+  for (int i = 0; i < kMax * 4; ++i) big.push_back(i);
+  const int* heap_data = big.data();
+  VecType big_moved(std::move(big));
+  EXPECT_EQ(big_moved.data(), heap_data);
+  EXPECT_EQ(big_moved.size(), kMax * 4);
+  EXPECT_TRUE(big.empty());
+  EXPECT_EQ(big.capacity(), kMax);
+
+  big.push_back(1);
+  EXPECT_EQ(big.back(), 1);
+
+  VecType assigned;
+  assigned = std::move(big_moved);
+  EXPECT_EQ(assigned.data(), heap_data);
+  EXPECT_EQ(assigned.size(), kMax * 4);
+  EXPECT_EQ(assigned.back(), kMax * 4 - 1);
+  EXPECT_TRUE(big_moved.empty());
+
+  assigned = std::move(small_moved);
+  EXPECT_EQ(assigned.size(), kMax / 2);
+  EXPECT_EQ(assigned.front(), 1);
+
+  VecType spilled_target(kMax * 2);
+  VecType spilled_source(kMax * 3, 7);
+  heap_data = spilled_source.data();
+  spilled_target = std::move(spilled_source);
+  EXPECT_EQ(spilled_target.data(), heap_data);
+  EXPECT_EQ(spilled_target.size(), kMax * 3);
+}
+
+TEST(FixedVector, swap) {
+  const int kSmall = 8;
+  FixedVector<int, kSmall> small{1, 2, 3};
+  FixedVector<int, kSmall> large(kSmall * 4, 7);
+  FixedVector<int, kSmall> other_large(kSmall * 2, 9);
+  const int* heap = large.data();
+
+  swap(small, large);
+  EXPECT_EQ(small.data(), heap);
+  EXPECT_EQ(small.size(), kSmall * 4);
+  EXPECT_TRUE((large == FixedVector<int, kSmall>({1, 2, 3})));
+  EXPECT_TRUE(large.get_allocator().use_stack_memory());
+
+  const int* other_heap = other_large.data();
+  small.swap(other_large);
+  EXPECT_EQ(small.data(), other_heap);
+  EXPECT_EQ(other_large.data(), heap);
+
+  FixedVector<int, kSmall> tiny{4};
+  tiny.swap(large);
+  EXPECT_TRUE((tiny == FixedVector<int, kSmall>({1, 2, 3})));
+  EXPECT_TRUE((large == FixedVector<int, kSmall>({4})));
+}
+
+TEST(FixedVector, allocator_equality) {
+  FixedVector<int, 4> lhs;
+  FixedVector<int, 4> rhs;
+  EXPECT_TRUE(lhs.get_allocator() == lhs.get_allocator());
+  EXPECT_FALSE(lhs.get_allocator() == rhs.get_allocator());
+  EXPECT_TRUE(lhs.get_allocator() != rhs.get_allocator());
+}
@@ -0,0 +1,71 @@
+#include "fixed_work_stealing_deque.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+
+TEST(FixedWorkStealingDeque, general) {
+  FixedWorkStealingDeque<int, 3> deque;
+  EXPECT_EQ(deque.capacity(), 4);
+  int value = -1;
+  EXPECT_FALSE(deque.pop(value));
+  EXPECT_FALSE(deque.steal(value));
+
+  for (int i = 0; i < 4; ++i) EXPECT_TRUE(deque.push(i));
+  EXPECT_FALSE(deque.push(4));
+  EXPECT_EQ(deque.size_approx(), 4);
+
+  // the owner takes the newest, a thief the oldest
+  EXPECT_TRUE(deque.pop(value));
+  EXPECT_EQ(value, 3);
+  EXPECT_TRUE(deque.steal(value));
+  EXPECT_EQ(value, 0);
+  EXPECT_TRUE(deque.push(5));
+  EXPECT_TRUE(deque.push(6));
+  EXPECT_FALSE(deque.push(7));
+
+  std::vector<int> rest;
+  while (deque.pop(value)) rest.push_back(value);
+  EXPECT_EQ(rest, (std::vector<int>{6, 5, 2, 1}));
+  EXPECT_TRUE(deque.empty_approx());
+  EXPECT_FALSE(deque.steal(value));
+}
+
+TEST(FixedWorkStealingDeque, thieves) {
+  constexpr size_t kTasks = 200000;
+  constexpr size_t kThieves = 3;
+  FixedWorkStealingDeque<size_t, 64> deque;
+  std::vector<std::atomic<int>> taken(kTasks);
+  for (std::atomic<int>& count : taken) count.store(0);
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> thieves;
+  for (size_t t = 0; t < kThieves; ++t) {
+    thieves.emplace_back([&] {
+      size_t task;
+      while (!done.load()) {
+        if (deque.steal(task)) {
+          ++taken[task];
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  // the owner pushes, and works on its own tasks every now and then
+  size_t task;
+  for (size_t i = 0; i < kTasks; ++i) {
+    while (!deque.push(i)) {
+      if (deque.pop(task)) ++taken[task];
+    }
+    if (i % 5 == 0 && deque.pop(task)) ++taken[task];
+  }
+  while (deque.pop(task)) ++taken[task];
+  done.store(true);
+  for (std::thread& thief : thieves) thief.join();
+
+  size_t wrong = 0;
+  for (std::atomic<int>& count : taken) wrong += count.load() != 1;
+  EXPECT_EQ(wrong, 0);
+}
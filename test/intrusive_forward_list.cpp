@@ -0,0 +1,135 @@
+#include "intrusive_forward_list.hpp"
+
+#include <vector>
+#include "gtest/gtest.h"
+
+struct Job {
+  explicit Job(int i = 0) : id(i) {}
+  int id;
+  IntrusiveForwardListHook hook;
+  IntrusiveForwardListHook other_hook;
+  bool operator==(const Job& other) const { return id == other.id; }
+  bool operator<(const Job& other) const { return id < other.id; }
+};
+
+using JobQueue = IntrusiveForwardList<Job, &Job::hook>;
+using OtherQueue = IntrusiveForwardList<Job, &Job::other_hook>;
+
+std::vector<int> Ids(const JobQueue& list) {
+  std::vector<int> ids;
+  for (const Job& job : list) ids.push_back(job.id);
+  return ids;
+}
+
+TEST(IntrusiveForwardList, fifo) {
+  Job jobs[4] = {Job(0), Job(1), Job(2), Job(3)};
+  JobQueue queue;
+  EXPECT_TRUE(queue.empty());
+  queue.push_back(jobs[1]);
+  queue.push_back(jobs[2]);
+  queue.push_front(jobs[0]);
+  EXPECT_EQ(queue.size(), 3);
+  EXPECT_EQ(&queue.front(), &jobs[0]);
+  EXPECT_EQ(&queue.back(), &jobs[2]);
+  EXPECT_EQ(Ids(queue), std::vector<int>({0, 1, 2}));
+
+  while (!queue.empty()) queue.pop_front();
+  for (const Job& job : jobs) EXPECT_FALSE(job.hook.is_linked());
+  // the tail went back to the head
+  queue.push_back(jobs[3]);
+  queue.push_back(jobs[0]);
+  EXPECT_EQ(Ids(queue), std::vector<int>({3, 0}));
+  queue.clear();
+}
+
+TEST(IntrusiveForwardList, insert_erase_after) {
+  Job jobs[5] = {Job(0), Job(1), Job(2), Job(3), Job(4)};
+  JobQueue queue;
+  queue.push_back(jobs[0]);
+  auto it = queue.insert_after(queue.begin(), jobs[2]);
+  queue.insert_after(queue.before_begin(), jobs[1]);
+  queue.insert_after(it, jobs[3]);
+  EXPECT_EQ(&queue.back(), &jobs[3]);
+  queue.push_back(jobs[4]);
+  EXPECT_EQ(Ids(queue), std::vector<int>({1, 0, 2, 3, 4}));
+
+  it = queue.erase_after(queue.iterator_to(jobs[2]));
+  EXPECT_EQ(it->id, 4);
+  queue.erase_after(queue.iterator_to(jobs[2]), queue.end());
+  EXPECT_EQ(Ids(queue), std::vector<int>({1, 0, 2}));
+  EXPECT_EQ(&queue.back(), &jobs[2]);
+  EXPECT_FALSE(jobs[4].hook.is_linked());
+  queue.push_back(jobs[4]);
+  EXPECT_EQ(Ids(queue), std::vector<int>({1, 0, 2, 4}));
+  queue.clear();
+}
+
+TEST(IntrusiveForwardList, splice_after) {
+  Job jobs[6] = {Job(0), Job(1), Job(2), Job(3), Job(4), Job(5)};
+  JobQueue lhs(jobs, jobs + 3);
+  JobQueue rhs(jobs + 3, jobs + 6);
+
+  // the element after 3, onto the end
+  lhs.splice_after(lhs.iterator_to(jobs[2]), rhs, rhs.iterator_to(jobs[3]));
+  EXPECT_EQ(Ids(lhs), std::vector<int>({0, 1, 2, 4}));
+  EXPECT_EQ(Ids(rhs), std::vector<int>({3, 5}));
+  EXPECT_EQ(&lhs.back(), &jobs[4]);
+
+  lhs.splice_after(lhs.before_begin(), rhs);
+  EXPECT_EQ(Ids(lhs), std::vector<int>({3, 5, 0, 1, 2, 4}));
+  EXPECT_TRUE(rhs.empty());
+  // the emptied list stays usable, a job is unlinked before it moves
+  Job& first = lhs.front();
+  lhs.pop_front();
+  rhs.push_back(first);
+  EXPECT_EQ(Ids(rhs), std::vector<int>({3}));
+  rhs.clear();
+
+  rhs.splice_after(rhs.before_begin(), lhs, lhs.iterator_to(jobs[5]),
+                   lhs.end());
+  EXPECT_EQ(Ids(lhs), std::vector<int>({5}));
+  EXPECT_EQ(Ids(rhs), std::vector<int>({0, 1, 2, 4}));
+  EXPECT_EQ(&lhs.back(), &jobs[5]);
+  EXPECT_EQ(&rhs.back(), &jobs[4]);
+  EXPECT_EQ(rhs.size(), 4);
+
+  // within one list, the last element to the front
+  rhs.splice_after(rhs.before_begin(), rhs, rhs.iterator_to(jobs[2]));
+  EXPECT_EQ(Ids(rhs), std::vector<int>({4, 0, 1, 2}));
+  EXPECT_EQ(&rhs.back(), &jobs[2]);
+  EXPECT_EQ(rhs.size(), 4);
+  lhs.clear();
+  rhs.clear();
+}
+
+TEST(IntrusiveForwardList, swap_move_compare) {
+  Job jobs[3] = {Job(0), Job(1), Job(2)};
+  JobQueue lhs(jobs, jobs + 2);
+  JobQueue rhs;
+  swap(lhs, rhs);
+  EXPECT_TRUE(lhs.empty());
+  EXPECT_EQ(Ids(rhs), std::vector<int>({0, 1}));
+  lhs.push_back(jobs[2]);
+  EXPECT_EQ(Ids(lhs), std::vector<int>({2}));
+
+  JobQueue moved(std::move(rhs));
+  EXPECT_TRUE(rhs.empty());
+  EXPECT_EQ(Ids(moved), std::vector<int>({0, 1}));
+  EXPECT_EQ(&moved.back(), &jobs[1]);
+
+  Job others[2] = {Job(0), Job(2)};
+  OtherQueue other(others, others + 2);
+  EXPECT_TRUE(moved < other);
+  EXPECT_TRUE(other > moved);
+  EXPECT_TRUE(moved != other);
+  moved.pop_front();
+  moved.erase_after(moved.before_begin());
+  EXPECT_TRUE(moved.empty());
+  moved = std::move(lhs);
+  EXPECT_EQ(Ids(moved), std::vector<int>({2}));
+  moved.push_front(jobs[0]);
+  EXPECT_TRUE(moved == other);
+  EXPECT_TRUE(moved <= other);
+  moved.clear();
+  other.clear();
+}
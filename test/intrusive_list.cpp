@@ -0,0 +1,167 @@
+#include "intrusive_list.hpp"
+
+#include <vector>
+#include "gtest/gtest.h"
+
+struct Task {
+  explicit Task(int i = 0) : id(i) {}
+  int id;
+  IntrusiveListHook run_hook;
+  IntrusiveListHook all_hook;
+  bool operator==(const Task& other) const { return id == other.id; }
+  bool operator<(const Task& other) const { return id < other.id; }
+};
+
+using RunQueue = IntrusiveList<Task, &Task::run_hook>;
+using AllTasks = IntrusiveList<Task, &Task::all_hook>;
+
+std::vector<int> Ids(const RunQueue& list) {
+  std::vector<int> ids;
+  for (const Task& task : list) ids.push_back(task.id);
+  return ids;
+}
+
+TEST(IntrusiveList, push_pop) {
+  Task tasks[4] = {Task(0), Task(1), Task(2), Task(3)};
+  RunQueue queue;
+  EXPECT_TRUE(queue.empty());
+  queue.push_back(tasks[1]);
+  queue.push_back(tasks[2]);
+  queue.push_front(tasks[0]);
+  EXPECT_EQ(queue.size(), 3);
+  EXPECT_EQ(&queue.front(), &tasks[0]);
+  EXPECT_EQ(&queue.back(), &tasks[2]);
+  EXPECT_TRUE(tasks[1].run_hook.is_linked());
+  EXPECT_FALSE(tasks[3].run_hook.is_linked());
+  EXPECT_EQ(Ids(queue), std::vector<int>({0, 1, 2}));
+
+  std::vector<int> reversed;
+  for (auto it = queue.rbegin(); it != queue.rend(); ++it) {
+    reversed.push_back(it->id);
+  }
+  EXPECT_EQ(reversed, std::vector<int>({2, 1, 0}));
+
+  queue.pop_front();
+  queue.pop_back();
+  EXPECT_FALSE(tasks[0].run_hook.is_linked());
+  EXPECT_EQ(Ids(queue), std::vector<int>({1}));
+  queue.clear();
+  EXPECT_FALSE(tasks[1].run_hook.is_linked());
+}
+
+TEST(IntrusiveList, two_hooks) {
+  Task tasks[3] = {Task(0), Task(1), Task(2)};
+  RunQueue queue;
+  AllTasks all(tasks, tasks + 3);
+  queue.push_back(tasks[2]);
+  queue.push_back(tasks[0]);
+  EXPECT_EQ(all.size(), 3);
+  EXPECT_EQ(Ids(queue), std::vector<int>({2, 0}));
+  // unlink in O(1) from the object alone
+  all.erase(all.iterator_to(tasks[1]));
+  EXPECT_EQ(all.size(), 2);
+  EXPECT_EQ(all.front().id, 0);
+  EXPECT_EQ(all.back().id, 2);
+  all.clear();
+  queue.clear();
+}
+
+TEST(IntrusiveList, insert_erase) {
+  Task tasks[5] = {Task(0), Task(1), Task(2), Task(3), Task(4)};
+  RunQueue queue;
+  queue.push_back(tasks[0]);
+  queue.push_back(tasks[4]);
+  auto it = queue.insert(queue.iterator_to(tasks[4]), tasks[2]);
+  EXPECT_EQ(it->id, 2);
+  queue.insert(it, tasks[1]);
+  queue.insert(queue.end(), tasks[3]);
+  EXPECT_EQ(Ids(queue), std::vector<int>({0, 1, 2, 4, 3}));
+  it = queue.erase(queue.iterator_to(tasks[2]));
+  EXPECT_EQ(it->id, 4);
+  it = queue.erase(queue.begin(), it);
+  EXPECT_EQ(Ids(queue), std::vector<int>({4, 3}));
+  EXPECT_FALSE(tasks[0].run_hook.is_linked());
+  queue.clear();
+}
+
+TEST(IntrusiveList, splice) {
+  Task tasks[6] = {Task(0), Task(1), Task(2), Task(3), Task(4), Task(5)};
+  RunQueue lhs(tasks, tasks + 3);
+  RunQueue rhs(tasks + 3, tasks + 6);
+
+  lhs.splice(lhs.end(), rhs, rhs.iterator_to(tasks[4]));
+  EXPECT_EQ(Ids(lhs), std::vector<int>({0, 1, 2, 4}));
+  EXPECT_EQ(Ids(rhs), std::vector<int>({3, 5}));
+
+  lhs.splice(lhs.begin(), rhs);
+  EXPECT_EQ(Ids(lhs), std::vector<int>({3, 5, 0, 1, 2, 4}));
+  EXPECT_TRUE(rhs.empty());
+
+  rhs.splice(rhs.end(), lhs, lhs.iterator_to(tasks[0]), lhs.end());
+  EXPECT_EQ(Ids(lhs), std::vector<int>({3, 5}));
+  EXPECT_EQ(Ids(rhs), std::vector<int>({0, 1, 2, 4}));
+  EXPECT_EQ(rhs.size(), 4);
+
+  // within one list
+  rhs.splice(rhs.begin(), rhs, rhs.iterator_to(tasks[4]));
+  rhs.splice(rhs.end(), rhs, rhs.iterator_to(tasks[4]),
+             rhs.iterator_to(tasks[1]));
+  EXPECT_EQ(Ids(rhs), std::vector<int>({1, 2, 4, 0}));
+  EXPECT_EQ(rhs.size(), 4);
+  lhs.clear();
+  rhs.clear();
+}
+
+TEST(IntrusiveList, swap_move) {
+  Task tasks[3] = {Task(0), Task(1), Task(2)};
+  RunQueue lhs(tasks, tasks + 2);
+  RunQueue rhs;
+  lhs.swap(rhs);
+  EXPECT_TRUE(lhs.empty());
+  EXPECT_EQ(Ids(rhs), std::vector<int>({0, 1}));
+  lhs.push_back(tasks[2]);
+  swap(lhs, rhs);
+  EXPECT_EQ(Ids(lhs), std::vector<int>({0, 1}));
+  EXPECT_EQ(Ids(rhs), std::vector<int>({2}));
+
+  RunQueue moved(std::move(lhs));
+  EXPECT_TRUE(lhs.empty());
+  EXPECT_EQ(Ids(moved), std::vector<int>({0, 1}));
+  rhs = std::move(moved);
+  EXPECT_TRUE(moved.empty());
+  EXPECT_FALSE(tasks[2].run_hook.is_linked());
+  EXPECT_EQ(Ids(rhs), std::vector<int>({0, 1}));
+  rhs.clear();
+}
+
+TEST(IntrusiveList, compare) {
+  Task lhs_tasks[3] = {Task(0), Task(1), Task(2)};
+  Task rhs_tasks[3] = {Task(0), Task(1), Task(3)};
+  RunQueue lhs(lhs_tasks, lhs_tasks + 3);
+  AllTasks rhs(rhs_tasks, rhs_tasks + 3);
+  EXPECT_TRUE(lhs != rhs);
+  EXPECT_TRUE(lhs < rhs);
+  EXPECT_TRUE(lhs <= rhs);
+  EXPECT_TRUE(rhs > lhs);
+  rhs.pop_back();
+  rhs.push_back(rhs_tasks[2]);
+  lhs.pop_back();
+  EXPECT_TRUE(lhs < rhs);
+  rhs.pop_back();
+  EXPECT_TRUE(lhs == rhs);
+  EXPECT_TRUE(lhs >= rhs);
+  lhs.clear();
+  rhs.clear();
+}
+
+TEST(IntrusiveList, copy_is_unlinked) {
+  Task task(7);
+  RunQueue queue;
+  queue.push_back(task);
+  Task copy(task);
+  EXPECT_FALSE(copy.run_hook.is_linked());
+  EXPECT_EQ(copy.id, 7);
+  queue.push_back(copy);
+  EXPECT_EQ(queue.size(), 2);
+  queue.clear();
+}
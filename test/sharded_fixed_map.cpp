@@ -0,0 +1,131 @@
+#include "sharded_fixed_map.hpp"
+
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include "gtest/gtest.h"
+
+using MapType = ShardedFixedMap<int, std::string, 8, 4>;
+
+TEST(ShardedFixedMap, general) {
+  MapType map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_TRUE(map.insert(1, "one"));
+  EXPECT_FALSE(map.insert(1, "uno"));
+  EXPECT_TRUE(map.insert_or_assign(2, "two"));
+  EXPECT_FALSE(map.insert_or_assign(2, "dos"));
+  EXPECT_EQ(map.size(), 2);
+
+  std::string value;
+  EXPECT_TRUE(map.get(1, value));
+  EXPECT_EQ(value, "one");
+  EXPECT_TRUE(map.get(2, value));
+  EXPECT_EQ(value, "dos");
+  EXPECT_FALSE(map.get(3, value));
+  EXPECT_TRUE(map.contains(2));
+
+  EXPECT_TRUE(map.update(1, [](std::string& v) { v += "!"; }));
+  EXPECT_FALSE(map.update(3, [](std::string& v) { v += "!"; }));
+  size_t length = 0;
+  EXPECT_TRUE(map.visit(1, [&length](const std::string& v) {
+    length = v.size();
+  }));
+  EXPECT_EQ(length, 4);
+
+  EXPECT_EQ(map.erase(1), 1);
+  EXPECT_EQ(map.erase(1), 0);
+  map.clear();
+  EXPECT_TRUE(map.empty());
+}
+
+TEST(ShardedFixedMap, spreads_and_overflows) {
+  MapType map;
+  std::map<int, std::string> expect;
+  // well past 4 shards of 8 inline nodes
+  for (int i = 0; i < 200; ++i) {
+    map.insert(i * 7, std::to_string(i));
+    expect.emplace(i * 7, std::to_string(i));
+  }
+  EXPECT_EQ(map.size(), expect.size());
+  std::vector<size_t> per_shard(MapType::shard_count());
+  std::map<int, std::string> seen;
+  map.for_each([&](int key, const std::string& value) {
+    ++per_shard[MapType::shard_of(key)];
+    seen.emplace(key, value);
+  });
+  EXPECT_EQ(seen, expect);
+  for (size_t count : per_shard) EXPECT_GT(count, 20);
+}
+
+TEST(ShardedFixedMap, multi_get) {
+  MapType map;
+  for (int i = 0; i < 100; i += 2) map.insert(i, std::to_string(i));
+
+  std::vector<int> keys;
+  for (int i = 99; i >= 0; i -= 3) keys.push_back(i);
+  std::vector<std::string> values(keys.size());
+  std::unique_ptr<bool[]> found(new bool[keys.size()]);
+  size_t hits =
+      map.multi_get(keys.data(), keys.size(), values.data(), found.get());
+
+  size_t expect_hits = 0;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    bool even = keys[i] % 2 == 0;
+    expect_hits += even;
+    EXPECT_EQ(found[i], even);
+    EXPECT_EQ(values[i], even ? std::to_string(keys[i]) : "");
+  }
+  EXPECT_EQ(hits, expect_hits);
+  EXPECT_EQ(map.multi_get(keys.data(), 0, values.data()), 0);
+}
+
+TEST(ShardedFixedMap, readers_and_writers) {
+  // each value is twice its key, whichever version a reader sees
+  ShardedFixedMap<int, long, 64, 8> map;
+  constexpr int kKeys = 256;
+  for (int i = 0; i < kKeys; ++i) map.insert(i, 2L * i);
+
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> bad{0};
+  std::vector<std::thread> threads;
+  for (int w = 0; w < 2; ++w) {
+    threads.emplace_back([&map, w] {
+      for (int round = 0; round < 200; ++round) {
+        for (int i = w; i < kKeys; i += 2) {
+          if (round % 2 == 0) {
+            map.erase(i);
+          } else {
+            map.insert(i, 2L * i);
+          }
+        }
+        std::this_thread::yield();
+      }
+    });
+  }
+  for (int r = 0; r < 2; ++r) {
+    threads.emplace_back([&map, &stop, &bad] {
+      int keys[16];
+      long values[16];
+      bool found[16];
+      while (!stop.load()) {
+        for (int i = 0; i < 16; ++i) keys[i] = (i * 37) % kKeys;
+        map.multi_get(keys, 16, values, found);
+        for (int i = 0; i < 16; ++i) {
+          bad += found[i] && values[i] != 2L * keys[i];
+        }
+        long value;
+        if (map.get(keys[3], value)) bad += value != 2L * keys[3];
+        std::this_thread::yield();
+      }
+    });
+  }
+  threads[0].join();
+  threads[1].join();
+  stop.store(true);
+  threads[2].join();
+  threads[3].join();
+  EXPECT_EQ(bad.load(), 0);
+  EXPECT_EQ(map.size(), kKeys);
+}
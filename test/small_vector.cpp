@@ -0,0 +1,180 @@
+#include "small_vector.hpp"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <numeric>
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include "gtest/gtest.h"
+
+static constexpr size_t kMax = 16;
+
+TEST(SmallVector, general) {
+  std::vector<size_t> vec(kMax * 4);
+  std::iota(std::begin(vec), std::end(vec), 0ul);
+
+  SmallVector<size_t, kMax> sv;
+  EXPECT_TRUE(sv.empty());
+  EXPECT_EQ(sv.capacity(), kMax);
+  EXPECT_TRUE(sv.use_stack_memory());
+
+  for (size_t i = 0; i < kMax; ++i) sv.push_back(i);
+  EXPECT_TRUE(sv.use_stack_memory());
+  for (size_t i = kMax; i < vec.size(); ++i) sv.push_back(i);
+  EXPECT_FALSE(sv.use_stack_memory());
+  EXPECT_TRUE(std::equal(std::begin(vec), std::end(vec), std::begin(sv)));
+
+  SmallVector<size_t, kMax> sv2(std::begin(vec), std::end(vec));
+  EXPECT_TRUE(sv == sv2);
+  sv2.pop_back();
+  EXPECT_TRUE(sv2 < sv);
+  EXPECT_TRUE(sv != sv2);
+
+  // growth can return to the inline buffer
+  sv.resize(kMax / 2);
+  sv.shrink_to_fit();
+  EXPECT_TRUE(sv.use_stack_memory());
+  EXPECT_EQ(sv.capacity(), kMax);
+  EXPECT_TRUE(std::equal(std::begin(sv), std::end(sv), std::begin(vec)));
+}
+
+TEST(SmallVector, ctor_assign) {
+  std::vector<int> vec = {1, 2, 3};
+  SmallVector<int, kMax> sv0(vec);
+  SmallVector<int, kMax> sv1 = {1, 2, 3};
+  SmallVector<int, kMax> sv2(3, 7);
+  SmallVector<int, kMax> sv3(kMax * 2);
+  EXPECT_TRUE(sv0 == sv1);
+  EXPECT_EQ(sv2[2], 7);
+  EXPECT_EQ(sv3.size(), kMax * 2);
+  EXPECT_EQ(sv3.back(), 0);
+
+  sv2 = sv1;
+  EXPECT_TRUE(sv2 == sv1);
+  sv2 = {4, 5};
+  EXPECT_EQ(sv2.size(), 2);
+  sv2.assign(kMax * 3, 1);
+  EXPECT_EQ(sv2.size(), kMax * 3);
+  sv2 = std::vector<int>(kMax, 2);
+  EXPECT_EQ(sv2.front(), 2);
+  EXPECT_THROW(sv2.at(kMax), std::out_of_range);
+}
+
+TEST(SmallVector, move_swap) {
+  SmallVector<std::string, kMax> inline_strs(kMax / 2, "inline");
+  SmallVector<std::string, kMax> heap_strs(kMax * 2, "heap");
+  const std::string* heap_data = heap_strs.data();
+
+  SmallVector<std::string, kMax> moved(std::move(heap_strs));
+  EXPECT_EQ(moved.data(), heap_data);
+  EXPECT_TRUE(heap_strs.empty());
+  EXPECT_TRUE(heap_strs.use_stack_memory());
+
+  SmallVector<std::string, kMax> moved2(std::move(inline_strs));
+  EXPECT_EQ(moved2.size(), kMax / 2);
+  EXPECT_EQ(moved2.back(), "inline");
+  EXPECT_TRUE(inline_strs.empty());
+
+  swap(moved, moved2);
+  EXPECT_EQ(moved.size(), kMax / 2);
+  EXPECT_EQ(moved2.size(), kMax * 2);
+  EXPECT_EQ(moved2.data(), heap_data);
+
+  moved = std::move(moved2);
+  EXPECT_EQ(moved.data(), heap_data);
+  EXPECT_EQ(moved.back(), "heap");
+}
+
+TEST(SmallVector, nothrow_move) {
+  static_assert(std::is_nothrow_move_constructible<
+                    SmallVector<std::string, kMax>>::value, "");
+  static_assert(std::is_nothrow_move_assignable<
+                    SmallVector<std::string, kMax>>::value, "");
+
+  // a growing std::vector moves its elements, the spilled buffers stay put
+  std::vector<SmallVector<std::string, kMax>> rows;
+  rows.emplace_back(kMax * 2, "heap");
+  const std::string* heap_data = rows[0].data();
+  for (int i = 0; i < 16; ++i) rows.emplace_back();
+  EXPECT_EQ(rows[0].data(), heap_data);
+}
+
+TEST(SmallVector, modifiers) {
+  SmallVector<std::string, 4> sv = {"a", "d"};
+  sv.insert(sv.begin() + 1, "b");
+  sv.emplace(sv.begin() + 2, 1, 'c');
+  EXPECT_EQ(sv, (SmallVector<std::string, 4>{"a", "b", "c", "d"}));
+
+  // insert a reference into itself while growing
+  sv.push_back(sv[0]);
+  sv.insert(sv.begin(), 2, sv[3]);
+  EXPECT_EQ(sv, (SmallVector<std::string, 4>{"d", "d", "a", "b", "c", "d",
+                                             "a"}));
+
+  std::vector<std::string> more = {"x", "y"};
+  sv.insert(sv.begin() + 2, more.begin(), more.end());
+  EXPECT_EQ(sv[2], "x");
+  EXPECT_EQ(sv[3], "y");
+  EXPECT_EQ(sv.size(), 9);
+
+  sv.erase(sv.begin(), sv.begin() + 2);
+  sv.erase(sv.begin() + 2);
+  EXPECT_EQ(sv, (SmallVector<std::string, 4>{"x", "y", "b", "c", "d", "a"}));
+
+  sv.resize(2);
+  sv.resize(3, "z");
+  EXPECT_EQ(sv, (SmallVector<std::string, 4>{"x", "y", "z"}));
+  sv.shrink_to_fit();
+  EXPECT_TRUE(sv.use_stack_memory());
+  EXPECT_EQ(sv.back(), "z");
+
+  sv.clear();
+  EXPECT_TRUE(sv.empty());
+}
+
+struct ThrowOnCopy {
+  static int budget;
+  std::string value;
+  ThrowOnCopy(const std::string& v) : value(v) {}
+  ThrowOnCopy(const ThrowOnCopy& other) : value(other.value) {
+    if (--budget < 0) throw std::runtime_error("copy");
+  }
+  ThrowOnCopy(ThrowOnCopy&&) noexcept = default;
+};
+int ThrowOnCopy::budget = 0;
+
+TEST(SmallVector, insert_throw) {
+  // a copy that throws leaves the elements as they were, the buffer the
+  // vector grew into included
+  std::vector<ThrowOnCopy> values;
+  for (int i = 0; i < 3; ++i) {
+    values.emplace_back("new " + std::to_string(i) + std::string(20, '.'));
+  }
+  SmallVector<ThrowOnCopy, 8> sv;
+  for (int i = 0; i < 6; ++i) {
+    sv.emplace_back("old " + std::to_string(i) + std::string(20, '.'));
+  }
+  ThrowOnCopy::budget = 1;
+  EXPECT_THROW(sv.insert(sv.begin() + 1, values.begin(), values.end()),
+               std::runtime_error);
+  ThrowOnCopy::budget = 2;
+  EXPECT_THROW(sv.insert(sv.begin() + 1, 4, values[0]), std::runtime_error);
+  ThrowOnCopy::budget = 0;
+  EXPECT_THROW(sv.insert(sv.begin() + 1, values[1]), std::runtime_error);
+  ASSERT_EQ(sv.size(), 6);
+  for (int i = 0; i < 6; ++i) {
+    EXPECT_EQ(sv[i].value, "old " + std::to_string(i) + std::string(20, '.'));
+  }
+
+  // growing out of the inline buffer, the new buffer is freed
+  SmallVector<ThrowOnCopy, 2> full;
+  full.emplace_back("a");
+  full.emplace_back("b");
+  ThrowOnCopy::budget = 0;
+  EXPECT_THROW(full.push_back(values[0]), std::runtime_error);
+  EXPECT_EQ(full.size(), 2);
+  EXPECT_TRUE(full.use_stack_memory());
+}
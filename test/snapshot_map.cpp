@@ -0,0 +1,128 @@
+#include "snapshot_map.hpp"
+#include "fixed_map.hpp"
+#include "fixed_flat_map.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <stdexcept>
+#include "gtest/gtest.h"
+
+using MapType = SnapshotMap<FixedMap<int, std::string, 8>, 4>;
+
+TEST(SnapshotMap, general) {
+  MapType map;
+  MapType::Reader reader(map);
+  std::string value;
+  EXPECT_FALSE(reader.get(1, value));
+
+  map.insert_or_assign(1, "one");
+  map.insert_or_assign(2, "two");
+  map.insert_or_assign(2, "dos");
+  EXPECT_TRUE(reader.get(1, value));
+  EXPECT_EQ(value, "one");
+  EXPECT_TRUE(reader.get(2, value));
+  EXPECT_EQ(value, "dos");
+
+  map.erase(1);
+  EXPECT_FALSE(reader.get(1, value));
+  {
+    MapType::Snapshot snapshot = reader.read();
+    EXPECT_EQ(snapshot->size(), 1);
+    EXPECT_EQ((*snapshot).begin()->second, "dos");
+  }
+
+  FixedMap<int, std::string, 8> replacement;
+  replacement.emplace(7, "seven");
+  map.publish(replacement);
+  EXPECT_TRUE(reader.get(7, value));
+  EXPECT_FALSE(reader.get(2, value));
+  EXPECT_EQ(map.epoch(), 6);
+}
+
+TEST(SnapshotMap, snapshot_is_stable) {
+  SnapshotMap<FixedFlatMap<int, int, 16>> map;
+  for (int i = 0; i < 10; ++i) map.insert_or_assign(i, i);
+  SnapshotMap<FixedFlatMap<int, int, 16>>::Reader reader(map);
+  auto snapshot = reader.read();
+
+  // the version read stays alive and unchanged through later publishes
+  for (int i = 0; i < 10; ++i) map.insert_or_assign(i, -i);
+  map.update([](FixedFlatMap<int, int, 16>& m) { m.clear(); });
+  EXPECT_EQ(map.reclaim(), 11);
+  EXPECT_EQ(snapshot->size(), 10);
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(snapshot->find(i)->second, i);
+
+  // once the read is over every old version goes
+  { auto done = std::move(snapshot); }
+  EXPECT_EQ(map.reclaim(), 0);
+  EXPECT_TRUE(reader.read()->empty());
+}
+
+TEST(SnapshotMap, failed_update_publishes_nothing) {
+  MapType map;
+  map.insert_or_assign(1, "one");
+  uint64_t epoch = map.epoch();
+  EXPECT_THROW(map.update([](FixedMap<int, std::string, 8>& m) {
+    m.clear();
+    throw std::runtime_error("no");
+  }), std::runtime_error);
+  EXPECT_EQ(map.epoch(), epoch);
+  MapType::Reader reader(map);
+  EXPECT_EQ(reader.read()->size(), 1);
+}
+
+TEST(SnapshotMap, reader_slots) {
+  MapType map;
+  {
+    std::vector<std::unique_ptr<MapType::Reader>> readers;
+    for (int i = 0; i < 4; ++i) readers.emplace_back(new MapType::Reader(map));
+    EXPECT_THROW(MapType::Reader reader(map), std::length_error);
+  }
+  // the slots are free again
+  MapType::Reader reader(map);
+  EXPECT_TRUE(reader.read()->empty());
+}
+
+TEST(SnapshotMap, readers_and_writer) {
+  // every version maps each key to key + version, readers check that the
+  // whole map they see comes from one version
+  constexpr int kKeys = 64;
+  using Map = FixedMap<int, long, kKeys>;
+  SnapshotMap<Map, 8> map;
+  map.update([](Map& m) {
+    for (int i = 0; i < kKeys; ++i) m.emplace(i, i);
+  });
+
+  std::atomic<bool> stop{false};
+  std::atomic<size_t> bad{0};
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 3; ++r) {
+    readers.emplace_back([&map, &stop, &bad] {
+      SnapshotMap<Map, 8>::Reader reader(map);
+      long last = 0;
+      while (!stop.load()) {
+        auto snapshot = reader.read();
+        long version = snapshot->find(0)->second;
+        bad += version < last || snapshot->size() != kKeys;
+        for (const auto& entry : *snapshot) {
+          bad += entry.second != entry.first + version;
+        }
+        last = version;
+        std::this_thread::yield();
+      }
+    });
+  }
+  for (long version = 1; version <= 300; ++version) {
+    map.update([](Map& m) {
+      for (auto& entry : m) ++entry.second;
+    });
+    std::this_thread::yield();
+  }
+  stop.store(true);
+  for (std::thread& reader : readers) reader.join();
+  EXPECT_EQ(bad.load(), 0);
+  EXPECT_EQ(map.reclaim(), 0);
+}
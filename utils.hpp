@@ -1,21 +1,58 @@
 #pragma once
 #include <memory>
+#include <cstdint>
+#include <type_traits>
 
-// maximum fixed container memory usage
-// default value is one memory page
-// when comes to fixedswap, another
-// one page memory will be used
-template <typename T>
-void FixedSwap(T& a, T& b) {
-  constexpr size_t kMaxStackUsage = 4 * 1024;
+// tag for constructors and insert overloads whose input range is already
+// sorted by the container's Compare and holds no equivalent keys
+struct sorted_unique_t {};
+constexpr sorted_unique_t sorted_unique{};
 
-  if (sizeof(a) < kMaxStackUsage) {
-    T tmp(a);
-    a = b;
-    b = tmp;
-  } else {
-    std::unique_ptr<T> uptr(new T(a));
-    a = b;
-    b = *uptr;
+// the same for multi containers, whose sorted input may repeat keys
+struct sorted_equivalent_t {};
+constexpr sorted_equivalent_t sorted_equivalent{};
+
+// smallest power of two that is at least n
+constexpr size_t RingSlots(size_t n, size_t slots = 1) {
+  return slots >= n ? slots : RingSlots(n, slots * 2);
+}
+
+// what data written by different threads is kept apart by
+constexpr size_t kCacheLineSize = 64;
+
+// std::hash is the identity for integers, spread the bits before they are
+// split into a bucket or shard index and the rest
+inline size_t MixHash(size_t hash) {
+  uint64_t h = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull;
+  return static_cast<size_t>(h ^ (h >> 32));
+}
+
+// lower_bound over a sorted array written so that the compiler can turn
+// the loop body into a conditional move, small tables then search without
+// branch mispredictions
+template <typename T, typename Key, typename Compare>
+inline size_t BranchlessLowerBound(const T* first, size_t n, const Key& key,
+                                   const Compare& comp) {
+  if (n == 0) {
+    return 0;
+  }
+  const T* base = first;
+  while (n > 1) {
+    size_t half = n / 2;
+    base = comp(base[half], key) ? base + half : base;
+    n -= half;
   }
+  return (base - first) + comp(*base, key);
+}
+
+// the object a member belongs to, found from the member's address the way
+// offsetof would; the member must not sit in a virtual base of T
+template <typename T, typename Member, Member T::*Field>
+inline T* MemberOwner(Member* member) {
+  // never constructed, only the member's address within it is taken
+  static typename std::aligned_storage<sizeof(T), alignof(T)>::type probe;
+  const T* object = reinterpret_cast<const T*>(&probe);
+  size_t offset = reinterpret_cast<const char*>(&(object->*Field)) -
+                  reinterpret_cast<const char*>(object);
+  return reinterpret_cast<T*>(reinterpret_cast<char*>(member) - offset);
 }